@@ -25,6 +25,7 @@
 #define __LIBDOGECOIN_ADDRESS_H__
 
 #include <stdbool.h>
+#include <stdio.h>
 
 #include <dogecoin/dogecoin.h>
 #include <dogecoin/tool.h>
@@ -34,6 +35,29 @@ LIBDOGECOIN_BEGIN_DECL
 /* generate a new private key (hex) */
 LIBDOGECOIN_API int generatePrivPubKeypair(char* wif_privkey, char* p2pkh_pubkey, bool is_testnet);
 
+/* string slots used by generatePrivPubKeypairs: a compressed WIF key (52 chars) and a p2pkh address (34 chars) plus NUL */
+#define KEYPAIR_WIF_LENGTH 53
+#define KEYPAIR_P2PKH_LENGTH 35
+
+/* generate n keypairs from a random base key k as k, k + 1, ..., k + n - 1, wif_privkeys receives n WIF keys of
+   KEYPAIR_WIF_LENGTH bytes each and p2pkh_pubkeys n addresses of KEYPAIR_P2PKH_LENGTH bytes each (either may be NULL),
+   public keys are derived by point addition and the work is split over num_threads threads
+   WARNING: the keys are linearly related, anyone holding one of them can step +-1 to every other key of the batch.
+   Treat the whole batch as a single secret and never hand out or export an individual key, use
+   generatePrivPubKeypairsTweaked when keys are shared one by one */
+LIBDOGECOIN_API int generatePrivPubKeypairs(char* wif_privkeys, char* p2pkh_pubkeys, size_t n, bool is_testnet, unsigned int num_threads);
+
+/* same as generatePrivPubKeypairs, written to file as one "wif p2pkh" line per keypair
+   WARNING: consecutive keys as above, the file is a single secret */
+LIBDOGECOIN_API int generatePrivPubKeypairsToFile(FILE* file, size_t n, bool is_testnet, unsigned int num_threads);
+
+/* generate n keypairs as k + HMAC-SHA256(s, i) from a random base k and a random secret s that are discarded afterwards,
+   one key reveals nothing about the others; slower than generatePrivPubKeypairs (a scalar multiplication per key) */
+LIBDOGECOIN_API int generatePrivPubKeypairsTweaked(char* wif_privkeys, char* p2pkh_pubkeys, size_t n, bool is_testnet, unsigned int num_threads);
+
+/* same as generatePrivPubKeypairsTweaked, written to file as one "wif p2pkh" line per keypair */
+LIBDOGECOIN_API int generatePrivPubKeypairsTweakedToFile(FILE* file, size_t n, bool is_testnet, unsigned int num_threads);
+
 /* generate HD master key and WIF public key */
 LIBDOGECOIN_API int generateHDMasterPubKeypair(char* wif_privkey_master, char* p2pkh_pubkey_master, bool is_testnet);
 
@@ -31,6 +31,7 @@
 #include <stdint.h>
 
 #include <dogecoin/chainparams.h>
+#include <dogecoin/crypto/sha2.h>
 #include <dogecoin/dogecoin.h>
 
 #define DOGECOIN_BIP32_CHAINCODE_SIZE 32
@@ -55,12 +56,18 @@ LIBDOGECOIN_API void dogecoin_hdnode_free(dogecoin_hdnode* node);
 LIBDOGECOIN_API dogecoin_bool dogecoin_hdnode_public_ckd(dogecoin_hdnode* inout, uint32_t i);
 LIBDOGECOIN_API dogecoin_bool dogecoin_hdnode_from_seed(const uint8_t* seed, int seed_len, dogecoin_hdnode* out);
 LIBDOGECOIN_API dogecoin_bool dogecoin_hdnode_private_ckd(dogecoin_hdnode* inout, uint32_t i);
+//!child key derivation with the parent chain code already keyed into chain_code_ctx (hmac_sha512_prepare),
+//!derive many children of one parent from copies of it without rehashing the hmac pads
+LIBDOGECOIN_API dogecoin_bool dogecoin_hdnode_public_ckd_ctx(dogecoin_hdnode* inout, uint32_t i, const hmac_sha512_ctx* chain_code_ctx);
+LIBDOGECOIN_API dogecoin_bool dogecoin_hdnode_private_ckd_ctx(dogecoin_hdnode* inout, uint32_t i, const hmac_sha512_ctx* chain_code_ctx);
 LIBDOGECOIN_API void dogecoin_hdnode_fill_public_key(dogecoin_hdnode* node);
 LIBDOGECOIN_API void dogecoin_hdnode_serialize_public(const dogecoin_hdnode* node, const dogecoin_chainparams* chain, char* str, int strsize);
 LIBDOGECOIN_API void dogecoin_hdnode_serialize_private(const dogecoin_hdnode* node, const dogecoin_chainparams* chain, char* str, int strsize);
 
 /* gives out the raw sha256/ripemd160 hash */
 LIBDOGECOIN_API void dogecoin_hdnode_get_hash160(const dogecoin_hdnode* node, uint160 hash160_out);
+//!hash160 of the public keys of n nodes at once on the sha256/ripemd160 batch lanes
+LIBDOGECOIN_API void dogecoin_hdnode_get_hash160_batch(const dogecoin_hdnode* nodes, size_t n, uint160* hash160s);
 LIBDOGECOIN_API void dogecoin_hdnode_get_p2pkh_address(const dogecoin_hdnode* node, const dogecoin_chainparams* chain, char* str, int strsize);
 LIBDOGECOIN_API dogecoin_bool dogecoin_hdnode_get_pub_hex(const dogecoin_hdnode* node, char* str, size_t* strsize);
 LIBDOGECOIN_API dogecoin_bool dogecoin_hdnode_deserialize(const char* str, const dogecoin_chainparams* chain, dogecoin_hdnode* node);
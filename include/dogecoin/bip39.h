@@ -0,0 +1,65 @@
+/*
+
+ The MIT License (MIT)
+
+ Copyright (c) 2022 The Dogecoin Foundation
+
+ Permission is hereby granted, free of charge, to any person obtaining
+ a copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES
+ OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+#ifndef __LIBDOGECOIN_BIP39_H__
+#define __LIBDOGECOIN_BIP39_H__
+
+#include <stdint.h>
+
+#include <dogecoin/dogecoin.h>
+
+LIBDOGECOIN_BEGIN_DECL
+
+#define BIP39_WORDLIST_SIZE 2048
+#define BIP39_SEED_LENGTH 64
+#define BIP39_PBKDF2_ROUNDS 2048
+// 24 words of at most 8 letters, the separators and the terminator
+#define BIP39_MAX_MNEMONIC_LENGTH (24 * 9)
+
+//!the english wordlist, sorted, every word is unique in its first four letters
+extern const char* const dogecoin_bip39_wordlist_english[BIP39_WORDLIST_SIZE];
+
+//!index of a wordlist word of len bytes (need not be terminated), -1 if it is not in the list
+LIBDOGECOIN_API int dogecoin_bip39_word_index(const char* word, size_t len);
+
+//!mnemonic for 16, 20, 24, 28 or 32 bytes of entropy, words separated by single spaces
+//!false if the entropy length is invalid or the mnemonic does not fit into size bytes
+LIBDOGECOIN_API dogecoin_bool dogecoin_bip39_mnemonic_from_entropy(const uint8_t* entropy, size_t entropy_len, char* mnemonic, size_t size);
+//!entropy of a 12, 15, 18, 21 or 24 word mnemonic into up to 32 bytes, false on unknown words, bad spacing or a bad checksum
+LIBDOGECOIN_API dogecoin_bool dogecoin_bip39_mnemonic_to_entropy(const char* mnemonic, uint8_t* entropy, size_t* entropy_len);
+//!true if the mnemonic only has wordlist words and its checksum matches
+LIBDOGECOIN_API dogecoin_bool dogecoin_bip39_mnemonic_check(const char* mnemonic);
+
+//!64 byte seed for dogecoin_hdnode_from_seed, pbkdf2-hmac-sha512(mnemonic, "mnemonic" || passphrase, 2048)
+//!the mnemonic is not checked, both strings are expected in NFKD form (plain ascii for the english list), passphrase may be NULL
+LIBDOGECOIN_API void dogecoin_bip39_seed_from_mnemonic(const char* mnemonic, const char* passphrase, uint8_t seed[BIP39_SEED_LENGTH]);
+//!seeds of n mnemonics into n consecutive 64 byte seeds, several at a time on the sha512 batch lanes
+//!passphrases may be NULL if none of the mnemonics has one
+LIBDOGECOIN_API void dogecoin_bip39_seeds_from_mnemonics(const char* const mnemonics[], const char* const passphrases[], size_t n, uint8_t* seeds);
+
+LIBDOGECOIN_END_DECL
+
+#endif // __LIBDOGECOIN_BIP39_H__
@@ -0,0 +1,93 @@
+/*
+
+ The MIT License (MIT)
+
+ Copyright (c) 2022 The Dogecoin Foundation
+
+ Permission is hereby granted, free of charge, to any person obtaining
+ a copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES
+ OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+#ifndef __LIBDOGECOIN_BLOCK_H__
+#define __LIBDOGECOIN_BLOCK_H__
+
+#include <dogecoin/cstr.h>
+#include <dogecoin/dogecoin.h>
+#include <dogecoin/tx.h>
+#include <dogecoin/vector.h>
+
+LIBDOGECOIN_BEGIN_DECL
+
+#define DOGECOIN_BLOCK_HEADER_SIZE 80
+
+// merge mined blocks carry an auxpow (parent chain coinbase, branches and parent header) after the header
+#define DOGECOIN_BLOCK_VERSION_AUXPOW (1 << 8)
+
+typedef struct dogecoin_block_header_ {
+    int32_t version;
+    uint256 prev_block;
+    uint256 merkle_root;
+    uint32_t timestamp;
+    uint32_t bits;
+    uint32_t nonce;
+} dogecoin_block_header;
+
+typedef struct dogecoin_block_ {
+    dogecoin_block_header header;
+    cstring* auxpow;      // raw auxpow data, NULL if the block is not merge mined
+    vector* txs;          // dogecoin_tx*
+    uint256* txids;       // txids of txs, same order
+    uint256 merkle_root;  // merkle root computed from txids
+    dogecoin_bool merkle_mutated; // duplicated subtrees were found (CVE-2012-2459)
+} dogecoin_block;
+
+//!parse/serialize the 80 byte block header
+LIBDOGECOIN_API dogecoin_bool dogecoin_block_header_deserialize(const unsigned char* header_serialized, size_t inlen, dogecoin_block_header* header);
+LIBDOGECOIN_API void dogecoin_block_header_serialize(cstring* s, const dogecoin_block_header* header);
+
+//!double sha256 of the serialized header (block id, not the scrypt pow hash)
+LIBDOGECOIN_API void dogecoin_block_header_hash(const dogecoin_block_header* header, uint256 hash);
+
+//!scrypt(1024, 1, 1) of the serialized header, the proof of work hash
+LIBDOGECOIN_API void dogecoin_block_header_pow_hash(const dogecoin_block_header* header, uint256 hash);
+//!proof of work hashes of n headers, computed on the scrypt batch lanes
+LIBDOGECOIN_API void dogecoin_block_header_pow_hash_batch(const dogecoin_block_header* headers, size_t n, uint256* hashes);
+//!true if the pow hash is at or below the target encoded in the header's own bits
+//!(merge mined blocks carry their proof of work in the auxpow parent header instead)
+LIBDOGECOIN_API dogecoin_bool dogecoin_block_header_check_pow(const dogecoin_block_header* header, const uint256 pow_hash);
+
+//!create a new empty block
+LIBDOGECOIN_API dogecoin_block* dogecoin_block_new();
+LIBDOGECOIN_API void dogecoin_block_free(dogecoin_block* block);
+
+//!parse a p2p serialized block (header, optional auxpow, transactions) into a block created with dogecoin_block_new
+//!content of a previously deserialized block is released first, so the block can be reused
+//!txs are parsed and hashed on up to num_threads threads (0 or 1 = calling thread only)
+//!returns false if the data is malformed, use dogecoin_block_check_merkle_root to verify the content
+LIBDOGECOIN_API dogecoin_bool dogecoin_block_deserialize(const unsigned char* block_serialized, size_t inlen, dogecoin_block* block, size_t* consumed_length, unsigned int num_threads);
+
+//!merkle root over a list of hashes, mutated (optional) is set if two identical siblings were hashed
+LIBDOGECOIN_API void dogecoin_block_merkle_root(const uint256* hashes, size_t num_hashes, uint256 root, dogecoin_bool* mutated);
+
+//!true if the computed merkle root matches the header and the tree is not mutated
+LIBDOGECOIN_API dogecoin_bool dogecoin_block_check_merkle_root(const dogecoin_block* block);
+
+LIBDOGECOIN_END_DECL
+
+#endif // __LIBDOGECOIN_BLOCK_H__
@@ -0,0 +1,79 @@
+/*
+
+ The MIT License (MIT)
+
+ Copyright (c) 2022 The Dogecoin Foundation
+
+ Permission is hereby granted, free of charge, to any person obtaining
+ a copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES
+ OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+#ifndef __LIBDOGECOIN_COINSELECT_H__
+#define __LIBDOGECOIN_COINSELECT_H__
+
+#include <dogecoin/cstr.h>
+#include <dogecoin/dogecoin.h>
+#include <dogecoin/script.h>
+#include <dogecoin/tx.h>
+
+LIBDOGECOIN_BEGIN_DECL
+
+// change below the recommended dust limit (0.01 DOGE) is added to the fee instead
+#define DOGECOIN_COINSELECT_MIN_CHANGE 1000000
+
+// upper bound of branch and bound search steps before falling back
+#define DOGECOIN_COINSELECT_BNB_TRIES 100000
+
+typedef struct dogecoin_utxo_ {
+    dogecoin_tx_outpoint outpoint;
+    int64_t value;
+    enum dogecoin_tx_out_type script_type;
+    uint32_t input_size;  // estimated size of the spending input, 0 = derive from script_type
+} dogecoin_utxo;
+
+enum dogecoin_coinselect_algo {
+    DOGECOIN_COINSELECT_BNB,
+    DOGECOIN_COINSELECT_KNAPSACK,
+    DOGECOIN_COINSELECT_SRD,
+};
+
+typedef struct dogecoin_coinselect_result_ {
+    size_t* selected;      // indices into the utxo array, ascending
+    size_t count;
+    int64_t value;         // sum of the selected utxo values
+    int64_t fee;           // fee for the selected inputs (and the change output if any)
+    int64_t change;        // 0 if no change output is needed
+    enum dogecoin_coinselect_algo algo;
+} dogecoin_coinselect_result;
+
+//!estimated size in bytes of an input spending an output of the given type
+LIBDOGECOIN_API uint32_t dogecoin_coinselect_input_size(enum dogecoin_tx_out_type type);
+
+//!classify the script (via dogecoin_script_classify) and return the estimated input size, bare multisig uses the required signature count
+LIBDOGECOIN_API uint32_t dogecoin_coinselect_script_input_size(const cstring* script_pubkey, enum dogecoin_tx_out_type* type_out);
+
+//!select utxos covering target (outputs plus their fee) at fee_per_kb koinu per 1000 bytes
+//!tries an exact branch and bound match first, then the cheaper of knapsack and single random draw
+//!returns NULL if the utxos can not pay for the target, free the result with dogecoin_coinselect_result_free
+LIBDOGECOIN_API dogecoin_coinselect_result* dogecoin_coinselect(const dogecoin_utxo* utxos, size_t num_utxos, int64_t target, uint64_t fee_per_kb);
+LIBDOGECOIN_API void dogecoin_coinselect_result_free(dogecoin_coinselect_result* result);
+
+LIBDOGECOIN_END_DECL
+
+#endif // __LIBDOGECOIN_COINSELECT_H__
@@ -0,0 +1,50 @@
+/*
+
+ The MIT License (MIT)
+
+ Copyright (c) 2022 The Dogecoin Foundation
+
+ Permission is hereby granted, free of charge, to any person obtaining
+ a copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES
+ OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+#ifndef __LIBDOGECOIN_CRYPTO_CPU_H__
+#define __LIBDOGECOIN_CRYPTO_CPU_H__
+
+#include <dogecoin/dogecoin.h>
+
+LIBDOGECOIN_BEGIN_DECL
+
+// x86 instruction set extensions the hash transforms can dispatch to,
+// only set if the cpu reports them and the os saves the registers they use
+typedef struct dogecoin_cpu_features_ {
+    dogecoin_bool sse2;
+    dogecoin_bool sse41;
+    dogecoin_bool avx2;
+    dogecoin_bool bmi2;
+    dogecoin_bool avx512f;
+    dogecoin_bool shani;
+} dogecoin_cpu_features;
+
+//!detected once on first use, all false on non x86 targets
+LIBDOGECOIN_API const dogecoin_cpu_features* dogecoin_cpu_get_features(void);
+
+LIBDOGECOIN_END_DECL
+
+#endif // __LIBDOGECOIN_CRYPTO_CPU_H__
@@ -34,17 +34,46 @@
 LIBDOGECOIN_BEGIN_DECL
 
 //!init static ecc context
-LIBDOGECOIN_API void dogecoin_ecc_start(void);
+LIBDOGECOIN_API dogecoin_bool dogecoin_ecc_start(void);
 
 //!destroys the static ecc context
 LIBDOGECOIN_API void dogecoin_ecc_stop(void);
 
+//!a secp256k1 context with its own blinding, the functions without a context argument use
+//!dogecoin_ecc_thread_ctx
+typedef struct dogecoin_ecc_ctx_ dogecoin_ecc_ctx;
+
+//!create a randomized context, NULL on failure
+LIBDOGECOIN_API dogecoin_ecc_ctx* dogecoin_ecc_ctx_new(void);
+LIBDOGECOIN_API void dogecoin_ecc_ctx_free(dogecoin_ecc_ctx* ctx);
+
+//!the calling thread's context: the static one on the thread that called dogecoin_ecc_start, a
+//!new one created on first use (and freed when the thread exits) on any other thread
+LIBDOGECOIN_API dogecoin_ecc_ctx* dogecoin_ecc_thread_ctx(void);
+
+//!contexts for threads spawned by the batch functions, created on first use and kept until dogecoin_ecc_stop
+//!worker i gets the same context on every call, workers past DOGECOIN_ECC_WORKER_CTXS share them
+#define DOGECOIN_ECC_WORKER_CTXS 64
+LIBDOGECOIN_API dogecoin_ecc_ctx* dogecoin_ecc_worker_ctx(unsigned int worker);
+
+//!make ctx the calling thread's context for the functions without a context argument, the previous one is
+//!freed unless it is the static or a worker context, ctx itself is freed on thread exit unless it is one of those
+LIBDOGECOIN_API void dogecoin_ecc_thread_ctx_set(dogecoin_ecc_ctx* ctx);
+
 //!get public key from given private key
 LIBDOGECOIN_API void dogecoin_ecc_get_pubkey(const uint8_t* private_key, uint8_t* public_key, size_t* public_key_len, dogecoin_bool compressed);
 
 //!ec mul tweak on given private key
 LIBDOGECOIN_API dogecoin_bool dogecoin_ecc_private_key_tweak_add(uint8_t* private_key, const uint8_t* tweak);
 
+//!add n to a private key in place, false (key unchanged) if the result would reach the group order
+LIBDOGECOIN_API dogecoin_bool dogecoin_ecc_private_key_add(uint8_t* private_key, uint64_t n);
+
+//!public keys of the consecutive private keys k, k + 1, ..., k + n - 1 stored back to back (33 or 65 bytes each),
+//!one scalar multiplication and then point additions normalized in batches with a single inversion
+//!false if k is invalid or k + n - 1 reaches the group order
+LIBDOGECOIN_API dogecoin_bool dogecoin_ecc_get_pubkey_sequence(const uint8_t* private_key, size_t n, uint8_t* public_keys, dogecoin_bool compressed);
+
 //!ec mul tweak on given public key
 LIBDOGECOIN_API dogecoin_bool dogecoin_ecc_public_key_tweak_add(uint8_t* public_key_inout, const uint8_t* tweak);
 
@@ -56,15 +85,20 @@ LIBDOGECOIN_API dogecoin_bool dogecoin_ecc_verify_pubkey(const uint8_t* public_k
 
 //!create a DER signature (72-74 bytes) with private key
 LIBDOGECOIN_API dogecoin_bool dogecoin_ecc_sign(const uint8_t* private_key, const uint256 hash, unsigned char* sigder, size_t* outlen);
+LIBDOGECOIN_API dogecoin_bool dogecoin_ecc_sign_ctx(const dogecoin_ecc_ctx* ctx, const uint8_t* private_key, const uint256 hash, unsigned char* sigder, size_t* outlen);
 
 //!create a compact (64bytes) signature with private key
 LIBDOGECOIN_API dogecoin_bool dogecoin_ecc_sign_compact(const uint8_t* private_key, const uint256 hash, unsigned char* sigcomp, size_t* outlen);
+LIBDOGECOIN_API dogecoin_bool dogecoin_ecc_sign_compact_ctx(const dogecoin_ecc_ctx* ctx, const uint8_t* private_key, const uint256 hash, unsigned char* sigcomp, size_t* outlen);
 
 //!create a compact recoverable (65bytes) signature with private key
 LIBDOGECOIN_API dogecoin_bool dogecoin_ecc_sign_compact_recoverable(const uint8_t* private_key, const uint256 hash, unsigned char* sigcomprec, size_t* outlen, int* recid);
+LIBDOGECOIN_API dogecoin_bool dogecoin_ecc_sign_compact_recoverable_ctx(const dogecoin_ecc_ctx* ctx, const uint8_t* private_key, const uint256 hash, unsigned char* sigcomprec, size_t* outlen, int* recid);
 
 //!recover a pubkey from a signature and recid
 LIBDOGECOIN_API dogecoin_bool dogecoin_ecc_recover_pubkey(const unsigned char* sigrec, const uint256 hash, const int recid, uint8_t* public_key, size_t *outlen);
+//!same on an explicit context, serialized compressed (33 bytes) or uncompressed (65 bytes)
+LIBDOGECOIN_API dogecoin_bool dogecoin_ecc_recover_pubkey_ctx(const dogecoin_ecc_ctx* ctx, const unsigned char* sigrec, const uint256 hash, const int recid, uint8_t* public_key, size_t *outlen, dogecoin_bool compressed);
 
 //!converts (and normalized) a compact signature to DER
 LIBDOGECOIN_API dogecoin_bool dogecoin_ecc_compact_to_der_normalized(unsigned char* sigcomp_in, unsigned char* sigder_out, size_t* sigder_len_out);
@@ -72,8 +106,45 @@ LIBDOGECOIN_API dogecoin_bool dogecoin_ecc_compact_to_der_normalized(unsigned ch
 //!convert DER signature to compact
 LIBDOGECOIN_API dogecoin_bool dogecoin_ecc_der_to_compact(unsigned char* sigder_in, size_t sigder_len, unsigned char* sigcomp_out);
 
-//!verify DER signature with public key
+//!verify DER signature with public key, the parsed public key is kept in the pubkey cache
 LIBDOGECOIN_API dogecoin_bool dogecoin_ecc_verify_sig(const uint8_t* public_key, dogecoin_bool compressed, const uint256 hash, unsigned char* sigder, size_t siglen);
+LIBDOGECOIN_API dogecoin_bool dogecoin_ecc_verify_sig_ctx(const dogecoin_ecc_ctx* ctx, const uint8_t* public_key, dogecoin_bool compressed, const uint256 hash, unsigned char* sigder, size_t siglen);
+
+//!32 byte x-only (bip340) public key of a private key
+LIBDOGECOIN_API dogecoin_bool dogecoin_ecc_get_xonly_pubkey(const uint8_t* private_key, uint8_t* xonly_pubkey);
+
+//!create a 64 byte bip340 schnorr signature of a 32 byte hash, aux_rand32 NULL draws fresh randomness
+LIBDOGECOIN_API dogecoin_bool dogecoin_ecc_schnorr_sign(const uint8_t* private_key, const uint256 hash, unsigned char* sig64, const uint8_t* aux_rand32);
+LIBDOGECOIN_API dogecoin_bool dogecoin_ecc_schnorr_sign_ctx(const dogecoin_ecc_ctx* ctx, const uint8_t* private_key, const uint256 hash, unsigned char* sig64, const uint8_t* aux_rand32);
+
+//!verify a bip340 schnorr signature of a 32 byte hash with a 32 byte x-only public key
+LIBDOGECOIN_API dogecoin_bool dogecoin_ecc_schnorr_verify(const uint8_t* xonly_pubkey, const uint256 hash, const unsigned char* sig64);
+LIBDOGECOIN_API dogecoin_bool dogecoin_ecc_schnorr_verify_ctx(const dogecoin_ecc_ctx* ctx, const uint8_t* xonly_pubkey, const uint256 hash, const unsigned char* sig64);
+
+//!one (hash, x-only pubkey, signature) triple for dogecoin_ecc_schnorr_verify_batch, which sets valid
+typedef struct dogecoin_schnorr_check_ {
+    const uint8_t* hash;          // 32 bytes
+    const uint8_t* xonly_pubkey;  // 32 bytes
+    const unsigned char* sig;     // 64 bytes
+    dogecoin_bool valid;
+} dogecoin_schnorr_check;
+
+//!verify all checks on up to num_threads threads (the calling thread included, 0 or 1 = calling thread only),
+//!true if every signature is valid
+LIBDOGECOIN_API dogecoin_bool dogecoin_ecc_schnorr_verify_batch(dogecoin_schnorr_check* checks, size_t num_checks, unsigned int num_threads);
+
+//!entries of the parsed pubkey cache created by dogecoin_ecc_start
+#define DOGECOIN_ECC_PUBKEY_CACHE_DEFAULT_ENTRIES 4096
+
+//!resize (and empty) the parsed pubkey cache, rounded down to a power of two, 0 disables it
+//!not safe to call while other threads verify signatures
+LIBDOGECOIN_API dogecoin_bool dogecoin_ecc_pubkey_cache_resize(size_t max_entries);
+
+//!number of entries the parsed pubkey cache can hold
+LIBDOGECOIN_API size_t dogecoin_ecc_pubkey_cache_size(void);
+
+//!lookups that found a parsed pubkey and lookups that had to parse it since the last resize
+LIBDOGECOIN_API void dogecoin_ecc_pubkey_cache_stats(uint64_t* hits, uint64_t* misses);
 
 LIBDOGECOIN_END_DECL
 
@@ -32,6 +32,7 @@
 #include <dogecoin/cstr.h>
 #include <dogecoin/dogecoin.h>
 #include <dogecoin/mem.h>
+#include <dogecoin/crypto/rmd160.h>
 #include <dogecoin/crypto/sha2.h>
 #include <dogecoin/vector.h>
 
@@ -55,13 +56,41 @@ LIBDOGECOIN_API static inline void dogecoin_hash_set(uint256 hash_dest, const ui
 
 LIBDOGECOIN_API static inline void dogecoin_hash(const unsigned char* datain, size_t length, uint256 hashout) {
     sha256_raw(datain, length, hashout);
-    sha256_raw(hashout, SHA256_DIGEST_LENGTH, hashout); // dogecoin double sha256 hash
+    sha256_raw_32(hashout, hashout); // dogecoin double sha256 hash
+}
+
+// double sha256 of exactly 32 / 64 bytes (merkle nodes, hashes of hashes)
+LIBDOGECOIN_API static inline void dogecoin_hash_32(const unsigned char* datain, uint256 hashout) {
+    sha256d_32(datain, hashout);
+}
+
+LIBDOGECOIN_API static inline void dogecoin_hash_64(const unsigned char* datain, uint256 hashout) {
+    sha256d_64(datain, hashout);
+}
+
+// n consecutive inputs to n consecutive hashes on the sha256 batch lanes
+LIBDOGECOIN_API static inline void dogecoin_hash_32_batch(const unsigned char* datain, size_t n, uint256* hashout) {
+    sha256d_32_batch((uint8_t*)hashout, datain, n);
+}
+
+LIBDOGECOIN_API static inline void dogecoin_hash_64_batch(const unsigned char* datain, size_t n, uint256* hashout) {
+    sha256d_64_batch((uint8_t*)hashout, datain, n);
 }
 
 LIBDOGECOIN_API static inline void dogecoin_hash_sngl_sha256(const unsigned char* datain, size_t length, uint256 hashout) {
     sha256_raw(datain, length, hashout); // single sha256 hash
 }
 
+// ripemd160(sha256(data)), the hash behind p2pkh and p2sh addresses
+LIBDOGECOIN_API static inline void dogecoin_hash160(const unsigned char* datain, size_t length, uint160 hashout) {
+    uint256 sha;
+    sha256_raw(datain, length, sha);
+    rmd160_32(sha, hashout);
+}
+
+//!hash160 of n independent messages, sha256 and ripemd160 both run on their batch lanes
+LIBDOGECOIN_API void dogecoin_hash160_batch(const unsigned char* const datain[], const size_t lens[], size_t n, uint160* hashout);
+
 LIBDOGECOIN_END_DECL
 
 #endif // __LIBDOGECOIN_CRYPTO_HASH_H__
@@ -64,6 +64,8 @@ LIBDOGECOIN_API void dogecoin_pubkey_from_key(const dogecoin_key* privkey, dogec
 
 //get the hash160 (single SHA256 + RIPEMD160)
 LIBDOGECOIN_API void dogecoin_pubkey_get_hash160(const dogecoin_pubkey* pubkey, uint160 hash160);
+//get the hash160 of n pubkeys at once on the sha256/ripemd160 batch lanes
+LIBDOGECOIN_API void dogecoin_pubkey_get_hash160_batch(const dogecoin_pubkey* pubkeys, size_t n, uint160* hash160s);
 
 //get the hex representation of a pubkey, strsize must be at leat 66 bytes
 LIBDOGECOIN_API dogecoin_bool dogecoin_pubkey_get_hex(const dogecoin_pubkey* pubkey, char* str, size_t* strsize);
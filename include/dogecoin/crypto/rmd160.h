@@ -30,7 +30,29 @@
 
 LIBDOGECOIN_BEGIN_DECL
 
-LIBDOGECOIN_API void rmd160(const uint8_t* msg, uint32_t msg_len, uint8_t* hash);
+#define RMD160_BLOCK_LENGTH 64
+#define RMD160_DIGEST_LENGTH 20
+
+typedef struct rmd160_context_ {
+    uint32_t state[5];
+    uint64_t bytes;
+    uint8_t buffer[RMD160_BLOCK_LENGTH];
+} rmd160_context;
+
+//!streaming ripemd160, rmd160_finalize may write the digest over the last input
+LIBDOGECOIN_API void rmd160_init(rmd160_context* ctx);
+LIBDOGECOIN_API void rmd160_write(rmd160_context* ctx, const uint8_t* data, size_t len);
+LIBDOGECOIN_API void rmd160_finalize(uint8_t hash[RMD160_DIGEST_LENGTH], rmd160_context* ctx);
+
+//!one-shot ripemd160, hash may overlap msg
+LIBDOGECOIN_API void rmd160(const uint8_t* msg, size_t msg_len, uint8_t* hash);
+
+//!ripemd160 of exactly 32 bytes (a sha256 digest) in a single block with precomputed padding
+LIBDOGECOIN_API void rmd160_32(const uint8_t* in, uint8_t hash[RMD160_DIGEST_LENGTH]);
+//!ripemd160 of n consecutive 32 byte inputs into n consecutive 20 byte digests on the batch lanes
+LIBDOGECOIN_API void rmd160_32_batch(uint8_t* out, const uint8_t* in, size_t n);
+//!force the lanes used by rmd160_32_batch (1, 4, 8 or 16), false if not compiled in or not supported by this cpu
+LIBDOGECOIN_API dogecoin_bool rmd160_set_batch_lanes(unsigned int lanes);
 
 LIBDOGECOIN_END_DECL
 
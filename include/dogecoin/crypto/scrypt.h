@@ -0,0 +1,58 @@
+/*
+
+ The MIT License (MIT)
+
+ Copyright (c) 2022 The Dogecoin Foundation
+
+ Permission is hereby granted, free of charge, to any person obtaining
+ a copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES
+ OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+#ifndef __LIBDOGECOIN_CRYPTO_SCRYPT_H__
+#define __LIBDOGECOIN_CRYPTO_SCRYPT_H__
+
+#include <dogecoin/dogecoin.h>
+
+LIBDOGECOIN_BEGIN_DECL
+
+// scrypt with N = 1024, r = 1, p = 1 and a 32 byte output, password and salt are both the
+// serialized 80 byte block header
+#define SCRYPT_POW_INPUT_LENGTH 80
+#define SCRYPT_POW_OUTPUT_LENGTH 32
+
+enum scrypt_implementation {
+    SCRYPT_IMPL_STANDARD,
+    SCRYPT_IMPL_SSE2,
+};
+
+//!select the fastest salsa20/8 core and batch lanes the cpu supports (also done on first use), returns its name
+LIBDOGECOIN_API const char* scrypt_autodetect(void);
+//!force a single stream core, false if it is not compiled in or not supported by this cpu
+LIBDOGECOIN_API dogecoin_bool scrypt_set_implementation(enum scrypt_implementation impl);
+//!force the lanes used by scrypt_1024_1_1_256_batch (1, 4, 8 or 16), false if not compiled in or not supported by this cpu
+LIBDOGECOIN_API dogecoin_bool scrypt_set_batch_lanes(unsigned int lanes);
+
+//!proof of work hash of one serialized header, uses 128kb of stack
+LIBDOGECOIN_API void scrypt_1024_1_1_256(const uint8_t* input, uint8_t output[SCRYPT_POW_OUTPUT_LENGTH]);
+//!n consecutive 80 byte headers into n consecutive 32 byte hashes, interleaved on the batch lanes
+LIBDOGECOIN_API void scrypt_1024_1_1_256_batch(uint8_t* out, const uint8_t* in, size_t n);
+
+LIBDOGECOIN_END_DECL
+
+#endif // __LIBDOGECOIN_CRYPTO_SCRYPT_H__
@@ -58,19 +58,87 @@ typedef struct _sha512_context {
     uint8_t buffer[SHA512_BLOCK_LENGTH];
 } sha512_context;
 
+/* sha contexts that already absorbed the key xor ipad / opad block */
+typedef struct _hmac_sha256_ctx {
+    sha256_context inner;
+    sha256_context outer;
+} hmac_sha256_ctx;
+typedef struct _hmac_sha512_ctx {
+    sha512_context inner;
+    sha512_context outer;
+} hmac_sha512_ctx;
+
+enum sha256_implementation {
+    SHA256_IMPL_STANDARD,
+    SHA256_IMPL_SSE41,
+    SHA256_IMPL_AVX2,
+    SHA256_IMPL_SHANI,
+};
+
+//!select the fastest sha256 transform the cpu supports (also done on first use), returns its name
+LIBDOGECOIN_API const char* sha256_autodetect(void);
+//!force a sha256 transform, false if it is not compiled in or not supported by this cpu
+LIBDOGECOIN_API dogecoin_bool sha256_set_implementation(enum sha256_implementation impl);
+
 LIBDOGECOIN_API void sha256_init(sha256_context*);
 LIBDOGECOIN_API void sha256_write(sha256_context*, const uint8_t*, size_t);
 LIBDOGECOIN_API void sha256_finalize(uint8_t[SHA256_DIGEST_LENGTH], sha256_context*);
 LIBDOGECOIN_API void sha256_raw(const uint8_t*, size_t, uint8_t[SHA256_DIGEST_LENGTH]);
 
+//!hash n independent messages (outs[i] = sha256(inputs[i], lens[i])) on the widest multi lane transform available
+LIBDOGECOIN_API void sha256_raw_batch(const uint8_t* const inputs[], const size_t lens[], uint8_t* const outs[], size_t n);
+//!force the lanes used by sha256_raw_batch (1, 4, 8 or 16), false if not compiled in or not supported by this cpu
+LIBDOGECOIN_API dogecoin_bool sha256_set_batch_lanes(unsigned int lanes);
+
+//!sha256 of exactly 32 bytes, double sha256 of exactly 32 or 64 bytes, using precomputed padding blocks
+LIBDOGECOIN_API void sha256_raw_32(const uint8_t* in, uint8_t digest[SHA256_DIGEST_LENGTH]);
+LIBDOGECOIN_API void sha256d_32(const uint8_t* in, uint8_t digest[SHA256_DIGEST_LENGTH]);
+LIBDOGECOIN_API void sha256d_64(const uint8_t* in, uint8_t digest[SHA256_DIGEST_LENGTH]);
+//!double sha256 of n consecutive 32 or 64 byte inputs into n consecutive digests on the batch lanes, out may overlap in at or before it
+LIBDOGECOIN_API void sha256d_32_batch(uint8_t* out, const uint8_t* in, size_t n);
+LIBDOGECOIN_API void sha256d_64_batch(uint8_t* out, const uint8_t* in, size_t n);
+
+enum sha512_implementation {
+    SHA512_IMPL_STANDARD,
+    SHA512_IMPL_AVX2,
+};
+
+//!select the fastest sha512 transform and batch lanes the cpu supports (also done on first use), returns its name
+LIBDOGECOIN_API const char* sha512_autodetect(void);
+//!force a sha512 transform, false if it is not compiled in or not supported by this cpu
+LIBDOGECOIN_API dogecoin_bool sha512_set_implementation(enum sha512_implementation impl);
+
 LIBDOGECOIN_API void sha512_init(sha512_context*);
 LIBDOGECOIN_API void sha512_write(sha512_context*, const uint8_t*, size_t);
 LIBDOGECOIN_API void sha512_finalize(uint8_t[SHA512_DIGEST_LENGTH], sha512_context*);
 LIBDOGECOIN_API void sha512_raw(const uint8_t*, size_t, uint8_t[SHA512_DIGEST_LENGTH]);
 
+//!hash n independent messages (outs[i] = sha512(inputs[i], lens[i])) on the widest multi lane transform available
+LIBDOGECOIN_API void sha512_raw_batch(const uint8_t* const inputs[], const size_t lens[], uint8_t* const outs[], size_t n);
+//!force the lanes used by sha512_raw_batch (1, 4 or 8), false if not compiled in or not supported by this cpu
+LIBDOGECOIN_API dogecoin_bool sha512_set_batch_lanes(unsigned int lanes);
+
 LIBDOGECOIN_API void hmac_sha256(const uint8_t* key, const uint32_t keylen, const uint8_t* msg, const uint32_t msglen, uint8_t* hmac);
 LIBDOGECOIN_API void hmac_sha512(const uint8_t* key, const uint32_t keylen, const uint8_t* msg, const uint32_t msglen, uint8_t* hmac);
 
+//!hash the padded key blocks once, then reuse the midstates for every message under that key
+LIBDOGECOIN_API void hmac_sha256_prepare(hmac_sha256_ctx* ctx, const uint8_t* key, size_t keylen);
+LIBDOGECOIN_API void hmac_sha256_compute(const hmac_sha256_ctx* ctx, const uint8_t* msg, size_t msglen, uint8_t hmac[SHA256_DIGEST_LENGTH]);
+LIBDOGECOIN_API void hmac_sha512_prepare(hmac_sha512_ctx* ctx, const uint8_t* key, size_t keylen);
+LIBDOGECOIN_API void hmac_sha512_compute(const hmac_sha512_ctx* ctx, const uint8_t* msg, size_t msglen, uint8_t hmac[SHA512_DIGEST_LENGTH]);
+//!wipe the keyed midstates
+LIBDOGECOIN_API void hmac_sha256_ctx_cleanse(hmac_sha256_ctx* ctx);
+LIBDOGECOIN_API void hmac_sha512_ctx_cleanse(hmac_sha512_ctx* ctx);
+
+//!PBKDF2 (RFC 8018) with hmac-sha256 into keylen bytes, the _ctx variant reuses an already keyed hmac context
+LIBDOGECOIN_API void pbkdf2_hmac_sha256(const uint8_t* pass, size_t passlen, const uint8_t* salt, size_t saltlen, uint32_t iterations, uint8_t* key, size_t keylen);
+LIBDOGECOIN_API void pbkdf2_hmac_sha256_ctx(const hmac_sha256_ctx* ctx, const uint8_t* salt, size_t saltlen, uint32_t iterations, uint8_t* key, size_t keylen);
+//!PBKDF2 with hmac-sha512, iterations compress one padded block per pad directly on the keyed midstates
+LIBDOGECOIN_API void pbkdf2_hmac_sha512(const uint8_t* pass, size_t passlen, const uint8_t* salt, size_t saltlen, uint32_t iterations, uint8_t* key, size_t keylen);
+LIBDOGECOIN_API void pbkdf2_hmac_sha512_ctx(const hmac_sha512_ctx* ctx, const uint8_t* salt, size_t saltlen, uint32_t iterations, uint8_t* key, size_t keylen);
+//!n independent 64 byte pbkdf2-hmac-sha512 keys, the iterations of several keys run together on the sha512 batch lanes
+LIBDOGECOIN_API void pbkdf2_hmac_sha512_batch(const uint8_t* const passes[], const size_t passlens[], const uint8_t* const salts[], const size_t saltlens[], uint32_t iterations, uint8_t* const keys[], size_t n);
+
 LIBDOGECOIN_END_DECL
 
 #endif /* __LIBDOGECOIN_CRYPTO_SHA2_H__ */
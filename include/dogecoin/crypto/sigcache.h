@@ -0,0 +1,59 @@
+/*
+
+ The MIT License (MIT)
+
+ Copyright (c) 2022 The Dogecoin Foundation
+
+ Permission is hereby granted, free of charge, to any person obtaining
+ a copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES
+ OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+#ifndef __LIBDOGECOIN_CRYPTO_SIGCACHE_H__
+#define __LIBDOGECOIN_CRYPTO_SIGCACHE_H__
+
+#include <dogecoin/dogecoin.h>
+
+LIBDOGECOIN_BEGIN_DECL
+
+#define DOGECOIN_SIGCACHE_DEFAULT_BYTES (32 * 1024 * 1024)
+
+// set of (sighash, pubkey, signature) triples that verified, a cuckoo hash table where
+// every key has eight possible slots; lookups take no lock, inserts and erases are serialized
+typedef struct dogecoin_sigcache_ dogecoin_sigcache;
+
+//!create a signature cache using at most max_bytes for its slots, salted with fresh randomness
+LIBDOGECOIN_API dogecoin_sigcache* dogecoin_sigcache_new(size_t max_bytes);
+LIBDOGECOIN_API void dogecoin_sigcache_free(dogecoin_sigcache* cache);
+
+//!number of slots, the largest power of two that fits into max_bytes
+LIBDOGECOIN_API size_t dogecoin_sigcache_size(const dogecoin_sigcache* cache);
+
+//!true if the triple was inserted before, erase removes it (once a block spends it, it will not be seen again)
+LIBDOGECOIN_API dogecoin_bool dogecoin_sigcache_contains(dogecoin_sigcache* cache, const uint256 sighash, const uint8_t* pubkey, size_t pubkeylen, const unsigned char* sig, size_t siglen, dogecoin_bool erase);
+
+//!remember a triple that verified, if all slots of the key are taken another entry may be dropped
+LIBDOGECOIN_API void dogecoin_sigcache_insert(dogecoin_sigcache* cache, const uint256 sighash, const uint8_t* pubkey, size_t pubkeylen, const unsigned char* sig, size_t siglen);
+
+//!dogecoin_ecc_verify_sig through the cache, store = true (mempool) inserts valid signatures,
+//!store = false (block) erases the ones it finds
+LIBDOGECOIN_API dogecoin_bool dogecoin_sigcache_verify_sig(dogecoin_sigcache* cache, const uint8_t* public_key, dogecoin_bool compressed, const uint256 hash, unsigned char* sigder, size_t siglen, dogecoin_bool store);
+
+LIBDOGECOIN_END_DECL
+
+#endif // __LIBDOGECOIN_CRYPTO_SIGCACHE_H__
@@ -52,6 +52,19 @@ LIBDOGECOIN_API void dogecoin_free(void* ptr);
 
 LIBDOGECOIN_API volatile void *dogecoin_mem_zero(volatile void *dst, size_t len);
 
+// bump pointer arena on top of a caller supplied buffer
+// allocations are never freed individually, dogecoin_arena_reset releases all of them at once
+typedef struct dogecoin_arena_ {
+    uint8_t* base;
+    size_t size;
+    size_t used;
+} dogecoin_arena;
+
+LIBDOGECOIN_API void dogecoin_arena_init(dogecoin_arena* arena, void* buf, size_t size);
+// returns NULL if the arena is exhausted (does not call the memory mapper)
+LIBDOGECOIN_API void* dogecoin_arena_alloc(dogecoin_arena* arena, size_t size);
+LIBDOGECOIN_API void dogecoin_arena_reset(dogecoin_arena* arena);
+
 LIBDOGECOIN_END_DECL
 
 #endif // __LIBDOGECOIN_MEM_H__
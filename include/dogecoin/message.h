@@ -0,0 +1,81 @@
+/*
+
+ The MIT License (MIT)
+
+ Copyright (c) 2022 The Dogecoin Foundation
+
+ Permission is hereby granted, free of charge, to any person obtaining
+ a copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES
+ OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+#ifndef __LIBDOGECOIN_MESSAGE_H__
+#define __LIBDOGECOIN_MESSAGE_H__
+
+#include <dogecoin/chainparams.h>
+#include <dogecoin/crypto/key.h>
+#include <dogecoin/dogecoin.h>
+
+LIBDOGECOIN_BEGIN_DECL
+
+#define DOGECOIN_MESSAGE_MAGIC "Dogecoin Signed Message:\n"
+
+// header byte 27 + recid (+ 4 for a compressed key), then the 64 byte compact signature
+#define DOGECOIN_MESSAGE_SIG_LENGTH 65
+// base64 of the signature and the terminating NUL
+#define DOGECOIN_MESSAGE_SIG_BASE64_LENGTH 89
+
+#define DOGECOIN_MESSAGE_CACHE_DEFAULT_ENTRIES 65536
+
+// recovered pubkeys keyed by (message hash, signature), a set associative table with striped locks
+typedef struct dogecoin_message_cache_ dogecoin_message_cache;
+
+typedef struct dogecoin_message_check_ {
+    const char* address;    // p2pkh address expected to have signed
+    const char* signature;  // base64
+    const char* message;
+    dogecoin_bool valid;    // result
+} dogecoin_message_check;
+
+//!double sha256 of the magic and the message, both prefixed with their varint length
+LIBDOGECOIN_API void dogecoin_message_hash(const char* message, size_t len, uint256 hash);
+
+//!sign a message, sig_base64 needs DOGECOIN_MESSAGE_SIG_BASE64_LENGTH bytes
+//!compressed selects the key form (and so the address) the signature commits to
+LIBDOGECOIN_API dogecoin_bool dogecoin_message_sign(const dogecoin_key* key, dogecoin_bool compressed, const char* message, char* sig_base64);
+
+//!recover the public key that signed message, through the cache if not NULL
+LIBDOGECOIN_API dogecoin_bool dogecoin_message_recover_pubkey(dogecoin_message_cache* cache, const char* sig_base64, const char* message, dogecoin_pubkey* pubkey);
+
+//!true if sig_base64 is a signature of message by the key of the p2pkh address
+LIBDOGECOIN_API dogecoin_bool dogecoin_message_verify(dogecoin_message_cache* cache, const char* address, const char* sig_base64, const char* message, const dogecoin_chainparams* chain);
+
+//!verify all checks on up to num_threads threads (the calling thread included, 0 or 1 = calling thread only),
+//!sets valid on every check and returns the number of valid ones
+LIBDOGECOIN_API size_t dogecoin_message_verify_batch(dogecoin_message_cache* cache, dogecoin_message_check* checks, size_t num_checks, const dogecoin_chainparams* chain, unsigned int num_threads);
+
+//!create a recovered pubkey cache with at most max_entries entries (rounded down to a power of two)
+LIBDOGECOIN_API dogecoin_message_cache* dogecoin_message_cache_new(size_t max_entries);
+LIBDOGECOIN_API void dogecoin_message_cache_free(dogecoin_message_cache* cache);
+
+//!lookups that found a recovered pubkey and lookups that had to recover it
+LIBDOGECOIN_API void dogecoin_message_cache_stats(dogecoin_message_cache* cache, uint64_t* hits, uint64_t* misses);
+
+LIBDOGECOIN_END_DECL
+
+#endif // __LIBDOGECOIN_MESSAGE_H__
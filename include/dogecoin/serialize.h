@@ -44,6 +44,7 @@ LIBDOGECOIN_API void ser_u32(cstring* s, uint32_t v_);
 LIBDOGECOIN_API void ser_u64(cstring* s, uint64_t v_);
 LIBDOGECOIN_API void ser_u256(cstring* s, const unsigned char* v_);
 LIBDOGECOIN_API void ser_varlen(cstring* s, uint32_t vlen);
+LIBDOGECOIN_API size_t ser_varlen_size(uint32_t vlen);
 LIBDOGECOIN_API void ser_str(cstring* s, const char* s_in, size_t maxlen);
 LIBDOGECOIN_API void ser_varstr(cstring* s, cstring* s_in);
 
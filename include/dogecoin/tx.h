@@ -67,6 +67,11 @@ typedef struct dogecoin_tx_ {
     vector* vin;
     vector* vout;
     uint32_t locktime;
+    // txid/wtxid cache, reset by the mutating helpers or dogecoin_tx_invalidate_hash
+    uint256 txid;
+    uint256 wtxid;
+    dogecoin_bool txid_valid;
+    dogecoin_bool wtxid_valid;
 } dogecoin_tx;
 
 //!create a new tx input
@@ -90,10 +95,95 @@ LIBDOGECOIN_API int dogecoin_tx_deserialize(const unsigned char* tx_serialized,
 //!serialize a lbc dogecoin data structure into a p2p serialized buffer
 LIBDOGECOIN_API void dogecoin_tx_serialize(cstring* s, const dogecoin_tx* tx, dogecoin_bool allow_witness);
 
+//!exact length of the p2p serialization, computed without allocating
+LIBDOGECOIN_API size_t dogecoin_tx_serialized_size(const dogecoin_tx* tx, dogecoin_bool allow_witness);
+
+//!serialize into caller memory, returns the number of bytes written or 0 if cap is too small (nothing is written then)
+LIBDOGECOIN_API size_t dogecoin_tx_serialize_to(uint8_t* buf, size_t cap, const dogecoin_tx* tx, dogecoin_bool allow_witness);
+
+/* read-only view over a p2p serialized transaction
+ * the view never allocates, all pointers handed out by the accessors point
+ * into the buffer passed to dogecoin_tx_view_parse which must outlive the view */
+typedef struct dogecoin_tx_view_ {
+    const uint8_t* data;
+    size_t len;            // total length of the serialized tx (incl. witness data)
+    int32_t version;
+    uint32_t locktime;
+    dogecoin_bool has_witness;
+    uint32_t vin_count;
+    uint32_t vout_count;
+    size_t vin_offset;     // offset of the first input
+    size_t vout_offset;    // offset of the first output
+    size_t witness_offset; // offset of the first witness stack (0 if no witness)
+} dogecoin_tx_view;
+
+typedef struct dogecoin_tx_view_in_ {
+    const uint8_t* prevout_hash; // 32 bytes
+    uint32_t prevout_n;
+    const uint8_t* script_sig;
+    size_t script_sig_len;
+    uint32_t sequence;
+    size_t index;
+    size_t next_offset;    // internal, used by dogecoin_tx_view_next_in
+} dogecoin_tx_view_in;
+
+typedef struct dogecoin_tx_view_out_ {
+    int64_t value;
+    const uint8_t* script_pubkey;
+    size_t script_pubkey_len;
+    size_t index;
+    size_t next_offset;    // internal, used by dogecoin_tx_view_next_out
+} dogecoin_tx_view_out;
+
+//!validate the layout of a p2p serialized transaction and fill the view, no heap allocation
+LIBDOGECOIN_API dogecoin_bool dogecoin_tx_view_parse(dogecoin_tx_view* view, const unsigned char* tx_serialized, size_t inlen, size_t* consumed_length, dogecoin_bool allow_witness);
+
+//!random access to input/output n (walks the serialization, O(n))
+LIBDOGECOIN_API dogecoin_bool dogecoin_tx_view_get_in(const dogecoin_tx_view* view, size_t n, dogecoin_tx_view_in* in);
+LIBDOGECOIN_API dogecoin_bool dogecoin_tx_view_get_out(const dogecoin_tx_view* view, size_t n, dogecoin_tx_view_out* out);
+
+//!sequential access, advances the given input/output to the next one, returns false at the end
+LIBDOGECOIN_API dogecoin_bool dogecoin_tx_view_next_in(const dogecoin_tx_view* view, dogecoin_tx_view_in* in);
+LIBDOGECOIN_API dogecoin_bool dogecoin_tx_view_next_out(const dogecoin_tx_view* view, dogecoin_tx_view_out* out);
+
+//!witness stack access for input n
+LIBDOGECOIN_API size_t dogecoin_tx_view_witness_count(const dogecoin_tx_view* view, size_t n);
+LIBDOGECOIN_API dogecoin_bool dogecoin_tx_view_get_witness_item(const dogecoin_tx_view* view, size_t n, size_t item, const uint8_t** data_out, size_t* len_out);
+
+//!deserialize a p2p serialized transaction with the whole object graph (tx, inputs, outputs, scripts, witness items) placed in the given arena
+//!returns NULL if the tx is invalid or the arena is exhausted (the arena is left untouched in that case)
+//!the returned tx is read only, it must not be passed to dogecoin_tx_free or grown, reset the arena instead
+//!use dogecoin_tx_copy to get a mutable heap copy
+LIBDOGECOIN_API dogecoin_tx* dogecoin_tx_deserialize_arena(const unsigned char* tx_serialized, size_t inlen, dogecoin_arena* arena, size_t* consumed_length, dogecoin_bool allow_witness);
+
+//!txid (hash of the non witness serialization), cached on the tx after the first call
 LIBDOGECOIN_API void dogecoin_tx_hash(const dogecoin_tx* tx, uint8_t* hashout);
+//!wtxid (hash of the witness serialization, equals the txid without witness data), cached as well
+LIBDOGECOIN_API void dogecoin_tx_wtxid(const dogecoin_tx* tx, uint8_t* hashout);
+//!drop the cached txid/wtxid, required after changing the tx fields directly
+LIBDOGECOIN_API void dogecoin_tx_invalidate_hash(dogecoin_tx* tx);
 
 LIBDOGECOIN_API dogecoin_bool dogecoin_tx_sighash(const dogecoin_tx* tx_to, const cstring* fromPubKey, unsigned int in_num, int hashtype, const uint64_t amount, const enum dogecoin_sig_version sigversion, uint8_t* hash);
 
+/* per transaction sighash state, built once and shared by all inputs
+ * holds the BIP143 hashPrevouts/hashSequence/hashOutputs and the legacy
+ * serialization pieces, the tx must not be modified while the context is in use */
+typedef struct dogecoin_sighash_ctx_ {
+    const dogecoin_tx* tx;
+    uint256 hash_prevouts;
+    uint256 hash_sequence;
+    uint256 hash_outputs;
+    cstring* legacy_inputs;  // all inputs serialized with an empty script_sig (NULL: serialize from tx)
+    cstring* legacy_outputs; // varlen output count followed by all outputs (NULL: serialize from tx)
+} dogecoin_sighash_ctx;
+
+//!precompute the transaction wide sighash pieces, free with dogecoin_sighash_ctx_free
+LIBDOGECOIN_API dogecoin_sighash_ctx* dogecoin_sighash_ctx_new(const dogecoin_tx* tx);
+LIBDOGECOIN_API void dogecoin_sighash_ctx_free(dogecoin_sighash_ctx* ctx);
+
+//!same as dogecoin_tx_sighash but only does the input specific work, the context is read only and can be shared between threads
+LIBDOGECOIN_API dogecoin_bool dogecoin_tx_sighash_with_ctx(const dogecoin_sighash_ctx* ctx, const cstring* fromPubKey, unsigned int in_num, int hashtype, const uint64_t amount, const enum dogecoin_sig_version sigversion, uint8_t* hash);
+
 LIBDOGECOIN_API dogecoin_bool dogecoin_tx_add_address_out(dogecoin_tx* tx, const dogecoin_chainparams* chain, int64_t amount, const char* address);
 LIBDOGECOIN_API dogecoin_bool dogecoin_tx_add_p2sh_hash160_out(dogecoin_tx* tx, int64_t amount, uint160 hash160);
 LIBDOGECOIN_API dogecoin_bool dogecoin_tx_add_p2pkh_hash160_out(dogecoin_tx* tx, int64_t amount, uint160 hash160);
@@ -120,6 +210,19 @@ enum dogecoin_tx_sign_result {
 const char* dogecoin_tx_sign_result_to_str(const enum dogecoin_tx_sign_result result);
 enum dogecoin_tx_sign_result dogecoin_tx_sign_input(dogecoin_tx *tx_in_out, const cstring *script, uint64_t amount, const dogecoin_key *privkey, int inputindex, int sighashtype, uint8_t *sigcompact_out, uint8_t *sigder_out, int *sigder_len);
 
+typedef struct dogecoin_tx_sign_job_ {
+    int inputindex;
+    const cstring* script;
+    uint64_t amount;
+    const dogecoin_key* privkey;
+    int sighashtype;
+    enum dogecoin_tx_sign_result result; // set by dogecoin_tx_sign_inputs_batch
+} dogecoin_tx_sign_job;
+
+//!sign many inputs of one tx, pubkeys, sighashes and signatures are computed on up to num_threads threads (0 or 1 = calling thread only)
+//!the script_sig/witness updates are applied in job order, returns DOGECOIN_SIGN_OK or the first failing job result
+LIBDOGECOIN_API enum dogecoin_tx_sign_result dogecoin_tx_sign_inputs_batch(dogecoin_tx* tx_in_out, dogecoin_tx_sign_job* jobs, size_t num_jobs, unsigned int num_threads);
+
 LIBDOGECOIN_END_DECL
 
 #endif // __LIBDOGECOIN_TX_H__
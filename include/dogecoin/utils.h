@@ -44,6 +44,10 @@ LIBDOGECOIN_BEGIN_DECL
 LIBDOGECOIN_API void utils_clear_buffers(void);
 LIBDOGECOIN_API void utils_hex_to_bin(const char* str, unsigned char* out, int inLen, int* outLen);
 LIBDOGECOIN_API void utils_bin_to_hex(unsigned char* bin_in, size_t inlen, char* hex_out);
+/* base64 (rfc 4648, padded), b64_out needs 4 * ((inlen + 2) / 3) + 1 bytes, returns the length written */
+LIBDOGECOIN_API size_t utils_base64_encode(const unsigned char* bin_in, size_t inlen, char* b64_out);
+/* outlen holds the size of bin_out and receives the decoded length, false on malformed input */
+LIBDOGECOIN_API dogecoin_bool utils_base64_decode(const char* b64_in, size_t inlen, unsigned char* bin_out, size_t* outlen);
 LIBDOGECOIN_API uint8_t* utils_hex_to_uint8(const char* str);
 LIBDOGECOIN_API char* utils_uint8_to_hex(const uint8_t* bin, size_t l);
 LIBDOGECOIN_API void utils_reverse_hex(char* h, int len);
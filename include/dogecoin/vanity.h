@@ -0,0 +1,73 @@
+/*
+
+ The MIT License (MIT)
+
+ Copyright (c) 2022 The Dogecoin Foundation
+
+ Permission is hereby granted, free of charge, to any person obtaining
+ a copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES
+ OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+#ifndef __LIBDOGECOIN_VANITY_H__
+#define __LIBDOGECOIN_VANITY_H__
+
+#include <dogecoin/chainparams.h>
+#include <dogecoin/crypto/key.h>
+#include <dogecoin/dogecoin.h>
+
+LIBDOGECOIN_BEGIN_DECL
+
+// longest prefix accepted, a full p2pkh address
+#define DOGECOIN_VANITY_MAX_PREFIX 34
+// a prefix maps to one hash160 range per possible address length
+#define DOGECOIN_VANITY_MAX_RANGES 4
+
+typedef struct dogecoin_vanity_pattern_ {
+    char prefix[DOGECOIN_VANITY_MAX_PREFIX + 1];
+    uint8_t version;          // p2pkh version byte of the chain
+    size_t num_ranges;
+    uint160 lo[DOGECOIN_VANITY_MAX_RANGES]; // inclusive hash160 bounds, big endian
+    uint160 hi[DOGECOIN_VANITY_MAX_RANGES];
+    double difficulty;        // expected number of keys per match
+} dogecoin_vanity_pattern;
+
+typedef struct dogecoin_vanity_progress_ {
+    uint64_t keys;            // keys tried so far
+    double elapsed;           // seconds
+    double keys_per_sec;
+    double eta;               // seconds until a match is more likely than not, 0 once past that point
+    dogecoin_bool found;
+} dogecoin_vanity_progress;
+
+typedef void (*dogecoin_vanity_progress_cb)(const dogecoin_vanity_progress* progress, void* user_data);
+
+//!turn a p2pkh address prefix into hash160 bounds, false if the prefix is not base58 or no address of chain can start with it
+LIBDOGECOIN_API dogecoin_bool dogecoin_vanity_pattern_init(dogecoin_vanity_pattern* pattern, const char* prefix, const dogecoin_chainparams* chain);
+
+//!true if the p2pkh address of hash160 starts with the pattern's prefix (range check, base58 only at the range edges)
+LIBDOGECOIN_API dogecoin_bool dogecoin_vanity_match(const dogecoin_vanity_pattern* pattern, const uint160 hash160);
+
+//!search random key sequences on num_threads threads until a compressed key matches or max_keys (0 = no limit) were tried
+//!progress (optional) is called about once a second from the calling thread and once at the end
+//!returns true and the key in key_out on a match
+LIBDOGECOIN_API dogecoin_bool dogecoin_vanity_search(const dogecoin_vanity_pattern* pattern, unsigned int num_threads, uint64_t max_keys, dogecoin_vanity_progress_cb progress, void* user_data, dogecoin_key* key_out);
+
+LIBDOGECOIN_END_DECL
+
+#endif // __LIBDOGECOIN_VANITY_H__
@@ -39,12 +39,19 @@
 #ifndef _MSC_VER
 #  include <unistd.h>
 #endif
+#ifdef HAVE_PTHREAD
+#  include <pthread.h>
+#endif
 
 #include <dogecoin/address.h>
 #include <dogecoin/tool.h>
 #include <dogecoin/bip32.h>
+#include <dogecoin/crypto/base58.h>
+#include <dogecoin/crypto/ecc.h>
 #include <dogecoin/crypto/key.h>
 #include <dogecoin/crypto/random.h>
+#include <dogecoin/crypto/sha2.h>
+#include <dogecoin/mem.h>
 #include <dogecoin/utils.h>
 
 int generatePrivPubKeypair(char* wif_privkey, char* p2pkh_pubkey, bool is_testnet) {
@@ -153,3 +160,263 @@ int generateDerivedHDPubkey(const char* wif_privkey_master, char* p2pkh_pubkey)
 
     return true;
 }
+
+/* keys are derived, hashed and encoded this many at a time */
+#define KEYPAIR_BATCH 256
+/* keypairs written per round by generatePrivPubKeypairsToFile */
+#define KEYPAIR_FILE_ROUND 65536
+
+typedef struct keypair_job_ {
+    const dogecoin_chainparams* chain;
+    const hmac_sha256_ctx* tweak; /* NULL for consecutive keys */
+    uint8_t privkey[DOGECOIN_ECKEY_PKEY_LENGTH]; /* first key of the range, or the base when tweaked */
+    uint64_t first_index; /* index of start in the tweaked sequence */
+    char* wif_privkeys;
+    char* p2pkh_pubkeys;
+    size_t start;
+    size_t end;
+    dogecoin_bool ok;
+} keypair_job;
+
+/* base + HMAC-SHA256(secret, index), index as 8 big endian bytes */
+static dogecoin_bool keypair_tweaked_key(const hmac_sha256_ctx* tweak, const uint8_t* base, uint64_t index, uint8_t* privkey) {
+    uint8_t msg[8];
+    uint8_t t[SHA256_DIGEST_LENGTH];
+    dogecoin_bool ok;
+    int i;
+    for (i = 7; i >= 0; i--) {
+        msg[i] = (uint8_t)index;
+        index >>= 8;
+    }
+    hmac_sha256_compute(tweak, msg, sizeof(msg), t);
+    memcpy(privkey, base, DOGECOIN_ECKEY_PKEY_LENGTH);
+    ok = dogecoin_ecc_private_key_tweak_add(privkey, t);
+    dogecoin_mem_zero(t, sizeof(t));
+    return ok;
+}
+
+/* one range of keys: private keys of a batch, their public keys (point additions when consecutive),
+   batched hash160, then base58 */
+static void* keypair_worker(void* arg) {
+    keypair_job* job = arg;
+    uint8_t* privkeys = dogecoin_malloc(KEYPAIR_BATCH * DOGECOIN_ECKEY_PKEY_LENGTH);
+    uint8_t* pubkeys = dogecoin_malloc(KEYPAIR_BATCH * DOGECOIN_ECKEY_COMPRESSED_LENGTH);
+    dogecoin_pubkey* batch = dogecoin_calloc(KEYPAIR_BATCH, sizeof(dogecoin_pubkey));
+    uint160* hashes = dogecoin_malloc(KEYPAIR_BATCH * sizeof(uint160));
+    uint8_t payload[DOGECOIN_ECKEY_PKEY_LENGTH + 2];
+    size_t done, m, i, len;
+
+    job->ok = true;
+    for (done = job->start; done < job->end && job->ok; done += m) {
+        m = job->end - done < KEYPAIR_BATCH ? job->end - done : KEYPAIR_BATCH;
+        for (i = 0; i < m && job->ok; i++) {
+            uint8_t* privkey = privkeys + i * DOGECOIN_ECKEY_PKEY_LENGTH;
+            if (job->tweak) {
+                job->ok = keypair_tweaked_key(job->tweak, job->privkey, job->first_index + (done - job->start) + i, privkey);
+            } else {
+                memcpy(privkey, job->privkey, DOGECOIN_ECKEY_PKEY_LENGTH);
+                /* the last key of the range may be the last valid one */
+                if (done + i + 1 < job->end)
+                    job->ok = dogecoin_ecc_private_key_add(job->privkey, 1);
+            }
+        }
+        if (!job->ok)
+            break;
+        if (job->p2pkh_pubkeys) {
+            if (job->tweak) {
+                for (i = 0; i < m; i++) {
+                    len = DOGECOIN_ECKEY_COMPRESSED_LENGTH;
+                    dogecoin_ecc_get_pubkey(privkeys + i * DOGECOIN_ECKEY_PKEY_LENGTH, pubkeys + i * DOGECOIN_ECKEY_COMPRESSED_LENGTH, &len, true);
+                }
+            } else if (!dogecoin_ecc_get_pubkey_sequence(privkeys, m, pubkeys, true)) {
+                job->ok = false;
+                break;
+            }
+            for (i = 0; i < m; i++) {
+                batch[i].compressed = true;
+                memcpy(batch[i].pubkey, pubkeys + i * DOGECOIN_ECKEY_COMPRESSED_LENGTH, DOGECOIN_ECKEY_COMPRESSED_LENGTH);
+            }
+            dogecoin_pubkey_get_hash160_batch(batch, m, hashes);
+            for (i = 0; i < m; i++) {
+                payload[0] = job->chain->b58prefix_pubkey_address;
+                memcpy(payload + 1, hashes[i], sizeof(uint160));
+                dogecoin_base58_encode_check(payload, sizeof(uint160) + 1, job->p2pkh_pubkeys + (done + i) * KEYPAIR_P2PKH_LENGTH, KEYPAIR_P2PKH_LENGTH);
+            }
+        }
+        for (i = 0; i < m && job->wif_privkeys; i++) {
+            /* same layout as dogecoin_privkey_encode_wif, always compressed */
+            payload[0] = job->chain->b58prefix_secret_address;
+            memcpy(payload + 1, privkeys + i * DOGECOIN_ECKEY_PKEY_LENGTH, DOGECOIN_ECKEY_PKEY_LENGTH);
+            payload[DOGECOIN_ECKEY_PKEY_LENGTH + 1] = 1;
+            dogecoin_base58_encode_check(payload, sizeof(payload), job->wif_privkeys + (done + i) * KEYPAIR_WIF_LENGTH, KEYPAIR_WIF_LENGTH);
+        }
+    }
+    dogecoin_mem_zero(payload, sizeof(payload));
+    dogecoin_mem_zero(job->privkey, sizeof(job->privkey));
+    dogecoin_mem_zero(privkeys, KEYPAIR_BATCH * DOGECOIN_ECKEY_PKEY_LENGTH);
+    dogecoin_free(hashes);
+    dogecoin_free(batch);
+    dogecoin_free(pubkeys);
+    dogecoin_free(privkeys);
+    return NULL;
+}
+
+/* keypairs base, base + 1, ..., base + n - 1, or base + HMAC(secret, first_index + i) when tweak is set,
+   split into one contiguous range per thread */
+static int generate_keypairs_from(const uint8_t* base, const hmac_sha256_ctx* tweak, uint64_t first_index, char* wif_privkeys, char* p2pkh_pubkeys, size_t n, const dogecoin_chainparams* chain, unsigned int num_threads) {
+    size_t i, done = 0;
+    int ok = true;
+
+    if (num_threads < 1)
+        num_threads = 1;
+    if (num_threads > n / KEYPAIR_BATCH)
+        num_threads = n / KEYPAIR_BATCH ? (unsigned int)(n / KEYPAIR_BATCH) : 1;
+    keypair_job* jobs = dogecoin_calloc(num_threads, sizeof(keypair_job));
+    for (i = 0; i < num_threads; i++) {
+        jobs[i].chain = chain;
+        jobs[i].tweak = tweak;
+        jobs[i].wif_privkeys = wif_privkeys;
+        jobs[i].p2pkh_pubkeys = p2pkh_pubkeys;
+        jobs[i].start = n * i / num_threads;
+        jobs[i].end = n * (i + 1) / num_threads;
+        jobs[i].first_index = first_index + jobs[i].start;
+        memcpy(jobs[i].privkey, base, DOGECOIN_ECKEY_PKEY_LENGTH);
+        if (!tweak && !dogecoin_ecc_private_key_add(jobs[i].privkey, jobs[i].start))
+            ok = false;
+    }
+    if (!ok) {
+        dogecoin_mem_zero(jobs, num_threads * sizeof(keypair_job));
+        dogecoin_free(jobs);
+        return false;
+    }
+#ifdef HAVE_PTHREAD
+    if (num_threads > 1) {
+        pthread_t* threads = dogecoin_calloc(num_threads, sizeof(pthread_t));
+        size_t started = 0;
+        /* the calling thread takes the first range */
+        for (started = 1; started < num_threads; started++) {
+            if (pthread_create(&threads[started], NULL, keypair_worker, &jobs[started]) != 0)
+                break;
+        }
+        keypair_worker(&jobs[0]);
+        for (i = 1; i < started; i++) {
+            pthread_join(threads[i], NULL);
+        }
+        dogecoin_free(threads);
+        done = started;
+    }
+#endif
+    /* single threaded (or pthreads not available), run the ranges that were not picked up */
+    for (i = done; i < num_threads; i++) {
+        keypair_worker(&jobs[i]);
+    }
+    for (i = 0; i < num_threads; i++) {
+        ok = ok && jobs[i].ok;
+    }
+    dogecoin_free(jobs);
+    return ok;
+}
+
+/* random base key k that leaves room for n consecutive keys (n = 0: any valid key) */
+static void generate_keypairs_base(uint8_t* base, size_t n) {
+    dogecoin_key key;
+    uint8_t last[DOGECOIN_ECKEY_PKEY_LENGTH];
+    do {
+        dogecoin_privkey_gen(&key);
+        memcpy(last, key.privkey, sizeof(last));
+    } while (n > 0 && !dogecoin_ecc_private_key_add(last, n - 1));
+    memcpy(base, key.privkey, DOGECOIN_ECKEY_PKEY_LENGTH);
+    dogecoin_mem_zero(last, sizeof(last));
+    dogecoin_privkey_cleanse(&key);
+}
+
+/* random tweak secret, only ever held while a batch is generated */
+static void generate_keypairs_tweak(hmac_sha256_ctx* tweak) {
+    uint8_t secret[32];
+    dogecoin_random_bytes(secret, sizeof(secret), 0);
+    hmac_sha256_prepare(tweak, secret, sizeof(secret));
+    dogecoin_mem_zero(secret, sizeof(secret));
+}
+
+static int generate_keypairs(char* wif_privkeys, char* p2pkh_pubkeys, size_t n, bool is_testnet, unsigned int num_threads, dogecoin_bool tweaked) {
+    const dogecoin_chainparams* chain = is_testnet ? &dogecoin_chainparams_test : &dogecoin_chainparams_main;
+    uint8_t base[DOGECOIN_ECKEY_PKEY_LENGTH];
+    hmac_sha256_ctx tweak;
+    int ok;
+    generate_keypairs_base(base, tweaked ? 0 : n);
+    if (tweaked)
+        generate_keypairs_tweak(&tweak);
+    ok = generate_keypairs_from(base, tweaked ? &tweak : NULL, 0, wif_privkeys, p2pkh_pubkeys, n, chain, num_threads);
+    if (tweaked)
+        hmac_sha256_ctx_cleanse(&tweak);
+    dogecoin_mem_zero(base, sizeof(base));
+    return ok;
+}
+
+int generatePrivPubKeypairs(char* wif_privkeys, char* p2pkh_pubkeys, size_t n, bool is_testnet, unsigned int num_threads) {
+    return generate_keypairs(wif_privkeys, p2pkh_pubkeys, n, is_testnet, num_threads, false);
+}
+
+int generatePrivPubKeypairsTweaked(char* wif_privkeys, char* p2pkh_pubkeys, size_t n, bool is_testnet, unsigned int num_threads) {
+    return generate_keypairs(wif_privkeys, p2pkh_pubkeys, n, is_testnet, num_threads, true);
+}
+
+static int generate_keypairs_to_file(FILE* file, size_t n, bool is_testnet, unsigned int num_threads, dogecoin_bool tweaked) {
+    const dogecoin_chainparams* chain = is_testnet ? &dogecoin_chainparams_test : &dogecoin_chainparams_main;
+    const size_t round = n < KEYPAIR_FILE_ROUND ? n : KEYPAIR_FILE_ROUND;
+    uint8_t base[DOGECOIN_ECKEY_PKEY_LENGTH];
+    hmac_sha256_ctx tweak;
+    char* wifs;
+    char* addrs;
+    char* lines;
+    size_t done, m, i, len;
+    int ok = true;
+
+    if (!file)
+        return false;
+    if (n == 0)
+        return true;
+    wifs = dogecoin_malloc(round * KEYPAIR_WIF_LENGTH);
+    addrs = dogecoin_malloc(round * KEYPAIR_P2PKH_LENGTH);
+    lines = dogecoin_malloc(round * (KEYPAIR_WIF_LENGTH + KEYPAIR_P2PKH_LENGTH));
+    generate_keypairs_base(base, tweaked ? 0 : n);
+    if (tweaked)
+        generate_keypairs_tweak(&tweak);
+    for (done = 0; ok && done < n; done += m) {
+        m = n - done < round ? n - done : round;
+        ok = generate_keypairs_from(base, tweaked ? &tweak : NULL, done, wifs, addrs, m, chain, num_threads);
+        /* "wif p2pkh\n" per keypair */
+        for (i = 0, len = 0; ok && i < m; i++) {
+            size_t l = strlen(wifs + i * KEYPAIR_WIF_LENGTH);
+            memcpy(lines + len, wifs + i * KEYPAIR_WIF_LENGTH, l);
+            len += l;
+            lines[len++] = ' ';
+            l = strlen(addrs + i * KEYPAIR_P2PKH_LENGTH);
+            memcpy(lines + len, addrs + i * KEYPAIR_P2PKH_LENGTH, l);
+            len += l;
+            lines[len++] = '\n';
+        }
+        if (ok && fwrite(lines, 1, len, file) != len)
+            ok = false;
+        /* consecutive keys continue from the next base, tweaked ones from the next index */
+        if (ok && !tweaked && done + m < n)
+            ok = dogecoin_ecc_private_key_add(base, m);
+    }
+    if (tweaked)
+        hmac_sha256_ctx_cleanse(&tweak);
+    dogecoin_mem_zero(base, sizeof(base));
+    dogecoin_mem_zero(wifs, round * KEYPAIR_WIF_LENGTH);
+    dogecoin_mem_zero(lines, round * (KEYPAIR_WIF_LENGTH + KEYPAIR_P2PKH_LENGTH));
+    dogecoin_free(lines);
+    dogecoin_free(addrs);
+    dogecoin_free(wifs);
+    return ok;
+}
+
+int generatePrivPubKeypairsToFile(FILE* file, size_t n, bool is_testnet, unsigned int num_threads) {
+    return generate_keypairs_to_file(file, n, is_testnet, num_threads, false);
+}
+
+int generatePrivPubKeypairsTweakedToFile(FILE* file, size_t n, bool is_testnet, unsigned int num_threads) {
+    return generate_keypairs_to_file(file, n, is_testnet, num_threads, true);
+}
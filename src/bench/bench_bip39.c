@@ -0,0 +1,107 @@
+/*
+
+ The MIT License (MIT)
+
+ Copyright (c) 2022 The Dogecoin Foundation
+
+ Permission is hereby granted, free of charge, to any person obtaining
+ a copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES
+ OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+#ifdef HAVE_CONFIG_H
+#  include <src/libdogecoin-config.h>
+#endif
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include <dogecoin/bip39.h>
+#include <dogecoin/crypto/sha2.h>
+#include <dogecoin/mem.h>
+
+// bip39 seed derivation throughput, one mnemonic at a time and restored in bulk on every
+// sha512 lane width
+
+#define BENCH_MNEMONICS 64
+
+static int64_t bench_time_us(void) {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (int64_t)tv.tv_usec + (int64_t)tv.tv_sec * 1000000;
+}
+
+static void bench_bip39_report(const char* name, int rounds, int64_t elapsed_us) {
+    const double seeds = (double)rounds * BENCH_MNEMONICS;
+    printf("bip39 seed_from_mnemonic %-10s: %8.0f seeds/s\n", name, seeds * 1e6 / (double)elapsed_us);
+}
+
+int main(int argc, char* argv[]) {
+    const int rounds = argc > 1 ? atoi(argv[1]) : 2;
+    const unsigned int lanes[] = {1, 4, 8};
+    char (*mnemonics)[BIP39_MAX_MNEMONIC_LENGTH] = dogecoin_calloc(BENCH_MNEMONICS, BIP39_MAX_MNEMONIC_LENGTH);
+    const char* list[BENCH_MNEMONICS];
+    uint8_t* seeds = dogecoin_calloc(BENCH_MNEMONICS, BIP39_SEED_LENGTH);
+    uint8_t entropy[16];
+    char name[32];
+    int64_t start;
+    size_t i, j;
+    int r;
+
+    if (rounds < 1) {
+        printf("Usage: bench_bip39 [rounds of %d mnemonics]\n", BENCH_MNEMONICS);
+        dogecoin_free(seeds);
+        dogecoin_free(mnemonics);
+        return 1;
+    }
+
+    for (i = 0; i < BENCH_MNEMONICS; i++) {
+        for (j = 0; j < sizeof(entropy); j++) {
+            entropy[j] = (uint8_t)(i * 29 + j * 7);
+        }
+        dogecoin_bip39_mnemonic_from_entropy(entropy, sizeof(entropy), mnemonics[i], BIP39_MAX_MNEMONIC_LENGTH);
+        list[i] = mnemonics[i];
+    }
+
+    start = bench_time_us();
+    for (r = 0; r < rounds; r++) {
+        for (i = 0; i < BENCH_MNEMONICS; i++) {
+            dogecoin_bip39_seed_from_mnemonic(list[i], NULL, seeds + i * BIP39_SEED_LENGTH);
+        }
+    }
+    bench_bip39_report("single", rounds, bench_time_us() - start);
+
+    for (i = 0; i < sizeof(lanes) / sizeof(lanes[0]); i++) {
+        if (!sha512_set_batch_lanes(lanes[i]))
+            continue;
+        snprintf(name, sizeof(name), "%u lanes", lanes[i]);
+        start = bench_time_us();
+        for (r = 0; r < rounds; r++) {
+            dogecoin_bip39_seeds_from_mnemonics(list, NULL, BENCH_MNEMONICS, seeds);
+        }
+        bench_bip39_report(name, rounds, bench_time_us() - start);
+    }
+    sha512_autodetect();
+
+    dogecoin_free(seeds);
+    dogecoin_free(mnemonics);
+    return 0;
+}
@@ -0,0 +1,240 @@
+/*
+
+ The MIT License (MIT)
+
+ Copyright (c) 2022 The Dogecoin Foundation
+
+ Permission is hereby granted, free of charge, to any person obtaining
+ a copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES
+ OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+#ifdef HAVE_CONFIG_H
+#  include <src/libdogecoin-config.h>
+#endif
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_HAVE_TSC 1
+#endif
+
+#include <dogecoin/crypto/base58.h>
+#include <dogecoin/crypto/rmd160.h>
+#include <dogecoin/crypto/segwit_addr.h>
+#include <dogecoin/crypto/sha2.h>
+#include <dogecoin/mem.h>
+#include <dogecoin/utils.h>
+
+// micro benchmarks of the hash and encoding primitives, printed as one json document:
+// {"sha256": impl, "sha512": impl, "tsc": bool, "results": [{"name", "size", "iterations",
+// "ns_per_op", "cycles_per_byte"}, ...]}
+// cycles are time stamp counter ticks, cycles_per_byte is null where there is no tsc
+
+#define BENCH_MAX_SIZE 65536
+
+typedef struct bench_data_ {
+    uint8_t* in;
+    size_t len;
+    uint8_t* out;
+    char* str;
+    size_t strsize;
+} bench_data;
+
+typedef struct bench_case_ {
+    const char* name;
+    void (*setup)(bench_data* d);
+    void (*op)(bench_data* d);
+    const size_t* sizes;
+} bench_case;
+
+static volatile uint8_t bench_sink;
+
+static const uint8_t bench_hmac_key[32] = {
+    0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b,
+    0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b};
+
+static int64_t bench_time_us(void) {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (int64_t)tv.tv_usec + (int64_t)tv.tv_sec * 1000000;
+}
+
+static uint64_t bench_cycles(void) {
+#ifdef BENCH_HAVE_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+static void bench_sha256(bench_data* d) {
+    sha256_raw(d->in, d->len, d->out);
+    bench_sink ^= d->out[0];
+}
+
+static void bench_sha512(bench_data* d) {
+    sha512_raw(d->in, d->len, d->out);
+    bench_sink ^= d->out[0];
+}
+
+static void bench_hmac_sha512(bench_data* d) {
+    hmac_sha512(bench_hmac_key, sizeof(bench_hmac_key), d->in, (uint32_t)d->len, d->out);
+    bench_sink ^= d->out[0];
+}
+
+static void bench_rmd160(bench_data* d) {
+    rmd160(d->in, d->len, d->out);
+    bench_sink ^= d->out[0];
+}
+
+static void bench_base58_encode_check(bench_data* d) {
+    dogecoin_base58_encode_check(d->in, (int)d->len, d->str, (int)d->strsize);
+    bench_sink ^= (uint8_t)d->str[0];
+}
+
+static void bench_base58_decode_setup(bench_data* d) {
+    dogecoin_base58_encode_check(d->in, (int)d->len, d->str, (int)d->strsize);
+}
+
+static void bench_base58_decode_check(bench_data* d) {
+    // the output buffer has to hold the whole string, decoding starts at its end
+    dogecoin_base58_decode_check(d->str, d->out, d->strsize);
+    bench_sink ^= d->out[0];
+}
+
+static void bench_segwit_addr_encode(bench_data* d) {
+    // version 0 programs are 20 or 32 bytes, other lengths go out as version 1
+    const int witver = (d->len == 20 || d->len == 32) ? 0 : 1;
+    segwit_addr_encode(d->str, "doge", witver, d->in, d->len);
+    bench_sink ^= (uint8_t)d->str[5];
+}
+
+static void bench_hex_encode(bench_data* d) {
+    utils_bin_to_hex(d->in, d->len, d->str);
+    bench_sink ^= (uint8_t)d->str[0];
+}
+
+static void bench_hex_decode_setup(bench_data* d) {
+    utils_bin_to_hex(d->in, d->len, d->str);
+}
+
+static void bench_hex_decode(bench_data* d) {
+    int outlen;
+    utils_hex_to_bin(d->str, d->out, (int)(d->len * 2), &outlen);
+    bench_sink ^= d->out[0];
+}
+
+static const size_t bench_hash_sizes[] = {32, 64, 256, 1024, 8192, BENCH_MAX_SIZE, 0};
+static const size_t bench_base58_sizes[] = {21, 33, 78, 0};
+static const size_t bench_segwit_sizes[] = {20, 32, 40, 0};
+static const size_t bench_hex_sizes[] = {32, 256, 4096, BENCH_MAX_SIZE, 0};
+
+static const bench_case bench_cases[] = {
+    {"sha256_raw", NULL, bench_sha256, bench_hash_sizes},
+    {"sha512_raw", NULL, bench_sha512, bench_hash_sizes},
+    {"hmac_sha512", NULL, bench_hmac_sha512, bench_hash_sizes},
+    {"rmd160", NULL, bench_rmd160, bench_hash_sizes},
+    {"dogecoin_base58_encode_check", NULL, bench_base58_encode_check, bench_base58_sizes},
+    {"dogecoin_base58_decode_check", bench_base58_decode_setup, bench_base58_decode_check, bench_base58_sizes},
+    {"segwit_addr_encode", NULL, bench_segwit_addr_encode, bench_segwit_sizes},
+    {"utils_bin_to_hex", NULL, bench_hex_encode, bench_hex_sizes},
+    {"utils_hex_to_bin", bench_hex_decode_setup, bench_hex_decode, bench_hex_sizes},
+};
+
+// doubles the iteration count until a run takes at least min_us and reports that run
+static void bench_run(const bench_case* c, bench_data* d, int64_t min_us, dogecoin_bool first) {
+    uint64_t iterations = 1, i, cycles;
+    int64_t elapsed;
+
+    if (c->setup)
+        c->setup(d);
+    c->op(d);
+    for (;;) {
+        const uint64_t start_cycles = bench_cycles();
+        const int64_t start = bench_time_us();
+        for (i = 0; i < iterations; i++) {
+            c->op(d);
+        }
+        elapsed = bench_time_us() - start;
+        cycles = bench_cycles() - start_cycles;
+        if (elapsed >= min_us)
+            break;
+        iterations *= 2;
+    }
+    printf("%s\n    {\"name\": \"%s\", \"size\": %u, \"iterations\": %llu, \"ns_per_op\": %.2f, ",
+           first ? "" : ",", c->name, (unsigned int)d->len, (unsigned long long)iterations,
+           (double)elapsed * 1000.0 / (double)iterations);
+#ifdef BENCH_HAVE_TSC
+    printf("\"cycles_per_byte\": %.3f}", (double)cycles / (double)iterations / (double)d->len);
+#else
+    (void)cycles;
+    printf("\"cycles_per_byte\": null}");
+#endif
+}
+
+int main(int argc, char* argv[]) {
+    const int min_ms = argc > 1 ? atoi(argv[1]) : 50;
+    const char* filter = argc > 2 ? argv[2] : NULL;
+    dogecoin_bool first = true;
+    bench_data d;
+    size_t i, s;
+
+    if (min_ms < 1) {
+        fprintf(stderr, "Usage: bench_dogecoin [milliseconds per case] [name filter]\n");
+        return 1;
+    }
+
+    d.in = dogecoin_malloc(BENCH_MAX_SIZE);
+    d.out = dogecoin_malloc(BENCH_MAX_SIZE * 2 + 1);
+    d.strsize = BENCH_MAX_SIZE * 2 + 1;
+    d.str = dogecoin_malloc(d.strsize);
+    for (i = 0; i < BENCH_MAX_SIZE; i++) {
+        d.in[i] = (uint8_t)(i * 167 + 13);
+    }
+    // leading zero bytes take a different path through base58
+    d.in[0] = 0x1e;
+
+    printf("{\n  \"sha256\": \"%s\",\n  \"sha512\": \"%s\",\n", sha256_autodetect(), sha512_autodetect());
+#ifdef BENCH_HAVE_TSC
+    printf("  \"tsc\": true,\n");
+#else
+    printf("  \"tsc\": false,\n");
+#endif
+    printf("  \"results\": [");
+    for (i = 0; i < sizeof(bench_cases) / sizeof(bench_cases[0]); i++) {
+        if (filter && !strstr(bench_cases[i].name, filter))
+            continue;
+        for (s = 0; bench_cases[i].sizes[s]; s++) {
+            d.len = bench_cases[i].sizes[s];
+            bench_run(&bench_cases[i], &d, (int64_t)min_ms * 1000, first);
+            first = false;
+        }
+    }
+    printf("\n  ]\n}\n");
+
+    dogecoin_free(d.str);
+    dogecoin_free(d.out);
+    dogecoin_free(d.in);
+    return 0;
+}
@@ -0,0 +1,241 @@
+/*
+
+ The MIT License (MIT)
+
+ Copyright (c) 2022 The Dogecoin Foundation
+
+ Permission is hereby granted, free of charge, to any person obtaining
+ a copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES
+ OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+#ifdef HAVE_CONFIG_H
+#  include <src/libdogecoin-config.h>
+#endif
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <dogecoin/address.h>
+#include <dogecoin/chainparams.h>
+#include <dogecoin/crypto/ecc.h>
+#include <dogecoin/crypto/key.h>
+#include <dogecoin/mem.h>
+#include <dogecoin/message.h>
+
+// signature verification throughput: ecdsa through dogecoin_ecc_verify_sig (with and without
+// the parsed pubkey cache), bip340 schnorr one by one and through the multi threaded bulk check,
+// then public key derivation per key against the incremental sequence and bulk keypairs, and
+// signed message verification one by one, in bulk and through the recovered pubkey cache
+
+#define BENCH_SIGS 256
+
+static int64_t bench_time_us(void) {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (int64_t)tv.tv_usec + (int64_t)tv.tv_sec * 1000000;
+}
+
+static void bench_ecc_report(const char* name, const char* unit, int rounds, int64_t elapsed_us) {
+    const double ops = (double)rounds * BENCH_SIGS;
+    printf("%-36s: %9.0f %ss/s, %7.2f us/%s\n", name, ops * 1e6 / (double)elapsed_us, unit, (double)elapsed_us / ops, unit);
+}
+
+int main(int argc, char* argv[]) {
+    const int rounds = argc > 1 ? atoi(argv[1]) : 4;
+    uint8_t (*hashes)[32] = dogecoin_calloc(BENCH_SIGS, 32);
+    uint8_t (*pubkeys)[33] = dogecoin_calloc(BENCH_SIGS, 33);
+    uint8_t (*xonly)[32] = dogecoin_calloc(BENCH_SIGS, 32);
+    unsigned char (*der)[74] = dogecoin_calloc(BENCH_SIGS, 74);
+    unsigned char (*schnorr)[64] = dogecoin_calloc(BENCH_SIGS, 64);
+    size_t* derlens = dogecoin_calloc(BENCH_SIGS, sizeof(size_t));
+    dogecoin_schnorr_check* checks = dogecoin_calloc(BENCH_SIGS, sizeof(dogecoin_schnorr_check));
+    uint8_t privkey[32];
+    unsigned int threads, max_threads = 1;
+    char name[64];
+    int64_t start;
+    size_t i, len;
+    int r, cache;
+
+    if (rounds < 1) {
+        printf("Usage: bench_ecc [rounds of %d signatures]\n", BENCH_SIGS);
+        return 1;
+    }
+    dogecoin_ecc_start();
+#ifdef _SC_NPROCESSORS_ONLN
+    if (sysconf(_SC_NPROCESSORS_ONLN) > 1)
+        max_threads = (unsigned int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+
+    for (i = 0; i < BENCH_SIGS; i++) {
+        memset(privkey, (int)(i % 255) + 1, sizeof(privkey));
+        privkey[0] = (uint8_t)(i >> 8);
+        memset(hashes[i], (int)i, 32);
+        len = 33;
+        dogecoin_ecc_get_pubkey(privkey, pubkeys[i], &len, true);
+        derlens[i] = 74;
+        dogecoin_ecc_sign(privkey, hashes[i], der[i], &derlens[i]);
+        dogecoin_ecc_get_xonly_pubkey(privkey, xonly[i]);
+        dogecoin_ecc_schnorr_sign(privkey, hashes[i], schnorr[i], NULL);
+        checks[i].hash = hashes[i];
+        checks[i].xonly_pubkey = xonly[i];
+        checks[i].sig = schnorr[i];
+    }
+
+    for (cache = 0; cache < 2; cache++) {
+        dogecoin_ecc_pubkey_cache_resize(cache ? DOGECOIN_ECC_PUBKEY_CACHE_DEFAULT_ENTRIES : 0);
+        // one pass to fill the cache
+        for (i = 0; cache && i < BENCH_SIGS; i++) {
+            dogecoin_ecc_verify_sig(pubkeys[i], true, hashes[i], der[i], derlens[i]);
+        }
+        start = bench_time_us();
+        for (r = 0; r < rounds; r++) {
+            for (i = 0; i < BENCH_SIGS; i++) {
+                if (!dogecoin_ecc_verify_sig(pubkeys[i], true, hashes[i], der[i], derlens[i]))
+                    printf("ecdsa signature %u failed\n", (unsigned int)i);
+            }
+        }
+        bench_ecc_report(cache ? "ecdsa verify_sig, pubkey cache" : "ecdsa verify_sig", "sig", rounds, bench_time_us() - start);
+    }
+
+    start = bench_time_us();
+    for (r = 0; r < rounds; r++) {
+        for (i = 0; i < BENCH_SIGS; i++) {
+            if (!dogecoin_ecc_schnorr_verify(xonly[i], hashes[i], schnorr[i]))
+                printf("schnorr signature %u failed\n", (unsigned int)i);
+        }
+    }
+    bench_ecc_report("schnorr verify", "sig", rounds, bench_time_us() - start);
+
+    // 1, 2, 4, ... threads and finally every core
+    for (threads = 1;; threads = threads * 2 < max_threads ? threads * 2 : max_threads) {
+        snprintf(name, sizeof(name), "schnorr verify_batch, %u threads", threads);
+        start = bench_time_us();
+        for (r = 0; r < rounds; r++) {
+            if (!dogecoin_ecc_schnorr_verify_batch(checks, BENCH_SIGS, threads))
+                printf("schnorr batch failed\n");
+        }
+        bench_ecc_report(name, "sig", rounds, bench_time_us() - start);
+        if (threads == max_threads)
+            break;
+    }
+
+    start = bench_time_us();
+    for (r = 0; r < rounds; r++) {
+        for (i = 0; i < BENCH_SIGS; i++) {
+            len = 33;
+            dogecoin_ecc_get_pubkey(privkey, pubkeys[i], &len, true);
+            dogecoin_ecc_private_key_add(privkey, 1);
+        }
+    }
+    bench_ecc_report("get_pubkey", "key", rounds, bench_time_us() - start);
+    start = bench_time_us();
+    for (r = 0; r < rounds; r++) {
+        dogecoin_ecc_get_pubkey_sequence(privkey, BENCH_SIGS, pubkeys[0], true);
+        dogecoin_ecc_private_key_add(privkey, BENCH_SIGS);
+    }
+    bench_ecc_report("get_pubkey_sequence", "key", rounds, bench_time_us() - start);
+
+    char wif[KEYPAIR_WIF_LENGTH * 2];
+    char addr[KEYPAIR_P2PKH_LENGTH * 2];
+    start = bench_time_us();
+    for (r = 0; r < rounds; r++) {
+        for (i = 0; i < BENCH_SIGS; i++) {
+            generatePrivPubKeypair(wif, addr, false);
+        }
+    }
+    bench_ecc_report("generatePrivPubKeypair", "key", rounds, bench_time_us() - start);
+    char* wifs = dogecoin_malloc(BENCH_SIGS * KEYPAIR_WIF_LENGTH);
+    char* addrs = dogecoin_malloc(BENCH_SIGS * KEYPAIR_P2PKH_LENGTH);
+    for (threads = 1;; threads = threads * 2 < max_threads ? threads * 2 : max_threads) {
+        snprintf(name, sizeof(name), "generatePrivPubKeypairs, %u threads", threads);
+        start = bench_time_us();
+        for (r = 0; r < rounds; r++) {
+            generatePrivPubKeypairs(wifs, addrs, BENCH_SIGS, false, threads);
+        }
+        bench_ecc_report(name, "key", rounds, bench_time_us() - start);
+        if (threads == max_threads)
+            break;
+    }
+    dogecoin_free(addrs);
+    dogecoin_free(wifs);
+
+    dogecoin_message_check* msg_checks = dogecoin_calloc(BENCH_SIGS, sizeof(dogecoin_message_check));
+    char (*msg_sigs)[DOGECOIN_MESSAGE_SIG_BASE64_LENGTH] = dogecoin_calloc(BENCH_SIGS, DOGECOIN_MESSAGE_SIG_BASE64_LENGTH);
+    char (*msg_addrs)[KEYPAIR_P2PKH_LENGTH] = dogecoin_calloc(BENCH_SIGS, KEYPAIR_P2PKH_LENGTH);
+    for (i = 0; i < BENCH_SIGS; i++) {
+        dogecoin_key key;
+        dogecoin_pubkey pubkey;
+        dogecoin_privkey_init(&key);
+        memset(key.privkey, (int)(i % 255) + 1, sizeof(key.privkey));
+        key.privkey[0] = (uint8_t)(i >> 8);
+        dogecoin_pubkey_init(&pubkey);
+        dogecoin_pubkey_from_key(&key, &pubkey);
+        dogecoin_pubkey_getaddr_p2pkh(&pubkey, &dogecoin_chainparams_main, msg_addrs[i]);
+        dogecoin_message_sign(&key, true, "bench_ecc login", msg_sigs[i]);
+        msg_checks[i].address = msg_addrs[i];
+        msg_checks[i].signature = msg_sigs[i];
+        msg_checks[i].message = "bench_ecc login";
+    }
+    start = bench_time_us();
+    for (r = 0; r < rounds; r++) {
+        for (i = 0; i < BENCH_SIGS; i++) {
+            if (!dogecoin_message_verify(NULL, msg_addrs[i], msg_sigs[i], "bench_ecc login", &dogecoin_chainparams_main))
+                printf("message signature %u failed\n", (unsigned int)i);
+        }
+    }
+    bench_ecc_report("message verify", "sig", rounds, bench_time_us() - start);
+    for (threads = 1;; threads = threads * 2 < max_threads ? threads * 2 : max_threads) {
+        snprintf(name, sizeof(name), "message verify_batch, %u threads", threads);
+        start = bench_time_us();
+        for (r = 0; r < rounds; r++) {
+            if (dogecoin_message_verify_batch(NULL, msg_checks, BENCH_SIGS, &dogecoin_chainparams_main, threads) != BENCH_SIGS)
+                printf("message batch failed\n");
+        }
+        bench_ecc_report(name, "sig", rounds, bench_time_us() - start);
+        if (threads == max_threads)
+            break;
+    }
+    // repeated logins, every round after the first finds the recovered keys
+    dogecoin_message_cache* msg_cache = dogecoin_message_cache_new(DOGECOIN_MESSAGE_CACHE_DEFAULT_ENTRIES);
+    dogecoin_message_verify_batch(msg_cache, msg_checks, BENCH_SIGS, &dogecoin_chainparams_main, 1);
+    start = bench_time_us();
+    for (r = 0; r < rounds; r++) {
+        if (dogecoin_message_verify_batch(msg_cache, msg_checks, BENCH_SIGS, &dogecoin_chainparams_main, 1) != BENCH_SIGS)
+            printf("cached message batch failed\n");
+    }
+    bench_ecc_report("message verify_batch, cache hits", "sig", rounds, bench_time_us() - start);
+    dogecoin_message_cache_free(msg_cache);
+    dogecoin_free(msg_addrs);
+    dogecoin_free(msg_sigs);
+    dogecoin_free(msg_checks);
+
+    dogecoin_free(checks);
+    dogecoin_free(derlens);
+    dogecoin_free(schnorr);
+    dogecoin_free(der);
+    dogecoin_free(xonly);
+    dogecoin_free(pubkeys);
+    dogecoin_free(hashes);
+    dogecoin_ecc_stop();
+    return 0;
+}
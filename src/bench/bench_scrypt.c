@@ -0,0 +1,160 @@
+/*
+
+ The MIT License (MIT)
+
+ Copyright (c) 2022 The Dogecoin Foundation
+
+ Permission is hereby granted, free of charge, to any person obtaining
+ a copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES
+ OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+#ifdef HAVE_CONFIG_H
+#  include <src/libdogecoin-config.h>
+#endif
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
+#include <dogecoin/crypto/scrypt.h>
+#include <dogecoin/mem.h>
+
+// scrypt proof of work throughput: every single stream core and lane width on one core,
+// then the autodetected configuration on every core
+
+#define BENCH_HEADERS 256
+
+static int64_t bench_time_us(void) {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (int64_t)tv.tv_usec + (int64_t)tv.tv_sec * 1000000;
+}
+
+typedef struct bench_scrypt_job_ {
+    uint8_t headers[BENCH_HEADERS * SCRYPT_POW_INPUT_LENGTH];
+    uint8_t hashes[BENCH_HEADERS * SCRYPT_POW_OUTPUT_LENGTH];
+    int rounds;
+    dogecoin_bool batch;
+} bench_scrypt_job;
+
+static void* bench_scrypt_run(void* arg) {
+    bench_scrypt_job* job = arg;
+    int r;
+    size_t i;
+    for (r = 0; r < job->rounds; r++) {
+        // a different nonce per round, like a miner would
+        job->headers[76] = (uint8_t)r;
+        if (job->batch) {
+            scrypt_1024_1_1_256_batch(job->hashes, job->headers, BENCH_HEADERS);
+        } else {
+            for (i = 0; i < BENCH_HEADERS; i++) {
+                scrypt_1024_1_1_256(job->headers + i * SCRYPT_POW_INPUT_LENGTH, job->hashes + i * SCRYPT_POW_OUTPUT_LENGTH);
+            }
+        }
+    }
+    return NULL;
+}
+
+static void bench_scrypt_init(bench_scrypt_job* job, int rounds, dogecoin_bool batch, unsigned int seed) {
+    size_t i;
+    for (i = 0; i < sizeof(job->headers); i++) {
+        job->headers[i] = (uint8_t)(i * 31 + seed);
+    }
+    job->rounds = rounds;
+    job->batch = batch;
+}
+
+static void bench_scrypt_report(const char* name, unsigned int threads, int rounds, int64_t elapsed_us) {
+    const double hashes = (double)rounds * BENCH_HEADERS * threads;
+    const double per_sec = hashes * 1e6 / (double)elapsed_us;
+    printf("scrypt_1024_1_1_256 %-12s threads %2u: %10.0f h/s, %10.0f h/s per core\n", name, threads, per_sec, per_sec / threads);
+}
+
+int main(int argc, char* argv[]) {
+    const int rounds = argc > 1 ? atoi(argv[1]) : 2;
+    const unsigned int lanes[] = {4, 8, 16};
+    bench_scrypt_job* job = dogecoin_calloc(1, sizeof(*job));
+    char name[32];
+    int64_t start;
+    size_t i;
+
+    if (rounds < 1) {
+        printf("Usage: bench_scrypt [rounds of %d headers]\n", BENCH_HEADERS);
+        dogecoin_free(job);
+        return 1;
+    }
+
+    if (scrypt_set_implementation(SCRYPT_IMPL_STANDARD)) {
+        scrypt_set_batch_lanes(1);
+        bench_scrypt_init(job, rounds, false, 0);
+        start = bench_time_us();
+        bench_scrypt_run(job);
+        bench_scrypt_report("standard", 1, rounds, bench_time_us() - start);
+    }
+    if (scrypt_set_implementation(SCRYPT_IMPL_SSE2)) {
+        bench_scrypt_init(job, rounds, false, 0);
+        start = bench_time_us();
+        bench_scrypt_run(job);
+        bench_scrypt_report("sse2", 1, rounds, bench_time_us() - start);
+    }
+    for (i = 0; i < sizeof(lanes) / sizeof(lanes[0]); i++) {
+        if (!scrypt_set_batch_lanes(lanes[i]))
+            continue;
+        snprintf(name, sizeof(name), "%u lanes", lanes[i]);
+        bench_scrypt_init(job, rounds, true, 0);
+        start = bench_time_us();
+        bench_scrypt_run(job);
+        bench_scrypt_report(name, 1, rounds, bench_time_us() - start);
+    }
+    dogecoin_free(job);
+
+#ifdef HAVE_PTHREAD
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cores > 1) {
+        const unsigned int threads = (unsigned int)cores;
+        bench_scrypt_job* jobs = dogecoin_calloc(threads, sizeof(*jobs));
+        pthread_t* tids = dogecoin_calloc(threads, sizeof(pthread_t));
+        unsigned int t, started;
+        snprintf(name, sizeof(name), "%s", scrypt_autodetect());
+        for (t = 0; t < threads; t++) {
+            bench_scrypt_init(&jobs[t], rounds, true, t);
+        }
+        start = bench_time_us();
+        for (started = 0; started < threads; started++) {
+            if (pthread_create(&tids[started], NULL, bench_scrypt_run, &jobs[started]) != 0)
+                break;
+        }
+        for (t = 0; t < started; t++) {
+            pthread_join(tids[t], NULL);
+        }
+        if (started > 0)
+            bench_scrypt_report("batch", started, rounds, bench_time_us() - start);
+        dogecoin_free(tids);
+        dogecoin_free(jobs);
+    }
+#endif
+    return 0;
+}
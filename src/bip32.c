@@ -99,18 +99,25 @@ dogecoin_bool dogecoin_hdnode_from_seed(const uint8_t* seed, int seed_len, dogec
 }
 
 dogecoin_bool dogecoin_hdnode_public_ckd(dogecoin_hdnode* inout, uint32_t i) {
+    hmac_sha512_ctx chain_code_ctx;
+    hmac_sha512_prepare(&chain_code_ctx, inout->chain_code, DOGECOIN_BIP32_CHAINCODE_SIZE);
+    dogecoin_bool ret = dogecoin_hdnode_public_ckd_ctx(inout, i, &chain_code_ctx);
+    hmac_sha512_ctx_cleanse(&chain_code_ctx);
+    return ret;
+}
+
+dogecoin_bool dogecoin_hdnode_public_ckd_ctx(dogecoin_hdnode* inout, uint32_t i, const hmac_sha512_ctx* chain_code_ctx) {
     uint8_t data[1 + 32 + 4];
     uint8_t I[32 + DOGECOIN_BIP32_CHAINCODE_SIZE];
     uint8_t fingerprint[32];
     if (i & 0x80000000) return false; // private derivation
     else { memcpy(data, inout->public_key, DOGECOIN_ECKEY_COMPRESSED_LENGTH); } // public derivation
     write_be(data + DOGECOIN_ECKEY_COMPRESSED_LENGTH, i);
-    sha256_raw(inout->public_key, DOGECOIN_ECKEY_COMPRESSED_LENGTH, fingerprint);
-    rmd160(fingerprint, 32, fingerprint);
+    dogecoin_hash160(inout->public_key, DOGECOIN_ECKEY_COMPRESSED_LENGTH, fingerprint);
     inout->fingerprint = (fingerprint[0] << 24) + (fingerprint[1] << 16) + (fingerprint[2] << 8) + fingerprint[3];
     memset(inout->private_key, 0, 32);
     int failed = 0;
-    hmac_sha512(inout->chain_code, 32, data, sizeof(data), I);
+    hmac_sha512_compute(chain_code_ctx, data, sizeof(data), I);
     memcpy(inout->chain_code, I + 32, DOGECOIN_BIP32_CHAINCODE_SIZE);
     if (!dogecoin_ecc_public_key_tweak_add(inout->public_key, I)) failed = false;
     if (!failed) {
@@ -126,6 +133,14 @@ dogecoin_bool dogecoin_hdnode_public_ckd(dogecoin_hdnode* inout, uint32_t i) {
 
 
 dogecoin_bool dogecoin_hdnode_private_ckd(dogecoin_hdnode* inout, uint32_t i) {
+    hmac_sha512_ctx chain_code_ctx;
+    hmac_sha512_prepare(&chain_code_ctx, inout->chain_code, DOGECOIN_BIP32_CHAINCODE_SIZE);
+    dogecoin_bool ret = dogecoin_hdnode_private_ckd_ctx(inout, i, &chain_code_ctx);
+    hmac_sha512_ctx_cleanse(&chain_code_ctx);
+    return ret;
+}
+
+dogecoin_bool dogecoin_hdnode_private_ckd_ctx(dogecoin_hdnode* inout, uint32_t i, const hmac_sha512_ctx* chain_code_ctx) {
     uint8_t data[1 + DOGECOIN_ECKEY_PKEY_LENGTH + 4];
     uint8_t I[DOGECOIN_ECKEY_PKEY_LENGTH + DOGECOIN_BIP32_CHAINCODE_SIZE];
     uint8_t fingerprint[DOGECOIN_BIP32_CHAINCODE_SIZE];
@@ -137,13 +152,12 @@ dogecoin_bool dogecoin_hdnode_private_ckd(dogecoin_hdnode* inout, uint32_t i) {
         memcpy(data, inout->public_key, DOGECOIN_ECKEY_COMPRESSED_LENGTH);
     }
     write_be(data + DOGECOIN_ECKEY_COMPRESSED_LENGTH, i);
-    sha256_raw(inout->public_key, DOGECOIN_ECKEY_COMPRESSED_LENGTH, fingerprint);
-    rmd160(fingerprint, 32, fingerprint);
+    dogecoin_hash160(inout->public_key, DOGECOIN_ECKEY_COMPRESSED_LENGTH, fingerprint);
     inout->fingerprint = (fingerprint[0] << 24) + (fingerprint[1] << 16) +
                          (fingerprint[2] << 8) + fingerprint[3];
     memset(fingerprint, 0, sizeof(fingerprint));
     memcpy(p, inout->private_key, DOGECOIN_ECKEY_PKEY_LENGTH);
-    hmac_sha512(inout->chain_code, DOGECOIN_BIP32_CHAINCODE_SIZE, data, sizeof(data), I);
+    hmac_sha512_compute(chain_code_ctx, data, sizeof(data), I);
     memcpy(inout->chain_code, I + DOGECOIN_ECKEY_PKEY_LENGTH, DOGECOIN_BIP32_CHAINCODE_SIZE);
     memcpy(inout->private_key, I, DOGECOIN_ECKEY_PKEY_LENGTH);
     memcpy(z, inout->private_key, DOGECOIN_ECKEY_PKEY_LENGTH);
@@ -195,9 +209,21 @@ void dogecoin_hdnode_serialize_private(const dogecoin_hdnode* node, const dogeco
 }
 
 void dogecoin_hdnode_get_hash160(const dogecoin_hdnode* node, uint160 hash160_out) {
-    uint256 hashout;
-    dogecoin_hash_sngl_sha256(node->public_key, DOGECOIN_ECKEY_COMPRESSED_LENGTH, hashout);
-    rmd160(hashout, sizeof(hashout), hash160_out);
+    dogecoin_hash160(node->public_key, DOGECOIN_ECKEY_COMPRESSED_LENGTH, hash160_out);
+}
+
+void dogecoin_hdnode_get_hash160_batch(const dogecoin_hdnode* nodes, size_t n, uint160* hash160s) {
+    const unsigned char* data[64];
+    size_t lens[64];
+    size_t i, chunk;
+    for (; n > 0; n -= chunk, nodes += chunk, hash160s += chunk) {
+        chunk = n < 64 ? n : 64;
+        for (i = 0; i < chunk; i++) {
+            data[i] = nodes[i].public_key;
+            lens[i] = DOGECOIN_ECKEY_COMPRESSED_LENGTH;
+        }
+        dogecoin_hash160_batch(data, lens, chunk, hash160s);
+    }
 }
 
 void dogecoin_hdnode_get_p2pkh_address(const dogecoin_hdnode* node, const dogecoin_chainparams* chain, char* str, int strsize) {
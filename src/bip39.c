@@ -0,0 +1,183 @@
+/*
+
+ The MIT License (MIT)
+
+ Copyright (c) 2022 The Dogecoin Foundation
+
+ Permission is hereby granted, free of charge, to any person obtaining
+ a copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES
+ OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include <string.h>
+
+#include <dogecoin/bip39.h>
+#include <dogecoin/crypto/sha2.h>
+#include <dogecoin/mem.h>
+
+#define BIP39_MAX_WORDS 24
+#define BIP39_SALT_PREFIX "mnemonic"
+#define BIP39_SALT_PREFIX_LENGTH 8
+// seeds derived per pbkdf2_hmac_sha512_batch call
+#define BIP39_SEED_CHUNK 64
+
+static dogecoin_bool bip39_entropy_length_valid(size_t entropy_len) {
+    return entropy_len >= 16 && entropy_len <= 32 && entropy_len % 4 == 0;
+}
+
+// 11 bit word index i of a big endian bit string
+static int bip39_bits_get(const uint8_t* bits, size_t i) {
+    const size_t pos = i * 11;
+    const uint32_t v = ((uint32_t)bits[pos / 8] << 16) | ((uint32_t)bits[pos / 8 + 1] << 8) | bits[pos / 8 + 2];
+    return (int)((v >> (13 - pos % 8)) & 0x7ff);
+}
+
+static void bip39_bits_set(uint8_t* bits, size_t i, int index) {
+    const size_t pos = i * 11;
+    const uint32_t v = (uint32_t)index << (13 - pos % 8);
+    bits[pos / 8] |= (uint8_t)(v >> 16);
+    bits[pos / 8 + 1] |= (uint8_t)(v >> 8);
+    bits[pos / 8 + 2] |= (uint8_t)v;
+}
+
+dogecoin_bool dogecoin_bip39_mnemonic_from_entropy(const uint8_t* entropy, size_t entropy_len, char* mnemonic, size_t size) {
+    // entropy, the checksum byte and room for the 3 byte reads of the last index
+    uint8_t bits[32 + 1 + 2];
+    size_t i, pos = 0;
+
+    if (!bip39_entropy_length_valid(entropy_len))
+        return false;
+    memset(bits, 0, sizeof(bits));
+    memcpy(bits, entropy, entropy_len);
+    // the checksum is the first entropy_len / 4 bits of sha256(entropy)
+    uint8_t hash[SHA256_DIGEST_LENGTH];
+    sha256_raw(entropy, entropy_len, hash);
+    bits[entropy_len] = hash[0];
+
+    const size_t words = (entropy_len * 8 + entropy_len / 4) / 11;
+    for (i = 0; i < words; i++) {
+        const char* word = dogecoin_bip39_wordlist_english[bip39_bits_get(bits, i)];
+        const size_t len = strlen(word);
+        if (pos + len + 1 > size) {
+            dogecoin_mem_zero(bits, sizeof(bits));
+            return false;
+        }
+        if (i > 0)
+            mnemonic[pos - 1] = ' ';
+        memcpy(mnemonic + pos, word, len);
+        pos += len + 1;
+        mnemonic[pos - 1] = '\0';
+    }
+    dogecoin_mem_zero(bits, sizeof(bits));
+    return true;
+}
+
+// word indices of a mnemonic packed into bits, exactly one space between words since the seed
+// is derived from the string as given
+static dogecoin_bool bip39_mnemonic_bits(const char* mnemonic, uint8_t* bits, size_t* words) {
+    const char* p = mnemonic;
+    *words = 0;
+    for (;;) {
+        const char* end = strchr(p, ' ');
+        const size_t len = end ? (size_t)(end - p) : strlen(p);
+        const int index = dogecoin_bip39_word_index(p, len);
+        if (index < 0 || *words == BIP39_MAX_WORDS)
+            return false;
+        bip39_bits_set(bits, (*words)++, index);
+        if (!end)
+            return true;
+        p = end + 1;
+    }
+}
+
+dogecoin_bool dogecoin_bip39_mnemonic_to_entropy(const char* mnemonic, uint8_t* entropy, size_t* entropy_len) {
+    uint8_t bits[32 + 1 + 2];
+    uint8_t hash[SHA256_DIGEST_LENGTH];
+    size_t words, len;
+    dogecoin_bool ok = false;
+
+    memset(bits, 0, sizeof(bits));
+    if (bip39_mnemonic_bits(mnemonic, bits, &words) && words % 3 == 0 && words >= 12) {
+        len = words * 4 / 3;
+        sha256_raw(bits, len, hash);
+        const uint8_t mask = (uint8_t)(0xff << (8 - len / 4));
+        ok = (bits[len] & mask) == (hash[0] & mask);
+        if (ok && entropy)
+            memcpy(entropy, bits, len);
+        if (ok && entropy_len)
+            *entropy_len = len;
+    }
+    dogecoin_mem_zero(bits, sizeof(bits));
+    return ok;
+}
+
+dogecoin_bool dogecoin_bip39_mnemonic_check(const char* mnemonic) {
+    return dogecoin_bip39_mnemonic_to_entropy(mnemonic, NULL, NULL);
+}
+
+// "mnemonic" || passphrase, wiped and freed by the caller
+static uint8_t* bip39_salt_new(const char* passphrase, size_t* saltlen) {
+    const size_t passlen = passphrase ? strlen(passphrase) : 0;
+    uint8_t* salt = dogecoin_malloc(BIP39_SALT_PREFIX_LENGTH + passlen);
+    memcpy(salt, BIP39_SALT_PREFIX, BIP39_SALT_PREFIX_LENGTH);
+    if (passlen)
+        memcpy(salt + BIP39_SALT_PREFIX_LENGTH, passphrase, passlen);
+    *saltlen = BIP39_SALT_PREFIX_LENGTH + passlen;
+    return salt;
+}
+
+static void bip39_salt_free(uint8_t* salt, size_t saltlen) {
+    dogecoin_mem_zero(salt, saltlen);
+    dogecoin_free(salt);
+}
+
+void dogecoin_bip39_seed_from_mnemonic(const char* mnemonic, const char* passphrase, uint8_t seed[BIP39_SEED_LENGTH]) {
+    size_t saltlen;
+    uint8_t* salt = bip39_salt_new(passphrase, &saltlen);
+    pbkdf2_hmac_sha512((const uint8_t*)mnemonic, strlen(mnemonic), salt, saltlen, BIP39_PBKDF2_ROUNDS, seed, BIP39_SEED_LENGTH);
+    bip39_salt_free(salt, saltlen);
+}
+
+void dogecoin_bip39_seeds_from_mnemonics(const char* const mnemonics[], const char* const passphrases[], size_t n, uint8_t* seeds) {
+    const uint8_t* passes[BIP39_SEED_CHUNK];
+    size_t passlens[BIP39_SEED_CHUNK];
+    const uint8_t* salts[BIP39_SEED_CHUNK];
+    uint8_t* salt_bufs[BIP39_SEED_CHUNK];
+    size_t saltlens[BIP39_SEED_CHUNK];
+    uint8_t* keys[BIP39_SEED_CHUNK];
+    size_t i, chunk;
+
+    for (; n > 0; n -= chunk) {
+        chunk = n < BIP39_SEED_CHUNK ? n : BIP39_SEED_CHUNK;
+        for (i = 0; i < chunk; i++) {
+            passes[i] = (const uint8_t*)mnemonics[i];
+            passlens[i] = strlen(mnemonics[i]);
+            salt_bufs[i] = bip39_salt_new(passphrases ? passphrases[i] : NULL, &saltlens[i]);
+            salts[i] = salt_bufs[i];
+            keys[i] = seeds + i * BIP39_SEED_LENGTH;
+        }
+        pbkdf2_hmac_sha512_batch(passes, passlens, salts, saltlens, BIP39_PBKDF2_ROUNDS, keys, chunk);
+        for (i = 0; i < chunk; i++) {
+            bip39_salt_free(salt_bufs[i], saltlens[i]);
+        }
+        mnemonics += chunk;
+        if (passphrases)
+            passphrases += chunk;
+        seeds += chunk * BIP39_SEED_LENGTH;
+    }
+}
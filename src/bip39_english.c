@@ -0,0 +1,609 @@
+/*
+
+ The MIT License (MIT)
+
+ Copyright (c) 2022 The Dogecoin Foundation
+
+ Permission is hereby granted, free of charge, to any person obtaining
+ a copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES
+ OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include <string.h>
+
+#include <dogecoin/bip39.h>
+
+#define BIP39_HASH_BUCKETS 512
+#define BIP39_HASH_SLOTS 4096
+
+// bip-0039 english.txt, sha256 2f5eed53a4727b4bf8880d8f3f199efc90e58503646d9ff8eff3a2ed3b24dbda
+const char* const dogecoin_bip39_wordlist_english[BIP39_WORDLIST_SIZE] = {
+    "abandon", "ability", "able", "about", "above", "absent", "absorb", "abstract",
+    "absurd", "abuse", "access", "accident", "account", "accuse", "achieve", "acid",
+    "acoustic", "acquire", "across", "act", "action", "actor", "actress", "actual",
+    "adapt", "add", "addict", "address", "adjust", "admit", "adult", "advance",
+    "advice", "aerobic", "affair", "afford", "afraid", "again", "age", "agent",
+    "agree", "ahead", "aim", "air", "airport", "aisle", "alarm", "album",
+    "alcohol", "alert", "alien", "all", "alley", "allow", "almost", "alone",
+    "alpha", "already", "also", "alter", "always", "amateur", "amazing", "among",
+    "amount", "amused", "analyst", "anchor", "ancient", "anger", "angle", "angry",
+    "animal", "ankle", "announce", "annual", "another", "answer", "antenna", "antique",
+    "anxiety", "any", "apart", "apology", "appear", "apple", "approve", "april",
+    "arch", "arctic", "area", "arena", "argue", "arm", "armed", "armor",
+    "army", "around", "arrange", "arrest", "arrive", "arrow", "art", "artefact",
+    "artist", "artwork", "ask", "aspect", "assault", "asset", "assist", "assume",
+    "asthma", "athlete", "atom", "attack", "attend", "attitude", "attract", "auction",
+    "audit", "august", "aunt", "author", "auto", "autumn", "average", "avocado",
+    "avoid", "awake", "aware", "away", "awesome", "awful", "awkward", "axis",
+    "baby", "bachelor", "bacon", "badge", "bag", "balance", "balcony", "ball",
+    "bamboo", "banana", "banner", "bar", "barely", "bargain", "barrel", "base",
+    "basic", "basket", "battle", "beach", "bean", "beauty", "because", "become",
+    "beef", "before", "begin", "behave", "behind", "believe", "below", "belt",
+    "bench", "benefit", "best", "betray", "better", "between", "beyond", "bicycle",
+    "bid", "bike", "bind", "biology", "bird", "birth", "bitter", "black",
+    "blade", "blame", "blanket", "blast", "bleak", "bless", "blind", "blood",
+    "blossom", "blouse", "blue", "blur", "blush", "board", "boat", "body",
+    "boil", "bomb", "bone", "bonus", "book", "boost", "border", "boring",
+    "borrow", "boss", "bottom", "bounce", "box", "boy", "bracket", "brain",
+    "brand", "brass", "brave", "bread", "breeze", "brick", "bridge", "brief",
+    "bright", "bring", "brisk", "broccoli", "broken", "bronze", "broom", "brother",
+    "brown", "brush", "bubble", "buddy", "budget", "buffalo", "build", "bulb",
+    "bulk", "bullet", "bundle", "bunker", "burden", "burger", "burst", "bus",
+    "business", "busy", "butter", "buyer", "buzz", "cabbage", "cabin", "cable",
+    "cactus", "cage", "cake", "call", "calm", "camera", "camp", "can",
+    "canal", "cancel", "candy", "cannon", "canoe", "canvas", "canyon", "capable",
+    "capital", "captain", "car", "carbon", "card", "cargo", "carpet", "carry",
+    "cart", "case", "cash", "casino", "castle", "casual", "cat", "catalog",
+    "catch", "category", "cattle", "caught", "cause", "caution", "cave", "ceiling",
+    "celery", "cement", "census", "century", "cereal", "certain", "chair", "chalk",
+    "champion", "change", "chaos", "chapter", "charge", "chase", "chat", "cheap",
+    "check", "cheese", "chef", "cherry", "chest", "chicken", "chief", "child",
+    "chimney", "choice", "choose", "chronic", "chuckle", "chunk", "churn", "cigar",
+    "cinnamon", "circle", "citizen", "city", "civil", "claim", "clap", "clarify",
+    "claw", "clay", "clean", "clerk", "clever", "click", "client", "cliff",
+    "climb", "clinic", "clip", "clock", "clog", "close", "cloth", "cloud",
+    "clown", "club", "clump", "cluster", "clutch", "coach", "coast", "coconut",
+    "code", "coffee", "coil", "coin", "collect", "color", "column", "combine",
+    "come", "comfort", "comic", "common", "company", "concert", "conduct", "confirm",
+    "congress", "connect", "consider", "control", "convince", "cook", "cool", "copper",
+    "copy", "coral", "core", "corn", "correct", "cost", "cotton", "couch",
+    "country", "couple", "course", "cousin", "cover", "coyote", "crack", "cradle",
+    "craft", "cram", "crane", "crash", "crater", "crawl", "crazy", "cream",
+    "credit", "creek", "crew", "cricket", "crime", "crisp", "critic", "crop",
+    "cross", "crouch", "crowd", "crucial", "cruel", "cruise", "crumble", "crunch",
+    "crush", "cry", "crystal", "cube", "culture", "cup", "cupboard", "curious",
+    "current", "curtain", "curve", "cushion", "custom", "cute", "cycle", "dad",
+    "damage", "damp", "dance", "danger", "daring", "dash", "daughter", "dawn",
+    "day", "deal", "debate", "debris", "decade", "december", "decide", "decline",
+    "decorate", "decrease", "deer", "defense", "define", "defy", "degree", "delay",
+    "deliver", "demand", "demise", "denial", "dentist", "deny", "depart", "depend",
+    "deposit", "depth", "deputy", "derive", "describe", "desert", "design", "desk",
+    "despair", "destroy", "detail", "detect", "develop", "device", "devote", "diagram",
+    "dial", "diamond", "diary", "dice", "diesel", "diet", "differ", "digital",
+    "dignity", "dilemma", "dinner", "dinosaur", "direct", "dirt", "disagree", "discover",
+    "disease", "dish", "dismiss", "disorder", "display", "distance", "divert", "divide",
+    "divorce", "dizzy", "doctor", "document", "dog", "doll", "dolphin", "domain",
+    "donate", "donkey", "donor", "door", "dose", "double", "dove", "draft",
+    "dragon", "drama", "drastic", "draw", "dream", "dress", "drift", "drill",
+    "drink", "drip", "drive", "drop", "drum", "dry", "duck", "dumb",
+    "dune", "during", "dust", "dutch", "duty", "dwarf", "dynamic", "eager",
+    "eagle", "early", "earn", "earth", "easily", "east", "easy", "echo",
+    "ecology", "economy", "edge", "edit", "educate", "effort", "egg", "eight",
+    "either", "elbow", "elder", "electric", "elegant", "element", "elephant", "elevator",
+    "elite", "else", "embark", "embody", "embrace", "emerge", "emotion", "employ",
+    "empower", "empty", "enable", "enact", "end", "endless", "endorse", "enemy",
+    "energy", "enforce", "engage", "engine", "enhance", "enjoy", "enlist", "enough",
+    "enrich", "enroll", "ensure", "enter", "entire", "entry", "envelope", "episode",
+    "equal", "equip", "era", "erase", "erode", "erosion", "error", "erupt",
+    "escape", "essay", "essence", "estate", "eternal", "ethics", "evidence", "evil",
+    "evoke", "evolve", "exact", "example", "excess", "exchange", "excite", "exclude",
+    "excuse", "execute", "exercise", "exhaust", "exhibit", "exile", "exist", "exit",
+    "exotic", "expand", "expect", "expire", "explain", "expose", "express", "extend",
+    "extra", "eye", "eyebrow", "fabric", "face", "faculty", "fade", "faint",
+    "faith", "fall", "false", "fame", "family", "famous", "fan", "fancy",
+    "fantasy", "farm", "fashion", "fat", "fatal", "father", "fatigue", "fault",
+    "favorite", "feature", "february", "federal", "fee", "feed", "feel", "female",
+    "fence", "festival", "fetch", "fever", "few", "fiber", "fiction", "field",
+    "figure", "file", "film", "filter", "final", "find", "fine", "finger",
+    "finish", "fire", "firm", "first", "fiscal", "fish", "fit", "fitness",
+    "fix", "flag", "flame", "flash", "flat", "flavor", "flee", "flight",
+    "flip", "float", "flock", "floor", "flower", "fluid", "flush", "fly",
+    "foam", "focus", "fog", "foil", "fold", "follow", "food", "foot",
+    "force", "forest", "forget", "fork", "fortune", "forum", "forward", "fossil",
+    "foster", "found", "fox", "fragile", "frame", "frequent", "fresh", "friend",
+    "fringe", "frog", "front", "frost", "frown", "frozen", "fruit", "fuel",
+    "fun", "funny", "furnace", "fury", "future", "gadget", "gain", "galaxy",
+    "gallery", "game", "gap", "garage", "garbage", "garden", "garlic", "garment",
+    "gas", "gasp", "gate", "gather", "gauge", "gaze", "general", "genius",
+    "genre", "gentle", "genuine", "gesture", "ghost", "giant", "gift", "giggle",
+    "ginger", "giraffe", "girl", "give", "glad", "glance", "glare", "glass",
+    "glide", "glimpse", "globe", "gloom", "glory", "glove", "glow", "glue",
+    "goat", "goddess", "gold", "good", "goose", "gorilla", "gospel", "gossip",
+    "govern", "gown", "grab", "grace", "grain", "grant", "grape", "grass",
+    "gravity", "great", "green", "grid", "grief", "grit", "grocery", "group",
+    "grow", "grunt", "guard", "guess", "guide", "guilt", "guitar", "gun",
+    "gym", "habit", "hair", "half", "hammer", "hamster", "hand", "happy",
+    "harbor", "hard", "harsh", "harvest", "hat", "have", "hawk", "hazard",
+    "head", "health", "heart", "heavy", "hedgehog", "height", "hello", "helmet",
+    "help", "hen", "hero", "hidden", "high", "hill", "hint", "hip",
+    "hire", "history", "hobby", "hockey", "hold", "hole", "holiday", "hollow",
+    "home", "honey", "hood", "hope", "horn", "horror", "horse", "hospital",
+    "host", "hotel", "hour", "hover", "hub", "huge", "human", "humble",
+    "humor", "hundred", "hungry", "hunt", "hurdle", "hurry", "hurt", "husband",
+    "hybrid", "ice", "icon", "idea", "identify", "idle", "ignore", "ill",
+    "illegal", "illness", "image", "imitate", "immense", "immune", "impact", "impose",
+    "improve", "impulse", "inch", "include", "income", "increase", "index", "indicate",
+    "indoor", "industry", "infant", "inflict", "inform", "inhale", "inherit", "initial",
+    "inject", "injury", "inmate", "inner", "innocent", "input", "inquiry", "insane",
+    "insect", "inside", "inspire", "install", "intact", "interest", "into", "invest",
+    "invite", "involve", "iron", "island", "isolate", "issue", "item", "ivory",
+    "jacket", "jaguar", "jar", "jazz", "jealous", "jeans", "jelly", "jewel",
+    "job", "join", "joke", "journey", "joy", "judge", "juice", "jump",
+    "jungle", "junior", "junk", "just", "kangaroo", "keen", "keep", "ketchup",
+    "key", "kick", "kid", "kidney", "kind", "kingdom", "kiss", "kit",
+    "kitchen", "kite", "kitten", "kiwi", "knee", "knife", "knock", "know",
+    "lab", "label", "labor", "ladder", "lady", "lake", "lamp", "language",
+    "laptop", "large", "later", "latin", "laugh", "laundry", "lava", "law",
+    "lawn", "lawsuit", "layer", "lazy", "leader", "leaf", "learn", "leave",
+    "lecture", "left", "leg", "legal", "legend", "leisure", "lemon", "lend",
+    "length", "lens", "leopard", "lesson", "letter", "level", "liar", "liberty",
+    "library", "license", "life", "lift", "light", "like", "limb", "limit",
+    "link", "lion", "liquid", "list", "little", "live", "lizard", "load",
+    "loan", "lobster", "local", "lock", "logic", "lonely", "long", "loop",
+    "lottery", "loud", "lounge", "love", "loyal", "lucky", "luggage", "lumber",
+    "lunar", "lunch", "luxury", "lyrics", "machine", "mad", "magic", "magnet",
+    "maid", "mail", "main", "major", "make", "mammal", "man", "manage",
+    "mandate", "mango", "mansion", "manual", "maple", "marble", "march", "margin",
+    "marine", "market", "marriage", "mask", "mass", "master", "match", "material",
+    "math", "matrix", "matter", "maximum", "maze", "meadow", "mean", "measure",
+    "meat", "mechanic", "medal", "media", "melody", "melt", "member", "memory",
+    "mention", "menu", "mercy", "merge", "merit", "merry", "mesh", "message",
+    "metal", "method", "middle", "midnight", "milk", "million", "mimic", "mind",
+    "minimum", "minor", "minute", "miracle", "mirror", "misery", "miss", "mistake",
+    "mix", "mixed", "mixture", "mobile", "model", "modify", "mom", "moment",
+    "monitor", "monkey", "monster", "month", "moon", "moral", "more", "morning",
+    "mosquito", "mother", "motion", "motor", "mountain", "mouse", "move", "movie",
+    "much", "muffin", "mule", "multiply", "muscle", "museum", "mushroom", "music",
+    "must", "mutual", "myself", "mystery", "myth", "naive", "name", "napkin",
+    "narrow", "nasty", "nation", "nature", "near", "neck", "need", "negative",
+    "neglect", "neither", "nephew", "nerve", "nest", "net", "network", "neutral",
+    "never", "news", "next", "nice", "night", "noble", "noise", "nominee",
+    "noodle", "normal", "north", "nose", "notable", "note", "nothing", "notice",
+    "novel", "now", "nuclear", "number", "nurse", "nut", "oak", "obey",
+    "object", "oblige", "obscure", "observe", "obtain", "obvious", "occur", "ocean",
+    "october", "odor", "off", "offer", "office", "often", "oil", "okay",
+    "old", "olive", "olympic", "omit", "once", "one", "onion", "online",
+    "only", "open", "opera", "opinion", "oppose", "option", "orange", "orbit",
+    "orchard", "order", "ordinary", "organ", "orient", "original", "orphan", "ostrich",
+    "other", "outdoor", "outer", "output", "outside", "oval", "oven", "over",
+    "own", "owner", "oxygen", "oyster", "ozone", "pact", "paddle", "page",
+    "pair", "palace", "palm", "panda", "panel", "panic", "panther", "paper",
+    "parade", "parent", "park", "parrot", "party", "pass", "patch", "path",
+    "patient", "patrol", "pattern", "pause", "pave", "payment", "peace", "peanut",
+    "pear", "peasant", "pelican", "pen", "penalty", "pencil", "people", "pepper",
+    "perfect", "permit", "person", "pet", "phone", "photo", "phrase", "physical",
+    "piano", "picnic", "picture", "piece", "pig", "pigeon", "pill", "pilot",
+    "pink", "pioneer", "pipe", "pistol", "pitch", "pizza", "place", "planet",
+    "plastic", "plate", "play", "please", "pledge", "pluck", "plug", "plunge",
+    "poem", "poet", "point", "polar", "pole", "police", "pond", "pony",
+    "pool", "popular", "portion", "position", "possible", "post", "potato", "pottery",
+    "poverty", "powder", "power", "practice", "praise", "predict", "prefer", "prepare",
+    "present", "pretty", "prevent", "price", "pride", "primary", "print", "priority",
+    "prison", "private", "prize", "problem", "process", "produce", "profit", "program",
+    "project", "promote", "proof", "property", "prosper", "protect", "proud", "provide",
+    "public", "pudding", "pull", "pulp", "pulse", "pumpkin", "punch", "pupil",
+    "puppy", "purchase", "purity", "purpose", "purse", "push", "put", "puzzle",
+    "pyramid", "quality", "quantum", "quarter", "question", "quick", "quit", "quiz",
+    "quote", "rabbit", "raccoon", "race", "rack", "radar", "radio", "rail",
+    "rain", "raise", "rally", "ramp", "ranch", "random", "range", "rapid",
+    "rare", "rate", "rather", "raven", "raw", "razor", "ready", "real",
+    "reason", "rebel", "rebuild", "recall", "receive", "recipe", "record", "recycle",
+    "reduce", "reflect", "reform", "refuse", "region", "regret", "regular", "reject",
+    "relax", "release", "relief", "rely", "remain", "remember", "remind", "remove",
+    "render", "renew", "rent", "reopen", "repair", "repeat", "replace", "report",
+    "require", "rescue", "resemble", "resist", "resource", "response", "result", "retire",
+    "retreat", "return", "reunion", "reveal", "review", "reward", "rhythm", "rib",
+    "ribbon", "rice", "rich", "ride", "ridge", "rifle", "right", "rigid",
+    "ring", "riot", "ripple", "risk", "ritual", "rival", "river", "road",
+    "roast", "robot", "robust", "rocket", "romance", "roof", "rookie", "room",
+    "rose", "rotate", "rough", "round", "route", "royal", "rubber", "rude",
+    "rug", "rule", "run", "runway", "rural", "sad", "saddle", "sadness",
+    "safe", "sail", "salad", "salmon", "salon", "salt", "salute", "same",
+    "sample", "sand", "satisfy", "satoshi", "sauce", "sausage", "save", "say",
+    "scale", "scan", "scare", "scatter", "scene", "scheme", "school", "science",
+    "scissors", "scorpion", "scout", "scrap", "screen", "script", "scrub", "sea",
+    "search", "season", "seat", "second", "secret", "section", "security", "seed",
+    "seek", "segment", "select", "sell", "seminar", "senior", "sense", "sentence",
+    "series", "service", "session", "settle", "setup", "seven", "shadow", "shaft",
+    "shallow", "share", "shed", "shell", "sheriff", "shield", "shift", "shine",
+    "ship", "shiver", "shock", "shoe", "shoot", "shop", "short", "shoulder",
+    "shove", "shrimp", "shrug", "shuffle", "shy", "sibling", "sick", "side",
+    "siege", "sight", "sign", "silent", "silk", "silly", "silver", "similar",
+    "simple", "since", "sing", "siren", "sister", "situate", "six", "size",
+    "skate", "sketch", "ski", "skill", "skin", "skirt", "skull", "slab",
+    "slam", "sleep", "slender", "slice", "slide", "slight", "slim", "slogan",
+    "slot", "slow", "slush", "small", "smart", "smile", "smoke", "smooth",
+    "snack", "snake", "snap", "sniff", "snow", "soap", "soccer", "social",
+    "sock", "soda", "soft", "solar", "soldier", "solid", "solution", "solve",
+    "someone", "song", "soon", "sorry", "sort", "soul", "sound", "soup",
+    "source", "south", "space", "spare", "spatial", "spawn", "speak", "special",
+    "speed", "spell", "spend", "sphere", "spice", "spider", "spike", "spin",
+    "spirit", "split", "spoil", "sponsor", "spoon", "sport", "spot", "spray",
+    "spread", "spring", "spy", "square", "squeeze", "squirrel", "stable", "stadium",
+    "staff", "stage", "stairs", "stamp", "stand", "start", "state", "stay",
+    "steak", "steel", "stem", "step", "stereo", "stick", "still", "sting",
+    "stock", "stomach", "stone", "stool", "story", "stove", "strategy", "street",
+    "strike", "strong", "struggle", "student", "stuff", "stumble", "style", "subject",
+    "submit", "subway", "success", "such", "sudden", "suffer", "sugar", "suggest",
+    "suit", "summer", "sun", "sunny", "sunset", "super", "supply", "supreme",
+    "sure", "surface", "surge", "surprise", "surround", "survey", "suspect", "sustain",
+    "swallow", "swamp", "swap", "swarm", "swear", "sweet", "swift", "swim",
+    "swing", "switch", "sword", "symbol", "symptom", "syrup", "system", "table",
+    "tackle", "tag", "tail", "talent", "talk", "tank", "tape", "target",
+    "task", "taste", "tattoo", "taxi", "teach", "team", "tell", "ten",
+    "tenant", "tennis", "tent", "term", "test", "text", "thank", "that",
+    "theme", "then", "theory", "there", "they", "thing", "this", "thought",
+    "three", "thrive", "throw", "thumb", "thunder", "ticket", "tide", "tiger",
+    "tilt", "timber", "time", "tiny", "tip", "tired", "tissue", "title",
+    "toast", "tobacco", "today", "toddler", "toe", "together", "toilet", "token",
+    "tomato", "tomorrow", "tone", "tongue", "tonight", "tool", "tooth", "top",
+    "topic", "topple", "torch", "tornado", "tortoise", "toss", "total", "tourist",
+    "toward", "tower", "town", "toy", "track", "trade", "traffic", "tragic",
+    "train", "transfer", "trap", "trash", "travel", "tray", "treat", "tree",
+    "trend", "trial", "tribe", "trick", "trigger", "trim", "trip", "trophy",
+    "trouble", "truck", "true", "truly", "trumpet", "trust", "truth", "try",
+    "tube", "tuition", "tumble", "tuna", "tunnel", "turkey", "turn", "turtle",
+    "twelve", "twenty", "twice", "twin", "twist", "two", "type", "typical",
+    "ugly", "umbrella", "unable", "unaware", "uncle", "uncover", "under", "undo",
+    "unfair", "unfold", "unhappy", "uniform", "unique", "unit", "universe", "unknown",
+    "unlock", "until", "unusual", "unveil", "update", "upgrade", "uphold", "upon",
+    "upper", "upset", "urban", "urge", "usage", "use", "used", "useful",
+    "useless", "usual", "utility", "vacant", "vacuum", "vague", "valid", "valley",
+    "valve", "van", "vanish", "vapor", "various", "vast", "vault", "vehicle",
+    "velvet", "vendor", "venture", "venue", "verb", "verify", "version", "very",
+    "vessel", "veteran", "viable", "vibrant", "vicious", "victory", "video", "view",
+    "village", "vintage", "violin", "virtual", "virus", "visa", "visit", "visual",
+    "vital", "vivid", "vocal", "voice", "void", "volcano", "volume", "vote",
+    "voyage", "wage", "wagon", "wait", "walk", "wall", "walnut", "want",
+    "warfare", "warm", "warrior", "wash", "wasp", "waste", "water", "wave",
+    "way", "wealth", "weapon", "wear", "weasel", "weather", "web", "wedding",
+    "weekend", "weird", "welcome", "west", "wet", "whale", "what", "wheat",
+    "wheel", "when", "where", "whip", "whisper", "wide", "width", "wife",
+    "wild", "will", "win", "window", "wine", "wing", "wink", "winner",
+    "winter", "wire", "wisdom", "wise", "wish", "witness", "wolf", "woman",
+    "wonder", "wood", "wool", "word", "work", "world", "worry", "worth",
+    "wrap", "wreck", "wrestle", "wrist", "write", "wrong", "yard", "year",
+    "yellow", "you", "young", "youth", "zebra", "zero", "zone", "zoo"
+};
+
+// hash and displace perfect hash over the first four letters, which are unique in the list:
+// slot = (h(key) ^ disp[bucket(key)]) % BIP39_HASH_SLOTS holds index + 1 of the only word with that prefix
+static const uint16_t bip39_english_disp[BIP39_HASH_BUCKETS] = {
+    5, 7, 2, 9, 0, 3, 0, 0, 3, 0, 0, 1, 1, 2, 0, 0,
+    3, 4, 1, 1, 0, 1, 4, 0, 1, 1, 0, 1, 0, 0, 6, 0,
+    1, 0, 0, 0, 5, 0, 0, 1, 0, 1, 3, 0, 3, 4, 1, 0,
+    0, 0, 0, 0, 17, 0, 0, 7, 0, 11, 3, 3, 3, 6, 0, 4,
+    0, 3, 10, 4, 3, 14, 0, 1, 4, 0, 0, 0, 1, 0, 1, 12,
+    6, 0, 0, 1, 0, 1, 1, 0, 0, 4, 8, 2, 1, 0, 7, 2,
+    6, 2, 1, 0, 7, 3, 0, 3, 1, 1, 0, 2, 5, 0, 0, 0,
+    0, 9, 0, 0, 12, 2, 14, 4, 8, 0, 2, 0, 2, 0, 0, 6,
+    0, 5, 10, 0, 1, 1, 0, 0, 5, 4, 17, 0, 0, 10, 3, 2,
+    15, 1, 2, 0, 4, 2, 0, 1, 0, 0, 3, 7, 0, 3, 0, 0,
+    0, 0, 4, 0, 6, 1, 1, 2, 3, 7, 1, 1, 0, 0, 0, 2,
+    0, 1, 4, 0, 3, 7, 1, 3, 0, 0, 0, 0, 2, 5, 1, 1,
+    0, 0, 3, 2, 0, 16, 2, 3, 1, 0, 0, 6, 4, 3, 11, 0,
+    1, 0, 1, 4, 1, 0, 1, 1, 0, 1, 0, 3, 1, 5, 1, 1,
+    0, 3, 4, 6, 0, 18, 3, 16, 0, 1, 0, 2, 0, 8, 3, 0,
+    2, 2, 0, 6, 16, 3, 4, 1, 0, 0, 9, 2, 2, 2, 5, 2,
+    0, 0, 1, 1, 0, 5, 4, 2, 1, 5, 1, 3, 0, 3, 22, 23,
+    9, 5, 0, 12, 6, 6, 7, 3, 0, 0, 4, 2, 0, 3, 6, 2,
+    0, 0, 1, 8, 1, 3, 0, 0, 2, 0, 0, 4, 13, 2, 4, 0,
+    0, 1, 0, 1, 0, 0, 0, 2, 3, 3, 0, 1, 2, 5, 2, 10,
+    6, 0, 3, 0, 18, 7, 3, 2, 0, 1, 2, 4, 38, 3, 5, 4,
+    2, 3, 1, 5, 0, 5, 0, 0, 2, 0, 2, 0, 5, 5, 0, 2,
+    0, 4, 2, 8, 2, 0, 6, 0, 0, 13, 0, 0, 0, 8, 1, 13,
+    3, 2, 0, 0, 2, 2, 3, 13, 3, 8, 5, 14, 1, 4, 9, 1,
+    0, 0, 0, 0, 0, 10, 8, 20, 0, 4, 4, 6, 16, 3, 3, 2,
+    6, 9, 16, 8, 6, 4, 1, 0, 2, 1, 0, 12, 4, 4, 2, 1,
+    8, 4, 1, 12, 0, 4, 1, 0, 13, 0, 6, 0, 0, 2, 1, 2,
+    0, 0, 0, 7, 0, 0, 2, 28, 1, 0, 0, 4, 2, 0, 14, 3,
+    2, 0, 1, 3, 9, 0, 4, 0, 4, 2, 0, 0, 3, 4, 1, 0,
+    1, 3, 1, 19, 2, 3, 0, 0, 9, 1, 1, 3, 4, 13, 8, 2,
+    3, 0, 0, 13, 1, 1, 0, 10, 0, 12, 0, 10, 17, 7, 1, 7,
+    0, 0, 0, 1, 0, 6, 29, 6, 6, 1, 8, 10, 7, 18, 4, 6
+};
+
+static const uint16_t bip39_english_slots[BIP39_HASH_SLOTS] = {
+    938, 0, 736, 935, 1471, 215, 0, 2006, 1837, 0, 0, 900, 1339, 112, 630, 0,
+    923, 1069, 1053, 1970, 2047, 285, 1024, 708, 0, 0, 1918, 0, 0, 1734, 870, 1523,
+    517, 1060, 0, 0, 471, 0, 0, 0, 428, 0, 542, 0, 2000, 612, 561, 1285,
+    0, 0, 0, 1037, 584, 974, 0, 0, 0, 0, 1413, 1691, 0, 0, 0, 1180,
+    0, 1275, 0, 695, 1117, 55, 1625, 396, 0, 383, 0, 0, 1288, 0, 0, 803,
+    1793, 0, 0, 0, 970, 846, 1997, 1724, 1064, 1937, 0, 0, 674, 1893, 593, 545,
+    1239, 0, 1605, 519, 1022, 0, 0, 129, 0, 1668, 1331, 746, 0, 1192, 0, 929,
+    172, 1687, 1099, 156, 0, 1450, 1964, 480, 0, 1261, 205, 484, 642, 0, 0, 2033,
+    0, 1580, 0, 0, 1745, 282, 2040, 0, 899, 0, 12, 1215, 863, 1175, 1332, 417,
+    0, 0, 0, 0, 0, 1492, 0, 1321, 509, 0, 0, 0, 0, 0, 0, 0,
+    1177, 114, 0, 366, 701, 335, 576, 0, 1410, 371, 115, 0, 0, 1282, 1933, 0,
+    0, 374, 143, 0, 891, 0, 1241, 625, 901, 0, 1497, 546, 633, 0, 1378, 1479,
+    0, 0, 623, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1436, 855, 1209, 1214,
+    1342, 566, 331, 558, 1539, 1585, 328, 768, 1667, 648, 1092, 1201, 0, 2002, 1531, 1740,
+    1533, 0, 1490, 1096, 0, 0, 0, 816, 24, 723, 824, 1258, 1953, 131, 0, 1987,
+    0, 64, 1253, 1197, 0, 0, 0, 1109, 0, 1769, 0, 0, 182, 0, 0, 296,
+    1663, 1325, 0, 1385, 1710, 1145, 1430, 361, 549, 2042, 1427, 1776, 0, 503, 177, 791,
+    834, 794, 0, 0, 0, 0, 573, 447, 1930, 0, 0, 1212, 0, 141, 246, 29,
+    0, 1344, 0, 0, 1496, 0, 0, 0, 641, 735, 1906, 2018, 0, 0, 0, 348,
+    228, 0, 0, 0, 1502, 1519, 1020, 1749, 190, 941, 1886, 0, 1100, 0, 0, 0,
+    1086, 0, 0, 0, 1167, 0, 1576, 0, 0, 0, 1044, 1639, 0, 1556, 0, 614,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1284, 0, 0,
+    0, 0, 0, 0, 0, 0, 1116, 892, 806, 1425, 972, 1009, 50, 0, 0, 0,
+    1310, 969, 0, 0, 1016, 235, 1369, 0, 0, 0, 0, 1817, 1782, 2016, 0, 1901,
+    983, 0, 0, 0, 1429, 0, 221, 0, 1399, 1835, 0, 959, 1243, 0, 0, 649,
+    1729, 1098, 1686, 991, 1679, 1819, 627, 479, 0, 1890, 0, 0, 0, 0, 0, 1353,
+    0, 582, 0, 17, 0, 0, 0, 0, 0, 0, 0, 303, 1250, 327, 0, 0,
+    0, 0, 502, 0, 0, 0, 0, 0, 0, 495, 0, 0, 613, 999, 1568, 0,
+    362, 0, 48, 0, 1792, 1257, 0, 0, 0, 543, 0, 0, 49, 0, 1720, 0,
+    1217, 0, 0, 0, 0, 142, 1357, 238, 1446, 217, 0, 0, 0, 1018, 1131, 0,
+    0, 924, 1365, 940, 0, 989, 1434, 0, 0, 0, 0, 0, 753, 1592, 0, 0,
+    601, 0, 1184, 1164, 1521, 293, 1546, 1051, 0, 0, 186, 0, 1841, 0, 0, 1584,
+    192, 1095, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 66, 0,
+    0, 0, 264, 0, 0, 325, 0, 1042, 0, 0, 0, 422, 1697, 0, 430, 0,
+    501, 1662, 2028, 1122, 0, 807, 0, 0, 0, 340, 0, 0, 797, 0, 38, 387,
+    0, 118, 1607, 1441, 1805, 56, 1871, 0, 0, 0, 1609, 917, 851, 1940, 1135, 57,
+    0, 157, 1975, 920, 0, 0, 0, 0, 1194, 734, 199, 0, 0, 617, 0, 645,
+    937, 468, 1085, 0, 523, 1673, 1457, 1748, 0, 0, 683, 0, 0, 0, 0, 2004,
+    0, 0, 1163, 1754, 1313, 1575, 0, 0, 0, 688, 207, 2034, 1996, 266, 1270, 1487,
+    499, 691, 0, 811, 409, 0, 0, 0, 1142, 0, 1766, 1810, 1417, 1569, 0, 512,
+    693, 378, 1414, 0, 0, 1629, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 1944, 0, 1221, 0, 0, 540, 0, 650,
+    946, 0, 0, 69, 1823, 567, 1867, 1945, 171, 0, 0, 981, 0, 1843, 211, 883,
+    0, 0, 0, 518, 1501, 212, 1267, 1977, 1449, 876, 0, 0, 0, 278, 483, 0,
+    0, 0, 0, 829, 0, 2038, 402, 0, 1324, 718, 0, 11, 1646, 997, 0, 0,
+    322, 0, 769, 0, 1148, 1712, 0, 0, 0, 0, 0, 698, 1773, 0, 1149, 389,
+    0, 0, 0, 0, 0, 0, 297, 4, 1281, 0, 369, 966, 0, 0, 0, 241,
+    0, 0, 0, 0, 0, 783, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    950, 230, 1029, 160, 0, 0, 0, 225, 0, 0, 859, 0, 0, 932, 1462, 0,
+    1305, 0, 758, 973, 1341, 108, 1538, 254, 1543, 0, 0, 0, 0, 0, 961, 1231,
+    0, 97, 0, 0, 1570, 0, 0, 0, 0, 1986, 0, 0, 0, 1536, 1655, 0,
+    0, 359, 0, 1316, 1118, 214, 1565, 0, 2043, 0, 0, 652, 1696, 364, 0, 1959,
+    1849, 1176, 1726, 0, 0, 790, 0, 752, 0, 1921, 1293, 0, 0, 0, 0, 1440,
+    1896, 0, 1875, 539, 572, 0, 0, 0, 928, 51, 0, 0, 934, 459, 0, 578,
+    1405, 482, 1641, 1836, 0, 1469, 198, 0, 1974, 1128, 0, 964, 0, 1472, 281, 726,
+    261, 0, 1825, 0, 707, 0, 407, 0, 0, 2037, 0, 1672, 311, 0, 1911, 716,
+    0, 1040, 265, 1224, 0, 1486, 1104, 0, 1322, 514, 0, 0, 0, 1759, 0, 0,
+    195, 0, 0, 0, 0, 0, 0, 0, 338, 1412, 1489, 0, 1107, 865, 1416, 1389,
+    1115, 0, 144, 0, 250, 0, 0, 0, 0, 0, 839, 0, 0, 253, 1384, 54,
+    0, 1803, 1368, 1220, 0, 0, 0, 1015, 0, 0, 0, 0, 0, 339, 635, 516,
+    1185, 220, 1307, 1094, 1604, 457, 1866, 0, 0, 128, 1329, 1938, 1078, 0, 0, 1242,
+    1684, 478, 770, 1082, 170, 1731, 1349, 0, 0, 589, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 326, 438, 0,
+    0, 0, 0, 0, 1420, 1102, 0, 1711, 0, 1158, 0, 0, 0, 138, 0, 1932,
+    1853, 754, 356, 0, 895, 757, 575, 0, 0, 1005, 1719, 671, 0, 1428, 2, 0,
+    1643, 1007, 0, 0, 0, 0, 462, 343, 234, 0, 0, 0, 610, 0, 0, 1376,
+    224, 469, 939, 450, 682, 738, 0, 0, 1304, 0, 879, 556, 872, 0, 634, 2021,
+    268, 1238, 1090, 963, 1537, 1736, 0, 32, 0, 1637, 202, 487, 1914, 0, 677, 0,
+    196, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 22, 0, 0, 0,
+    299, 492, 0, 155, 1771, 0, 0, 0, 363, 0, 1961, 421, 1695, 1658, 0, 0,
+    0, 0, 0, 967, 577, 0, 0, 0, 239, 0, 386, 0, 0, 0, 0, 0,
+    0, 0, 1848, 1066, 0, 1181, 117, 1904, 0, 0, 0, 747, 1859, 722, 1199, 0,
+    0, 0, 0, 919, 1897, 0, 0, 533, 0, 0, 0, 1912, 0, 0, 280, 0,
+    522, 2039, 1507, 1690, 0, 1983, 1671, 0, 908, 0, 936, 309, 0, 1401, 262, 0,
+    687, 0, 414, 135, 0, 0, 0, 321, 0, 1985, 0, 0, 779, 107, 275, 0,
+    1927, 0, 1141, 496, 0, 0, 1923, 105, 373, 914, 337, 511, 994, 1411, 1653, 0,
+    0, 1294, 154, 0, 1062, 0, 0, 0, 0, 127, 1382, 0, 397, 1882, 1632, 0,
+    1309, 0, 1366, 1219, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1123, 1527,
+    0, 475, 0, 0, 0, 728, 0, 0, 0, 167, 0, 1833, 476, 0, 0, 1616,
+    0, 1343, 0, 477, 0, 169, 0, 0, 772, 132, 0, 0, 0, 0, 0, 0,
+    65, 1190, 1485, 1550, 1994, 0, 1320, 0, 1562, 1579, 0, 0, 0, 0, 0, 1573,
+    0, 0, 0, 506, 0, 1659, 951, 0, 0, 2023, 0, 0, 0, 658, 0, 388,
+    0, 119, 1791, 398, 0, 1363, 0, 894, 0, 0, 1395, 0, 0, 0, 0, 0,
+    0, 1452, 0, 1297, 848, 1130, 342, 1356, 0, 958, 600, 58, 1783, 640, 78, 0,
+    1023, 1509, 0, 524, 1475, 1504, 0, 1675, 1838, 0, 0, 0, 0, 0, 1822, 0,
+    882, 222, 1340, 1208, 0, 1089, 0, 0, 0, 0, 0, 0, 1589, 580, 0, 0,
+    1544, 0, 0, 0, 0, 324, 0, 1929, 0, 1461, 0, 0, 0, 1816, 0, 0,
+    0, 0, 0, 0, 0, 1286, 1001, 420, 1272, 1172, 1119, 0, 0, 0, 1633, 0,
+    0, 1154, 1631, 0, 1371, 1878, 1796, 532, 993, 0, 0, 0, 0, 9, 2045, 571,
+    1126, 850, 1065, 0, 987, 0, 0, 0, 354, 1617, 1670, 568, 257, 1883, 744, 563,
+    1963, 449, 1295, 854, 897, 1681, 481, 827, 279, 1269, 0, 0, 122, 948, 165, 174,
+    0, 0, 1541, 0, 0, 0, 0, 0, 0, 1954, 0, 467, 308, 0, 1554, 1308,
+    0, 493, 0, 1079, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 137, 0,
+    0, 0, 0, 843, 0, 805, 0, 702, 0, 0, 0, 0, 1424, 0, 810, 0,
+    1764, 153, 0, 353, 0, 347, 1151, 0, 1171, 0, 145, 0, 0, 1391, 0, 1881,
+    233, 3, 0, 0, 0, 0, 0, 0, 0, 1943, 1337, 0, 0, 0, 0, 1027,
+    1872, 0, 0, 599, 0, 0, 0, 559, 0, 945, 986, 1741, 271, 0, 0, 0,
+    0, 0, 0, 0, 0, 762, 1248, 0, 0, 1677, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 1110, 0, 1484, 965, 654, 0, 1700, 89, 0, 0,
+    0, 0, 2029, 0, 1268, 0, 1716, 498, 0, 840, 0, 0, 0, 0, 0, 1772,
+    1004, 842, 903, 0, 1362, 804, 0, 1160, 0, 0, 0, 952, 1862, 0, 0, 809,
+    0, 0, 992, 158, 0, 0, 0, 0, 957, 0, 1515, 1473, 1195, 0, 1373, 0,
+    0, 2019, 1057, 0, 759, 1674, 710, 1025, 263, 0, 1059, 1244, 1503, 902, 1966, 681,
+    0, 853, 1245, 0, 121, 1088, 295, 0, 0, 0, 0, 0, 0, 1558, 134, 1583,
+    0, 813, 692, 490, 585, 0, 314, 0, 213, 0, 0, 0, 820, 1481, 0, 0,
+    838, 0, 1874, 570, 0, 0, 0, 0, 1010, 0, 0, 0, 996, 1144, 998, 0,
+    1276, 0, 0, 0, 0, 755, 0, 0, 0, 0, 0, 1903, 1894, 0, 1920, 0,
+    116, 1845, 0, 538, 0, 594, 1868, 0, 0, 0, 0, 0, 1465, 0, 0, 596,
+    61, 587, 0, 1978, 676, 1468, 637, 0, 1333, 1354, 0, 0, 858, 1161, 607, 111,
+    123, 0, 437, 706, 1236, 405, 283, 1689, 306, 984, 0, 0, 0, 85, 1806, 0,
+    0, 0, 0, 0, 0, 0, 1955, 1114, 0, 0, 1649, 616, 0, 1807, 0, 0,
+    104, 0, 0, 0, 690, 0, 0, 1234, 0, 0, 0, 0, 0, 0, 1179, 0,
+    0, 376, 0, 1274, 672, 352, 346, 0, 1512, 0, 0, 0, 218, 0, 1380, 0,
+    782, 226, 1802, 0, 528, 1463, 0, 76, 0, 668, 0, 590, 1781, 0, 2012, 1189,
+    1840, 1306, 1448, 0, 455, 255, 927, 0, 985, 0, 0, 0, 0, 0, 1623, 1946,
+    0, 817, 525, 203, 316, 1097, 35, 0, 1989, 1070, 1742, 0, 0, 1080, 0, 0,
+    0, 0, 0, 1549, 0, 0, 16, 0, 1034, 424, 1120, 1216, 0, 0, 0, 799,
+    0, 0, 0, 0, 1714, 0, 1924, 179, 0, 0, 1574, 0, 0, 1422, 1280, 0,
+    1511, 1851, 1626, 1296, 0, 841, 0, 355, 0, 1143, 887, 0, 1884, 1603, 0, 930,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 1456, 1303, 749, 631, 1982, 679, 1222,
+    1941, 0, 785, 70, 0, 286, 0, 709, 0, 555, 0, 184, 0, 87, 486, 0,
+    208, 764, 737, 1206, 1735, 1636, 1756, 0, 0, 0, 0, 0, 1557, 1760, 1335, 1493,
+    0, 0, 1951, 0, 0, 0, 313, 0, 1661, 909, 0, 1418, 21, 0, 2027, 0,
+    1767, 379, 0, 0, 1046, 0, 1958, 0, 0, 0, 1289, 0, 0, 0, 968, 0,
+    1794, 0, 1370, 0, 1770, 1011, 531, 103, 426, 1902, 0, 0, 0, 0, 0, 0,
+    1606, 537, 0, 0, 0, 0, 0, 845, 1919, 0, 1198, 603, 332, 0, 39, 1352,
+    1965, 1820, 0, 1229, 1680, 608, 1824, 1187, 1744, 1534, 0, 732, 725, 597, 565, 1733,
+    1595, 0, 0, 1746, 0, 0, 0, 0, 304, 0, 0, 0, 0, 1832, 1326, 912,
+    685, 0, 413, 102, 0, 1196, 739, 0, 42, 0, 0, 0, 0, 0, 1814, 139,
+    662, 0, 0, 0, 0, 0, 1271, 0, 0, 1006, 0, 1648, 0, 0, 0, 0,
+    1150, 375, 0, 0, 0, 0, 152, 350, 0, 0, 0, 0, 626, 1856, 243, 1447,
+    1460, 1618, 0, 0, 0, 0, 925, 1976, 1907, 0, 541, 72, 0, 856, 0, 1525,
+    0, 0, 473, 881, 1818, 0, 166, 1091, 1061, 1888, 0, 273, 944, 1676, 0, 1547,
+    0, 0, 0, 1315, 176, 0, 0, 0, 1259, 432, 0, 1956, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 720, 0, 686, 0, 1699, 0, 0, 0,
+    792, 808, 0, 0, 399, 34, 1880, 756, 0, 0, 666, 0, 0, 444, 0, 0,
+    0, 1905, 1159, 0, 0, 1360, 0, 1850, 918, 1864, 1394, 1876, 669, 0, 745, 1003,
+    1129, 833, 0, 0, 1442, 0, 1186, 0, 609, 1790, 1312, 0, 0, 1075, 646, 1788,
+    0, 0, 0, 1508, 0, 931, 0, 0, 869, 1682, 258, 2005, 554, 1909, 0, 960,
+    1168, 0, 1755, 1087, 0, 292, 0, 0, 1542, 0, 1763, 1949, 0, 0, 0, 0,
+    1560, 0, 96, 0, 0, 826, 1657, 312, 621, 1811, 1660, 1723, 0, 1707, 0, 1218,
+    1775, 694, 1152, 178, 1563, 0, 1400, 395, 1892, 0, 0, 0, 611, 1067, 0, 382,
+    0, 0, 1630, 0, 7, 789, 1435, 0, 0, 0, 0, 0, 0, 0, 0, 1439,
+    536, 1895, 1173, 1139, 0, 0, 0, 1972, 0, 982, 162, 1834, 0, 0, 0, 0,
+    163, 0, 0, 0, 1467, 465, 0, 1732, 1743, 0, 63, 435, 0, 0, 110, 0,
+    0, 0, 0, 0, 0, 0, 1688, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    319, 2032, 0, 0, 0, 0, 0, 0, 1962, 508, 0, 1140, 0, 0, 659, 1012,
+    0, 1650, 0, 0, 0, 0, 0, 140, 0, 1396, 0, 1877, 0, 836, 0, 0,
+    1789, 0, 1645, 886, 0, 392, 0, 0, 1598, 1694, 0, 1432, 1232, 2010, 0, 53,
+    1459, 1801, 2008, 470, 1049, 598, 1188, 0, 943, 0, 1056, 1404, 31, 1524, 0, 0,
+    454, 552, 187, 1409, 926, 294, 0, 0, 874, 161, 1348, 175, 0, 2035, 620, 767,
+    0, 1138, 1518, 0, 0, 0, 93, 1225, 0, 0, 0, 0, 124, 1593, 0, 1758,
+    0, 0, 615, 0, 1571, 0, 0, 0, 1291, 0, 1548, 0, 1698, 0, 1419, 0,
+    0, 1482, 1156, 1797, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1063, 0, 847,
+    0, 0, 0, 0, 0, 236, 1136, 0, 0, 0, 0, 748, 0, 0, 0, 1861,
+    0, 0, 1182, 2046, 0, 0, 1240, 0, 638, 0, 0, 629, 1981, 46, 1074, 988,
+    831, 83, 0, 0, 0, 1202, 1055, 80, 1458, 14, 0, 0, 0, 485, 0, 0,
+    1205, 0, 1300, 0, 44, 0, 0, 267, 1916, 0, 1488, 1334, 0, 0, 1844, 0,
+    488, 812, 1266, 497, 500, 1252, 0, 410, 665, 0, 0, 0, 0, 1495, 0, 1654,
+    0, 0, 837, 0, 1390, 394, 0, 181, 673, 0, 0, 1635, 0, 40, 445, 1264,
+    0, 0, 0, 0, 0, 550, 0, 168, 1787, 25, 0, 0, 0, 0, 1338, 1601,
+    0, 458, 1071, 1237, 1233, 1191, 1311, 1408, 849, 0, 329, 1831, 1134, 52, 0, 569,
+    0, 333, 1302, 0, 1228, 1466, 434, 164, 0, 731, 1952, 466, 126, 0, 1260, 773,
+    1812, 0, 1137, 0, 1567, 521, 0, 403, 0, 274, 526, 0, 1703, 715, 416, 0,
+    318, 954, 0, 183, 507, 2031, 1718, 0, 832, 0, 0, 0, 0, 0, 0, 0,
+    0, 1854, 242, 1627, 365, 0, 247, 5, 150, 1798, 370, 0, 1597, 0, 0, 1800,
+    0, 890, 1398, 534, 0, 0, 0, 0, 1517, 0, 0, 0, 0, 0, 1377, 1855,
+    1364, 0, 1014, 1971, 0, 0, 231, 75, 0, 0, 0, 0, 0, 0, 0, 0,
+    209, 1528, 1578, 0, 1169, 880, 1950, 619, 0, 1351, 1968, 0, 0, 684, 0, 1887,
+    1510, 43, 815, 0, 774, 0, 711, 0, 23, 0, 0, 0, 0, 0, 1656, 0,
+    0, 1032, 0, 657, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1290,
+    0, 0, 0, 384, 0, 0, 0, 1265, 0, 1426, 1262, 0, 0, 443, 0, 20,
+    0, 0, 0, 0, 0, 0, 1870, 1804, 1939, 245, 0, 0, 0, 896, 885, 1602,
+    252, 45, 0, 0, 0, 1470, 0, 0, 1455, 0, 0, 733, 868, 0, 0, 1999,
+    0, 330, 159, 680, 0, 0, 0, 0, 1204, 0, 0, 86, 0, 0, 0, 1054,
+    431, 0, 18, 1753, 1227, 1105, 1166, 133, 0, 0, 19, 0, 1588, 700, 0, 0,
+    0, 0, 0, 0, 1106, 0, 0, 1779, 860, 1928, 823, 0, 0, 0, 391, 0,
+    802, 0, 0, 0, 393, 0, 0, 0, 0, 0, 864, 0, 1287, 0, 251, 1857,
+    1628, 146, 0, 530, 2015, 743, 0, 0, 663, 0, 0, 0, 0, 1050, 795, 977,
+    0, 0, 0, 0, 0, 68, 1350, 751, 1330, 0, 0, 605, 595, 592, 0, 0,
+    867, 1685, 1301, 1728, 0, 0, 1506, 636, 730, 0, 0, 433, 109, 1230, 259, 1784,
+    1033, 0, 0, 0, 0, 0, 1249, 0, 1702, 0, 0, 189, 0, 1947, 819, 714,
+    0, 1318, 0, 101, 91, 1147, 0, 0, 1647, 0, 1516, 1995, 0, 0, 0, 776,
+    0, 0, 0, 1777, 0, 1000, 0, 661, 0, 0, 0, 651, 149, 0, 664, 357,
+    0, 0, 0, 922, 1444, 0, 0, 344, 978, 1693, 0, 0, 1917, 0, 41, 0,
+    1256, 1520, 71, 0, 1826, 0, 0, 0, 1942, 0, 1403, 0, 1829, 0, 1013, 120,
+    269, 453, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1591, 581, 1762, 1336, 760,
+    1809, 197, 814, 491, 586, 0, 0, 1314, 0, 0, 0, 0, 1757, 0, 0, 0,
+    862, 1768, 0, 300, 0, 0, 1889, 0, 0, 0, 1153, 0, 0, 0, 439, 1634,
+    1278, 622, 655, 0, 0, 147, 1780, 1879, 0, 0, 0, 0, 0, 1392, 0, 796,
+    0, 0, 0, 741, 1613, 1017, 1127, 440, 0, 0, 0, 916, 1860, 0, 27, 0,
+    628, 0, 1622, 0, 1730, 1979, 1611, 1522, 1973, 0, 206, 1084, 201, 678, 990, 644,
+    113, 260, 0, 0, 0, 0, 0, 0, 1839, 2036, 310, 1969, 1058, 0, 79, 0,
+    415, 0, 1922, 712, 92, 1619, 1165, 1925, 0, 0, 801, 0, 0, 1587, 82, 0,
+    0, 0, 844, 0, 0, 408, 0, 0, 0, 1178, 1722, 0, 1494, 0, 2026, 151,
+    0, 0, 358, 0, 0, 976, 1774, 0, 1263, 1317, 0, 0, 244, 1514, 1383, 0,
+    0, 227, 624, 0, 0, 905, 1367, 0, 515, 742, 1967, 1438, 148, 1499, 77, 0,
+    136, 535, 73, 0, 1529, 0, 1052, 59, 0, 1093, 0, 0, 0, 0, 0, 0,
+    979, 81, 0, 0, 0, 0, 729, 1535, 1246, 62, 1505, 1615, 0, 0, 277, 0,
+    0, 0, 1960, 0, 0, 0, 0, 0, 0, 0, 0, 425, 0, 1174, 0, 0,
+    0, 0, 0, 1038, 1717, 835, 0, 780, 0, 0, 0, 0, 0, 0, 0, 0,
+    1991, 1047, 0, 2024, 0, 0, 0, 0, 1863, 670, 334, 368, 0, 1885, 0, 0,
+    1298, 1898, 0, 249, 0, 0, 0, 0, 216, 0, 0, 1375, 1474, 1891, 1200, 463,
+    0, 1346, 223, 229, 0, 1785, 0, 1076, 1477, 878, 1828, 1402, 1908, 291, 1752, 0,
+    0, 1738, 873, 0, 1590, 1030, 618, 0, 1101, 1821, 1327, 272, 1036, 1638, 0, 0,
+    0, 1561, 0, 106, 0, 0, 0, 1915, 130, 763, 0, 0, 0, 0, 1808, 1815,
+    1564, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1111, 1935, 1211, 0, 0,
+    0, 1155, 0, 0, 0, 1713, 703, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 1847, 0, 0, 0, 0, 461, 0, 0, 0, 0, 0, 0, 1858, 1936, 893,
+    1454, 1083, 904, 1910, 0, 0, 0, 0, 1345, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 1581, 0, 0, 13, 0, 719, 0, 406, 527, 1555, 290,
+    0, 0, 1035, 320, 0, 494, 0, 0, 0, 0, 0, 0, 0, 0, 579, 778,
+    367, 0, 0, 0, 1323, 0, 953, 0, 1706, 0, 0, 0, 1283, 0, 1388, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 1433, 219, 0, 0, 0, 0, 1381, 0,
+    2014, 548, 0, 0, 1786, 1532, 544, 0, 452, 200, 1526, 2022, 1464, 933, 591, 800,
+    456, 604, 1299, 474, 949, 1407, 0, 256, 1586, 553, 724, 0, 761, 0, 786, 0,
+    520, 1193, 1678, 464, 0, 0, 0, 1081, 0, 0, 1545, 0, 2048, 551, 125, 276,
+    0, 0, 0, 0, 0, 0, 0, 947, 1992, 436, 0, 1572, 1701, 822, 1112, 818,
+    1666, 385, 412, 1279, 0, 100, 2030, 0, 1480, 0, 0, 1423, 0, 0, 775, 1,
+    0, 0, 1852, 0, 0, 0, 574, 0, 660, 1865, 750, 0, 0, 0, 0, 0,
+    1513, 0, 0, 1374, 0, 0, 0, 0, 0, 632, 1692, 0, 639, 0, 2009, 1431,
+    1203, 30, 1899, 2020, 0, 0, 0, 0, 1827, 0, 962, 0, 871, 788, 0, 0,
+    1207, 0, 1478, 727, 0, 1577, 0, 1162, 472, 766, 560, 1984, 0, 2001, 88, 1559,
+    0, 0, 0, 0, 0, 0, 315, 1045, 1709, 0, 0, 0, 287, 821, 0, 0,
+    0, 1415, 381, 0, 697, 656, 0, 1765, 1931, 0, 0, 0, 0, 0, 0, 0,
+    1277, 1121, 1002, 0, 8, 0, 0, 0, 2017, 0, 0, 0, 0, 0, 0, 0,
+    0, 675, 793, 1846, 1359, 0, 1869, 0, 1608, 915, 1125, 0, 1133, 0, 0, 606,
+    588, 1610, 1451, 1737, 0, 0, 204, 74, 0, 1621, 643, 0, 1980, 0, 1073, 429,
+    1551, 0, 830, 1913, 0, 0, 1355, 284, 307, 0, 84, 419, 0, 289, 1553, 913,
+    0, 0, 0, 0, 0, 1103, 1210, 1993, 1596, 510, 0, 777, 0, 0, 699, 0,
+    1778, 390, 95, 302, 0, 0, 1873, 1652, 0, 0, 372, 0, 0, 1727, 1552, 0,
+    377, 0, 448, 0, 0, 0, 1624, 0, 0, 0, 1235, 0, 0, 1599, 564, 0,
+    0, 980, 0, 0, 6, 529, 1437, 1600, 60, 0, 1347, 689, 1500, 2013, 857, 0,
+    602, 0, 1328, 1830, 0, 0, 0, 0, 0, 210, 0, 0, 188, 1170, 2003, 0,
+    910, 0, 1068, 884, 191, 1247, 317, 194, 1031, 781, 875, 771, 1683, 1990, 0, 0,
+    1319, 98, 907, 0, 1739, 401, 1594, 0, 1926, 0, 0, 861, 0, 0, 0, 360,
+    0, 1665, 47, 0, 1715, 0, 1292, 442, 1157, 505, 0, 0, 0, 1213, 0, 0,
+    301, 0, 1386, 0, 1361, 0, 0, 0, 0, 0, 0, 0, 888, 0, 0, 28,
+    0, 784, 0, 921, 1443, 1642, 0, 0, 1445, 0, 1644, 349, 0, 1028, 1372, 647,
+    1021, 0, 26, 1183, 0, 1048, 1750, 1751, 451, 877, 942, 1223, 1077, 0, 1476, 717,
+    1761, 0, 0, 713, 1406, 185, 562, 1948, 1582, 0, 1640, 0, 1108, 583, 557, 765,
+    37, 0, 0, 489, 0, 975, 704, 0, 2041, 427, 1708, 995, 1934, 0, 1041, 513,
+    653, 696, 380, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    1725, 906, 94, 547, 446, 0, 1795, 441, 0, 0, 971, 0, 1226, 0, 1124, 0,
+    0, 0, 0, 740, 1358, 0, 0, 955, 0, 1008, 0, 1669, 1072, 0, 787, 0,
+    0, 0, 0, 173, 36, 1620, 460, 0, 1453, 0, 0, 0, 0, 0, 2011, 1998,
+    0, 1747, 0, 404, 0, 0, 0, 0, 305, 288, 0, 90, 0, 0, 1251, 418,
+    1043, 1704, 1113, 0, 323, 0, 0, 0, 0, 0, 1273, 0, 0, 0, 180, 0,
+    1397, 0, 1039, 0, 0, 0, 298, 0, 2025, 1705, 1387, 1799, 1721, 889, 336, 1813,
+    351, 0, 0, 2007, 0, 0, 345, 0, 0, 0, 0, 0, 705, 0, 0, 1379,
+    0, 0, 232, 0, 1498, 0, 1026, 67, 1612, 1900, 0, 0, 0, 721, 0, 0,
+    828, 270, 0, 0, 33, 1540, 1132, 0, 0, 248, 0, 0, 1530, 0, 0, 1842,
+    0, 825, 1019, 0, 193, 0, 0, 1255, 0, 1988, 0, 1957, 411, 0, 15, 0,
+    1651, 0, 0, 0, 866, 1491, 1254, 400, 1483, 0, 0, 423, 898, 2044, 1566, 911,
+    852, 1664, 956, 0, 0, 1146, 99, 0, 0, 0, 341, 504, 1393, 1421, 0, 798,
+    0, 667, 0, 10, 237, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1614, 240
+};
+
+int dogecoin_bip39_word_index(const char* word, size_t len) {
+    uint32_t key = 0;
+    size_t i;
+
+    if (len < 3 || len > 8)
+        return -1;
+    for (i = 0; i < 4 && i < len; i++) {
+        key |= (uint32_t)(uint8_t)word[i] << (8 * i);
+    }
+    const uint32_t bucket = (key * 0x9e3779b1u) >> 23;
+    const uint32_t slot = (((key * 0x85ebca77u) >> 20) ^ bip39_english_disp[bucket]) & (BIP39_HASH_SLOTS - 1);
+    const int index = (int)bip39_english_slots[slot] - 1;
+    if (index < 0)
+        return -1;
+    // the prefix only picks the candidate, the whole word has to match
+    const char* candidate = dogecoin_bip39_wordlist_english[index];
+    if (strncmp(candidate, word, len) != 0 || candidate[len] != '\0')
+        return -1;
+    return index;
+}
@@ -0,0 +1,353 @@
+/*
+
+ The MIT License (MIT)
+
+ Copyright (c) 2022 The Dogecoin Foundation
+
+ Permission is hereby granted, free of charge, to any person obtaining
+ a copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES
+ OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+#ifdef HAVE_CONFIG_H
+#  include <src/libdogecoin-config.h>
+#endif
+
+#include <string.h>
+
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
+#include <dogecoin/block.h>
+#include <dogecoin/buffer.h>
+#include <dogecoin/crypto/hash.h>
+#include <dogecoin/crypto/scrypt.h>
+#include <dogecoin/mem.h>
+#include <dogecoin/serialize.h>
+
+dogecoin_bool dogecoin_block_header_deserialize(const unsigned char* header_serialized, size_t inlen, dogecoin_block_header* header) {
+    struct const_buffer buf = {header_serialized, inlen};
+    if (!deser_s32(&header->version, &buf))
+        return false;
+    if (!deser_u256(header->prev_block, &buf))
+        return false;
+    if (!deser_u256(header->merkle_root, &buf))
+        return false;
+    if (!deser_u32(&header->timestamp, &buf))
+        return false;
+    if (!deser_u32(&header->bits, &buf))
+        return false;
+    if (!deser_u32(&header->nonce, &buf))
+        return false;
+    return true;
+}
+
+void dogecoin_block_header_serialize(cstring* s, const dogecoin_block_header* header) {
+    ser_s32(s, header->version);
+    ser_u256(s, header->prev_block);
+    ser_u256(s, header->merkle_root);
+    ser_u32(s, header->timestamp);
+    ser_u32(s, header->bits);
+    ser_u32(s, header->nonce);
+}
+
+void dogecoin_block_header_hash(const dogecoin_block_header* header, uint256 hash) {
+    cstring* s = cstr_new_sz(DOGECOIN_BLOCK_HEADER_SIZE);
+    dogecoin_block_header_serialize(s, header);
+    dogecoin_hash((const uint8_t*)s->str, s->len, hash);
+    cstr_free(s, true);
+}
+
+void dogecoin_block_header_pow_hash(const dogecoin_block_header* header, uint256 hash) {
+    cstring* s = cstr_new_sz(DOGECOIN_BLOCK_HEADER_SIZE);
+    dogecoin_block_header_serialize(s, header);
+    scrypt_1024_1_1_256((const uint8_t*)s->str, hash);
+    cstr_free(s, true);
+}
+
+void dogecoin_block_header_pow_hash_batch(const dogecoin_block_header* headers, size_t n, uint256* hashes) {
+    size_t i;
+    cstring* s = cstr_new_sz(n * DOGECOIN_BLOCK_HEADER_SIZE);
+    for (i = 0; i < n; i++) {
+        dogecoin_block_header_serialize(s, &headers[i]);
+    }
+    scrypt_1024_1_1_256_batch((uint8_t*)hashes, (const uint8_t*)s->str, n);
+    cstr_free(s, true);
+}
+
+dogecoin_bool dogecoin_block_header_check_pow(const dogecoin_block_header* header, const uint256 pow_hash) {
+    const uint32_t size = header->bits >> 24;
+    uint32_t mantissa = header->bits & 0x007fffff;
+    uint256 target;
+    int i;
+
+    // compact encoding: mantissa * 256^(size - 3), negative or overflowing targets are invalid
+    if (mantissa == 0 || (header->bits & 0x00800000) || size > 32u + (mantissa <= 0xffff) + (mantissa <= 0xff))
+        return false;
+    memset(target, 0, sizeof(target));
+    if (size <= 3) {
+        mantissa >>= 8 * (3 - size);
+        if (mantissa == 0)
+            return false;
+        for (i = 0; i < 3; i++) {
+            target[i] = (uint8_t)(mantissa >> (8 * i));
+        }
+    } else {
+        for (i = 0; i < 3 && size - 3 + i < 32; i++) {
+            target[size - 3 + i] = (uint8_t)(mantissa >> (8 * i));
+        }
+    }
+    // both are little endian 256 bit numbers
+    for (i = DOGECOIN_HASH_LENGTH - 1; i >= 0; i--) {
+        if (pow_hash[i] != target[i])
+            return pow_hash[i] < target[i];
+    }
+    return true;
+}
+
+static void dogecoin_block_tx_free_cb(void* data) {
+    dogecoin_tx_free(data);
+}
+
+dogecoin_block* dogecoin_block_new() {
+    dogecoin_block* block = dogecoin_calloc(1, sizeof(*block));
+    block->txs = vector_new(1, dogecoin_block_tx_free_cb);
+    return block;
+}
+
+void dogecoin_block_free(dogecoin_block* block) {
+    if (!block)
+        return;
+    if (block->auxpow)
+        cstr_free(block->auxpow, true);
+    if (block->txs)
+        vector_free(block->txs, true);
+    if (block->txids)
+        dogecoin_free(block->txids);
+    dogecoin_free(block);
+}
+
+// drop the content of a previous deserialize so a block can be reused
+static void dogecoin_block_reset(dogecoin_block* block) {
+    if (block->auxpow) {
+        cstr_free(block->auxpow, true);
+        block->auxpow = NULL;
+    }
+    if (block->txs)
+        vector_resize(block->txs, 0);
+    else
+        block->txs = vector_new(1, dogecoin_block_tx_free_cb);
+    if (block->txids) {
+        dogecoin_free(block->txids);
+        block->txids = NULL;
+    }
+    memset(block->merkle_root, 0, DOGECOIN_HASH_LENGTH);
+    block->merkle_mutated = false;
+}
+
+static dogecoin_bool dogecoin_block_skip_hashes(struct const_buffer* buf) {
+    uint32_t count;
+    if (!deser_varlen(&count, buf))
+        return false;
+    if (count > buf->len / DOGECOIN_HASH_LENGTH)
+        return false;
+    return deser_skip(buf, (size_t)count * DOGECOIN_HASH_LENGTH);
+}
+
+// coinbase tx of the parent chain, block hash, coinbase merkle branch + index,
+// chain merkle branch + index, parent block header
+static dogecoin_bool dogecoin_block_skip_auxpow(struct const_buffer* buf) {
+    dogecoin_tx_view view;
+    size_t consumed = 0;
+    if (!dogecoin_tx_view_parse(&view, buf->p, buf->len, &consumed, false))
+        return false;
+    if (!deser_skip(buf, consumed))
+        return false;
+    if (!deser_skip(buf, DOGECOIN_HASH_LENGTH))
+        return false;
+    if (!dogecoin_block_skip_hashes(buf) || !deser_skip(buf, 4))
+        return false;
+    if (!dogecoin_block_skip_hashes(buf) || !deser_skip(buf, 4))
+        return false;
+    return deser_skip(buf, DOGECOIN_BLOCK_HEADER_SIZE);
+}
+
+void dogecoin_block_merkle_root(const uint256* hashes, size_t num_hashes, uint256 root, dogecoin_bool* mutated) {
+    dogecoin_bool is_mutated = false;
+    size_t i, level_len = num_hashes;
+
+    if (mutated)
+        *mutated = false;
+    if (num_hashes == 0) {
+        memset(root, 0, DOGECOIN_HASH_LENGTH);
+        return;
+    }
+
+    // one spare slot for duplicating the last hash of an odd level
+    uint8_t* level = dogecoin_malloc((num_hashes + 1) * DOGECOIN_HASH_LENGTH);
+    memcpy(level, hashes, num_hashes * DOGECOIN_HASH_LENGTH);
+    while (level_len > 1) {
+        for (i = 0; i + 1 < level_len; i += 2) {
+            if (memcmp(level + i * DOGECOIN_HASH_LENGTH, level + (i + 1) * DOGECOIN_HASH_LENGTH, DOGECOIN_HASH_LENGTH) == 0)
+                is_mutated = true;
+        }
+        if (level_len & 1) {
+            memcpy(level + level_len * DOGECOIN_HASH_LENGTH, level + (level_len - 1) * DOGECOIN_HASH_LENGTH, DOGECOIN_HASH_LENGTH);
+            level_len++;
+        }
+        level_len /= 2;
+        // in place: a level is hashed on the batch lanes into the front of its own buffer
+        dogecoin_hash_64_batch(level, level_len, (uint256*)level);
+    }
+    memcpy(root, level, DOGECOIN_HASH_LENGTH);
+    dogecoin_free(level);
+    if (mutated)
+        *mutated = is_mutated;
+}
+
+dogecoin_bool dogecoin_block_check_merkle_root(const dogecoin_block* block) {
+    return !block->merkle_mutated && memcmp(block->merkle_root, block->header.merkle_root, DOGECOIN_HASH_LENGTH) == 0;
+}
+
+typedef struct dogecoin_block_parse_job_ {
+    const unsigned char* data;
+    const size_t* offsets;  // num_txs + 1 entries, tx i spans offsets[i]..offsets[i+1]
+    dogecoin_tx** txs;
+    uint256* txids;
+    size_t start, end;
+    dogecoin_bool ok;
+} dogecoin_block_parse_job;
+
+// deserialize and hash a contiguous range of txs, only touches its own slots
+static void* dogecoin_block_parse_worker(void* arg) {
+    dogecoin_block_parse_job* job = arg;
+    size_t i;
+    job->ok = true;
+    for (i = job->start; i < job->end; i++) {
+        const size_t len = job->offsets[i + 1] - job->offsets[i];
+        size_t consumed = 0;
+        dogecoin_tx* tx = dogecoin_tx_new();
+        job->txs[i] = tx;
+        if (!dogecoin_tx_deserialize(job->data + job->offsets[i], len, tx, &consumed, true) || consumed != len) {
+            job->ok = false;
+            return NULL;
+        }
+        dogecoin_tx_hash(tx, job->txids[i]);
+    }
+    return NULL;
+}
+
+dogecoin_bool dogecoin_block_deserialize(const unsigned char* block_serialized, size_t inlen, dogecoin_block* block, size_t* consumed_length, unsigned int num_threads) {
+    struct const_buffer buf = {block_serialized, inlen};
+    size_t i;
+    if (consumed_length)
+        *consumed_length = 0;
+    dogecoin_block_reset(block);
+
+    if (!dogecoin_block_header_deserialize(block_serialized, inlen, &block->header))
+        return false;
+    deser_skip(&buf, DOGECOIN_BLOCK_HEADER_SIZE);
+
+    if (block->header.version & DOGECOIN_BLOCK_VERSION_AUXPOW) {
+        const unsigned char* auxpow_start = buf.p;
+        if (!dogecoin_block_skip_auxpow(&buf))
+            return false;
+        block->auxpow = cstr_new_buf(auxpow_start, (const unsigned char*)buf.p - auxpow_start);
+    }
+
+    uint32_t num_txs;
+    if (!deser_varlen(&num_txs, &buf))
+        return false;
+    // every tx needs at least 10 bytes, reject absurd counts before allocating
+    if (num_txs > buf.len / 10)
+        return false;
+
+    // find the tx boundaries with a non allocating view walk, the txs can then be parsed independently
+    size_t* offsets = dogecoin_malloc(((size_t)num_txs + 1) * sizeof(size_t));
+    offsets[0] = inlen - buf.len;
+    for (i = 0; i < num_txs; i++) {
+        dogecoin_tx_view view;
+        size_t consumed = 0;
+        if (!dogecoin_tx_view_parse(&view, buf.p, buf.len, &consumed, true) || !deser_skip(&buf, consumed)) {
+            dogecoin_free(offsets);
+            return false;
+        }
+        offsets[i + 1] = inlen - buf.len;
+    }
+
+    dogecoin_tx** txs = dogecoin_calloc(num_txs ? num_txs : 1, sizeof(dogecoin_tx*));
+    block->txids = dogecoin_calloc(num_txs ? num_txs : 1, sizeof(uint256));
+
+    if (num_threads < 1)
+        num_threads = 1;
+    if (num_threads > num_txs)
+        num_threads = num_txs ? num_txs : 1;
+    dogecoin_block_parse_job* jobs = dogecoin_calloc(num_threads, sizeof(dogecoin_block_parse_job));
+    for (i = 0; i < num_threads; i++) {
+        jobs[i].data = block_serialized;
+        jobs[i].offsets = offsets;
+        jobs[i].txs = txs;
+        jobs[i].txids = block->txids;
+        jobs[i].start = num_txs * i / num_threads;
+        jobs[i].end = num_txs * (i + 1) / num_threads;
+    }
+
+    size_t done = 0;
+#ifdef HAVE_PTHREAD
+    if (num_threads > 1) {
+        pthread_t* threads = dogecoin_calloc(num_threads, sizeof(pthread_t));
+        size_t started = 0;
+        // the calling thread takes the first range
+        for (started = 1; started < num_threads; started++) {
+            if (pthread_create(&threads[started], NULL, dogecoin_block_parse_worker, &jobs[started]) != 0)
+                break;
+        }
+        dogecoin_block_parse_worker(&jobs[0]);
+        for (i = 1; i < started; i++) {
+            pthread_join(threads[i], NULL);
+        }
+        dogecoin_free(threads);
+        done = started;
+    }
+#endif
+    // single threaded (or pthreads not available), run the ranges that were not picked up
+    for (i = done; i < num_threads; i++) {
+        dogecoin_block_parse_worker(&jobs[i]);
+    }
+
+    dogecoin_bool ok = true;
+    for (i = 0; i < num_threads; i++) {
+        ok = ok && jobs[i].ok;
+    }
+    for (i = 0; i < num_txs; i++) {
+        if (txs[i])
+            vector_add(block->txs, txs[i]);
+    }
+    dogecoin_free(jobs);
+    dogecoin_free(txs);
+    dogecoin_free(offsets);
+    if (!ok)
+        return false;
+
+    dogecoin_block_merkle_root((const uint256*)block->txids, num_txs, block->merkle_root, &block->merkle_mutated);
+
+    if (consumed_length)
+        *consumed_length = inlen - buf.len;
+    return true;
+}
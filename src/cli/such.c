@@ -42,6 +42,7 @@
 #include <dogecoin/tool.h>
 #include <dogecoin/tx.h>
 #include <dogecoin/utils.h>
+#include <dogecoin/vanity.h>
 
 static struct option long_options[] =
 {
@@ -49,6 +50,8 @@ static struct option long_options[] =
     {"pubkey", required_argument, NULL, 'k'},
     {"derived_path", required_argument, NULL, 'm'},
     {"command", required_argument, NULL, 'c'},
+    {"prefix", required_argument, NULL, 'x'},
+    {"threads", required_argument, NULL, 'j'},
     {"testnet", no_argument, NULL, 't'},
     {"regtest", no_argument, NULL, 'r'},
     {"version", no_argument, NULL, 'v'},
@@ -62,11 +65,23 @@ static void print_version() {
 static void print_usage() {
     print_version();
     printf("Usage: such (-m|-derived_path <bip_derived_path>) (-k|-pubkey <publickey>) (-p|-privkey <privatekey>) (-t[--testnet]) (-r[--regtest]) -c <command>\n");
-    printf("Available commands: generate_public_key (requires -p <wif>), p2pkh (requires -k <public key hex>), generate_private_key, bip32_extended_master_key, print_keys (requires -p <private key hex>), derive_child_keys (requires -m <custom path> -p <private key>) \n");
+    printf("Available commands: generate_public_key (requires -p <wif>), p2pkh (requires -k <public key hex>), generate_private_key, bip32_extended_master_key, print_keys (requires -p <private key hex>), derive_child_keys (requires -m <custom path> -p <private key>), vanity (requires -x <address prefix>, optional -j <threads>) \n");
     printf("\nExamples: \n");
     printf("Generate a testnet private ec keypair wif/hex:\n");
     printf("> such -c generate_private_key\n\n");
     printf("> such -c generate_public_key -p QRYZwxVxBFKgKP4bWPEwWBJpN3C3cTN6fads8SgJTgaPTJhEWgLH\n\n");
+    printf("Search a mainnet address starting with DShop on 4 threads:\n");
+    printf("> such -c vanity -x DShop -j 4\n\n");
+}
+
+static void print_vanity_progress(const dogecoin_vanity_progress* progress, void* user_data) {
+    (void)user_data;
+    if (progress->found) {
+        printf("\rtried %llu keys in %.1fs (%.0f keys/s)                    \n", (unsigned long long)progress->keys, progress->elapsed, progress->keys_per_sec);
+        return;
+    }
+    printf("\r%.0f keys/s, %llu keys tried, eta %.0fs (50%% chance)   ", progress->keys_per_sec, (unsigned long long)progress->keys, progress->eta);
+    fflush(stdout);
 }
 
 static bool showError(const char *er)
@@ -84,10 +99,12 @@ int main(int argc, char *argv[])
     char* pubkey    = 0;
     char* cmd       = 0;
     char *derived_path = 0;
+    char* prefix    = 0;
+    unsigned int threads = 1;
     const dogecoin_chainparams* chain = &dogecoin_chainparams_main;
 
     /* get arguments */
-    while ((opt = getopt_long_only(argc, argv,"p:k:m:c:trv", long_options, &long_index )) != -1) {
+    while ((opt = getopt_long_only(argc, argv,"p:k:m:c:x:j:trv", long_options, &long_index )) != -1) {
         switch (opt) {
             case 'p' :
                 pkey = optarg;
@@ -100,6 +117,13 @@ int main(int argc, char *argv[])
                 break;
             case 'k' : pubkey = optarg;
                 break;
+            case 'x' : prefix = optarg;
+                break;
+            case 'j' :
+                threads = (unsigned int)atoi(optarg);
+                if (threads < 1)
+                    return showError("Thread count must be at least 1");
+                break;
             case 't' :
                 chain = &dogecoin_chainparams_test;
                 break;
@@ -219,6 +243,32 @@ int main(int argc, char *argv[])
         else
             hd_print_node(chain, newextkey);
     }
+    else if (strcmp(cmd, "vanity") == 0)
+    {
+        dogecoin_vanity_pattern pattern;
+        dogecoin_key key;
+        dogecoin_pubkey pubkey;
+        size_t sizeout = 128;
+        char privkey_wif[sizeout];
+        char address_p2pkh[sizeout];
+
+        if (!prefix)
+            return showError("no address prefix (-x)");
+        if (!dogecoin_vanity_pattern_init(&pattern, prefix, chain))
+            return showError("no address can start with this prefix");
+        printf("searching %s on %u threads, about %.0f keys per match\n", prefix, threads, pattern.difficulty);
+        if (!dogecoin_vanity_search(&pattern, threads, 0, print_vanity_progress, NULL, &key))
+            return showError("vanity search failed");
+
+        dogecoin_pubkey_init(&pubkey);
+        dogecoin_pubkey_from_key(&key, &pubkey);
+        dogecoin_pubkey_getaddr_p2pkh(&pubkey, chain, address_p2pkh);
+        dogecoin_privkey_encode_wif(&key, chain, privkey_wif, &sizeout);
+        printf("private key wif: %s\n", privkey_wif);
+        printf("p2pkh address: %s\n", address_p2pkh);
+        dogecoin_privkey_cleanse(&key);
+        memset(privkey_wif, 0, strlen(privkey_wif));
+    }
 
 
     dogecoin_ecc_stop();
@@ -0,0 +1,432 @@
+/*
+
+ The MIT License (MIT)
+
+ Copyright (c) 2022 The Dogecoin Foundation
+
+ Permission is hereby granted, free of charge, to any person obtaining
+ a copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES
+ OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <dogecoin/coinselect.h>
+#include <dogecoin/crypto/random.h>
+#include <dogecoin/mem.h>
+#include <dogecoin/serialize.h>
+
+// outpoint (36) + sequence (4)
+#define DOGECOIN_COINSELECT_INPUT_BASE_SIZE 40
+// value (8) + script length (1) + p2pkh script (25)
+#define DOGECOIN_COINSELECT_CHANGE_OUTPUT_SIZE 34
+// script push of a DER signature plus hashtype
+#define DOGECOIN_COINSELECT_SIG_PUSH_SIZE 73
+// script push of a compressed pubkey
+#define DOGECOIN_COINSELECT_PUBKEY_PUSH_SIZE 34
+
+uint32_t dogecoin_coinselect_input_size(enum dogecoin_tx_out_type type) {
+    switch (type) {
+        case DOGECOIN_TX_PUBKEY:
+            return DOGECOIN_COINSELECT_INPUT_BASE_SIZE + 1 + DOGECOIN_COINSELECT_SIG_PUSH_SIZE;
+        case DOGECOIN_TX_SCRIPTHASH:
+            // p2sh-p2wpkh (as created by dogecoin_tx_sign_input): 23 byte scriptSig, witness counts a quarter
+            return DOGECOIN_COINSELECT_INPUT_BASE_SIZE + 1 + 23 + (1 + DOGECOIN_COINSELECT_SIG_PUSH_SIZE + DOGECOIN_COINSELECT_PUBKEY_PUSH_SIZE + 3) / 4;
+        case DOGECOIN_TX_WITNESS_V0_PUBKEYHASH:
+            return DOGECOIN_COINSELECT_INPUT_BASE_SIZE + 1 + (1 + DOGECOIN_COINSELECT_SIG_PUSH_SIZE + DOGECOIN_COINSELECT_PUBKEY_PUSH_SIZE + 3) / 4;
+        case DOGECOIN_TX_MULTISIG:
+            // unknown signature count, assume 2 (OP_0 + two signatures)
+            return DOGECOIN_COINSELECT_INPUT_BASE_SIZE + 1 + 1 + 2 * DOGECOIN_COINSELECT_SIG_PUSH_SIZE;
+        case DOGECOIN_TX_PUBKEYHASH:
+        default:
+            // nonstandard and witness scripthash are estimated like p2pkh
+            return DOGECOIN_COINSELECT_INPUT_BASE_SIZE + 1 + DOGECOIN_COINSELECT_SIG_PUSH_SIZE + DOGECOIN_COINSELECT_PUBKEY_PUSH_SIZE;
+    }
+}
+
+uint32_t dogecoin_coinselect_script_input_size(const cstring* script_pubkey, enum dogecoin_tx_out_type* type_out) {
+    enum dogecoin_tx_out_type type = dogecoin_script_classify(script_pubkey, NULL);
+    if (type_out)
+        *type_out = type;
+    if (type == DOGECOIN_TX_MULTISIG) {
+        // OP_m <pubkeys> OP_n OP_CHECKMULTISIG, spent with OP_0 <m signatures>
+        const uint32_t required = (uint8_t)script_pubkey->str[0] - OP_1 + 1;
+        const uint32_t script_sig_len = 1 + required * DOGECOIN_COINSELECT_SIG_PUSH_SIZE;
+        return DOGECOIN_COINSELECT_INPUT_BASE_SIZE + (uint32_t)ser_varlen_size(script_sig_len) + script_sig_len;
+    }
+    return dogecoin_coinselect_input_size(type);
+}
+
+static int64_t dogecoin_coinselect_fee(uint64_t fee_per_kb, uint32_t size) {
+    return (int64_t)(fee_per_kb * size / 1000);
+}
+
+// xorshift64*, only used to randomize the search, not for anything secret
+typedef struct dogecoin_coinselect_rng_ {
+    uint64_t state;
+    uint64_t bits;
+    unsigned int num_bits;
+} dogecoin_coinselect_rng;
+
+static void dogecoin_coinselect_rng_init(dogecoin_coinselect_rng* rng) {
+    rng->state = 0;
+    rng->num_bits = 0;
+    dogecoin_random_bytes((uint8_t*)&rng->state, sizeof(rng->state), 0);
+    if (rng->state == 0)
+        rng->state = 0x9e3779b97f4a7c15ULL;
+}
+
+static uint64_t dogecoin_coinselect_rng_next(dogecoin_coinselect_rng* rng) {
+    rng->state ^= rng->state >> 12;
+    rng->state ^= rng->state << 25;
+    rng->state ^= rng->state >> 27;
+    return rng->state * 0x2545f4914f6cdd1dULL;
+}
+
+static int dogecoin_coinselect_rng_bit(dogecoin_coinselect_rng* rng) {
+    if (rng->num_bits == 0) {
+        rng->bits = dogecoin_coinselect_rng_next(rng);
+        rng->num_bits = 64;
+    }
+    int bit = (int)(rng->bits & 1);
+    rng->bits >>= 1;
+    rng->num_bits--;
+    return bit;
+}
+
+typedef struct dogecoin_coinselect_entry_ {
+    int64_t effective_value;
+    size_t index;
+} dogecoin_coinselect_entry;
+
+// descending effective value, ties by utxo index to keep the order deterministic
+static int dogecoin_coinselect_entry_cmp(const void* a, const void* b) {
+    const dogecoin_coinselect_entry* ea = a;
+    const dogecoin_coinselect_entry* eb = b;
+    if (ea->effective_value != eb->effective_value)
+        return ea->effective_value > eb->effective_value ? -1 : 1;
+    return ea->index < eb->index ? -1 : (ea->index > eb->index);
+}
+
+static int dogecoin_coinselect_size_cmp(const void* a, const void* b) {
+    const size_t sa = *(const size_t*)a;
+    const size_t sb = *(const size_t*)b;
+    return sa < sb ? -1 : (sa > sb);
+}
+
+// depth first search over include/exclude decisions (largest value first) for a
+// selection within [target, target + cost_of_change], so no change output is needed
+static dogecoin_bool dogecoin_coinselect_bnb(const int64_t* values, size_t num_values, int64_t total, int64_t target, int64_t cost_of_change, size_t* best, size_t* best_count) {
+    if (total < target)
+        return false;
+
+    size_t* selection = dogecoin_malloc(num_values * sizeof(size_t));
+    size_t depth = 0, tries, i;
+    int64_t curr_value = 0, available = total, best_waste = INT64_MAX;
+    dogecoin_bool found = false;
+
+    for (tries = 0, i = 0; tries < DOGECOIN_COINSELECT_BNB_TRIES; tries++, i++) {
+        dogecoin_bool backtrack = false;
+        if (curr_value + available < target || curr_value > target + cost_of_change) {
+            backtrack = true;
+        } else if (curr_value >= target) {
+            const int64_t waste = curr_value - target;
+            if (waste <= best_waste) {
+                best_waste = waste;
+                memcpy(best, selection, depth * sizeof(size_t));
+                *best_count = depth;
+                found = true;
+                if (waste == 0)
+                    break;
+            }
+            backtrack = true;
+        }
+
+        if (backtrack) {
+            if (depth == 0)
+                break;
+            // values skipped after the last included one become available again
+            for (--i; i > selection[depth - 1]; --i) {
+                available += values[i];
+            }
+            // last included value is excluded now, continue with the one after it
+            curr_value -= values[i];
+            depth--;
+        } else {
+            available -= values[i];
+            // including a value equal to a just excluded one would repeat the excluded branch
+            if (depth == 0 || i - 1 == selection[depth - 1] || values[i] != values[i - 1]) {
+                selection[depth++] = i;
+                curr_value += values[i];
+            }
+        }
+    }
+    dogecoin_free(selection);
+    return found;
+}
+
+// randomized subset sum approximation (knapsack) over values[start..num_values)
+// best starts as the whole range, returns the value of the best subset found
+static int64_t dogecoin_coinselect_approximate_subset(const int64_t* values, size_t start, size_t num_values, int64_t total, int64_t target, dogecoin_coinselect_rng* rng, size_t* best, size_t* best_count) {
+    const size_t count = num_values - start;
+    // keep the work roughly bounded for very large utxo sets
+    const size_t iterations = count <= 1000 ? 1000 : (count >= 100000 ? 10 : 1000000 / count);
+    size_t* stack = dogecoin_malloc(count * sizeof(size_t));
+    uint8_t* included = dogecoin_malloc(count);
+    int64_t best_value = total;
+    size_t rep, i;
+
+    for (i = 0; i < count; i++) {
+        best[i] = start + i;
+    }
+    *best_count = count;
+
+    for (rep = 0; rep < iterations && best_value != target; rep++) {
+        size_t depth = 0, rep_best_depth = SIZE_MAX, rep_best_last = 0;
+        int64_t sum = 0;
+        dogecoin_bool reached = false;
+        int pass;
+        memset(included, 0, count);
+        for (pass = 0; pass < 2 && !reached; pass++) {
+            for (i = start; i < num_values; i++) {
+                if (pass == 0 ? !dogecoin_coinselect_rng_bit(rng) : included[i - start])
+                    continue;
+                if (sum + values[i] >= target) {
+                    // the set is stack[0..depth) plus i, values are only added so the last hit is the best
+                    reached = true;
+                    if (sum + values[i] < best_value) {
+                        best_value = sum + values[i];
+                        rep_best_depth = depth;
+                        rep_best_last = i;
+                    }
+                } else {
+                    sum += values[i];
+                    included[i - start] = 1;
+                    stack[depth++] = i;
+                }
+            }
+        }
+        if (rep_best_depth != SIZE_MAX) {
+            memcpy(best, stack, rep_best_depth * sizeof(size_t));
+            best[rep_best_depth] = rep_best_last;
+            *best_count = rep_best_depth + 1;
+        }
+    }
+    dogecoin_free(included);
+    dogecoin_free(stack);
+    return best_value;
+}
+
+// knapsack solver: exact match, everything below the target, the smallest value
+// above it, or an approximated subset, whichever comes closest
+static dogecoin_bool dogecoin_coinselect_knapsack(const int64_t* values, size_t num_values, int64_t target, int64_t min_change, dogecoin_coinselect_rng* rng, size_t* best, size_t* best_count) {
+    size_t lo = 0, hi = num_values, i;
+    // values is sorted descending, find the first value below target + min_change
+    while (lo < hi) {
+        const size_t mid = lo + (hi - lo) / 2;
+        if (values[mid] >= target + min_change)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    const size_t start = lo;
+    const dogecoin_bool has_larger = start > 0;
+
+    int64_t total_lower = 0;
+    for (i = start; i < num_values; i++) {
+        if (values[i] == target) {
+            best[0] = i;
+            *best_count = 1;
+            return true;
+        }
+        total_lower += values[i];
+    }
+
+    if (total_lower == target) {
+        for (i = start; i < num_values; i++) {
+            best[i - start] = i;
+        }
+        *best_count = num_values - start;
+        return true;
+    }
+
+    if (total_lower < target) {
+        if (!has_larger)
+            return false;
+        best[0] = start - 1;
+        *best_count = 1;
+        return true;
+    }
+
+    int64_t best_value = dogecoin_coinselect_approximate_subset(values, start, num_values, total_lower, target, rng, best, best_count);
+    if (best_value != target && total_lower >= target + min_change)
+        best_value = dogecoin_coinselect_approximate_subset(values, start, num_values, total_lower, target + min_change, rng, best, best_count);
+
+    // the smallest larger value wins if the subset leaves less than min_change or is not smaller
+    if (has_larger && ((best_value != target && best_value < target + min_change) || values[start - 1] <= best_value)) {
+        best[0] = start - 1;
+        *best_count = 1;
+    }
+    return true;
+}
+
+// single random draw: add random values until target is covered
+static dogecoin_bool dogecoin_coinselect_srd(const int64_t* values, size_t num_values, int64_t total, int64_t target, dogecoin_coinselect_rng* rng, size_t* best, size_t* best_count) {
+    if (total < target)
+        return false;
+
+    size_t* order = dogecoin_malloc(num_values * sizeof(size_t));
+    size_t i;
+    int64_t sum = 0;
+    for (i = 0; i < num_values; i++) {
+        order[i] = i;
+    }
+    // partial fisher-yates shuffle, only the drawn prefix is randomized
+    for (i = 0; i < num_values && sum < target; i++) {
+        const size_t j = i + (size_t)(dogecoin_coinselect_rng_next(rng) % (num_values - i));
+        const size_t tmp = order[i];
+        order[i] = order[j];
+        order[j] = tmp;
+        best[i] = order[i];
+        sum += values[order[i]];
+    }
+    *best_count = i;
+    dogecoin_free(order);
+    return true;
+}
+
+dogecoin_coinselect_result* dogecoin_coinselect(const dogecoin_utxo* utxos, size_t num_utxos, int64_t target, uint64_t fee_per_kb) {
+    size_t i, num_values = 0;
+    int64_t total = 0;
+
+    if (target <= 0 || num_utxos == 0)
+        return NULL;
+
+    const int64_t change_output_fee = dogecoin_coinselect_fee(fee_per_kb, DOGECOIN_COINSELECT_CHANGE_OUTPUT_SIZE);
+    const int64_t cost_of_change = change_output_fee + dogecoin_coinselect_fee(fee_per_kb, dogecoin_coinselect_input_size(DOGECOIN_TX_PUBKEYHASH));
+
+    // effective value = value minus the fee for spending it, uneconomic utxos are skipped
+    dogecoin_coinselect_entry* entries = dogecoin_malloc(num_utxos * sizeof(dogecoin_coinselect_entry));
+    for (i = 0; i < num_utxos; i++) {
+        const uint32_t input_size = utxos[i].input_size ? utxos[i].input_size : dogecoin_coinselect_input_size(utxos[i].script_type);
+        const int64_t effective_value = utxos[i].value - dogecoin_coinselect_fee(fee_per_kb, input_size);
+        if (effective_value <= 0)
+            continue;
+        entries[num_values].effective_value = effective_value;
+        entries[num_values].index = i;
+        total += effective_value;
+        num_values++;
+    }
+    if (total < target) {
+        dogecoin_free(entries);
+        return NULL;
+    }
+    qsort(entries, num_values, sizeof(dogecoin_coinselect_entry), dogecoin_coinselect_entry_cmp);
+
+    // the search loops only touch the packed values
+    int64_t* values = dogecoin_malloc(num_values * sizeof(int64_t));
+    for (i = 0; i < num_values; i++) {
+        values[i] = entries[i].effective_value;
+    }
+
+    size_t* selection = dogecoin_malloc(num_values * sizeof(size_t));
+    size_t count = 0;
+    enum dogecoin_coinselect_algo algo = DOGECOIN_COINSELECT_BNB;
+    dogecoin_bool found = dogecoin_coinselect_bnb(values, num_values, total, target, cost_of_change, selection, &count);
+
+    if (!found) {
+        dogecoin_coinselect_rng rng;
+        dogecoin_coinselect_rng_init(&rng);
+
+        // both fallbacks pay for a change output
+        const int64_t change_target = target + change_output_fee;
+        size_t* srd_selection = dogecoin_malloc(num_values * sizeof(size_t));
+        size_t srd_count = 0;
+        dogecoin_bool knapsack_found = dogecoin_coinselect_knapsack(values, num_values, change_target, DOGECOIN_COINSELECT_MIN_CHANGE, &rng, selection, &count);
+        dogecoin_bool srd_found = dogecoin_coinselect_srd(values, num_values, total, change_target + DOGECOIN_COINSELECT_MIN_CHANGE, &rng, srd_selection, &srd_count);
+
+        if (knapsack_found) {
+            algo = DOGECOIN_COINSELECT_KNAPSACK;
+            found = true;
+        }
+        if (srd_found) {
+            // prefer the cheaper selection (lower input fees), then the one with fewer inputs
+            int64_t knapsack_fee = 0, srd_fee = 0;
+            for (i = 0; knapsack_found && i < count; i++) {
+                knapsack_fee += utxos[entries[selection[i]].index].value - values[selection[i]];
+            }
+            for (i = 0; i < srd_count; i++) {
+                srd_fee += utxos[entries[srd_selection[i]].index].value - values[srd_selection[i]];
+            }
+            if (!knapsack_found || srd_fee < knapsack_fee || (srd_fee == knapsack_fee && srd_count < count)) {
+                memcpy(selection, srd_selection, srd_count * sizeof(size_t));
+                count = srd_count;
+                algo = DOGECOIN_COINSELECT_SRD;
+                found = true;
+            }
+        }
+        dogecoin_free(srd_selection);
+    }
+
+    // funds only cover the target without change and the search ran out of tries: largest first
+    if (!found) {
+        int64_t sum = 0;
+        for (count = 0; count < num_values && sum < target; count++) {
+            selection[count] = count;
+            sum += values[count];
+        }
+        algo = DOGECOIN_COINSELECT_KNAPSACK;
+    }
+
+    dogecoin_coinselect_result* result = dogecoin_calloc(1, sizeof(*result));
+    result->selected = dogecoin_malloc((count ? count : 1) * sizeof(size_t));
+    result->count = count;
+    result->algo = algo;
+    int64_t effective_sum = 0;
+    for (i = 0; i < count; i++) {
+        result->selected[i] = entries[selection[i]].index;
+        result->value += utxos[result->selected[i]].value;
+        effective_sum += values[selection[i]];
+    }
+    qsort(result->selected, count, sizeof(size_t), dogecoin_coinselect_size_cmp);
+
+    const int64_t input_fee = result->value - effective_sum;
+    const int64_t excess = effective_sum - target;
+    if (algo != DOGECOIN_COINSELECT_BNB && excess >= change_output_fee + DOGECOIN_COINSELECT_MIN_CHANGE) {
+        result->change = excess - change_output_fee;
+        result->fee = input_fee + change_output_fee;
+    } else {
+        // too small for a change output, the excess goes to the fee
+        result->change = 0;
+        result->fee = input_fee + excess;
+    }
+
+    dogecoin_free(selection);
+    dogecoin_free(values);
+    dogecoin_free(entries);
+    return result;
+}
+
+void dogecoin_coinselect_result_free(dogecoin_coinselect_result* result) {
+    if (!result)
+        return;
+    dogecoin_free(result->selected);
+    dogecoin_free(result);
+}
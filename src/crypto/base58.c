@@ -82,7 +82,7 @@ int dogecoin_b58check(const void* bin, size_t binsz, const char* base58str) {
     unsigned i = 0;
     if (binsz < 4) return -4;
     sha256_raw(bin, binsz - 4, buf);
-    sha256_raw(buf, 32, buf);
+    sha256_raw_32(buf, buf);
     if (memcmp(&binc[binsz - 4], buf, 4)) return -1;
     // check number of zeros is correct AFTER verifying checksum (to avoid possibility of accessing base58str beyond the end)
     for (i = 0; binc[i] == '\0' && base58str[i] == '1'; ++i) {} // just finding the end of zeros, nothing to do in loop
@@ -127,7 +127,7 @@ int dogecoin_base58_encode_check(const uint8_t* data, int datalen, char* str, in
     uint8_t* hash = buf + datalen;
     memcpy(buf, data, datalen);
     sha256_raw(data, datalen, hash);
-    sha256_raw(hash, 32, hash);
+    sha256_raw_32(hash, hash);
     size_t res = strsize;
     bool success = dogecoin_base58_encode(str, &res, buf, datalen + 4);
     memset(buf, 0, sizeof(buf));
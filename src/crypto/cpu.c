@@ -0,0 +1,93 @@
+/*
+
+ The MIT License (MIT)
+
+ Copyright (c) 2022 The Dogecoin Foundation
+
+ Permission is hereby granted, free of charge, to any person obtaining
+ a copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES
+ OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+#ifdef HAVE_CONFIG_H
+#  include <src/libdogecoin-config.h>
+#endif
+
+#include <string.h>
+
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
+#include <dogecoin/crypto/cpu.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#include <cpuid.h>
+#define DOGECOIN_CPU_X86
+#endif
+
+static dogecoin_cpu_features dogecoin_cpu_features_detected;
+#ifdef HAVE_PTHREAD
+static pthread_once_t dogecoin_cpu_features_once = PTHREAD_ONCE_INIT;
+#else
+static int dogecoin_cpu_features_ready = 0;
+#endif
+
+static void dogecoin_cpu_detect(dogecoin_cpu_features* cpu) {
+    memset(cpu, 0, sizeof(*cpu));
+#ifdef DOGECOIN_CPU_X86
+    uint32_t eax, ebx, ecx, edx, xcr0 = 0;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+        return;
+    cpu->sse2 = (edx >> 26) & 1;
+    cpu->sse41 = (ecx >> 19) & 1;
+    if (((ecx >> 27) & 1) && ((ecx >> 28) & 1)) {
+        // OSXSAVE and AVX: xcr0 tells which register sets the os preserves
+        uint32_t xcr0_hi;
+        __asm__("xgetbv" : "=a"(xcr0), "=d"(xcr0_hi) : "c"(0));
+    }
+    if (__get_cpuid_max(0, NULL) >= 7) {
+        __cpuid_count(7, 0, eax, ebx, ecx, edx);
+        cpu->avx2 = (xcr0 & 0x06) == 0x06 && ((ebx >> 5) & 1);
+        cpu->bmi2 = (ebx >> 8) & 1;
+        cpu->avx512f = (xcr0 & 0xe6) == 0xe6 && ((ebx >> 16) & 1);
+        cpu->shani = (ebx >> 29) & 1;
+    }
+#endif
+}
+
+#ifdef HAVE_PTHREAD
+static void dogecoin_cpu_detect_once(void) {
+    dogecoin_cpu_detect(&dogecoin_cpu_features_detected);
+}
+#endif
+
+const dogecoin_cpu_features* dogecoin_cpu_get_features(void) {
+#ifdef HAVE_PTHREAD
+    pthread_once(&dogecoin_cpu_features_once, dogecoin_cpu_detect_once);
+#else
+    // the release store publishes the detected features to acquiring readers
+    if (!__atomic_load_n(&dogecoin_cpu_features_ready, __ATOMIC_ACQUIRE)) {
+        dogecoin_cpu_features cpu;
+        dogecoin_cpu_detect(&cpu);
+        dogecoin_cpu_features_detected = cpu;
+        __atomic_store_n(&dogecoin_cpu_features_ready, 1, __ATOMIC_RELEASE);
+    }
+#endif
+    return &dogecoin_cpu_features_detected;
+}
@@ -1,37 +1,339 @@
+#ifdef HAVE_CONFIG_H
+#  include <src/libdogecoin-config.h>
+#endif
+
 #include <assert.h>
 #include <stdint.h>
 #include <string.h>
 
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
 #include <secp256k1/include/secp256k1.h>
+#include <secp256k1/include/secp256k1_extrakeys.h>
 #include <secp256k1/include/secp256k1_recovery.h>
+#include <secp256k1/include/secp256k1_schnorrsig.h>
 
 #include <dogecoin/dogecoin.h>
+#include <dogecoin/crypto/ecc.h>
 #include <dogecoin/crypto/random.h>
+#include <dogecoin/mem.h>
 
-static secp256k1_context* secp256k1_ctx = NULL;
+struct dogecoin_ecc_ctx_ {
+    secp256k1_context* ctx;
+    dogecoin_bool worker;  // owned by the worker pool, freed by dogecoin_ecc_stop only
+};
 
-dogecoin_bool dogecoin_ecc_start(void) {
-    dogecoin_random_init();
-    secp256k1_ctx = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
-    if (secp256k1_ctx == NULL) return false;
+// created by dogecoin_ecc_start for the thread that called it, the only context without pthreads
+static dogecoin_ecc_ctx ecc_static_ctx = {NULL, false};
+
+#ifdef HAVE_PTHREAD
+// every other thread gets its own context on first use, freed when the thread exits
+static pthread_key_t ecc_thread_key;
+static pthread_once_t ecc_thread_key_once = PTHREAD_ONCE_INIT;
+
+// contexts handed to the threads the batch functions spawn, kept across calls so short lived
+// workers do not create and randomize a context each
+static dogecoin_ecc_ctx* ecc_worker_ctxs[DOGECOIN_ECC_WORKER_CTXS];
+static pthread_mutex_t ecc_worker_ctxs_lock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+// parsed pubkey cache, a set associative table keyed by the serialized pubkey
+// sets are guarded by striped locks, set i uses lock i % DOGECOIN_ECC_PUBKEY_CACHE_LOCKS
+#define DOGECOIN_ECC_PUBKEY_CACHE_WAYS 4
+#define DOGECOIN_ECC_PUBKEY_CACHE_LOCKS 16
+
+typedef struct pubkey_cache_entry_ {
+    secp256k1_pubkey parsed;
+    uint32_t stamp;  // last use, 0 = empty
+    uint8_t len;
+    uint8_t pubkey[DOGECOIN_ECKEY_UNCOMPRESSED_LENGTH];
+} pubkey_cache_entry;
+
+static struct {
+    pubkey_cache_entry* entries;
+    size_t sets;  // power of two, 0 = disabled
+    uint64_t salt;
+    uint32_t clock[DOGECOIN_ECC_PUBKEY_CACHE_LOCKS];
+    uint64_t hits[DOGECOIN_ECC_PUBKEY_CACHE_LOCKS];
+    uint64_t misses[DOGECOIN_ECC_PUBKEY_CACHE_LOCKS];
+#ifdef HAVE_PTHREAD
+    pthread_mutex_t locks[DOGECOIN_ECC_PUBKEY_CACHE_LOCKS];
+    dogecoin_bool locks_ready;
+#endif
+} pubkey_cache;
+
+static void pubkey_cache_lock(size_t stripe) {
+#ifdef HAVE_PTHREAD
+    if (pubkey_cache.locks_ready) pthread_mutex_lock(&pubkey_cache.locks[stripe]);
+#else
+    (void)stripe;
+#endif
+}
+
+static void pubkey_cache_unlock(size_t stripe) {
+#ifdef HAVE_PTHREAD
+    if (pubkey_cache.locks_ready) pthread_mutex_unlock(&pubkey_cache.locks[stripe]);
+#else
+    (void)stripe;
+#endif
+}
+
+// the x coordinate is the part that varies, mixed with a per process salt so the
+// set of a key cannot be predicted
+static size_t pubkey_cache_set(const uint8_t* public_key, size_t len) {
+    uint64_t x, h;
+    memcpy(&x, public_key + 1, sizeof(x));
+    h = (x ^ pubkey_cache.salt) + ((uint64_t)public_key[0] << 8 | len);
+    h *= 0x9e3779b97f4a7c15ULL;
+    h ^= h >> 29;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 32;
+    return (size_t)h & (pubkey_cache.sets - 1);
+}
+
+// parse a serialized pubkey, from the cache if it was seen before
+static dogecoin_bool pubkey_cache_parse(const secp256k1_context* ctx, secp256k1_pubkey* pubkey, const uint8_t* public_key, size_t len) {
+    pubkey_cache_entry* set;
+    pubkey_cache_entry* victim;
+    size_t index, stripe, i;
+
+    if (pubkey_cache.sets == 0)
+        return secp256k1_ec_pubkey_parse(ctx, pubkey, public_key, len);
+
+    index = pubkey_cache_set(public_key, len);
+    stripe = index & (DOGECOIN_ECC_PUBKEY_CACHE_LOCKS - 1);
+    set = pubkey_cache.entries + index * DOGECOIN_ECC_PUBKEY_CACHE_WAYS;
+    pubkey_cache_lock(stripe);
+    for (i = 0; i < DOGECOIN_ECC_PUBKEY_CACHE_WAYS; i++) {
+        if (set[i].stamp && set[i].len == len && memcmp(set[i].pubkey, public_key, len) == 0) {
+            *pubkey = set[i].parsed;
+            set[i].stamp = ++pubkey_cache.clock[stripe];
+            pubkey_cache.hits[stripe]++;
+            pubkey_cache_unlock(stripe);
+            return true;
+        }
+    }
+    pubkey_cache.misses[stripe]++;
+    pubkey_cache_unlock(stripe);
+
+    // the square root for compressed keys runs outside of the lock, invalid keys are not cached
+    if (!secp256k1_ec_pubkey_parse(ctx, pubkey, public_key, len))
+        return false;
+
+    pubkey_cache_lock(stripe);
+    victim = set;
+    for (i = 0; i < DOGECOIN_ECC_PUBKEY_CACHE_WAYS; i++) {
+        if (set[i].stamp && set[i].len == len && memcmp(set[i].pubkey, public_key, len) == 0) {
+            victim = NULL;  // another thread got here first
+            break;
+        }
+        if (set[i].stamp < victim->stamp)
+            victim = &set[i];
+    }
+    if (victim) {
+        victim->parsed = *pubkey;
+        victim->len = (uint8_t)len;
+        memcpy(victim->pubkey, public_key, len);
+        victim->stamp = ++pubkey_cache.clock[stripe];
+    }
+    pubkey_cache_unlock(stripe);
+    return true;
+}
+
+dogecoin_bool dogecoin_ecc_pubkey_cache_resize(size_t max_entries) {
+    pubkey_cache_entry* entries = NULL;
+    pubkey_cache_entry* old;
+    size_t sets = 0;
+
+    if (max_entries >= DOGECOIN_ECC_PUBKEY_CACHE_WAYS) {
+        sets = 1;
+        while (sets * 2 * DOGECOIN_ECC_PUBKEY_CACHE_WAYS <= max_entries) sets *= 2;
+        entries = dogecoin_calloc(sets * DOGECOIN_ECC_PUBKEY_CACHE_WAYS, sizeof(pubkey_cache_entry));
+        if (!entries) return false;
+    }
+    old = pubkey_cache.entries;
+    pubkey_cache.entries = entries;
+    pubkey_cache.sets = sets;
+    memset(pubkey_cache.clock, 0, sizeof(pubkey_cache.clock));
+    memset(pubkey_cache.hits, 0, sizeof(pubkey_cache.hits));
+    memset(pubkey_cache.misses, 0, sizeof(pubkey_cache.misses));
+    if (old) dogecoin_free(old);
+    return true;
+}
+
+size_t dogecoin_ecc_pubkey_cache_size(void) {
+    return pubkey_cache.sets * DOGECOIN_ECC_PUBKEY_CACHE_WAYS;
+}
+
+void dogecoin_ecc_pubkey_cache_stats(uint64_t* hits, uint64_t* misses) {
+    uint64_t h = 0, m = 0;
+    size_t i;
+    for (i = 0; i < DOGECOIN_ECC_PUBKEY_CACHE_LOCKS; i++) {
+        pubkey_cache_lock(i);
+        h += pubkey_cache.hits[i];
+        m += pubkey_cache.misses[i];
+        pubkey_cache_unlock(i);
+    }
+    if (hits) *hits = h;
+    if (misses) *misses = m;
+}
+
+static void pubkey_cache_start(void) {
+#ifdef HAVE_PTHREAD
+    size_t i;
+    if (!pubkey_cache.locks_ready) {
+        for (i = 0; i < DOGECOIN_ECC_PUBKEY_CACHE_LOCKS; i++) pthread_mutex_init(&pubkey_cache.locks[i], NULL);
+        pubkey_cache.locks_ready = true;
+    }
+#endif
+    dogecoin_random_bytes((uint8_t*)&pubkey_cache.salt, sizeof(pubkey_cache.salt), 0);
+    if (!pubkey_cache.entries) dogecoin_ecc_pubkey_cache_resize(DOGECOIN_ECC_PUBKEY_CACHE_DEFAULT_ENTRIES);
+}
+
+static void pubkey_cache_stop(void) {
+#ifdef HAVE_PTHREAD
+    size_t i;
+#endif
+    dogecoin_ecc_pubkey_cache_resize(0);
+#ifdef HAVE_PTHREAD
+    if (pubkey_cache.locks_ready) {
+        pubkey_cache.locks_ready = false;
+        for (i = 0; i < DOGECOIN_ECC_PUBKEY_CACHE_LOCKS; i++) pthread_mutex_destroy(&pubkey_cache.locks[i]);
+    }
+#endif
+}
+
+dogecoin_ecc_ctx* dogecoin_ecc_ctx_new(void) {
+    dogecoin_ecc_ctx* ctx;
     uint8_t seed[32];
     int ret;
+    secp256k1_context* secp256k1_ctx = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+    if (secp256k1_ctx == NULL) return NULL;
     ret = dogecoin_random_bytes(seed, 32, 0);
-    if (!ret) return false;
-    ret = secp256k1_context_randomize(secp256k1_ctx, seed);
-    if (!ret) return false;
+    if (ret) ret = secp256k1_context_randomize(secp256k1_ctx, seed);
+    memset(seed, 0, sizeof(seed));
+    if (!ret) {
+        secp256k1_context_destroy(secp256k1_ctx);
+        return NULL;
+    }
+    ctx = dogecoin_calloc(1, sizeof(*ctx));
+    ctx->ctx = secp256k1_ctx;
+    return ctx;
+}
+
+void dogecoin_ecc_ctx_free(dogecoin_ecc_ctx* ctx) {
+    if (!ctx || ctx == &ecc_static_ctx || ctx->worker) return;
+    secp256k1_context_destroy(ctx->ctx);
+    dogecoin_free(ctx);
+}
+
+#ifdef HAVE_PTHREAD
+static void ecc_thread_ctx_free(void* ctx) {
+    dogecoin_ecc_ctx_free(ctx);
+}
+
+static void ecc_thread_key_create(void) {
+    pthread_key_create(&ecc_thread_key, ecc_thread_ctx_free);
+}
+#endif
+
+dogecoin_ecc_ctx* dogecoin_ecc_thread_ctx(void) {
+#ifdef HAVE_PTHREAD
+    dogecoin_ecc_ctx* ctx;
+    pthread_once(&ecc_thread_key_once, ecc_thread_key_create);
+    ctx = pthread_getspecific(ecc_thread_key);
+    if (!ctx) {
+        ctx = dogecoin_ecc_ctx_new();
+        assert(ctx);
+        pthread_setspecific(ecc_thread_key, ctx);
+    }
+    return ctx;
+#else
+    assert(ecc_static_ctx.ctx);
+    return &ecc_static_ctx;
+#endif
+}
+
+void dogecoin_ecc_thread_ctx_set(dogecoin_ecc_ctx* ctx) {
+#ifdef HAVE_PTHREAD
+    dogecoin_ecc_ctx* prev;
+    pthread_once(&ecc_thread_key_once, ecc_thread_key_create);
+    prev = pthread_getspecific(ecc_thread_key);
+    if (prev != ctx) dogecoin_ecc_ctx_free(prev);
+    pthread_setspecific(ecc_thread_key, ctx);
+#else
+    (void)ctx;
+#endif
+}
+
+dogecoin_ecc_ctx* dogecoin_ecc_worker_ctx(unsigned int worker) {
+#ifdef HAVE_PTHREAD
+    dogecoin_ecc_ctx* ctx;
+    // secp256k1 calls only read the context, so workers past the pool size can share one
+    worker %= DOGECOIN_ECC_WORKER_CTXS;
+    pthread_mutex_lock(&ecc_worker_ctxs_lock);
+    ctx = ecc_worker_ctxs[worker];
+    if (!ctx) {
+        ctx = dogecoin_ecc_ctx_new();
+        assert(ctx);
+        ctx->worker = true;
+        ecc_worker_ctxs[worker] = ctx;
+    }
+    pthread_mutex_unlock(&ecc_worker_ctxs_lock);
+    return ctx;
+#else
+    (void)worker;
+    return dogecoin_ecc_thread_ctx();
+#endif
+}
+
+#ifdef HAVE_PTHREAD
+static void ecc_worker_ctxs_free(void) {
+    unsigned int i;
+    pthread_mutex_lock(&ecc_worker_ctxs_lock);
+    for (i = 0; i < DOGECOIN_ECC_WORKER_CTXS; i++) {
+        if (!ecc_worker_ctxs[i]) continue;
+        secp256k1_context_destroy(ecc_worker_ctxs[i]->ctx);
+        dogecoin_free(ecc_worker_ctxs[i]);
+        ecc_worker_ctxs[i] = NULL;
+    }
+    pthread_mutex_unlock(&ecc_worker_ctxs_lock);
+}
+#endif
+
+dogecoin_bool dogecoin_ecc_start(void) {
+    dogecoin_ecc_ctx* ctx;
+    dogecoin_random_init();
+    ctx = dogecoin_ecc_ctx_new();
+    if (!ctx) return false;
+    ecc_static_ctx.ctx = ctx->ctx;
+    dogecoin_free(ctx);
+#ifdef HAVE_PTHREAD
+    pthread_once(&ecc_thread_key_once, ecc_thread_key_create);
+    pthread_setspecific(ecc_thread_key, &ecc_static_ctx);
+#endif
+    pubkey_cache_start();
     return true;
 }
 
 void dogecoin_ecc_stop(void) {
-    secp256k1_context* ctx = secp256k1_ctx;
-    secp256k1_ctx = NULL;
+    secp256k1_context* ctx = ecc_static_ctx.ctx;
+#ifdef HAVE_PTHREAD
+    pthread_once(&ecc_thread_key_once, ecc_thread_key_create);
+    if (pthread_getspecific(ecc_thread_key) == &ecc_static_ctx)
+        pthread_setspecific(ecc_thread_key, NULL);
+    ecc_worker_ctxs_free();
+#endif
+    ecc_static_ctx.ctx = NULL;
     if (ctx) secp256k1_context_destroy(ctx);
+    pubkey_cache_stop();
 }
 
 void dogecoin_ecc_get_pubkey(const uint8_t* private_key, uint8_t* public_key, size_t* in_outlen, dogecoin_bool compressed) {
     secp256k1_pubkey pubkey;
-    assert(secp256k1_ctx);
+    const secp256k1_context* secp256k1_ctx = dogecoin_ecc_thread_ctx()->ctx;
     assert((int)*in_outlen == (compressed ? 33 : 65));
     memset(public_key, 0, *in_outlen);
     if (!secp256k1_ec_pubkey_create(secp256k1_ctx, &pubkey, (const unsigned char*)private_key)) return;
@@ -40,14 +342,14 @@ void dogecoin_ecc_get_pubkey(const uint8_t* private_key, uint8_t* public_key, si
 }
 
 dogecoin_bool dogecoin_ecc_private_key_tweak_add(uint8_t* private_key, const uint8_t* tweak) {
-    assert(secp256k1_ctx);
+    const secp256k1_context* secp256k1_ctx = dogecoin_ecc_thread_ctx()->ctx;
     return secp256k1_ec_privkey_tweak_add(secp256k1_ctx, (unsigned char*)private_key, (const unsigned char*)tweak);
 }
 
 dogecoin_bool dogecoin_ecc_public_key_tweak_add(uint8_t* public_key_inout, const uint8_t* tweak) {
     size_t out = DOGECOIN_ECKEY_COMPRESSED_LENGTH;
     secp256k1_pubkey pubkey;
-    assert(secp256k1_ctx);
+    const secp256k1_context* secp256k1_ctx = dogecoin_ecc_thread_ctx()->ctx;
     if (!secp256k1_ec_pubkey_parse(secp256k1_ctx, &pubkey, public_key_inout, 33)) return false;
     if (!secp256k1_ec_pubkey_tweak_add(secp256k1_ctx, &pubkey, (const unsigned char*)tweak)) return false;
     if (!secp256k1_ec_pubkey_serialize(secp256k1_ctx, public_key_inout, &out, &pubkey, SECP256K1_EC_COMPRESSED)) return false;
@@ -55,13 +357,13 @@ dogecoin_bool dogecoin_ecc_public_key_tweak_add(uint8_t* public_key_inout, const
 }
 
 dogecoin_bool dogecoin_ecc_verify_privatekey(const uint8_t* private_key) {
-    assert(secp256k1_ctx);
+    const secp256k1_context* secp256k1_ctx = dogecoin_ecc_thread_ctx()->ctx;
     return secp256k1_ec_seckey_verify(secp256k1_ctx, (const unsigned char*)private_key);
 }
 
 dogecoin_bool dogecoin_ecc_verify_pubkey(const uint8_t* public_key, dogecoin_bool compressed) {
     secp256k1_pubkey pubkey;
-    assert(secp256k1_ctx);
+    const secp256k1_context* secp256k1_ctx = dogecoin_ecc_thread_ctx()->ctx;
     if (!secp256k1_ec_pubkey_parse(secp256k1_ctx, &pubkey, public_key, compressed ? 33 : 65)) {
         memset(&pubkey, 0, sizeof(pubkey));
         return false;
@@ -70,16 +372,20 @@ dogecoin_bool dogecoin_ecc_verify_pubkey(const uint8_t* public_key, dogecoin_boo
     return true;
 }
 
-dogecoin_bool dogecoin_ecc_sign(const uint8_t* private_key, const uint256 hash, unsigned char* sigder, size_t* outlen) {
-    assert(secp256k1_ctx);
+dogecoin_bool dogecoin_ecc_sign_ctx(const dogecoin_ecc_ctx* ctx, const uint8_t* private_key, const uint256 hash, unsigned char* sigder, size_t* outlen) {
+    const secp256k1_context* secp256k1_ctx = ctx->ctx;
     secp256k1_ecdsa_signature sig;
     if (!secp256k1_ecdsa_sign(secp256k1_ctx, &sig, hash, private_key, secp256k1_nonce_function_rfc6979, NULL)) return 0;
     if (!secp256k1_ecdsa_signature_serialize_der(secp256k1_ctx, sigder, outlen, &sig)) return 0;
     return 1;
 }
 
-dogecoin_bool dogecoin_ecc_sign_compact(const uint8_t* private_key, const uint256 hash, unsigned char* sigcomp, size_t* outlen) {
-    assert(secp256k1_ctx);
+dogecoin_bool dogecoin_ecc_sign(const uint8_t* private_key, const uint256 hash, unsigned char* sigder, size_t* outlen) {
+    return dogecoin_ecc_sign_ctx(dogecoin_ecc_thread_ctx(), private_key, hash, sigder, outlen);
+}
+
+dogecoin_bool dogecoin_ecc_sign_compact_ctx(const dogecoin_ecc_ctx* ctx, const uint8_t* private_key, const uint256 hash, unsigned char* sigcomp, size_t* outlen) {
+    const secp256k1_context* secp256k1_ctx = ctx->ctx;
     secp256k1_ecdsa_signature sig;
     if (!secp256k1_ecdsa_sign(secp256k1_ctx, &sig, hash, private_key, secp256k1_nonce_function_rfc6979, NULL)) return 0;
     *outlen = 64;
@@ -87,8 +393,12 @@ dogecoin_bool dogecoin_ecc_sign_compact(const uint8_t* private_key, const uint25
     return 1;
 }
 
-dogecoin_bool dogecoin_ecc_sign_compact_recoverable(const uint8_t* private_key, const uint256 hash, unsigned char* sigrec, size_t* outlen, int *recid) {
-    assert(secp256k1_ctx);
+dogecoin_bool dogecoin_ecc_sign_compact(const uint8_t* private_key, const uint256 hash, unsigned char* sigcomp, size_t* outlen) {
+    return dogecoin_ecc_sign_compact_ctx(dogecoin_ecc_thread_ctx(), private_key, hash, sigcomp, outlen);
+}
+
+dogecoin_bool dogecoin_ecc_sign_compact_recoverable_ctx(const dogecoin_ecc_ctx* ctx, const uint8_t* private_key, const uint256 hash, unsigned char* sigrec, size_t* outlen, int *recid) {
+    const secp256k1_context* secp256k1_ctx = ctx->ctx;
     secp256k1_ecdsa_recoverable_signature sig;
     if (!secp256k1_ecdsa_sign_recoverable(secp256k1_ctx, &sig, hash, private_key, secp256k1_nonce_function_rfc6979, NULL)) return 0;
     *outlen = 65;
@@ -96,27 +406,39 @@ dogecoin_bool dogecoin_ecc_sign_compact_recoverable(const uint8_t* private_key,
     return 1;
 }
 
-dogecoin_bool dogecoin_ecc_recover_pubkey(const unsigned char* sigrec, const uint256 hash, const int recid, uint8_t* public_key, size_t *outlen) {
-    assert(secp256k1_ctx);
+dogecoin_bool dogecoin_ecc_sign_compact_recoverable(const uint8_t* private_key, const uint256 hash, unsigned char* sigrec, size_t* outlen, int *recid) {
+    return dogecoin_ecc_sign_compact_recoverable_ctx(dogecoin_ecc_thread_ctx(), private_key, hash, sigrec, outlen, recid);
+}
+
+dogecoin_bool dogecoin_ecc_recover_pubkey_ctx(const dogecoin_ecc_ctx* ctx, const unsigned char* sigrec, const uint256 hash, const int recid, uint8_t* public_key, size_t *outlen, dogecoin_bool compressed) {
+    const secp256k1_context* secp256k1_ctx = ctx->ctx;
     secp256k1_pubkey pubkey;
     secp256k1_ecdsa_recoverable_signature sig;
     if (!secp256k1_ecdsa_recoverable_signature_parse_compact(secp256k1_ctx, &sig, sigrec, recid)) return false;
     if (!secp256k1_ecdsa_recover(secp256k1_ctx, &pubkey, &sig, hash)) return 0;
-    if (!secp256k1_ec_pubkey_serialize(secp256k1_ctx, public_key, outlen, &pubkey, SECP256K1_EC_COMPRESSED)) return 0;
+    if (!secp256k1_ec_pubkey_serialize(secp256k1_ctx, public_key, outlen, &pubkey, compressed ? SECP256K1_EC_COMPRESSED : SECP256K1_EC_UNCOMPRESSED)) return 0;
     return 1;
 }
 
-dogecoin_bool dogecoin_ecc_verify_sig(const uint8_t* public_key, dogecoin_bool compressed, const uint256 hash, unsigned char* sigder, size_t siglen) {
-    assert(secp256k1_ctx);
+dogecoin_bool dogecoin_ecc_recover_pubkey(const unsigned char* sigrec, const uint256 hash, const int recid, uint8_t* public_key, size_t *outlen) {
+    return dogecoin_ecc_recover_pubkey_ctx(dogecoin_ecc_thread_ctx(), sigrec, hash, recid, public_key, outlen, true);
+}
+
+dogecoin_bool dogecoin_ecc_verify_sig_ctx(const dogecoin_ecc_ctx* ctx, const uint8_t* public_key, dogecoin_bool compressed, const uint256 hash, unsigned char* sigder, size_t siglen) {
+    const secp256k1_context* secp256k1_ctx = ctx->ctx;
     secp256k1_ecdsa_signature sig;
     secp256k1_pubkey pubkey;
-    if (!secp256k1_ec_pubkey_parse(secp256k1_ctx, &pubkey, public_key, compressed ? 33 : 65)) return false;
+    if (!pubkey_cache_parse(secp256k1_ctx, &pubkey, public_key, compressed ? 33 : 65)) return false;
     if (!secp256k1_ecdsa_signature_parse_der(secp256k1_ctx, &sig, sigder, siglen)) return false;
     return secp256k1_ecdsa_verify(secp256k1_ctx, &sig, hash, &pubkey);
 }
 
+dogecoin_bool dogecoin_ecc_verify_sig(const uint8_t* public_key, dogecoin_bool compressed, const uint256 hash, unsigned char* sigder, size_t siglen) {
+    return dogecoin_ecc_verify_sig_ctx(dogecoin_ecc_thread_ctx(), public_key, compressed, hash, sigder, siglen);
+}
+
 dogecoin_bool dogecoin_ecc_compact_to_der_normalized(unsigned char* sigcomp_in, unsigned char* sigder_out, size_t* sigder_len_out) {
-    assert(secp256k1_ctx);
+    const secp256k1_context* secp256k1_ctx = dogecoin_ecc_thread_ctx()->ctx;
     secp256k1_ecdsa_signature sig;
     if (!secp256k1_ecdsa_signature_parse_compact(secp256k1_ctx, &sig, sigcomp_in)) return false;
     secp256k1_ecdsa_signature sigNorm;
@@ -125,8 +447,138 @@ dogecoin_bool dogecoin_ecc_compact_to_der_normalized(unsigned char* sigcomp_in,
 }
 
 dogecoin_bool dogecoin_ecc_der_to_compact(unsigned char* sigder_in, size_t sigder_len, unsigned char* sigcomp_out) {
-    assert(secp256k1_ctx);
+    const secp256k1_context* secp256k1_ctx = dogecoin_ecc_thread_ctx()->ctx;
     secp256k1_ecdsa_signature sig;
     if (!secp256k1_ecdsa_signature_parse_der(secp256k1_ctx, &sig, sigder_in, sigder_len)) return false;
     return secp256k1_ecdsa_signature_serialize_compact(secp256k1_ctx, sigcomp_out, &sig);
 }
+
+dogecoin_bool dogecoin_ecc_get_xonly_pubkey(const uint8_t* private_key, uint8_t* xonly_pubkey) {
+    const secp256k1_context* secp256k1_ctx = dogecoin_ecc_thread_ctx()->ctx;
+    secp256k1_keypair keypair;
+    secp256k1_xonly_pubkey pubkey;
+    dogecoin_bool ret = secp256k1_keypair_create(secp256k1_ctx, &keypair, private_key) &&
+                        secp256k1_keypair_xonly_pub(secp256k1_ctx, &pubkey, NULL, &keypair) &&
+                        secp256k1_xonly_pubkey_serialize(secp256k1_ctx, xonly_pubkey, &pubkey);
+    memset(&keypair, 0, sizeof(keypair));
+    return ret;
+}
+
+dogecoin_bool dogecoin_ecc_schnorr_sign_ctx(const dogecoin_ecc_ctx* ctx, const uint8_t* private_key, const uint256 hash, unsigned char* sig64, const uint8_t* aux_rand32) {
+    const secp256k1_context* secp256k1_ctx = ctx->ctx;
+    secp256k1_keypair keypair;
+    uint8_t aux[32];
+    dogecoin_bool ret;
+    if (!aux_rand32) {
+        if (!dogecoin_random_bytes(aux, sizeof(aux), 0)) return false;
+        aux_rand32 = aux;
+    }
+    ret = secp256k1_keypair_create(secp256k1_ctx, &keypair, private_key) &&
+          secp256k1_schnorrsig_sign(secp256k1_ctx, sig64, hash, &keypair, aux_rand32);
+    memset(&keypair, 0, sizeof(keypair));
+    memset(aux, 0, sizeof(aux));
+    return ret;
+}
+
+dogecoin_bool dogecoin_ecc_schnorr_sign(const uint8_t* private_key, const uint256 hash, unsigned char* sig64, const uint8_t* aux_rand32) {
+    return dogecoin_ecc_schnorr_sign_ctx(dogecoin_ecc_thread_ctx(), private_key, hash, sig64, aux_rand32);
+}
+
+dogecoin_bool dogecoin_ecc_schnorr_verify_ctx(const dogecoin_ecc_ctx* ctx, const uint8_t* xonly_pubkey, const uint256 hash, const unsigned char* sig64) {
+    const secp256k1_context* secp256k1_ctx = ctx->ctx;
+    secp256k1_xonly_pubkey pubkey;
+    if (!secp256k1_xonly_pubkey_parse(secp256k1_ctx, &pubkey, xonly_pubkey)) return false;
+    return secp256k1_schnorrsig_verify(secp256k1_ctx, sig64, hash, 32, &pubkey);
+}
+
+dogecoin_bool dogecoin_ecc_schnorr_verify(const uint8_t* xonly_pubkey, const uint256 hash, const unsigned char* sig64) {
+    return dogecoin_ecc_schnorr_verify_ctx(dogecoin_ecc_thread_ctx(), xonly_pubkey, hash, sig64);
+}
+
+typedef struct schnorr_verify_batch_ {
+    dogecoin_schnorr_check* checks;
+    size_t num_checks;
+    size_t next_check;
+#ifdef HAVE_PTHREAD
+    pthread_mutex_t lock;
+#endif
+} schnorr_verify_batch;
+
+// checks are handed out in small runs so the lock is not taken once per signature
+#define SCHNORR_VERIFY_BATCH_RUN 16
+
+// a thread working on the batch and the context it verifies with
+typedef struct schnorr_verify_worker_ {
+    schnorr_verify_batch* batch;
+    const dogecoin_ecc_ctx* ctx;
+} schnorr_verify_worker;
+
+static void schnorr_verify_batch_run(schnorr_verify_batch* batch, const dogecoin_ecc_ctx* ctx, size_t begin, size_t end) {
+    size_t i;
+    for (i = begin; i < end && i < batch->num_checks; i++) {
+        dogecoin_schnorr_check* check = &batch->checks[i];
+        check->valid = dogecoin_ecc_schnorr_verify_ctx(ctx, check->xonly_pubkey, check->hash, check->sig);
+    }
+}
+
+#ifdef HAVE_PTHREAD
+static void* schnorr_verify_batch_worker(void* arg) {
+    schnorr_verify_worker* worker = arg;
+    schnorr_verify_batch* batch = worker->batch;
+    for (;;) {
+        pthread_mutex_lock(&batch->lock);
+        size_t i = batch->next_check;
+        batch->next_check += SCHNORR_VERIFY_BATCH_RUN;
+        pthread_mutex_unlock(&batch->lock);
+        if (i >= batch->num_checks)
+            break;
+        schnorr_verify_batch_run(batch, worker->ctx, i, i + SCHNORR_VERIFY_BATCH_RUN);
+    }
+    return NULL;
+}
+#endif
+
+dogecoin_bool dogecoin_ecc_schnorr_verify_batch(dogecoin_schnorr_check* checks, size_t num_checks, unsigned int num_threads) {
+    schnorr_verify_batch batch;
+    size_t i;
+    batch.checks = checks;
+    batch.num_checks = num_checks;
+    batch.next_check = 0;
+
+    if (num_threads > (num_checks + SCHNORR_VERIFY_BATCH_RUN - 1) / SCHNORR_VERIFY_BATCH_RUN) {
+        num_threads = (unsigned int)((num_checks + SCHNORR_VERIFY_BATCH_RUN - 1) / SCHNORR_VERIFY_BATCH_RUN);
+    }
+#ifdef HAVE_PTHREAD
+    if (num_threads > 1) {
+        pthread_t* threads = dogecoin_calloc(num_threads, sizeof(pthread_t));
+        schnorr_verify_worker* workers = dogecoin_calloc(num_threads, sizeof(schnorr_verify_worker));
+        unsigned int started = 0;
+        pthread_mutex_init(&batch.lock, NULL);
+        // the calling thread works as well (on its own context), so spawn one thread less
+        workers[0].batch = &batch;
+        workers[0].ctx = dogecoin_ecc_thread_ctx();
+        for (started = 1; started < num_threads; started++) {
+            workers[started].batch = &batch;
+            workers[started].ctx = dogecoin_ecc_worker_ctx(started - 1);
+            if (pthread_create(&threads[started], NULL, schnorr_verify_batch_worker, &workers[started]) != 0)
+                break;
+        }
+        schnorr_verify_batch_worker(&workers[0]);
+        while (started > 1) {
+            pthread_join(threads[--started], NULL);
+        }
+        pthread_mutex_destroy(&batch.lock);
+        dogecoin_free(workers);
+        dogecoin_free(threads);
+    }
+#endif
+    // single threaded (or pthreads not available), run whatever is left
+    if (batch.next_check < num_checks)
+        schnorr_verify_batch_run(&batch, dogecoin_ecc_thread_ctx(), batch.next_check, num_checks);
+
+    for (i = 0; i < num_checks; i++) {
+        if (!checks[i].valid)
+            return false;
+    }
+    return true;
+}
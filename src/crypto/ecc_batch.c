@@ -0,0 +1,123 @@
+/*
+
+ The MIT License (MIT)
+
+ Copyright (c) 2022 The Dogecoin Foundation
+
+ Permission is hereby granted, free of charge, to any person obtaining
+ a copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES
+ OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include <string.h>
+
+#include <dogecoin/crypto/ecc.h>
+#include <dogecoin/mem.h>
+
+// the public secp256k1 api has no point addition that stays in jacobian coordinates, so this
+// file builds on the library's own field and group code (all static, nothing is exported twice)
+#include <secp256k1/include/secp256k1.h>
+#include <secp256k1/src/util.h>
+#include <secp256k1/src/field_impl.h>
+#include <secp256k1/src/group_impl.h>
+
+// points normalized with one field inversion
+#define ECC_SEQUENCE_BATCH 1024
+
+// order of the secp256k1 group, big endian
+static const uint8_t ecc_group_order[32] = {
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfe,
+    0xba, 0xae, 0xdc, 0xe6, 0xaf, 0x48, 0xa0, 0x3b, 0xbf, 0xd2, 0x5e, 0x8c, 0xd0, 0x36, 0x41, 0x41};
+
+dogecoin_bool dogecoin_ecc_private_key_add(uint8_t* private_key, uint64_t n) {
+    uint8_t sum[32];
+    unsigned int carry = 0;
+    int i;
+    for (i = 31; i >= 0; i--) {
+        carry += private_key[i] + (unsigned int)(n & 0xff);
+        sum[i] = (uint8_t)carry;
+        carry >>= 8;
+        n >>= 8;
+    }
+    // wrapping past 2^256 or reaching the group order
+    if (carry || memcmp(sum, ecc_group_order, sizeof(sum)) >= 0) {
+        memset(sum, 0, sizeof(sum));
+        return false;
+    }
+    memcpy(private_key, sum, sizeof(sum));
+    memset(sum, 0, sizeof(sum));
+    return true;
+}
+
+dogecoin_bool dogecoin_ecc_get_pubkey_sequence(const uint8_t* private_key, size_t n, uint8_t* public_keys, dogecoin_bool compressed) {
+    const size_t keylen = compressed ? DOGECOIN_ECKEY_COMPRESSED_LENGTH : DOGECOIN_ECKEY_UNCOMPRESSED_LENGTH;
+    uint8_t last[DOGECOIN_ECKEY_PKEY_LENGTH];
+    uint8_t start[DOGECOIN_ECKEY_UNCOMPRESSED_LENGTH];
+    size_t startlen = sizeof(start);
+    secp256k1_gej* jac;
+    secp256k1_ge* aff;
+    secp256k1_gej acc;
+    secp256k1_ge p;
+    secp256k1_fe x, y;
+    size_t done, m, i;
+
+    if (n == 0)
+        return true;
+    // every key up to k + n - 1 has to be valid
+    memcpy(last, private_key, sizeof(last));
+    if (!dogecoin_ecc_verify_privatekey(private_key) || !dogecoin_ecc_private_key_add(last, n - 1)) {
+        memset(last, 0, sizeof(last));
+        return false;
+    }
+    memset(last, 0, sizeof(last));
+
+    // one scalar multiplication for k * G, every further key is one mixed addition of G
+    dogecoin_ecc_get_pubkey(private_key, start, &startlen, false);
+    if (!secp256k1_fe_set_b32(&x, start + 1) || !secp256k1_fe_set_b32(&y, start + 33))
+        return false;
+    secp256k1_ge_set_xy(&p, &x, &y);
+    secp256k1_gej_set_ge(&acc, &p);
+
+    jac = dogecoin_malloc(ECC_SEQUENCE_BATCH * sizeof(secp256k1_gej));
+    aff = dogecoin_malloc(ECC_SEQUENCE_BATCH * sizeof(secp256k1_ge));
+    for (done = 0; done < n; done += m) {
+        m = n - done < ECC_SEQUENCE_BATCH ? n - done : ECC_SEQUENCE_BATCH;
+        jac[0] = acc;
+        for (i = 1; i < m; i++) {
+            secp256k1_gej_add_ge_var(&jac[i], &jac[i - 1], &secp256k1_ge_const_g, NULL);
+        }
+        secp256k1_gej_add_ge_var(&acc, &jac[m - 1], &secp256k1_ge_const_g, NULL);
+        // montgomery's trick, one inversion for the whole batch
+        secp256k1_ge_set_all_gej_var(aff, jac, m);
+        for (i = 0; i < m; i++) {
+            uint8_t* out = public_keys + (done + i) * keylen;
+            secp256k1_fe_normalize_var(&aff[i].x);
+            secp256k1_fe_normalize_var(&aff[i].y);
+            secp256k1_fe_get_b32(out + 1, &aff[i].x);
+            if (compressed) {
+                out[0] = secp256k1_fe_is_odd(&aff[i].y) ? 0x03 : 0x02;
+            } else {
+                out[0] = 0x04;
+                secp256k1_fe_get_b32(out + 33, &aff[i].y);
+            }
+        }
+    }
+    dogecoin_free(aff);
+    dogecoin_free(jac);
+    return true;
+}
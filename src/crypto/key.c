@@ -129,9 +129,21 @@ void dogecoin_pubkey_cleanse(dogecoin_pubkey* pubkey) {
 }
 
 void dogecoin_pubkey_get_hash160(const dogecoin_pubkey* pubkey, uint160 hash160) {
-    uint256 hashout;
-    dogecoin_hash_sngl_sha256(pubkey->pubkey, pubkey->compressed ? DOGECOIN_ECKEY_COMPRESSED_LENGTH : DOGECOIN_ECKEY_UNCOMPRESSED_LENGTH, hashout);
-    rmd160(hashout, sizeof(hashout), hash160);
+    dogecoin_hash160(pubkey->pubkey, pubkey->compressed ? DOGECOIN_ECKEY_COMPRESSED_LENGTH : DOGECOIN_ECKEY_UNCOMPRESSED_LENGTH, hash160);
+}
+
+void dogecoin_pubkey_get_hash160_batch(const dogecoin_pubkey* pubkeys, size_t n, uint160* hash160s) {
+    const unsigned char* data[64];
+    size_t lens[64];
+    size_t i, chunk;
+    for (; n > 0; n -= chunk, pubkeys += chunk, hash160s += chunk) {
+        chunk = n < 64 ? n : 64;
+        for (i = 0; i < chunk; i++) {
+            data[i] = pubkeys[i].pubkey;
+            lens[i] = pubkeys[i].compressed ? DOGECOIN_ECKEY_COMPRESSED_LENGTH : DOGECOIN_ECKEY_UNCOMPRESSED_LENGTH;
+        }
+        dogecoin_hash160_batch(data, lens, chunk, hash160s);
+    }
 }
 
 dogecoin_bool dogecoin_pubkey_get_hex(const dogecoin_pubkey* pubkey, char* str, size_t* strsize) {
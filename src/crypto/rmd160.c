@@ -23,9 +23,20 @@
  * OTHER DEALINGS IN THE SOFTWARE.
  */
 
+#ifdef HAVE_CONFIG_H
+#  include <src/libdogecoin-config.h>
+#endif
+
 #include <string.h>
 
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
+#include <dogecoin/crypto/cpu.h>
+#include <dogecoin/crypto/hash.h>
 #include <dogecoin/crypto/rmd160.h>
+#include <dogecoin/crypto/sha2.h>
 
 #define ROL(x, n) (((x) << (n)) | ((x) >> (32 - (n))))
 
@@ -96,7 +107,7 @@
         (c) = ROL((c), 10);                           \
     }
 
-static void compress(uint32_t* MDbuf, uint32_t* X) {
+static void compress(uint32_t* MDbuf, const uint32_t* X) {
     uint32_t aa = MDbuf[0], bb = MDbuf[1], cc = MDbuf[2], dd = MDbuf[3], ee = MDbuf[4];
     uint32_t aaa = MDbuf[0], bbb = MDbuf[1], ccc = MDbuf[2], ddd = MDbuf[3], eee = MDbuf[4];
 
@@ -289,39 +300,237 @@ static void compress(uint32_t* MDbuf, uint32_t* X) {
     MDbuf[0] = ddd;
 }
 
-void rmd160(const uint8_t* msg, uint32_t msg_len, uint8_t* hash) {
-    uint32_t i;
+static const uint32_t rmd160_initial_state[5] = {0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0UL};
+
+// ripemd160 message words are little endian, on little endian targets a block is copied as is
+static void rmd160_load_block(uint32_t* X, const uint8_t* block) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    memcpy(X, block, RMD160_BLOCK_LENGTH);
+#else
     int j;
-    uint32_t digest[5] = {0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0UL};
-    for (i = 0; i < (msg_len >> 6); ++i) {
-        uint32_t chunk[16];
-        for (j = 0; j < 16; ++j) {
-            chunk[j] = (uint32_t)(*(msg++));
-            chunk[j] |= (uint32_t)(*(msg++)) << 8;
-            chunk[j] |= (uint32_t)(*(msg++)) << 16;
-            chunk[j] |= (uint32_t)(*(msg++)) << 24;
+    for (j = 0; j < 16; ++j) {
+        X[j] = (uint32_t)block[4 * j] | ((uint32_t)block[4 * j + 1] << 8) |
+               ((uint32_t)block[4 * j + 2] << 16) | ((uint32_t)block[4 * j + 3] << 24);
+    }
+#endif
+}
+
+static void rmd160_store_digest(const uint32_t* state, size_t stride, uint8_t* hash) {
+    int i;
+    for (i = 0; i < 5; ++i) {
+        const uint32_t w = state[i * stride];
+        *(hash++) = w;
+        *(hash++) = w >> 8;
+        *(hash++) = w >> 16;
+        *(hash++) = w >> 24;
+    }
+}
+
+void rmd160_init(rmd160_context* ctx) {
+    memcpy(ctx->state, rmd160_initial_state, sizeof(ctx->state));
+    ctx->bytes = 0;
+}
+
+void rmd160_write(rmd160_context* ctx, const uint8_t* data, size_t len) {
+    uint32_t X[16];
+    size_t used = ctx->bytes & 63;
+    ctx->bytes += len;
+    if (used) {
+        const size_t fill = RMD160_BLOCK_LENGTH - used;
+        if (len < fill) {
+            memcpy(ctx->buffer + used, data, len);
+            return;
         }
-        compress(digest, chunk);
+        memcpy(ctx->buffer + used, data, fill);
+        rmd160_load_block(X, ctx->buffer);
+        compress(ctx->state, X);
+        data += fill;
+        len -= fill;
+    }
+    for (; len >= RMD160_BLOCK_LENGTH; len -= RMD160_BLOCK_LENGTH, data += RMD160_BLOCK_LENGTH) {
+        rmd160_load_block(X, data);
+        compress(ctx->state, X);
+    }
+    if (len)
+        memcpy(ctx->buffer, data, len);
+}
+
+void rmd160_finalize(uint8_t hash[RMD160_DIGEST_LENGTH], rmd160_context* ctx) {
+    uint32_t X[16];
+    const size_t used = ctx->bytes & 63;
+    const uint64_t bits = ctx->bytes << 3;
+    ctx->buffer[used] = 0x80;
+    memset(ctx->buffer + used + 1, 0, RMD160_BLOCK_LENGTH - used - 1);
+    if (used > 55) {
+        rmd160_load_block(X, ctx->buffer);
+        compress(ctx->state, X);
+        memset(ctx->buffer, 0, RMD160_BLOCK_LENGTH);
+    }
+    rmd160_load_block(X, ctx->buffer);
+    X[14] = (uint32_t)bits;
+    X[15] = (uint32_t)(bits >> 32);
+    compress(ctx->state, X);
+    rmd160_store_digest(ctx->state, 1, hash);
+}
+
+void rmd160(const uint8_t* msg, size_t msg_len, uint8_t* hash) {
+    rmd160_context ctx;
+    rmd160_init(&ctx);
+    rmd160_write(&ctx, msg, msg_len);
+    rmd160_finalize(hash, &ctx);
+}
+
+// a 32 byte message fills words 0..7, then the 1 bit and the 256 bit length
+static void rmd160_load_32(uint32_t* X, const uint8_t* in) {
+    uint8_t block[RMD160_BLOCK_LENGTH];
+    memcpy(block, in, 32);
+    memset(block + 32, 0, RMD160_BLOCK_LENGTH - 32);
+    rmd160_load_block(X, block);
+    X[8] = 0x80;
+    X[14] = 256;
+}
+
+void rmd160_32(const uint8_t* in, uint8_t hash[RMD160_DIGEST_LENGTH]) {
+    uint32_t state[5], X[16];
+    memcpy(state, rmd160_initial_state, sizeof(state));
+    rmd160_load_32(X, in);
+    compress(state, X);
+    rmd160_store_digest(state, 1, hash);
+}
+
+#ifdef ENABLE_SSE2
+void rmd160_transform_4way(uint32_t* state, const uint8_t* const* blocks);
+#endif
+#ifdef ENABLE_AVX2
+void rmd160_transform_8way(uint32_t* state, const uint8_t* const* blocks);
+#endif
+#ifdef ENABLE_AVX512
+void rmd160_transform_16way(uint32_t* state, const uint8_t* const* blocks);
+#endif
+
+/* One block for each of the lanes, state is word major (state[i * lanes + lane]) */
+typedef void (*rmd160_transform_multi_fn)(uint32_t* state, const uint8_t* const* blocks);
+
+/* 0 until the first batch picks the widest lanes (rmd160_detect_once) */
+static rmd160_transform_multi_fn rmd160_transform_multi = NULL;
+static unsigned int rmd160_batch_width = 0;
+
+dogecoin_bool rmd160_set_batch_lanes(unsigned int lanes) {
+    const dogecoin_cpu_features* cpu = dogecoin_cpu_get_features();
+    switch (lanes) {
+        case 1:
+            rmd160_transform_multi = NULL;
+            break;
+#ifdef ENABLE_SSE2
+        case 4:
+            if (!cpu->sse2)
+                return false;
+            rmd160_transform_multi = rmd160_transform_4way;
+            break;
+#endif
+#ifdef ENABLE_AVX2
+        case 8:
+            if (!cpu->avx2)
+                return false;
+            rmd160_transform_multi = rmd160_transform_8way;
+            break;
+#endif
+#ifdef ENABLE_AVX512
+        case 16:
+            if (!cpu->avx512f)
+                return false;
+            rmd160_transform_multi = rmd160_transform_16way;
+            break;
+#endif
+        default:
+            (void)cpu;
+            return false;
+    }
+    rmd160_batch_width = lanes;
+    return true;
+}
+
+static void rmd160_autodetect(void) {
+    if (!rmd160_set_batch_lanes(16) &&
+        !rmd160_set_batch_lanes(8) &&
+        !rmd160_set_batch_lanes(4)) {
+        rmd160_set_batch_lanes(1);
     }
-    // Last chunk
-    {
-        uint32_t chunk[16] = {0};
-        for (i = 0; i < (msg_len & 63); ++i) {
-            chunk[i >> 2] ^= (uint32_t)*msg++ << ((i & 3) << 3);
+}
+
+#ifdef HAVE_PTHREAD
+static pthread_once_t rmd160_detect_flag = PTHREAD_ONCE_INIT;
+
+static void rmd160_detect_first(void) {
+    // keep lanes that were forced before the first batch
+    if (rmd160_batch_width == 0)
+        rmd160_autodetect();
+}
+#endif
+
+// threads racing on the first batch wait for one detection, pthread_once orders the stores before their loads
+static void rmd160_detect_once(void) {
+#ifdef HAVE_PTHREAD
+    pthread_once(&rmd160_detect_flag, rmd160_detect_first);
+#else
+    if (rmd160_batch_width == 0)
+        rmd160_autodetect();
+#endif
+}
+
+void rmd160_32_batch(uint8_t* out, const uint8_t* in, size_t n) {
+    uint32_t state[5 * 16];
+    uint8_t buf[16][RMD160_BLOCK_LENGTH];
+    const uint8_t* blocks[16];
+    size_t i, j;
+
+    rmd160_detect_once();
+    const rmd160_transform_multi_fn transform = rmd160_transform_multi;
+    const size_t width = rmd160_batch_width;
+
+    if (transform) {
+        for (j = 0; j < width; j++) {
+            memset(buf[j] + 32, 0, RMD160_BLOCK_LENGTH - 32);
+            buf[j][32] = 0x80;
+            buf[j][57] = 0x01;
+            blocks[j] = buf[j];
         }
-        chunk[(msg_len >> 2) & 15] ^= (uint32_t)1 << (8 * (msg_len & 3) + 7);
-        if ((msg_len & 63) > 55) {
-            compress(digest, chunk);
-            memset(chunk, 0, 64);
+        for (; n >= width; n -= width) {
+            for (j = 0; j < width; j++) {
+                memcpy(buf[j], in + j * 32, 32);
+                for (i = 0; i < 5; i++) {
+                    state[i * width + j] = rmd160_initial_state[i];
+                }
+            }
+            transform(state, blocks);
+            for (j = 0; j < width; j++) {
+                rmd160_store_digest(state + j, width, out + j * RMD160_DIGEST_LENGTH);
+            }
+            out += width * RMD160_DIGEST_LENGTH;
+            in += width * 32;
         }
-        chunk[14] = msg_len << 3;
-        chunk[15] = (msg_len >> 29);
-        compress(digest, chunk);
     }
-    for (i = 0; i < 5; ++i) {
-        *(hash++) = digest[i];
-        *(hash++) = digest[i] >> 8;
-        *(hash++) = digest[i] >> 16;
-        *(hash++) = digest[i] >> 24;
+    for (; n > 0; n--) {
+        rmd160_32(in, out);
+        out += RMD160_DIGEST_LENGTH;
+        in += 32;
+    }
+}
+
+void dogecoin_hash160_batch(const unsigned char* const datain[], const size_t lens[], size_t n, uint160* hashout) {
+    uint256 sha[64];
+    uint8_t* outs[64];
+    size_t i, chunk;
+
+    for (i = 0; i < 64; i++) {
+        outs[i] = sha[i];
+    }
+    for (; n > 0; n -= chunk) {
+        chunk = n < 64 ? n : 64;
+        sha256_raw_batch(datain, lens, outs, chunk);
+        rmd160_32_batch((uint8_t*)hashout, (const uint8_t*)sha, chunk);
+        datain += chunk;
+        lens += chunk;
+        hashout += chunk;
     }
 }
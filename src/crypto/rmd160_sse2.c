@@ -0,0 +1,264 @@
+/*
+
+ The MIT License (MIT)
+
+ Copyright (c) 2022 The Dogecoin Foundation
+
+ Permission is hereby granted, free of charge, to any person obtaining
+ a copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES
+ OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <emmintrin.h>
+
+// four lane ripemd160 compression for rmd160_32_batch, one message per 32 bit lane,
+// built with -msse2
+
+#define VEC __m128i
+#define ADD(a, b) _mm_add_epi32(a, b)
+#define XOR(a, b) _mm_xor_si128(a, b)
+#define OR(a, b) _mm_or_si128(a, b)
+#define AND(a, b) _mm_and_si128(a, b)
+#define ANDNOT(a, b) _mm_andnot_si128(a, b)
+#define NOT(a) XOR(a, _mm_set1_epi32(-1))
+#define SET1(k) _mm_set1_epi32((int)(k))
+#define ROL(x, n) OR(_mm_slli_epi32(x, n), _mm_srli_epi32(x, 32 - (n)))
+#define F(x, y, z) XOR(XOR(x, y), z)
+#define G(x, y, z) OR(AND(x, y), ANDNOT(x, z))
+#define H(x, y, z) XOR(OR(x, NOT(y)), z)
+#define IQ(x, y, z) OR(AND(x, z), ANDNOT(z, y))
+#define J(x, y, z) XOR(x, OR(y, NOT(z)))
+#define LOAD(p) _mm_loadu_si128((const __m128i*)(p))
+#define STORE(p, v) _mm_storeu_si128((__m128i*)(p), v)
+#define READ(blocks, o) _mm_set_epi32((int)rmd160_sse2_read_le32(blocks[3] + (o)), (int)rmd160_sse2_read_le32(blocks[2] + (o)), \
+                                      (int)rmd160_sse2_read_le32(blocks[1] + (o)), (int)rmd160_sse2_read_le32(blocks[0] + (o)))
+
+// one step on every lane: a = rol(a + f(b, c, d) + x + k, s) + e, c = rol(c, 10)
+#define STEP(f, a, b, c, d, e, x, k, s)                            \
+    do {                                                           \
+        (a) = ADD(ADD((a), f((b), (c), (d))), ADD((x), SET1(k)));  \
+        (a) = ADD(ROL((a), (s)), (e));                             \
+        (c) = ROL((c), 10);                                        \
+    } while (0)
+
+static inline uint32_t rmd160_sse2_read_le32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// 4 independent ripemd160 compressions, state is word major (state[i * 4 + lane])
+void rmd160_transform_4way(uint32_t* state, const uint8_t* const* blocks) {
+    VEC aa = LOAD(state + 0 * 4), bb = LOAD(state + 1 * 4), cc = LOAD(state + 2 * 4), dd = LOAD(state + 3 * 4), ee = LOAD(state + 4 * 4);
+    VEC aaa = aa, bbb = bb, ccc = cc, ddd = dd, eee = ee;
+    VEC X[16];
+    int i;
+
+    for (i = 0; i < 16; i++) {
+        X[i] = READ(blocks, 4 * i);
+    }
+
+    /* round 1 */
+    STEP(F, aa, bb, cc, dd, ee, X[0], 0, 11);
+    STEP(F, ee, aa, bb, cc, dd, X[1], 0, 14);
+    STEP(F, dd, ee, aa, bb, cc, X[2], 0, 15);
+    STEP(F, cc, dd, ee, aa, bb, X[3], 0, 12);
+    STEP(F, bb, cc, dd, ee, aa, X[4], 0, 5);
+    STEP(F, aa, bb, cc, dd, ee, X[5], 0, 8);
+    STEP(F, ee, aa, bb, cc, dd, X[6], 0, 7);
+    STEP(F, dd, ee, aa, bb, cc, X[7], 0, 9);
+    STEP(F, cc, dd, ee, aa, bb, X[8], 0, 11);
+    STEP(F, bb, cc, dd, ee, aa, X[9], 0, 13);
+    STEP(F, aa, bb, cc, dd, ee, X[10], 0, 14);
+    STEP(F, ee, aa, bb, cc, dd, X[11], 0, 15);
+    STEP(F, dd, ee, aa, bb, cc, X[12], 0, 6);
+    STEP(F, cc, dd, ee, aa, bb, X[13], 0, 7);
+    STEP(F, bb, cc, dd, ee, aa, X[14], 0, 9);
+    STEP(F, aa, bb, cc, dd, ee, X[15], 0, 8);
+
+    /* round 2 */
+    STEP(G, ee, aa, bb, cc, dd, X[7], 0x5a827999, 7);
+    STEP(G, dd, ee, aa, bb, cc, X[4], 0x5a827999, 6);
+    STEP(G, cc, dd, ee, aa, bb, X[13], 0x5a827999, 8);
+    STEP(G, bb, cc, dd, ee, aa, X[1], 0x5a827999, 13);
+    STEP(G, aa, bb, cc, dd, ee, X[10], 0x5a827999, 11);
+    STEP(G, ee, aa, bb, cc, dd, X[6], 0x5a827999, 9);
+    STEP(G, dd, ee, aa, bb, cc, X[15], 0x5a827999, 7);
+    STEP(G, cc, dd, ee, aa, bb, X[3], 0x5a827999, 15);
+    STEP(G, bb, cc, dd, ee, aa, X[12], 0x5a827999, 7);
+    STEP(G, aa, bb, cc, dd, ee, X[0], 0x5a827999, 12);
+    STEP(G, ee, aa, bb, cc, dd, X[9], 0x5a827999, 15);
+    STEP(G, dd, ee, aa, bb, cc, X[5], 0x5a827999, 9);
+    STEP(G, cc, dd, ee, aa, bb, X[2], 0x5a827999, 11);
+    STEP(G, bb, cc, dd, ee, aa, X[14], 0x5a827999, 7);
+    STEP(G, aa, bb, cc, dd, ee, X[11], 0x5a827999, 13);
+    STEP(G, ee, aa, bb, cc, dd, X[8], 0x5a827999, 12);
+
+    /* round 3 */
+    STEP(H, dd, ee, aa, bb, cc, X[3], 0x6ed9eba1, 11);
+    STEP(H, cc, dd, ee, aa, bb, X[10], 0x6ed9eba1, 13);
+    STEP(H, bb, cc, dd, ee, aa, X[14], 0x6ed9eba1, 6);
+    STEP(H, aa, bb, cc, dd, ee, X[4], 0x6ed9eba1, 7);
+    STEP(H, ee, aa, bb, cc, dd, X[9], 0x6ed9eba1, 14);
+    STEP(H, dd, ee, aa, bb, cc, X[15], 0x6ed9eba1, 9);
+    STEP(H, cc, dd, ee, aa, bb, X[8], 0x6ed9eba1, 13);
+    STEP(H, bb, cc, dd, ee, aa, X[1], 0x6ed9eba1, 15);
+    STEP(H, aa, bb, cc, dd, ee, X[2], 0x6ed9eba1, 14);
+    STEP(H, ee, aa, bb, cc, dd, X[7], 0x6ed9eba1, 8);
+    STEP(H, dd, ee, aa, bb, cc, X[0], 0x6ed9eba1, 13);
+    STEP(H, cc, dd, ee, aa, bb, X[6], 0x6ed9eba1, 6);
+    STEP(H, bb, cc, dd, ee, aa, X[13], 0x6ed9eba1, 5);
+    STEP(H, aa, bb, cc, dd, ee, X[11], 0x6ed9eba1, 12);
+    STEP(H, ee, aa, bb, cc, dd, X[5], 0x6ed9eba1, 7);
+    STEP(H, dd, ee, aa, bb, cc, X[12], 0x6ed9eba1, 5);
+
+    /* round 4 */
+    STEP(IQ, cc, dd, ee, aa, bb, X[1], 0x8f1bbcdc, 11);
+    STEP(IQ, bb, cc, dd, ee, aa, X[9], 0x8f1bbcdc, 12);
+    STEP(IQ, aa, bb, cc, dd, ee, X[11], 0x8f1bbcdc, 14);
+    STEP(IQ, ee, aa, bb, cc, dd, X[10], 0x8f1bbcdc, 15);
+    STEP(IQ, dd, ee, aa, bb, cc, X[0], 0x8f1bbcdc, 14);
+    STEP(IQ, cc, dd, ee, aa, bb, X[8], 0x8f1bbcdc, 15);
+    STEP(IQ, bb, cc, dd, ee, aa, X[12], 0x8f1bbcdc, 9);
+    STEP(IQ, aa, bb, cc, dd, ee, X[4], 0x8f1bbcdc, 8);
+    STEP(IQ, ee, aa, bb, cc, dd, X[13], 0x8f1bbcdc, 9);
+    STEP(IQ, dd, ee, aa, bb, cc, X[3], 0x8f1bbcdc, 14);
+    STEP(IQ, cc, dd, ee, aa, bb, X[7], 0x8f1bbcdc, 5);
+    STEP(IQ, bb, cc, dd, ee, aa, X[15], 0x8f1bbcdc, 6);
+    STEP(IQ, aa, bb, cc, dd, ee, X[14], 0x8f1bbcdc, 8);
+    STEP(IQ, ee, aa, bb, cc, dd, X[5], 0x8f1bbcdc, 6);
+    STEP(IQ, dd, ee, aa, bb, cc, X[6], 0x8f1bbcdc, 5);
+    STEP(IQ, cc, dd, ee, aa, bb, X[2], 0x8f1bbcdc, 12);
+
+    /* round 5 */
+    STEP(J, bb, cc, dd, ee, aa, X[4], 0xa953fd4e, 9);
+    STEP(J, aa, bb, cc, dd, ee, X[0], 0xa953fd4e, 15);
+    STEP(J, ee, aa, bb, cc, dd, X[5], 0xa953fd4e, 5);
+    STEP(J, dd, ee, aa, bb, cc, X[9], 0xa953fd4e, 11);
+    STEP(J, cc, dd, ee, aa, bb, X[7], 0xa953fd4e, 6);
+    STEP(J, bb, cc, dd, ee, aa, X[12], 0xa953fd4e, 8);
+    STEP(J, aa, bb, cc, dd, ee, X[2], 0xa953fd4e, 13);
+    STEP(J, ee, aa, bb, cc, dd, X[10], 0xa953fd4e, 12);
+    STEP(J, dd, ee, aa, bb, cc, X[14], 0xa953fd4e, 5);
+    STEP(J, cc, dd, ee, aa, bb, X[1], 0xa953fd4e, 12);
+    STEP(J, bb, cc, dd, ee, aa, X[3], 0xa953fd4e, 13);
+    STEP(J, aa, bb, cc, dd, ee, X[8], 0xa953fd4e, 14);
+    STEP(J, ee, aa, bb, cc, dd, X[11], 0xa953fd4e, 11);
+    STEP(J, dd, ee, aa, bb, cc, X[6], 0xa953fd4e, 8);
+    STEP(J, cc, dd, ee, aa, bb, X[15], 0xa953fd4e, 5);
+    STEP(J, bb, cc, dd, ee, aa, X[13], 0xa953fd4e, 6);
+
+    /* parallel round 1 */
+    STEP(J, aaa, bbb, ccc, ddd, eee, X[5], 0x50a28be6, 8);
+    STEP(J, eee, aaa, bbb, ccc, ddd, X[14], 0x50a28be6, 9);
+    STEP(J, ddd, eee, aaa, bbb, ccc, X[7], 0x50a28be6, 9);
+    STEP(J, ccc, ddd, eee, aaa, bbb, X[0], 0x50a28be6, 11);
+    STEP(J, bbb, ccc, ddd, eee, aaa, X[9], 0x50a28be6, 13);
+    STEP(J, aaa, bbb, ccc, ddd, eee, X[2], 0x50a28be6, 15);
+    STEP(J, eee, aaa, bbb, ccc, ddd, X[11], 0x50a28be6, 15);
+    STEP(J, ddd, eee, aaa, bbb, ccc, X[4], 0x50a28be6, 5);
+    STEP(J, ccc, ddd, eee, aaa, bbb, X[13], 0x50a28be6, 7);
+    STEP(J, bbb, ccc, ddd, eee, aaa, X[6], 0x50a28be6, 7);
+    STEP(J, aaa, bbb, ccc, ddd, eee, X[15], 0x50a28be6, 8);
+    STEP(J, eee, aaa, bbb, ccc, ddd, X[8], 0x50a28be6, 11);
+    STEP(J, ddd, eee, aaa, bbb, ccc, X[1], 0x50a28be6, 14);
+    STEP(J, ccc, ddd, eee, aaa, bbb, X[10], 0x50a28be6, 14);
+    STEP(J, bbb, ccc, ddd, eee, aaa, X[3], 0x50a28be6, 12);
+    STEP(J, aaa, bbb, ccc, ddd, eee, X[12], 0x50a28be6, 6);
+
+    /* parallel round 2 */
+    STEP(IQ, eee, aaa, bbb, ccc, ddd, X[6], 0x5c4dd124, 9);
+    STEP(IQ, ddd, eee, aaa, bbb, ccc, X[11], 0x5c4dd124, 13);
+    STEP(IQ, ccc, ddd, eee, aaa, bbb, X[3], 0x5c4dd124, 15);
+    STEP(IQ, bbb, ccc, ddd, eee, aaa, X[7], 0x5c4dd124, 7);
+    STEP(IQ, aaa, bbb, ccc, ddd, eee, X[0], 0x5c4dd124, 12);
+    STEP(IQ, eee, aaa, bbb, ccc, ddd, X[13], 0x5c4dd124, 8);
+    STEP(IQ, ddd, eee, aaa, bbb, ccc, X[5], 0x5c4dd124, 9);
+    STEP(IQ, ccc, ddd, eee, aaa, bbb, X[10], 0x5c4dd124, 11);
+    STEP(IQ, bbb, ccc, ddd, eee, aaa, X[14], 0x5c4dd124, 7);
+    STEP(IQ, aaa, bbb, ccc, ddd, eee, X[15], 0x5c4dd124, 7);
+    STEP(IQ, eee, aaa, bbb, ccc, ddd, X[8], 0x5c4dd124, 12);
+    STEP(IQ, ddd, eee, aaa, bbb, ccc, X[12], 0x5c4dd124, 7);
+    STEP(IQ, ccc, ddd, eee, aaa, bbb, X[4], 0x5c4dd124, 6);
+    STEP(IQ, bbb, ccc, ddd, eee, aaa, X[9], 0x5c4dd124, 15);
+    STEP(IQ, aaa, bbb, ccc, ddd, eee, X[1], 0x5c4dd124, 13);
+    STEP(IQ, eee, aaa, bbb, ccc, ddd, X[2], 0x5c4dd124, 11);
+
+    /* parallel round 3 */
+    STEP(H, ddd, eee, aaa, bbb, ccc, X[15], 0x6d703ef3, 9);
+    STEP(H, ccc, ddd, eee, aaa, bbb, X[5], 0x6d703ef3, 7);
+    STEP(H, bbb, ccc, ddd, eee, aaa, X[1], 0x6d703ef3, 15);
+    STEP(H, aaa, bbb, ccc, ddd, eee, X[3], 0x6d703ef3, 11);
+    STEP(H, eee, aaa, bbb, ccc, ddd, X[7], 0x6d703ef3, 8);
+    STEP(H, ddd, eee, aaa, bbb, ccc, X[14], 0x6d703ef3, 6);
+    STEP(H, ccc, ddd, eee, aaa, bbb, X[6], 0x6d703ef3, 6);
+    STEP(H, bbb, ccc, ddd, eee, aaa, X[9], 0x6d703ef3, 14);
+    STEP(H, aaa, bbb, ccc, ddd, eee, X[11], 0x6d703ef3, 12);
+    STEP(H, eee, aaa, bbb, ccc, ddd, X[8], 0x6d703ef3, 13);
+    STEP(H, ddd, eee, aaa, bbb, ccc, X[12], 0x6d703ef3, 5);
+    STEP(H, ccc, ddd, eee, aaa, bbb, X[2], 0x6d703ef3, 14);
+    STEP(H, bbb, ccc, ddd, eee, aaa, X[10], 0x6d703ef3, 13);
+    STEP(H, aaa, bbb, ccc, ddd, eee, X[0], 0x6d703ef3, 13);
+    STEP(H, eee, aaa, bbb, ccc, ddd, X[4], 0x6d703ef3, 7);
+    STEP(H, ddd, eee, aaa, bbb, ccc, X[13], 0x6d703ef3, 5);
+
+    /* parallel round 4 */
+    STEP(G, ccc, ddd, eee, aaa, bbb, X[8], 0x7a6d76e9, 15);
+    STEP(G, bbb, ccc, ddd, eee, aaa, X[6], 0x7a6d76e9, 5);
+    STEP(G, aaa, bbb, ccc, ddd, eee, X[4], 0x7a6d76e9, 8);
+    STEP(G, eee, aaa, bbb, ccc, ddd, X[1], 0x7a6d76e9, 11);
+    STEP(G, ddd, eee, aaa, bbb, ccc, X[3], 0x7a6d76e9, 14);
+    STEP(G, ccc, ddd, eee, aaa, bbb, X[11], 0x7a6d76e9, 14);
+    STEP(G, bbb, ccc, ddd, eee, aaa, X[15], 0x7a6d76e9, 6);
+    STEP(G, aaa, bbb, ccc, ddd, eee, X[0], 0x7a6d76e9, 14);
+    STEP(G, eee, aaa, bbb, ccc, ddd, X[5], 0x7a6d76e9, 6);
+    STEP(G, ddd, eee, aaa, bbb, ccc, X[12], 0x7a6d76e9, 9);
+    STEP(G, ccc, ddd, eee, aaa, bbb, X[2], 0x7a6d76e9, 12);
+    STEP(G, bbb, ccc, ddd, eee, aaa, X[13], 0x7a6d76e9, 9);
+    STEP(G, aaa, bbb, ccc, ddd, eee, X[9], 0x7a6d76e9, 12);
+    STEP(G, eee, aaa, bbb, ccc, ddd, X[7], 0x7a6d76e9, 5);
+    STEP(G, ddd, eee, aaa, bbb, ccc, X[10], 0x7a6d76e9, 15);
+    STEP(G, ccc, ddd, eee, aaa, bbb, X[14], 0x7a6d76e9, 8);
+
+    /* parallel round 5 */
+    STEP(F, bbb, ccc, ddd, eee, aaa, X[12], 0, 8);
+    STEP(F, aaa, bbb, ccc, ddd, eee, X[15], 0, 5);
+    STEP(F, eee, aaa, bbb, ccc, ddd, X[10], 0, 12);
+    STEP(F, ddd, eee, aaa, bbb, ccc, X[4], 0, 9);
+    STEP(F, ccc, ddd, eee, aaa, bbb, X[1], 0, 12);
+    STEP(F, bbb, ccc, ddd, eee, aaa, X[5], 0, 5);
+    STEP(F, aaa, bbb, ccc, ddd, eee, X[8], 0, 14);
+    STEP(F, eee, aaa, bbb, ccc, ddd, X[7], 0, 6);
+    STEP(F, ddd, eee, aaa, bbb, ccc, X[6], 0, 8);
+    STEP(F, ccc, ddd, eee, aaa, bbb, X[2], 0, 13);
+    STEP(F, bbb, ccc, ddd, eee, aaa, X[13], 0, 6);
+    STEP(F, aaa, bbb, ccc, ddd, eee, X[14], 0, 5);
+    STEP(F, eee, aaa, bbb, ccc, ddd, X[0], 0, 15);
+    STEP(F, ddd, eee, aaa, bbb, ccc, X[3], 0, 13);
+    STEP(F, ccc, ddd, eee, aaa, bbb, X[9], 0, 11);
+    STEP(F, bbb, ccc, ddd, eee, aaa, X[11], 0, 11);
+
+    /* combine results */
+    ddd = ADD(ddd, ADD(cc, LOAD(state + 1 * 4)));
+    STORE(state + 1 * 4, ADD(LOAD(state + 2 * 4), ADD(dd, eee)));
+    STORE(state + 2 * 4, ADD(LOAD(state + 3 * 4), ADD(ee, aaa)));
+    STORE(state + 3 * 4, ADD(LOAD(state + 4 * 4), ADD(aa, bbb)));
+    STORE(state + 4 * 4, ADD(LOAD(state + 0 * 4), ADD(bb, ccc)));
+    STORE(state + 0 * 4, ddd);
+}
@@ -0,0 +1,336 @@
+/*
+
+ The MIT License (MIT)
+
+ Copyright (c) 2022 The Dogecoin Foundation
+
+ Permission is hereby granted, free of charge, to any person obtaining
+ a copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES
+ OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+#ifdef HAVE_CONFIG_H
+#  include <src/libdogecoin-config.h>
+#endif
+
+#include <stdint.h>
+#include <string.h>
+
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
+#include <dogecoin/crypto/cpu.h>
+#include <dogecoin/crypto/scrypt.h>
+#include <dogecoin/crypto/sha2.h>
+#include <dogecoin/mem.h>
+
+#define SCRYPT_N 1024
+// r = 1, B is a single 128 byte block of 32 little endian words
+#define SCRYPT_BLOCK_WORDS 32
+#define SCRYPT_BLOCK_LENGTH (SCRYPT_BLOCK_WORDS * 4)
+// the multi lane cores load and gather whole vectors, keep the scratchpad cache line aligned
+#define SCRYPT_SCRATCHPAD_SIZE (SCRYPT_N * SCRYPT_BLOCK_LENGTH + 63)
+#define SCRYPT_MAX_LANES 16
+
+#define ROTL32(a, b) (((a) << (b)) | ((a) >> (32 - (b))))
+
+static inline uint32_t scrypt_read_le32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline void scrypt_write_le32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static inline uint32_t* scrypt_align64(void* p) {
+    return (uint32_t*)(((uintptr_t)p + 63) & ~(uintptr_t)63);
+}
+
+// B = salsa20/8(B ^ Bx) + (B ^ Bx)
+static void scrypt_xor_salsa8(uint32_t B[16], const uint32_t Bx[16]) {
+    uint32_t x00, x01, x02, x03, x04, x05, x06, x07, x08, x09, x10, x11, x12, x13, x14, x15;
+    int i;
+
+    x00 = (B[0] ^= Bx[0]);
+    x01 = (B[1] ^= Bx[1]);
+    x02 = (B[2] ^= Bx[2]);
+    x03 = (B[3] ^= Bx[3]);
+    x04 = (B[4] ^= Bx[4]);
+    x05 = (B[5] ^= Bx[5]);
+    x06 = (B[6] ^= Bx[6]);
+    x07 = (B[7] ^= Bx[7]);
+    x08 = (B[8] ^= Bx[8]);
+    x09 = (B[9] ^= Bx[9]);
+    x10 = (B[10] ^= Bx[10]);
+    x11 = (B[11] ^= Bx[11]);
+    x12 = (B[12] ^= Bx[12]);
+    x13 = (B[13] ^= Bx[13]);
+    x14 = (B[14] ^= Bx[14]);
+    x15 = (B[15] ^= Bx[15]);
+    for (i = 0; i < 8; i += 2) {
+        /* columns */
+        x04 ^= ROTL32(x00 + x12, 7);
+        x09 ^= ROTL32(x05 + x01, 7);
+        x14 ^= ROTL32(x10 + x06, 7);
+        x03 ^= ROTL32(x15 + x11, 7);
+        x08 ^= ROTL32(x04 + x00, 9);
+        x13 ^= ROTL32(x09 + x05, 9);
+        x02 ^= ROTL32(x14 + x10, 9);
+        x07 ^= ROTL32(x03 + x15, 9);
+        x12 ^= ROTL32(x08 + x04, 13);
+        x01 ^= ROTL32(x13 + x09, 13);
+        x06 ^= ROTL32(x02 + x14, 13);
+        x11 ^= ROTL32(x07 + x03, 13);
+        x00 ^= ROTL32(x12 + x08, 18);
+        x05 ^= ROTL32(x01 + x13, 18);
+        x10 ^= ROTL32(x06 + x02, 18);
+        x15 ^= ROTL32(x11 + x07, 18);
+        /* rows */
+        x01 ^= ROTL32(x00 + x03, 7);
+        x06 ^= ROTL32(x05 + x04, 7);
+        x11 ^= ROTL32(x10 + x09, 7);
+        x12 ^= ROTL32(x15 + x14, 7);
+        x02 ^= ROTL32(x01 + x00, 9);
+        x07 ^= ROTL32(x06 + x05, 9);
+        x08 ^= ROTL32(x11 + x10, 9);
+        x13 ^= ROTL32(x12 + x15, 9);
+        x03 ^= ROTL32(x02 + x01, 13);
+        x04 ^= ROTL32(x07 + x06, 13);
+        x09 ^= ROTL32(x08 + x11, 13);
+        x14 ^= ROTL32(x13 + x12, 13);
+        x00 ^= ROTL32(x03 + x02, 18);
+        x05 ^= ROTL32(x04 + x07, 18);
+        x10 ^= ROTL32(x09 + x08, 18);
+        x15 ^= ROTL32(x14 + x13, 18);
+    }
+    B[0] += x00;
+    B[1] += x01;
+    B[2] += x02;
+    B[3] += x03;
+    B[4] += x04;
+    B[5] += x05;
+    B[6] += x06;
+    B[7] += x07;
+    B[8] += x08;
+    B[9] += x09;
+    B[10] += x10;
+    B[11] += x11;
+    B[12] += x12;
+    B[13] += x13;
+    B[14] += x14;
+    B[15] += x15;
+}
+
+// X = romix(X), V is a scratchpad of SCRYPT_N blocks
+static void scrypt_romix_standard(uint32_t* X, uint32_t* V) {
+    int i, k;
+
+    for (i = 0; i < SCRYPT_N; i++) {
+        memcpy(&V[i * SCRYPT_BLOCK_WORDS], X, SCRYPT_BLOCK_LENGTH);
+        scrypt_xor_salsa8(X, X + 16);
+        scrypt_xor_salsa8(X + 16, X);
+    }
+    for (i = 0; i < SCRYPT_N; i++) {
+        const uint32_t* v = &V[(X[16] & (SCRYPT_N - 1)) * SCRYPT_BLOCK_WORDS];
+        for (k = 0; k < SCRYPT_BLOCK_WORDS; k++) {
+            X[k] ^= v[k];
+        }
+        scrypt_xor_salsa8(X, X + 16);
+        scrypt_xor_salsa8(X + 16, X);
+    }
+}
+
+#ifdef ENABLE_SSE2
+void scrypt_romix_sse2(uint32_t* X, uint32_t* V);
+void scrypt_romix_4way(uint32_t* X, uint32_t* V);
+#endif
+#ifdef ENABLE_AVX2
+void scrypt_romix_8way(uint32_t* X, uint32_t* V);
+#endif
+#ifdef ENABLE_AVX512
+void scrypt_romix_16way(uint32_t* X, uint32_t* V);
+#endif
+
+typedef void (*scrypt_romix_fn)(uint32_t* X, uint32_t* V);
+
+static void scrypt_romix_autodetect(uint32_t* X, uint32_t* V);
+
+static scrypt_romix_fn scrypt_romix_impl = scrypt_romix_autodetect;
+static const char* scrypt_romix_name = "standard";
+static scrypt_romix_fn scrypt_romix_multi = NULL;
+static unsigned int scrypt_batch_width = 1;
+
+dogecoin_bool scrypt_set_implementation(enum scrypt_implementation impl) {
+    const dogecoin_cpu_features* cpu = dogecoin_cpu_get_features();
+    switch (impl) {
+#ifdef ENABLE_SSE2
+        case SCRYPT_IMPL_SSE2:
+            if (!cpu->sse2)
+                return false;
+            scrypt_romix_impl = scrypt_romix_sse2;
+            scrypt_romix_name = "sse2";
+            break;
+#endif
+        case SCRYPT_IMPL_STANDARD:
+            scrypt_romix_impl = scrypt_romix_standard;
+            scrypt_romix_name = "standard";
+            break;
+        default:
+            (void)cpu;
+            return false;
+    }
+    return true;
+}
+
+dogecoin_bool scrypt_set_batch_lanes(unsigned int lanes) {
+    const dogecoin_cpu_features* cpu = dogecoin_cpu_get_features();
+    switch (lanes) {
+        case 1:
+            scrypt_romix_multi = NULL;
+            break;
+#ifdef ENABLE_SSE2
+        case 4:
+            if (!cpu->sse2)
+                return false;
+            scrypt_romix_multi = scrypt_romix_4way;
+            break;
+#endif
+#ifdef ENABLE_AVX2
+        case 8:
+            if (!cpu->avx2)
+                return false;
+            scrypt_romix_multi = scrypt_romix_8way;
+            break;
+#endif
+#ifdef ENABLE_AVX512
+        case 16:
+            if (!cpu->avx512f)
+                return false;
+            scrypt_romix_multi = scrypt_romix_16way;
+            break;
+#endif
+        default:
+            (void)cpu;
+            return false;
+    }
+    scrypt_batch_width = lanes;
+    return true;
+}
+
+const char* scrypt_autodetect(void) {
+    if (!scrypt_set_implementation(SCRYPT_IMPL_SSE2))
+        scrypt_set_implementation(SCRYPT_IMPL_STANDARD);
+    if (!scrypt_set_batch_lanes(16) &&
+        !scrypt_set_batch_lanes(8) &&
+        !scrypt_set_batch_lanes(4)) {
+        scrypt_set_batch_lanes(1);
+    }
+    return scrypt_romix_name;
+}
+
+#ifdef HAVE_PTHREAD
+static pthread_once_t scrypt_detect_flag = PTHREAD_ONCE_INIT;
+
+static void scrypt_detect_first(void) {
+    // keep an implementation that was forced before the first use
+    if (scrypt_romix_impl == scrypt_romix_autodetect)
+        scrypt_autodetect();
+}
+#endif
+
+// threads racing on the first hash wait for one detection, pthread_once orders the pointer stores before their loads
+static void scrypt_detect_once(void) {
+#ifdef HAVE_PTHREAD
+    pthread_once(&scrypt_detect_flag, scrypt_detect_first);
+#else
+    if (scrypt_romix_impl == scrypt_romix_autodetect)
+        scrypt_autodetect();
+#endif
+}
+
+static void scrypt_romix_autodetect(uint32_t* X, uint32_t* V) {
+    scrypt_detect_once();
+    scrypt_romix_impl(X, V);
+}
+
+void scrypt_1024_1_1_256(const uint8_t* input, uint8_t output[SCRYPT_POW_OUTPUT_LENGTH]) {
+    uint8_t scratchpad[SCRYPT_SCRATCHPAD_SIZE];
+    uint32_t X[SCRYPT_BLOCK_WORDS];
+    uint8_t B[SCRYPT_BLOCK_LENGTH];
+    hmac_sha256_ctx ctx;
+    int k;
+
+    // both pbkdf2 passes are keyed with the header, pad it once
+    hmac_sha256_prepare(&ctx, input, SCRYPT_POW_INPUT_LENGTH);
+    pbkdf2_hmac_sha256_ctx(&ctx, input, SCRYPT_POW_INPUT_LENGTH, 1, B, SCRYPT_BLOCK_LENGTH);
+    for (k = 0; k < SCRYPT_BLOCK_WORDS; k++) {
+        X[k] = scrypt_read_le32(B + k * 4);
+    }
+    scrypt_romix_impl(X, scrypt_align64(scratchpad));
+    for (k = 0; k < SCRYPT_BLOCK_WORDS; k++) {
+        scrypt_write_le32(B + k * 4, X[k]);
+    }
+    pbkdf2_hmac_sha256_ctx(&ctx, B, SCRYPT_BLOCK_LENGTH, 1, output, SCRYPT_POW_OUTPUT_LENGTH);
+}
+
+void scrypt_1024_1_1_256_batch(uint8_t* out, const uint8_t* in, size_t n) {
+    uint32_t xbuf[SCRYPT_BLOCK_WORDS * SCRYPT_MAX_LANES + 16];
+    uint8_t B[SCRYPT_MAX_LANES][SCRYPT_BLOCK_LENGTH];
+    hmac_sha256_ctx ctx[SCRYPT_MAX_LANES];
+    size_t j, k;
+
+    scrypt_detect_once();
+    const scrypt_romix_fn romix = scrypt_romix_multi;
+    const size_t width = scrypt_batch_width;
+
+    if (romix && n >= width) {
+        // word major, word k of lane j at X[k * width + j]
+        uint32_t* X = scrypt_align64(xbuf);
+        void* scratchpad = dogecoin_malloc(width * SCRYPT_N * SCRYPT_BLOCK_LENGTH + 63);
+        uint32_t* V = scrypt_align64(scratchpad);
+        for (; n >= width; n -= width) {
+            for (j = 0; j < width; j++) {
+                const uint8_t* header = in + j * SCRYPT_POW_INPUT_LENGTH;
+                hmac_sha256_prepare(&ctx[j], header, SCRYPT_POW_INPUT_LENGTH);
+                pbkdf2_hmac_sha256_ctx(&ctx[j], header, SCRYPT_POW_INPUT_LENGTH, 1, B[j], SCRYPT_BLOCK_LENGTH);
+                for (k = 0; k < SCRYPT_BLOCK_WORDS; k++) {
+                    X[k * width + j] = scrypt_read_le32(B[j] + k * 4);
+                }
+            }
+            romix(X, V);
+            for (j = 0; j < width; j++) {
+                for (k = 0; k < SCRYPT_BLOCK_WORDS; k++) {
+                    scrypt_write_le32(B[j] + k * 4, X[k * width + j]);
+                }
+                pbkdf2_hmac_sha256_ctx(&ctx[j], B[j], SCRYPT_BLOCK_LENGTH, 1, out + j * SCRYPT_POW_OUTPUT_LENGTH, SCRYPT_POW_OUTPUT_LENGTH);
+            }
+            in += width * SCRYPT_POW_INPUT_LENGTH;
+            out += width * SCRYPT_POW_OUTPUT_LENGTH;
+        }
+        dogecoin_free(scratchpad);
+    }
+    for (; n > 0; n--) {
+        scrypt_1024_1_1_256(in, out);
+        in += SCRYPT_POW_INPUT_LENGTH;
+        out += SCRYPT_POW_OUTPUT_LENGTH;
+    }
+}
@@ -0,0 +1,151 @@
+/*
+
+ The MIT License (MIT)
+
+ Copyright (c) 2022 The Dogecoin Foundation
+
+ Permission is hereby granted, free of charge, to any person obtaining
+ a copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES
+ OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <immintrin.h>
+
+// sixteen lane scrypt romix (N = 1024, r = 1) for scrypt_1024_1_1_256_batch, one hash per 32 bit lane,
+// built with -mavx512f and only called after cpuid reported support
+
+#define VEC __m512i
+#define ADD(a, b) _mm512_add_epi32(a, b)
+#define XOR(a, b) _mm512_xor_si512(a, b)
+#define ROL(x, n) _mm512_rol_epi32(x, n)
+#define LOAD(p) _mm512_load_si512((const void*)(p))
+#define STORE(p, v) _mm512_store_si512((void*)(p), v)
+
+#define SCRYPT_N 1024
+
+// a ^= rol(b + c, n)
+#define QR(a, b, c, n) (a) = XOR((a), ROL(ADD((b), (c)), (n)))
+
+// B = salsa20/8(B ^ Bx) + (B ^ Bx) on every lane, word w of all lanes is in B[w]
+static inline void scrypt_xor_salsa8_16way(VEC* B, const VEC* Bx) {
+    VEC x00, x01, x02, x03, x04, x05, x06, x07, x08, x09, x10, x11, x12, x13, x14, x15;
+    int i;
+
+    x00 = B[0] = XOR(B[0], Bx[0]);
+    x01 = B[1] = XOR(B[1], Bx[1]);
+    x02 = B[2] = XOR(B[2], Bx[2]);
+    x03 = B[3] = XOR(B[3], Bx[3]);
+    x04 = B[4] = XOR(B[4], Bx[4]);
+    x05 = B[5] = XOR(B[5], Bx[5]);
+    x06 = B[6] = XOR(B[6], Bx[6]);
+    x07 = B[7] = XOR(B[7], Bx[7]);
+    x08 = B[8] = XOR(B[8], Bx[8]);
+    x09 = B[9] = XOR(B[9], Bx[9]);
+    x10 = B[10] = XOR(B[10], Bx[10]);
+    x11 = B[11] = XOR(B[11], Bx[11]);
+    x12 = B[12] = XOR(B[12], Bx[12]);
+    x13 = B[13] = XOR(B[13], Bx[13]);
+    x14 = B[14] = XOR(B[14], Bx[14]);
+    x15 = B[15] = XOR(B[15], Bx[15]);
+    for (i = 0; i < 8; i += 2) {
+        /* columns */
+        QR(x04, x00, x12, 7);
+        QR(x09, x05, x01, 7);
+        QR(x14, x10, x06, 7);
+        QR(x03, x15, x11, 7);
+        QR(x08, x04, x00, 9);
+        QR(x13, x09, x05, 9);
+        QR(x02, x14, x10, 9);
+        QR(x07, x03, x15, 9);
+        QR(x12, x08, x04, 13);
+        QR(x01, x13, x09, 13);
+        QR(x06, x02, x14, 13);
+        QR(x11, x07, x03, 13);
+        QR(x00, x12, x08, 18);
+        QR(x05, x01, x13, 18);
+        QR(x10, x06, x02, 18);
+        QR(x15, x11, x07, 18);
+        /* rows */
+        QR(x01, x00, x03, 7);
+        QR(x06, x05, x04, 7);
+        QR(x11, x10, x09, 7);
+        QR(x12, x15, x14, 7);
+        QR(x02, x01, x00, 9);
+        QR(x07, x06, x05, 9);
+        QR(x08, x11, x10, 9);
+        QR(x13, x12, x15, 9);
+        QR(x03, x02, x01, 13);
+        QR(x04, x07, x06, 13);
+        QR(x09, x08, x11, 13);
+        QR(x14, x13, x12, 13);
+        QR(x00, x03, x02, 18);
+        QR(x05, x04, x07, 18);
+        QR(x10, x09, x08, 18);
+        QR(x15, x14, x13, 18);
+    }
+    B[0] = ADD(B[0], x00);
+    B[1] = ADD(B[1], x01);
+    B[2] = ADD(B[2], x02);
+    B[3] = ADD(B[3], x03);
+    B[4] = ADD(B[4], x04);
+    B[5] = ADD(B[5], x05);
+    B[6] = ADD(B[6], x06);
+    B[7] = ADD(B[7], x07);
+    B[8] = ADD(B[8], x08);
+    B[9] = ADD(B[9], x09);
+    B[10] = ADD(B[10], x10);
+    B[11] = ADD(B[11], x11);
+    B[12] = ADD(B[12], x12);
+    B[13] = ADD(B[13], x13);
+    B[14] = ADD(B[14], x14);
+    B[15] = ADD(B[15], x15);
+}
+
+// X is word major (X[w * 16 + lane]), V is the 16 lane scratchpad of SCRYPT_N * 32 * 16 words
+void scrypt_romix_16way(uint32_t* X, uint32_t* V) {
+    VEC B[32];
+    const __m512i mask = _mm512_set1_epi32(SCRYPT_N - 1);
+    const __m512i lanes = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    int i, w;
+
+    for (w = 0; w < 32; w++) {
+        B[w] = LOAD(X + w * 16);
+    }
+    for (i = 0; i < SCRYPT_N; i++) {
+        for (w = 0; w < 32; w++) {
+            STORE(V + (i * 32 + w) * 16, B[w]);
+        }
+        scrypt_xor_salsa8_16way(B, B + 16);
+        scrypt_xor_salsa8_16way(B + 16, B);
+    }
+    for (i = 0; i < SCRYPT_N; i++) {
+        // word w of lane l is at V[(j_l * 32 + w) * 16 + l]
+        const __m512i idx = _mm512_add_epi32(_mm512_slli_epi32(_mm512_and_si512(B[16], mask), 9), lanes);
+        for (w = 0; w < 32; w++) {
+            B[w] = XOR(B[w], _mm512_i32gather_epi32(idx, (const void*)(V + w * 16), 4));
+        }
+        scrypt_xor_salsa8_16way(B, B + 16);
+        scrypt_xor_salsa8_16way(B + 16, B);
+    }
+    for (w = 0; w < 32; w++) {
+        STORE(X + w * 16, B[w]);
+    }
+}
@@ -0,0 +1,229 @@
+/*
+
+ The MIT License (MIT)
+
+ Copyright (c) 2022 The Dogecoin Foundation
+
+ Permission is hereby granted, free of charge, to any person obtaining
+ a copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES
+ OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <emmintrin.h>
+
+// scrypt romix (N = 1024, r = 1) for scrypt_1024_1_1_256, a single stream core and a four
+// lane core with one hash per 32 bit lane, built with -msse2
+
+#define VEC __m128i
+#define ADD(a, b) _mm_add_epi32(a, b)
+#define XOR(a, b) _mm_xor_si128(a, b)
+#define ROL(x, n) _mm_or_si128(_mm_slli_epi32(x, n), _mm_srli_epi32(x, 32 - (n)))
+#define LOAD(p) _mm_load_si128((const __m128i*)(p))
+#define STORE(p, v) _mm_store_si128((__m128i*)(p), v)
+
+#define SCRYPT_N 1024
+
+// a ^= rol(b + c, n)
+#define QR(a, b, c, n) (a) = XOR((a), ROL(ADD((b), (c)), (n)))
+
+// the 16 words of a salsa20 block are kept in diagonals, (x0, x5, x10, x15), (x4, x9, x14, x3),
+// (x8, x13, x2, x7), (x12, x1, x6, x11), so the column and row quarter rounds are plain lane ops
+// and only a rotation of three vectors sits between them
+static inline void scrypt_xor_salsa8_sse2(VEC* B, const VEC* Bx) {
+    VEC X0 = B[0] = XOR(B[0], Bx[0]);
+    VEC X1 = B[1] = XOR(B[1], Bx[1]);
+    VEC X2 = B[2] = XOR(B[2], Bx[2]);
+    VEC X3 = B[3] = XOR(B[3], Bx[3]);
+    int i;
+
+    for (i = 0; i < 8; i += 2) {
+        /* columns */
+        QR(X1, X0, X3, 7);
+        QR(X2, X1, X0, 9);
+        QR(X3, X2, X1, 13);
+        QR(X0, X3, X2, 18);
+        X1 = _mm_shuffle_epi32(X1, 0x93);
+        X2 = _mm_shuffle_epi32(X2, 0x4e);
+        X3 = _mm_shuffle_epi32(X3, 0x39);
+        /* rows */
+        QR(X3, X0, X1, 7);
+        QR(X2, X3, X0, 9);
+        QR(X1, X2, X3, 13);
+        QR(X0, X1, X2, 18);
+        X1 = _mm_shuffle_epi32(X1, 0x39);
+        X2 = _mm_shuffle_epi32(X2, 0x4e);
+        X3 = _mm_shuffle_epi32(X3, 0x93);
+    }
+    B[0] = ADD(B[0], X0);
+    B[1] = ADD(B[1], X1);
+    B[2] = ADD(B[2], X2);
+    B[3] = ADD(B[3], X3);
+}
+
+// single stream romix, X is the 32 word block in natural order, V a 16 byte aligned
+// scratchpad of SCRYPT_N * 32 words
+void scrypt_romix_sse2(uint32_t* X, uint32_t* V) {
+    uint32_t T[32] __attribute__((aligned(16)));
+    VEC B[8];
+    int i, k;
+
+    for (k = 0; k < 32; k += 16) {
+        for (i = 0; i < 16; i++) {
+            T[k + i] = X[k + i * 5 % 16];
+        }
+    }
+    for (k = 0; k < 8; k++) {
+        B[k] = LOAD(T + k * 4);
+    }
+    for (i = 0; i < SCRYPT_N; i++) {
+        for (k = 0; k < 8; k++) {
+            STORE(V + (i * 8 + k) * 4, B[k]);
+        }
+        scrypt_xor_salsa8_sse2(B, B + 4);
+        scrypt_xor_salsa8_sse2(B + 4, B);
+    }
+    for (i = 0; i < SCRYPT_N; i++) {
+        // x0 of the second half stays in the first lane of B[4]
+        const uint32_t* v = V + (_mm_cvtsi128_si32(B[4]) & (SCRYPT_N - 1)) * 32;
+        for (k = 0; k < 8; k++) {
+            B[k] = XOR(B[k], LOAD(v + k * 4));
+        }
+        scrypt_xor_salsa8_sse2(B, B + 4);
+        scrypt_xor_salsa8_sse2(B + 4, B);
+    }
+    for (k = 0; k < 8; k++) {
+        STORE(T + k * 4, B[k]);
+    }
+    for (k = 0; k < 32; k += 16) {
+        for (i = 0; i < 16; i++) {
+            X[k + i * 5 % 16] = T[k + i];
+        }
+    }
+}
+
+// B = salsa20/8(B ^ Bx) + (B ^ Bx) on every lane, word w of all lanes is in B[w]
+static inline void scrypt_xor_salsa8_4way(VEC* B, const VEC* Bx) {
+    VEC x00, x01, x02, x03, x04, x05, x06, x07, x08, x09, x10, x11, x12, x13, x14, x15;
+    int i;
+
+    x00 = B[0] = XOR(B[0], Bx[0]);
+    x01 = B[1] = XOR(B[1], Bx[1]);
+    x02 = B[2] = XOR(B[2], Bx[2]);
+    x03 = B[3] = XOR(B[3], Bx[3]);
+    x04 = B[4] = XOR(B[4], Bx[4]);
+    x05 = B[5] = XOR(B[5], Bx[5]);
+    x06 = B[6] = XOR(B[6], Bx[6]);
+    x07 = B[7] = XOR(B[7], Bx[7]);
+    x08 = B[8] = XOR(B[8], Bx[8]);
+    x09 = B[9] = XOR(B[9], Bx[9]);
+    x10 = B[10] = XOR(B[10], Bx[10]);
+    x11 = B[11] = XOR(B[11], Bx[11]);
+    x12 = B[12] = XOR(B[12], Bx[12]);
+    x13 = B[13] = XOR(B[13], Bx[13]);
+    x14 = B[14] = XOR(B[14], Bx[14]);
+    x15 = B[15] = XOR(B[15], Bx[15]);
+    for (i = 0; i < 8; i += 2) {
+        /* columns */
+        QR(x04, x00, x12, 7);
+        QR(x09, x05, x01, 7);
+        QR(x14, x10, x06, 7);
+        QR(x03, x15, x11, 7);
+        QR(x08, x04, x00, 9);
+        QR(x13, x09, x05, 9);
+        QR(x02, x14, x10, 9);
+        QR(x07, x03, x15, 9);
+        QR(x12, x08, x04, 13);
+        QR(x01, x13, x09, 13);
+        QR(x06, x02, x14, 13);
+        QR(x11, x07, x03, 13);
+        QR(x00, x12, x08, 18);
+        QR(x05, x01, x13, 18);
+        QR(x10, x06, x02, 18);
+        QR(x15, x11, x07, 18);
+        /* rows */
+        QR(x01, x00, x03, 7);
+        QR(x06, x05, x04, 7);
+        QR(x11, x10, x09, 7);
+        QR(x12, x15, x14, 7);
+        QR(x02, x01, x00, 9);
+        QR(x07, x06, x05, 9);
+        QR(x08, x11, x10, 9);
+        QR(x13, x12, x15, 9);
+        QR(x03, x02, x01, 13);
+        QR(x04, x07, x06, 13);
+        QR(x09, x08, x11, 13);
+        QR(x14, x13, x12, 13);
+        QR(x00, x03, x02, 18);
+        QR(x05, x04, x07, 18);
+        QR(x10, x09, x08, 18);
+        QR(x15, x14, x13, 18);
+    }
+    B[0] = ADD(B[0], x00);
+    B[1] = ADD(B[1], x01);
+    B[2] = ADD(B[2], x02);
+    B[3] = ADD(B[3], x03);
+    B[4] = ADD(B[4], x04);
+    B[5] = ADD(B[5], x05);
+    B[6] = ADD(B[6], x06);
+    B[7] = ADD(B[7], x07);
+    B[8] = ADD(B[8], x08);
+    B[9] = ADD(B[9], x09);
+    B[10] = ADD(B[10], x10);
+    B[11] = ADD(B[11], x11);
+    B[12] = ADD(B[12], x12);
+    B[13] = ADD(B[13], x13);
+    B[14] = ADD(B[14], x14);
+    B[15] = ADD(B[15], x15);
+}
+
+// X is word major (X[w * 4 + lane]), V is the 4 lane scratchpad of SCRYPT_N * 32 * 4 words
+void scrypt_romix_4way(uint32_t* X, uint32_t* V) {
+    VEC B[32];
+    int i, w;
+
+    for (w = 0; w < 32; w++) {
+        B[w] = LOAD(X + w * 4);
+    }
+    for (i = 0; i < SCRYPT_N; i++) {
+        for (w = 0; w < 32; w++) {
+            STORE(V + (i * 32 + w) * 4, B[w]);
+        }
+        scrypt_xor_salsa8_4way(B, B + 16);
+        scrypt_xor_salsa8_4way(B + 16, B);
+    }
+    for (i = 0; i < SCRYPT_N; i++) {
+        // sse2 has no gather, each lane picks its own block
+        uint32_t j[4] __attribute__((aligned(16)));
+        STORE(j, B[16]);
+        const uint32_t* v0 = V + (j[0] & (SCRYPT_N - 1)) * 32 * 4 + 0;
+        const uint32_t* v1 = V + (j[1] & (SCRYPT_N - 1)) * 32 * 4 + 1;
+        const uint32_t* v2 = V + (j[2] & (SCRYPT_N - 1)) * 32 * 4 + 2;
+        const uint32_t* v3 = V + (j[3] & (SCRYPT_N - 1)) * 32 * 4 + 3;
+        for (w = 0; w < 32; w++) {
+            B[w] = XOR(B[w], _mm_set_epi32((int)v3[w * 4], (int)v2[w * 4], (int)v1[w * 4], (int)v0[w * 4]));
+        }
+        scrypt_xor_salsa8_4way(B, B + 16);
+        scrypt_xor_salsa8_4way(B + 16, B);
+    }
+    for (w = 0; w < 32; w++) {
+        STORE(X + w * 4, B[w]);
+    }
+}
@@ -30,10 +30,21 @@
  * SUCH DAMAGE.
  */
 
+#ifdef HAVE_CONFIG_H
+#  include <src/libdogecoin-config.h>
+#endif
+
 #include <string.h>
 #include <stdint.h>
 
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
+#include <dogecoin/crypto/cpu.h>
 #include <dogecoin/crypto/sha2.h>
+#include <dogecoin/mem.h>
+
 
 /*
  * ASSERT NOTE:
@@ -355,9 +366,14 @@ static const sha2_word64 sha512_initial_hash_value[8] = {
     0x5be0cd19137e2179ULL};
 
 
+static void sha256_detect_once(void);
+static void sha512_detect_once(void);
+
 /*** SHA-256: *********************************************************/
 void sha256_init(sha256_context* context) {
     if (context == (sha256_context*)0) return;
+    // every context starts here, so the transform pointers are published before it is used
+    sha256_detect_once();
     MEMCPY_BCOPY(context->state, sha256_initial_hash_value, SHA256_DIGEST_LENGTH);
     MEMSET_BZERO(context->buffer, SHA256_BLOCK_LENGTH);
     context->bitcount = 0;
@@ -397,22 +413,20 @@ void sha256_init(sha256_context* context) {
     (h) = T1 + Sigma0_256(a) + majority((a), (b), (c));                                                               \
     j++
 
-static void sha256_transform(sha256_context* context, const sha2_word32* data) {
+static void sha256_transform_block(sha2_word32* state, const sha2_word32* data) {
     sha2_word32 a, b, c, d, e, f, g, h, s0, s1;
-    sha2_word32 T1, *W256;
+    sha2_word32 T1, W256[16];
     int j;
 
-    W256 = (sha2_word32*)context->buffer;
-
     /* Initialize registers with the prev. intermediate value */
-    a = context->state[0];
-    b = context->state[1];
-    c = context->state[2];
-    d = context->state[3];
-    e = context->state[4];
-    f = context->state[5];
-    g = context->state[6];
-    h = context->state[7];
+    a = state[0];
+    b = state[1];
+    c = state[2];
+    d = state[3];
+    e = state[4];
+    f = state[5];
+    g = state[6];
+    h = state[7];
 
     j = 0;
     do {
@@ -440,14 +454,14 @@ static void sha256_transform(sha256_context* context, const sha2_word32* data) {
     } while (j < 64);
 
     /* Compute the current intermediate hash value */
-    context->state[0] += a;
-    context->state[1] += b;
-    context->state[2] += c;
-    context->state[3] += d;
-    context->state[4] += e;
-    context->state[5] += f;
-    context->state[6] += g;
-    context->state[7] += h;
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
 
     /* Clean up */
     a = b = c = d = e = f = g = h = T1 = 0;
@@ -455,22 +469,20 @@ static void sha256_transform(sha256_context* context, const sha2_word32* data) {
 
 #else /* SHA2_UNROLL_TRANSFORM */
 
-static void sha256_transform(sha256_context* context, const sha2_word32* data) {
+static void sha256_transform_block(sha2_word32* state, const sha2_word32* data) {
     sha2_word32 a, b, c, d, e, f, g, h, s0, s1;
-    sha2_word32 T1, T2, *W256;
+    sha2_word32 T1, T2, W256[16];
     int j;
 
-    W256 = (sha2_word32*)context->buffer;
-
     /* Initialize registers with the prev. intermediate value */
-    a = context->state[0];
-    b = context->state[1];
-    c = context->state[2];
-    d = context->state[3];
-    e = context->state[4];
-    f = context->state[5];
-    g = context->state[6];
-    h = context->state[7];
+    a = state[0];
+    b = state[1];
+    c = state[2];
+    d = state[3];
+    e = state[4];
+    f = state[5];
+    g = state[6];
+    h = state[7];
 
     j = 0;
     do {
@@ -520,14 +532,14 @@ static void sha256_transform(sha256_context* context, const sha2_word32* data) {
     } while (j < 64);
 
     /* Compute the current intermediate hash value */
-    context->state[0] += a;
-    context->state[1] += b;
-    context->state[2] += c;
-    context->state[3] += d;
-    context->state[4] += e;
-    context->state[5] += f;
-    context->state[6] += g;
-    context->state[7] += h;
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
 
     /* Clean up */
     a = b = c = d = e = f = g = h = T1 = T2 = 0;
@@ -535,6 +547,176 @@ static void sha256_transform(sha256_context* context, const sha2_word32* data) {
 
 #endif /* SHA2_UNROLL_TRANSFORM */
 
+static void sha256_transform_standard(uint32_t* state, const uint8_t* data, size_t blocks) {
+    while (blocks--) {
+        sha256_transform_block(state, (const sha2_word32*)data);
+        data += SHA256_BLOCK_LENGTH;
+    }
+}
+
+#ifdef ENABLE_SSE2
+void sha256_transform_4way(uint32_t* state, const uint8_t* const* blocks);
+#endif
+#ifdef ENABLE_SSE41
+void sha256_transform_sse41(uint32_t* state, const uint8_t* data, size_t blocks);
+#endif
+#ifdef ENABLE_AVX2
+void sha256_transform_avx2(uint32_t* state, const uint8_t* data, size_t blocks);
+void sha256_transform_8way(uint32_t* state, const uint8_t* const* blocks);
+#endif
+#ifdef ENABLE_AVX512
+void sha256_transform_16way(uint32_t* state, const uint8_t* const* blocks);
+#endif
+#ifdef ENABLE_SHANI
+void sha256_transform_shani(uint32_t* state, const uint8_t* data, size_t blocks);
+#endif
+
+typedef void (*sha256_transform_fn)(uint32_t* state, const uint8_t* data, size_t blocks);
+/* One block for each of the lanes, state is word major (state[i * lanes + lane]) */
+typedef void (*sha256_transform_multi_fn)(uint32_t* state, const uint8_t* const* blocks);
+
+static void sha256_transform_autodetect(uint32_t* state, const uint8_t* data, size_t blocks);
+
+/* Selected once on first use (sha256_detect_once), or explicitly before any thread hashes */
+static sha256_transform_fn sha256_transform_impl = sha256_transform_autodetect;
+static const char* sha256_transform_name = "standard";
+static sha256_transform_multi_fn sha256_transform_multi = NULL;
+static unsigned int sha256_batch_width = 1;
+
+static dogecoin_bool sha256_cpu_supports(enum sha256_implementation impl) {
+    const dogecoin_cpu_features* cpu = dogecoin_cpu_get_features();
+    switch (impl) {
+        case SHA256_IMPL_STANDARD:
+            return true;
+#ifdef ENABLE_SSE41
+        case SHA256_IMPL_SSE41:
+            return cpu->sse41;
+#endif
+#ifdef ENABLE_AVX2
+        case SHA256_IMPL_AVX2:
+            return cpu->avx2 && cpu->bmi2;
+#endif
+#ifdef ENABLE_SHANI
+        case SHA256_IMPL_SHANI:
+            return cpu->sse41 && cpu->shani;
+#endif
+        default:
+            return false;
+    }
+}
+
+dogecoin_bool sha256_set_implementation(enum sha256_implementation impl) {
+    if (!sha256_cpu_supports(impl))
+        return false;
+    switch (impl) {
+#ifdef ENABLE_SSE41
+        case SHA256_IMPL_SSE41:
+            sha256_transform_impl = sha256_transform_sse41;
+            sha256_transform_name = "sse4.1";
+            break;
+#endif
+#ifdef ENABLE_AVX2
+        case SHA256_IMPL_AVX2:
+            sha256_transform_impl = sha256_transform_avx2;
+            sha256_transform_name = "avx2";
+            break;
+#endif
+#ifdef ENABLE_SHANI
+        case SHA256_IMPL_SHANI:
+            sha256_transform_impl = sha256_transform_shani;
+            sha256_transform_name = "shani";
+            break;
+#endif
+        default:
+            sha256_transform_impl = sha256_transform_standard;
+            sha256_transform_name = "standard";
+            break;
+    }
+    return true;
+}
+
+dogecoin_bool sha256_set_batch_lanes(unsigned int lanes) {
+    const dogecoin_cpu_features* cpu = dogecoin_cpu_get_features();
+    switch (lanes) {
+        case 1:
+            sha256_transform_multi = NULL;
+            break;
+#ifdef ENABLE_SSE2
+        case 4:
+            if (!cpu->sse2)
+                return false;
+            sha256_transform_multi = sha256_transform_4way;
+            break;
+#endif
+#ifdef ENABLE_AVX2
+        case 8:
+            if (!cpu->avx2)
+                return false;
+            sha256_transform_multi = sha256_transform_8way;
+            break;
+#endif
+#ifdef ENABLE_AVX512
+        case 16:
+            if (!cpu->avx512f)
+                return false;
+            sha256_transform_multi = sha256_transform_16way;
+            break;
+#endif
+        default:
+            return false;
+    }
+    sha256_batch_width = lanes;
+    return true;
+}
+
+const char* sha256_autodetect(void) {
+    if (sha256_set_implementation(SHA256_IMPL_SHANI)) {
+        /* one sha-ni stream outruns 4 or 8 lanes, only 16 avx-512 lanes are faster */
+        if (!sha256_set_batch_lanes(16))
+            sha256_set_batch_lanes(1);
+        return sha256_transform_name;
+    }
+    if (!sha256_set_implementation(SHA256_IMPL_AVX2) &&
+        !sha256_set_implementation(SHA256_IMPL_SSE41)) {
+        sha256_set_implementation(SHA256_IMPL_STANDARD);
+    }
+    if (!sha256_set_batch_lanes(16) &&
+        !sha256_set_batch_lanes(8) &&
+        !sha256_set_batch_lanes(4)) {
+        sha256_set_batch_lanes(1);
+    }
+    return sha256_transform_name;
+}
+
+#ifdef HAVE_PTHREAD
+static pthread_once_t sha256_detect_flag = PTHREAD_ONCE_INIT;
+
+static void sha256_detect_first(void) {
+    // keep a transform that was forced before the first use
+    if (sha256_transform_impl == sha256_transform_autodetect)
+        sha256_autodetect();
+}
+#endif
+
+// threads racing on the first hash wait for one detection, pthread_once orders the pointer stores before their loads
+static void sha256_detect_once(void) {
+#ifdef HAVE_PTHREAD
+    pthread_once(&sha256_detect_flag, sha256_detect_first);
+#else
+    if (sha256_transform_impl == sha256_transform_autodetect)
+        sha256_autodetect();
+#endif
+}
+
+static void sha256_transform_autodetect(uint32_t* state, const uint8_t* data, size_t blocks) {
+    sha256_detect_once();
+    sha256_transform_impl(state, data, blocks);
+}
+
+static void sha256_transform(sha256_context* context, const sha2_word32* data) {
+    sha256_transform_impl(context->state, (const uint8_t*)data, 1);
+}
+
 void sha256_write(sha256_context* context, const sha2_byte* data, size_t len) {
     unsigned int freespace, usedspace;
     if (len == 0) return; /* Calling with no data is valid - we do nothing */
@@ -558,12 +740,13 @@ void sha256_write(sha256_context* context, const sha2_byte* data, size_t len) {
             return;
         }
     }
-    while (len >= SHA256_BLOCK_LENGTH) {
-        /* Process as many complete blocks as we can */
-        sha256_transform(context, (const sha2_word32*)data);
-        context->bitcount += SHA256_BLOCK_LENGTH << 3;
-        len -= SHA256_BLOCK_LENGTH;
-        data += SHA256_BLOCK_LENGTH;
+    if (len >= SHA256_BLOCK_LENGTH) {
+        /* Process as many complete blocks as we can in one go */
+        size_t blocks = len / SHA256_BLOCK_LENGTH;
+        sha256_transform_impl(context->state, data, blocks);
+        context->bitcount += (uint64_t)blocks * SHA256_BLOCK_LENGTH << 3;
+        len -= blocks * SHA256_BLOCK_LENGTH;
+        data += blocks * SHA256_BLOCK_LENGTH;
     }
     if (len > 0) {
         /* There's left-overs, so save 'em */
@@ -577,7 +760,6 @@ void sha256_write(sha256_context* context, const sha2_byte* data, size_t len) {
 void sha256_finalize(sha2_byte digest[], sha256_context* context) {
     sha2_word32* d = (sha2_word32*)digest;
     unsigned int usedspace;
-    sha2_word64* t;
     /* If no digest buffer is passed, we don't bother doing this: */
     if (digest != (sha2_byte*)0) {
         usedspace = (context->bitcount >> 3) % SHA256_BLOCK_LENGTH;
@@ -609,8 +791,7 @@ void sha256_finalize(sha2_byte digest[], sha256_context* context) {
             *context->buffer = 0x80;
         }
         /* Set the bit count: */
-        t = (sha2_word64*)&context->buffer[SHA256_SHORT_BLOCK_LENGTH];
-        *t = context->bitcount;
+        MEMCPY_BCOPY(&context->buffer[SHA256_SHORT_BLOCK_LENGTH], &context->bitcount, sizeof(sha2_word64));
         /* Final transform: */
         sha256_transform(context, (sha2_word32*)context->buffer);
 
@@ -639,9 +820,246 @@ void sha256_raw(const sha2_byte* data, size_t len, uint8_t digest[SHA256_DIGEST_
     sha256_finalize(digest, &context);
 }
 
+/* Per lane progress of a message in sha256_raw_batch */
+typedef struct sha256_batch_lane_ {
+    const uint8_t* data;
+    size_t full_blocks;  /* blocks read straight from data */
+    size_t num_blocks;   /* full_blocks plus one or two padding blocks */
+    size_t block;        /* next block to compress */
+    size_t msg;          /* index of the message in the batch */
+    uint8_t pad[2 * SHA256_BLOCK_LENGTH];
+} sha256_batch_lane;
+
+static void sha256_batch_lane_start(sha256_batch_lane* lane, const uint8_t* data, size_t len, size_t msg) {
+    const size_t rem = len % SHA256_BLOCK_LENGTH;
+    const sha2_word64 bitcount = (sha2_word64)len << 3;
+    int i;
+    lane->data = data;
+    lane->full_blocks = len / SHA256_BLOCK_LENGTH;
+    lane->num_blocks = lane->full_blocks + (rem < SHA256_SHORT_BLOCK_LENGTH ? 1 : 2);
+    lane->block = 0;
+    lane->msg = msg;
+    /* the tail of the message, a 1 bit, zeros and the big endian bit count */
+    MEMCPY_BCOPY(lane->pad, data + lane->full_blocks * SHA256_BLOCK_LENGTH, rem);
+    lane->pad[rem] = 0x80;
+    const size_t pad_len = (lane->num_blocks - lane->full_blocks) * SHA256_BLOCK_LENGTH;
+    MEMSET_BZERO(lane->pad + rem + 1, pad_len - rem - 1);
+    for (i = 0; i < 8; i++) {
+        lane->pad[pad_len - 1 - i] = (sha2_byte)(bitcount >> (8 * i));
+    }
+}
+
+static const uint8_t* sha256_batch_lane_block(const sha256_batch_lane* lane) {
+    if (lane->block < lane->full_blocks)
+        return lane->data + lane->block * SHA256_BLOCK_LENGTH;
+    return lane->pad + (lane->block - lane->full_blocks) * SHA256_BLOCK_LENGTH;
+}
+
+static void sha256_batch_digest(const sha2_word32* state, size_t stride, uint8_t* digest) {
+    int i;
+    for (i = 0; i < 8; i++) {
+        const sha2_word32 w = state[i * stride];
+        digest[4 * i + 0] = (uint8_t)(w >> 24);
+        digest[4 * i + 1] = (uint8_t)(w >> 16);
+        digest[4 * i + 2] = (uint8_t)(w >> 8);
+        digest[4 * i + 3] = (uint8_t)w;
+    }
+}
+
+void sha256_raw_batch(const uint8_t* const inputs[], const size_t lens[], uint8_t* const outs[], size_t n) {
+    static const uint8_t idle_block[SHA256_BLOCK_LENGTH] = {0};
+    sha2_word32 state[8 * 16];
+    sha256_batch_lane lanes[16];
+    const uint8_t* blocks[16];
+    size_t next = 0, active = 0, i, j;
+
+    sha256_detect_once();
+    const sha256_transform_multi_fn transform = sha256_transform_multi;
+    const size_t width = sha256_batch_width;
+
+    if (transform) {
+        for (j = 0; j < width; j++) {
+            lanes[j].msg = SIZE_MAX;
+            for (i = 0; i < 8; i++) {
+                state[i * width + j] = sha256_initial_hash_value[i];
+            }
+            if (next < n) {
+                sha256_batch_lane_start(&lanes[j], inputs[next], lens[next], next);
+                next++;
+                active++;
+            }
+        }
+        /* keep the lanes busy, refill a lane as soon as its message is done,
+         * stop once fewer than half the lanes would do useful work */
+        while (active * 2 >= width) {
+            for (j = 0; j < width; j++) {
+                blocks[j] = lanes[j].msg != SIZE_MAX ? sha256_batch_lane_block(&lanes[j]) : idle_block;
+            }
+            transform(state, blocks);
+            for (j = 0; j < width; j++) {
+                if (lanes[j].msg == SIZE_MAX || ++lanes[j].block < lanes[j].num_blocks)
+                    continue;
+                sha256_batch_digest(state + j, width, outs[lanes[j].msg]);
+                for (i = 0; i < 8; i++) {
+                    state[i * width + j] = sha256_initial_hash_value[i];
+                }
+                if (next < n) {
+                    sha256_batch_lane_start(&lanes[j], inputs[next], lens[next], next);
+                    next++;
+                } else {
+                    lanes[j].msg = SIZE_MAX;
+                    active--;
+                }
+            }
+        }
+        /* finish the stragglers one at a time */
+        for (j = 0; j < width; j++) {
+            sha2_word32 lane_state[8];
+            if (lanes[j].msg == SIZE_MAX)
+                continue;
+            for (i = 0; i < 8; i++) {
+                lane_state[i] = state[i * width + j];
+            }
+            while (lanes[j].block < lanes[j].num_blocks) {
+                sha256_transform_impl(lane_state, sha256_batch_lane_block(&lanes[j]), 1);
+                lanes[j].block++;
+            }
+            sha256_batch_digest(lane_state, 1, outs[lanes[j].msg]);
+        }
+    }
+
+    for (; next < n; next++) {
+        sha256_raw(inputs[next], lens[next], outs[next]);
+    }
+}
+
+/*** Fixed length SHA-256: *******************************************/
+/* Padding for a message that ends on a block boundary after 64 bytes (512 bits) */
+static const sha2_byte sha256_pad_64[SHA256_BLOCK_LENGTH] = {
+    0x80, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x02, 0x00};
+
+/* Second half of the only block of a 32 byte (256 bit) message */
+static const sha2_byte sha256_pad_32[SHA256_BLOCK_LENGTH / 2] = {
+    0x80, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x01, 0x00};
+
+static void sha256_transform_32(sha2_word32* state, const sha2_byte* in) {
+    sha2_byte block[SHA256_BLOCK_LENGTH];
+    MEMCPY_BCOPY(block, in, 32);
+    MEMCPY_BCOPY(block + 32, sha256_pad_32, sizeof(sha256_pad_32));
+    MEMCPY_BCOPY(state, sha256_initial_hash_value, SHA256_DIGEST_LENGTH);
+    sha256_transform_impl(state, block, 1);
+}
+
+void sha256_raw_32(const uint8_t* in, uint8_t digest[SHA256_DIGEST_LENGTH]) {
+    sha2_word32 state[8];
+    sha256_detect_once();
+    sha256_transform_32(state, in);
+    sha256_batch_digest(state, 1, digest);
+}
+
+void sha256d_32(const uint8_t* in, uint8_t digest[SHA256_DIGEST_LENGTH]) {
+    sha2_word32 state[8];
+    sha2_byte hash[SHA256_DIGEST_LENGTH];
+    sha256_detect_once();
+    sha256_transform_32(state, in);
+    sha256_batch_digest(state, 1, hash);
+    sha256_transform_32(state, hash);
+    sha256_batch_digest(state, 1, digest);
+}
+
+void sha256d_64(const uint8_t* in, uint8_t digest[SHA256_DIGEST_LENGTH]) {
+    sha2_word32 state[8];
+    sha2_byte hash[SHA256_DIGEST_LENGTH];
+    sha256_detect_once();
+    MEMCPY_BCOPY(state, sha256_initial_hash_value, SHA256_DIGEST_LENGTH);
+    sha256_transform_impl(state, in, 1);
+    sha256_transform_impl(state, sha256_pad_64, 1);
+    sha256_batch_digest(state, 1, hash);
+    sha256_transform_32(state, hash);
+    sha256_batch_digest(state, 1, digest);
+}
+
+/* Double sha256 of width consecutive in_len (32 or 64) byte inputs, one per lane.
+ * All inputs are read before the first output is written. */
+static void sha256d_multi(sha256_transform_multi_fn transform, size_t width, uint8_t* out, const uint8_t* in, size_t in_len) {
+    sha2_word32 state[8 * 16];
+    sha2_byte buf[16][SHA256_BLOCK_LENGTH];
+    const uint8_t* blocks[16] = {NULL};
+    size_t i, j;
+
+    for (j = 0; j < width; j++) {
+        for (i = 0; i < 8; i++) {
+            state[i * width + j] = sha256_initial_hash_value[i];
+        }
+        if (in_len == SHA256_BLOCK_LENGTH) {
+            blocks[j] = in + j * SHA256_BLOCK_LENGTH;
+        } else {
+            MEMCPY_BCOPY(buf[j], in + j * 32, 32);
+            MEMCPY_BCOPY(buf[j] + 32, sha256_pad_32, sizeof(sha256_pad_32));
+            blocks[j] = buf[j];
+        }
+    }
+    transform(state, blocks);
+    if (in_len == SHA256_BLOCK_LENGTH) {
+        for (j = 0; j < width; j++) {
+            blocks[j] = sha256_pad_64;
+        }
+        transform(state, blocks);
+    }
+
+    /* second pass over the 32 byte digests */
+    for (j = 0; j < width; j++) {
+        sha256_batch_digest(state + j, width, buf[j]);
+        MEMCPY_BCOPY(buf[j] + 32, sha256_pad_32, sizeof(sha256_pad_32));
+        blocks[j] = buf[j];
+        for (i = 0; i < 8; i++) {
+            state[i * width + j] = sha256_initial_hash_value[i];
+        }
+    }
+    transform(state, blocks);
+    for (j = 0; j < width; j++) {
+        sha256_batch_digest(state + j, width, out + j * SHA256_DIGEST_LENGTH);
+    }
+}
+
+static void sha256d_batch(uint8_t* out, const uint8_t* in, size_t n, size_t in_len) {
+    sha256_detect_once();
+    const sha256_transform_multi_fn transform = sha256_transform_multi;
+    const size_t width = sha256_batch_width;
+
+    if (transform) {
+        for (; n >= width; n -= width) {
+            sha256d_multi(transform, width, out, in, in_len);
+            out += width * SHA256_DIGEST_LENGTH;
+            in += width * in_len;
+        }
+    }
+    for (; n > 0; n--) {
+        if (in_len == SHA256_BLOCK_LENGTH)
+            sha256d_64(in, out);
+        else
+            sha256d_32(in, out);
+        out += SHA256_DIGEST_LENGTH;
+        in += in_len;
+    }
+}
+
+void sha256d_32_batch(uint8_t* out, const uint8_t* in, size_t n) {
+    sha256d_batch(out, in, n, 32);
+}
+
+void sha256d_64_batch(uint8_t* out, const uint8_t* in, size_t n) {
+    sha256d_batch(out, in, n, SHA256_BLOCK_LENGTH);
+}
+
 /*** SHA-512: *********************************************************/
 void sha512_init(sha512_context* context) {
     if (context == (sha512_context*)0) return;
+    sha512_detect_once();
     MEMCPY_BCOPY(context->state, sha512_initial_hash_value, SHA512_DIGEST_LENGTH);
     MEMSET_BZERO(context->buffer, SHA512_BLOCK_LENGTH);
     context->bitcount[0] = context->bitcount[1] = 0;
@@ -680,20 +1098,20 @@ void sha512_init(sha512_context* context) {
     (h) = T1 + Sigma0_512(a) + majority((a), (b), (c));                                                               \
     j++
 
-static void sha512_transform(sha512_context* context, const sha2_word64* data) {
+static void sha512_transform_block(sha2_word64* state, const sha2_word64* data) {
     sha2_word64 a, b, c, d, e, f, g, h, s0, s1;
-    sha2_word64 T1, *W512 = (sha2_word64 *)context->buffer;
+    sha2_word64 T1, W512[16];
     int j;
 
     /* Initialize registers with the prev. intermediate value */
-    a = context->state[0];
-    b = context->state[1];
-    c = context->state[2];
-    d = context->state[3];
-    e = context->state[4];
-    f = context->state[5];
-    g = context->state[6];
-    h = context->state[7];
+    a = state[0];
+    b = state[1];
+    c = state[2];
+    d = state[3];
+    e = state[4];
+    f = state[5];
+    g = state[6];
+    h = state[7];
 
     j = 0;
     do {
@@ -720,14 +1138,14 @@ static void sha512_transform(sha512_context* context, const sha2_word64* data) {
     } while (j < 80);
 
     /* Compute the current intermediate hash value */
-    context->state[0] += a;
-    context->state[1] += b;
-    context->state[2] += c;
-    context->state[3] += d;
-    context->state[4] += e;
-    context->state[5] += f;
-    context->state[6] += g;
-    context->state[7] += h;
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
 
     /* Clean up */
     a = b = c = d = e = f = g = h = T1 = 0;
@@ -735,21 +1153,20 @@ static void sha512_transform(sha512_context* context, const sha2_word64* data) {
 
 #else /* SHA2_UNROLL_TRANSFORM */
 
-static void sha512_transform(sha512_context* context, const sha2_word64* data)
-{
+static void sha512_transform_block(sha2_word64* state, const sha2_word64* data) {
     sha2_word64 a, b, c, d, e, f, g, h, s0, s1;
-    sha2_word64 T1, T2, *W512 = (sha2_word64 *)context->buffer;
+    sha2_word64 T1, T2, W512[16];
     int j;
 
     /* Initialize registers with the prev. intermediate value */
-    a = context->state[0];
-    b = context->state[1];
-    c = context->state[2];
-    d = context->state[3];
-    e = context->state[4];
-    f = context->state[5];
-    g = context->state[6];
-    h = context->state[7];
+    a = state[0];
+    b = state[1];
+    c = state[2];
+    d = state[3];
+    e = state[4];
+    f = state[5];
+    g = state[6];
+    h = state[7];
 
     j = 0;
     do {
@@ -799,14 +1216,14 @@ static void sha512_transform(sha512_context* context, const sha2_word64* data)
     } while (j < 80);
 
     /* Compute the current intermediate hash value */
-    context->state[0] += a;
-    context->state[1] += b;
-    context->state[2] += c;
-    context->state[3] += d;
-    context->state[4] += e;
-    context->state[5] += f;
-    context->state[6] += g;
-    context->state[7] += h;
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
 
     /* Clean up */
     a = b = c = d = e = f = g = h = T1 = T2 = 0;
@@ -814,6 +1231,120 @@ static void sha512_transform(sha512_context* context, const sha2_word64* data)
 
 #endif /* SHA2_UNROLL_TRANSFORM */
 
+static void sha512_transform_standard(uint64_t* state, const uint8_t* data, size_t blocks) {
+    while (blocks--) {
+        sha512_transform_block(state, (const sha2_word64*)data);
+        data += SHA512_BLOCK_LENGTH;
+    }
+}
+
+#ifdef ENABLE_AVX2
+void sha512_transform_avx2(uint64_t* state, const uint8_t* data, size_t blocks);
+void sha512_transform_4way(uint64_t* state, const uint8_t* const* blocks);
+#endif
+#ifdef ENABLE_AVX512
+void sha512_transform_8way(uint64_t* state, const uint8_t* const* blocks);
+#endif
+
+typedef void (*sha512_transform_fn)(uint64_t* state, const uint8_t* data, size_t blocks);
+/* One block for each of the lanes, state is word major (state[i * lanes + lane]) */
+typedef void (*sha512_transform_multi_fn)(uint64_t* state, const uint8_t* const* blocks);
+
+static void sha512_transform_autodetect(uint64_t* state, const uint8_t* data, size_t blocks);
+
+/* Selected once on first use (sha512_detect_once), or explicitly before any thread hashes */
+static sha512_transform_fn sha512_transform_impl = sha512_transform_autodetect;
+static const char* sha512_transform_name = "standard";
+static sha512_transform_multi_fn sha512_transform_multi = NULL;
+static unsigned int sha512_batch_width = 1;
+
+dogecoin_bool sha512_set_implementation(enum sha512_implementation impl) {
+    const dogecoin_cpu_features* cpu = dogecoin_cpu_get_features();
+    switch (impl) {
+        case SHA512_IMPL_STANDARD:
+            sha512_transform_impl = sha512_transform_standard;
+            sha512_transform_name = "standard";
+            return true;
+#ifdef ENABLE_AVX2
+        case SHA512_IMPL_AVX2:
+            if (!cpu->avx2 || !cpu->bmi2)
+                return false;
+            sha512_transform_impl = sha512_transform_avx2;
+            sha512_transform_name = "avx2";
+            return true;
+#endif
+        default:
+            (void)cpu;
+            return false;
+    }
+}
+
+dogecoin_bool sha512_set_batch_lanes(unsigned int lanes) {
+    const dogecoin_cpu_features* cpu = dogecoin_cpu_get_features();
+    switch (lanes) {
+        case 1:
+            sha512_transform_multi = NULL;
+            break;
+#ifdef ENABLE_AVX2
+        case 4:
+            if (!cpu->avx2)
+                return false;
+            sha512_transform_multi = sha512_transform_4way;
+            break;
+#endif
+#ifdef ENABLE_AVX512
+        case 8:
+            if (!cpu->avx512f)
+                return false;
+            sha512_transform_multi = sha512_transform_8way;
+            break;
+#endif
+        default:
+            (void)cpu;
+            return false;
+    }
+    sha512_batch_width = lanes;
+    return true;
+}
+
+const char* sha512_autodetect(void) {
+    if (!sha512_set_implementation(SHA512_IMPL_AVX2))
+        sha512_set_implementation(SHA512_IMPL_STANDARD);
+    if (!sha512_set_batch_lanes(8) && !sha512_set_batch_lanes(4))
+        sha512_set_batch_lanes(1);
+    return sha512_transform_name;
+}
+
+#ifdef HAVE_PTHREAD
+static pthread_once_t sha512_detect_flag = PTHREAD_ONCE_INIT;
+
+static void sha512_detect_first(void) {
+    // keep a transform that was forced before the first use
+    if (sha512_transform_impl == sha512_transform_autodetect)
+        sha512_autodetect();
+}
+#endif
+
+// threads racing on the first hash wait for one detection, pthread_once orders the pointer stores before their loads
+static void sha512_detect_once(void) {
+#ifdef HAVE_PTHREAD
+    pthread_once(&sha512_detect_flag, sha512_detect_first);
+#else
+    if (sha512_transform_impl == sha512_transform_autodetect)
+        sha512_autodetect();
+#endif
+}
+
+static void sha512_transform_autodetect(uint64_t* state, const uint8_t* data, size_t blocks) {
+    sha512_detect_once();
+    sha512_transform_impl(state, data, blocks);
+}
+
+// buffered blocks come one at a time, the vector schedule only pays off on runs of blocks
+static void sha512_transform(sha512_context* context, const sha2_word64* data) {
+    sha512_transform_block(context->state, data);
+}
+
 void sha512_write(sha512_context* context, const sha2_byte* data, size_t len) {
     unsigned int freespace, usedspace;
     if (len == 0) return; /* Calling with no data is valid - we do nothing */
@@ -837,12 +1368,13 @@ void sha512_write(sha512_context* context, const sha2_byte* data, size_t len) {
             return;
         }
     }
-    while (len >= SHA512_BLOCK_LENGTH) {
-        /* Process as many complete blocks as we can */
-        sha512_transform(context, (const sha2_word64*)data);
-        ADDINC128(context->bitcount, SHA512_BLOCK_LENGTH << 3);
-        len -= SHA512_BLOCK_LENGTH;
-        data += SHA512_BLOCK_LENGTH;
+    if (len >= SHA512_BLOCK_LENGTH) {
+        /* Process as many complete blocks as we can in one go */
+        size_t blocks = len / SHA512_BLOCK_LENGTH;
+        sha512_transform_impl(context->state, data, blocks);
+        ADDINC128(context->bitcount, (sha2_word64)blocks * SHA512_BLOCK_LENGTH << 3);
+        len -= blocks * SHA512_BLOCK_LENGTH;
+        data += blocks * SHA512_BLOCK_LENGTH;
     }
     if (len > 0) {
         /* There's left-overs, so save 'em */
@@ -855,7 +1387,6 @@ void sha512_write(sha512_context* context, const sha2_byte* data, size_t len) {
 
 static void sha512_last(sha512_context* context) {
     unsigned int usedspace;
-    sha2_word64* t;
     usedspace = (context->bitcount[0] >> 3) % SHA512_BLOCK_LENGTH;
 #if BYTE_ORDER == LITTLE_ENDIAN
     /* Convert FROM host byte order */
@@ -884,10 +1415,8 @@ static void sha512_last(sha512_context* context) {
         *context->buffer = 0x80;
     }
     /* Store the length of input data (in bits): */
-    t = (sha2_word64*)&context->buffer[SHA512_SHORT_BLOCK_LENGTH];
-    *t = context->bitcount[1];
-    t = (sha2_word64*)&context->buffer[SHA512_SHORT_BLOCK_LENGTH + 8];
-    *t = context->bitcount[0];
+    MEMCPY_BCOPY(&context->buffer[SHA512_SHORT_BLOCK_LENGTH], &context->bitcount[1], sizeof(sha2_word64));
+    MEMCPY_BCOPY(&context->buffer[SHA512_SHORT_BLOCK_LENGTH + 8], &context->bitcount[0], sizeof(sha2_word64));
     /* Final transform: */
     sha512_transform(context, (sha2_word64*)context->buffer);
 }
@@ -922,50 +1451,384 @@ void sha512_raw(const sha2_byte* data, size_t len, uint8_t digest[SHA512_DIGEST_
     sha512_finalize(digest, &context);
 }
 
-void hmac_sha256(const uint8_t* key, const uint32_t keylen, const uint8_t* msg, const uint32_t msglen, uint8_t* hmac) {
+/*** Multi message SHA-512: ******************************************/
+typedef struct sha512_batch_lane_ {
+    const uint8_t* data;
+    size_t full_blocks;  /* blocks read straight from data */
+    size_t num_blocks;   /* full_blocks plus one or two padding blocks */
+    size_t block;        /* next block to compress */
+    size_t msg;          /* index of the message in the batch */
+    uint8_t pad[2 * SHA512_BLOCK_LENGTH];
+} sha512_batch_lane;
+
+static void sha512_batch_lane_start(sha512_batch_lane* lane, const uint8_t* data, size_t len, size_t msg) {
+    const size_t rem = len % SHA512_BLOCK_LENGTH;
+    const sha2_word64 bitcount = (sha2_word64)len << 3;
     int i;
-    uint8_t buf[SHA256_BLOCK_LENGTH], o_key_pad[SHA256_BLOCK_LENGTH],
-        i_key_pad[SHA256_BLOCK_LENGTH];
-    sha256_context ctx;
+    lane->data = data;
+    lane->full_blocks = len / SHA512_BLOCK_LENGTH;
+    lane->num_blocks = lane->full_blocks + (rem < SHA512_SHORT_BLOCK_LENGTH ? 1 : 2);
+    lane->block = 0;
+    lane->msg = msg;
+    /* the tail of the message, a 1 bit, zeros and the 128 bit big endian bit count */
+    MEMCPY_BCOPY(lane->pad, data + lane->full_blocks * SHA512_BLOCK_LENGTH, rem);
+    lane->pad[rem] = 0x80;
+    const size_t pad_len = (lane->num_blocks - lane->full_blocks) * SHA512_BLOCK_LENGTH;
+    MEMSET_BZERO(lane->pad + rem + 1, pad_len - rem - 1);
+    for (i = 0; i < 8; i++) {
+        lane->pad[pad_len - 1 - i] = (sha2_byte)(bitcount >> (8 * i));
+    }
+    lane->pad[pad_len - 9] = (sha2_byte)((sha2_word64)len >> 61);
+}
+
+static const uint8_t* sha512_batch_lane_block(const sha512_batch_lane* lane) {
+    if (lane->block < lane->full_blocks)
+        return lane->data + lane->block * SHA512_BLOCK_LENGTH;
+    return lane->pad + (lane->block - lane->full_blocks) * SHA512_BLOCK_LENGTH;
+}
+
+static void sha512_batch_digest(const sha2_word64* state, size_t stride, uint8_t* digest) {
+    int i, j;
+    for (i = 0; i < 8; i++) {
+        const sha2_word64 w = state[i * stride];
+        for (j = 0; j < 8; j++) {
+            digest[8 * i + j] = (uint8_t)(w >> (56 - 8 * j));
+        }
+    }
+}
+
+void sha512_raw_batch(const uint8_t* const inputs[], const size_t lens[], uint8_t* const outs[], size_t n) {
+    static const uint8_t idle_block[SHA512_BLOCK_LENGTH] = {0};
+    sha2_word64 state[8 * 8];
+    sha512_batch_lane lanes[8];
+    const uint8_t* blocks[8];
+    size_t next = 0, active = 0, i, j;
+
+    sha512_detect_once();
+    const sha512_transform_multi_fn transform = sha512_transform_multi;
+    const size_t width = sha512_batch_width;
+
+    if (transform) {
+        for (j = 0; j < width; j++) {
+            lanes[j].msg = SIZE_MAX;
+            for (i = 0; i < 8; i++) {
+                state[i * width + j] = sha512_initial_hash_value[i];
+            }
+            if (next < n) {
+                sha512_batch_lane_start(&lanes[j], inputs[next], lens[next], next);
+                next++;
+                active++;
+            }
+        }
+        /* same lane scheduling as sha256_raw_batch */
+        while (active * 2 >= width) {
+            for (j = 0; j < width; j++) {
+                blocks[j] = lanes[j].msg != SIZE_MAX ? sha512_batch_lane_block(&lanes[j]) : idle_block;
+            }
+            transform(state, blocks);
+            for (j = 0; j < width; j++) {
+                if (lanes[j].msg == SIZE_MAX || ++lanes[j].block < lanes[j].num_blocks)
+                    continue;
+                sha512_batch_digest(state + j, width, outs[lanes[j].msg]);
+                for (i = 0; i < 8; i++) {
+                    state[i * width + j] = sha512_initial_hash_value[i];
+                }
+                if (next < n) {
+                    sha512_batch_lane_start(&lanes[j], inputs[next], lens[next], next);
+                    next++;
+                } else {
+                    lanes[j].msg = SIZE_MAX;
+                    active--;
+                }
+            }
+        }
+        /* finish the stragglers one at a time */
+        for (j = 0; j < width; j++) {
+            sha2_word64 lane_state[8];
+            if (lanes[j].msg == SIZE_MAX)
+                continue;
+            for (i = 0; i < 8; i++) {
+                lane_state[i] = state[i * width + j];
+            }
+            while (lanes[j].block < lanes[j].num_blocks) {
+                sha512_transform_impl(lane_state, sha512_batch_lane_block(&lanes[j]), 1);
+                lanes[j].block++;
+            }
+            sha512_batch_digest(lane_state, 1, outs[lanes[j].msg]);
+        }
+    }
+
+    for (; next < n; next++) {
+        sha512_raw(inputs[next], lens[next], outs[next]);
+    }
+}
 
-    memset(buf, 0, SHA256_BLOCK_LENGTH);
+void hmac_sha256_prepare(hmac_sha256_ctx* ctx, const uint8_t* key, size_t keylen) {
+    int i;
+    uint8_t buf[SHA256_BLOCK_LENGTH];
+
+    MEMSET_BZERO(buf, SHA256_BLOCK_LENGTH);
     if (keylen > SHA256_BLOCK_LENGTH) {
         sha256_raw(key, keylen, buf);
     } else {
-        memcpy(buf, key, keylen);
+        MEMCPY_BCOPY(buf, key, keylen);
+    }
+    for (i = 0; i < SHA256_BLOCK_LENGTH; i++) {
+        buf[i] ^= 0x36;
     }
+    sha256_init(&ctx->inner);
+    sha256_write(&ctx->inner, buf, SHA256_BLOCK_LENGTH);
     for (i = 0; i < SHA256_BLOCK_LENGTH; i++) {
-        o_key_pad[i] = buf[i] ^ 0x5c;
-        i_key_pad[i] = buf[i] ^ 0x36;
+        buf[i] ^= 0x36 ^ 0x5c;
     }
-    sha256_init(&ctx);
-    sha256_write(&ctx, i_key_pad, SHA256_BLOCK_LENGTH);
-    sha256_write(&ctx, msg, msglen);
-    sha256_finalize(buf, &ctx);
-    sha256_init(&ctx);
-    sha256_write(&ctx, o_key_pad, SHA256_BLOCK_LENGTH);
-    sha256_write(&ctx, buf, SHA256_DIGEST_LENGTH);
-    sha256_finalize(hmac, &ctx);
+    sha256_init(&ctx->outer);
+    sha256_write(&ctx->outer, buf, SHA256_BLOCK_LENGTH);
+    MEMSET_BZERO(buf, SHA256_BLOCK_LENGTH);
 }
 
-void hmac_sha512(const uint8_t* key, const uint32_t keylen, const uint8_t* msg, const uint32_t msglen, uint8_t* hmac) {
+void hmac_sha256_compute(const hmac_sha256_ctx* ctx, const uint8_t* msg, size_t msglen, uint8_t hmac[SHA256_DIGEST_LENGTH]) {
+    uint8_t buf[SHA256_DIGEST_LENGTH];
+    sha256_context sha = ctx->inner;
+    sha256_write(&sha, msg, msglen);
+    sha256_finalize(buf, &sha);
+    sha = ctx->outer;
+    sha256_write(&sha, buf, SHA256_DIGEST_LENGTH);
+    sha256_finalize(hmac, &sha);
+}
+
+void hmac_sha256_ctx_cleanse(hmac_sha256_ctx* ctx) {
+    dogecoin_mem_zero(ctx, sizeof(*ctx));
+}
+
+void hmac_sha256(const uint8_t* key, const uint32_t keylen, const uint8_t* msg, const uint32_t msglen, uint8_t* hmac) {
+    hmac_sha256_ctx ctx;
+    hmac_sha256_prepare(&ctx, key, keylen);
+    hmac_sha256_compute(&ctx, msg, msglen, hmac);
+    hmac_sha256_ctx_cleanse(&ctx);
+}
+
+void pbkdf2_hmac_sha256_ctx(const hmac_sha256_ctx* ctx, const uint8_t* salt, size_t saltlen, uint32_t iterations, uint8_t* key, size_t keylen) {
+    sha256_context salted = ctx->inner, sha;
+    uint8_t u[SHA256_DIGEST_LENGTH], t[SHA256_DIGEST_LENGTH], counter[4];
+    uint32_t block, j;
+    size_t i;
+
+    // the salt is the same for every output block, absorb it once
+    sha256_write(&salted, salt, saltlen);
+    for (block = 1; keylen > 0; block++) {
+        const size_t len = keylen < SHA256_DIGEST_LENGTH ? keylen : SHA256_DIGEST_LENGTH;
+        counter[0] = (uint8_t)(block >> 24);
+        counter[1] = (uint8_t)(block >> 16);
+        counter[2] = (uint8_t)(block >> 8);
+        counter[3] = (uint8_t)block;
+        sha = salted;
+        sha256_write(&sha, counter, sizeof(counter));
+        sha256_finalize(u, &sha);
+        sha = ctx->outer;
+        sha256_write(&sha, u, SHA256_DIGEST_LENGTH);
+        sha256_finalize(u, &sha);
+        MEMCPY_BCOPY(t, u, SHA256_DIGEST_LENGTH);
+        for (j = 1; j < iterations; j++) {
+            hmac_sha256_compute(ctx, u, SHA256_DIGEST_LENGTH, u);
+            for (i = 0; i < SHA256_DIGEST_LENGTH; i++) {
+                t[i] ^= u[i];
+            }
+        }
+        MEMCPY_BCOPY(key, t, len);
+        key += len;
+        keylen -= len;
+    }
+    dogecoin_mem_zero(&salted, sizeof(salted));
+    dogecoin_mem_zero(&sha, sizeof(sha));
+    dogecoin_mem_zero(u, sizeof(u));
+    dogecoin_mem_zero(t, sizeof(t));
+}
+
+void pbkdf2_hmac_sha256(const uint8_t* pass, size_t passlen, const uint8_t* salt, size_t saltlen, uint32_t iterations, uint8_t* key, size_t keylen) {
+    hmac_sha256_ctx ctx;
+    hmac_sha256_prepare(&ctx, pass, passlen);
+    pbkdf2_hmac_sha256_ctx(&ctx, salt, saltlen, iterations, key, keylen);
+    hmac_sha256_ctx_cleanse(&ctx);
+}
+
+void hmac_sha512_prepare(hmac_sha512_ctx* ctx, const uint8_t* key, size_t keylen) {
     int i;
-    uint8_t buf[SHA512_BLOCK_LENGTH], o_key_pad[SHA512_BLOCK_LENGTH],
-        i_key_pad[SHA512_BLOCK_LENGTH];
-    sha512_context ctx;
-    memset(buf, 0, SHA512_BLOCK_LENGTH);
-    if (keylen > SHA512_BLOCK_LENGTH) sha512_raw(key, keylen, buf);
-    else memcpy(buf, key, keylen);
+    uint8_t buf[SHA512_BLOCK_LENGTH];
+
+    MEMSET_BZERO(buf, SHA512_BLOCK_LENGTH);
+    if (keylen > SHA512_BLOCK_LENGTH) {
+        sha512_raw(key, keylen, buf);
+    } else {
+        MEMCPY_BCOPY(buf, key, keylen);
+    }
+    for (i = 0; i < SHA512_BLOCK_LENGTH; i++) {
+        buf[i] ^= 0x36;
+    }
+    sha512_init(&ctx->inner);
+    sha512_write(&ctx->inner, buf, SHA512_BLOCK_LENGTH);
     for (i = 0; i < SHA512_BLOCK_LENGTH; i++) {
-        o_key_pad[i] = buf[i] ^ 0x5c;
-        i_key_pad[i] = buf[i] ^ 0x36;
-    }
-    sha512_init(&ctx);
-    sha512_write(&ctx, i_key_pad, SHA512_BLOCK_LENGTH);
-    sha512_write(&ctx, msg, msglen);
-    sha512_finalize(buf, &ctx);
-    sha512_init(&ctx);
-    sha512_write(&ctx, o_key_pad, SHA512_BLOCK_LENGTH);
-    sha512_write(&ctx, buf, SHA512_DIGEST_LENGTH);
-    sha512_finalize(hmac, &ctx);
+        buf[i] ^= 0x36 ^ 0x5c;
+    }
+    sha512_init(&ctx->outer);
+    sha512_write(&ctx->outer, buf, SHA512_BLOCK_LENGTH);
+    MEMSET_BZERO(buf, SHA512_BLOCK_LENGTH);
+}
+
+void hmac_sha512_compute(const hmac_sha512_ctx* ctx, const uint8_t* msg, size_t msglen, uint8_t hmac[SHA512_DIGEST_LENGTH]) {
+    uint8_t buf[SHA512_DIGEST_LENGTH];
+    sha512_context sha = ctx->inner;
+    sha512_write(&sha, msg, msglen);
+    sha512_finalize(buf, &sha);
+    sha = ctx->outer;
+    sha512_write(&sha, buf, SHA512_DIGEST_LENGTH);
+    sha512_finalize(hmac, &sha);
+}
+
+void hmac_sha512_ctx_cleanse(hmac_sha512_ctx* ctx) {
+    dogecoin_mem_zero(ctx, sizeof(*ctx));
+}
+
+void hmac_sha512(const uint8_t* key, const uint32_t keylen, const uint8_t* msg, const uint32_t msglen, uint8_t* hmac) {
+    hmac_sha512_ctx ctx;
+    hmac_sha512_prepare(&ctx, key, keylen);
+    hmac_sha512_compute(&ctx, msg, msglen, hmac);
+    hmac_sha512_ctx_cleanse(&ctx);
+}
+
+/* an hmac-sha512 of a 64 byte message is one padded block on top of each keyed midstate,
+ * the pbkdf2 iterations compress those blocks directly */
+#define PBKDF2_SHA512_MSG_BITS ((SHA512_BLOCK_LENGTH + SHA512_DIGEST_LENGTH) * 8)
+
+static void pbkdf2_sha512_pad_block(sha2_word64 block[SHA512_BLOCK_LENGTH / 8]) {
+    uint8_t* b = (uint8_t*)block;
+    MEMSET_BZERO(b + SHA512_DIGEST_LENGTH, SHA512_BLOCK_LENGTH - SHA512_DIGEST_LENGTH);
+    b[SHA512_DIGEST_LENGTH] = 0x80;
+    b[SHA512_BLOCK_LENGTH - 2] = (uint8_t)(PBKDF2_SHA512_MSG_BITS >> 8);
+    b[SHA512_BLOCK_LENGTH - 1] = (uint8_t)PBKDF2_SHA512_MSG_BITS;
+}
+
+/* u1 = hmac(salt || be32(block_no)), salted is the inner context that already absorbed the salt */
+static void pbkdf2_sha512_first(const hmac_sha512_ctx* ctx, const sha512_context* salted, uint32_t block_no, uint8_t u[SHA512_DIGEST_LENGTH]) {
+    uint8_t counter[4];
+    sha512_context sha = *salted;
+    counter[0] = (uint8_t)(block_no >> 24);
+    counter[1] = (uint8_t)(block_no >> 16);
+    counter[2] = (uint8_t)(block_no >> 8);
+    counter[3] = (uint8_t)block_no;
+    sha512_write(&sha, counter, sizeof(counter));
+    sha512_finalize(u, &sha);
+    sha = ctx->outer;
+    sha512_write(&sha, u, SHA512_DIGEST_LENGTH);
+    sha512_finalize(u, &sha);
+    dogecoin_mem_zero(&sha, sizeof(sha));
+}
+
+void pbkdf2_hmac_sha512_ctx(const hmac_sha512_ctx* ctx, const uint8_t* salt, size_t saltlen, uint32_t iterations, uint8_t* key, size_t keylen) {
+    sha512_context salted = ctx->inner;
+    sha2_word64 block[SHA512_BLOCK_LENGTH / 8], state[8];
+    uint8_t* u = (uint8_t*)block;
+    uint8_t t[SHA512_DIGEST_LENGTH];
+    uint32_t block_no, j;
+    size_t i;
+
+    pbkdf2_sha512_pad_block(block);
+    sha512_write(&salted, salt, saltlen);
+    for (block_no = 1; keylen > 0; block_no++) {
+        const size_t len = keylen < SHA512_DIGEST_LENGTH ? keylen : SHA512_DIGEST_LENGTH;
+        pbkdf2_sha512_first(ctx, &salted, block_no, u);
+        MEMCPY_BCOPY(t, u, SHA512_DIGEST_LENGTH);
+        for (j = 1; j < iterations; j++) {
+            MEMCPY_BCOPY(state, ctx->inner.state, sizeof(state));
+            sha512_transform_block(state, block);
+            sha512_batch_digest(state, 1, u);
+            MEMCPY_BCOPY(state, ctx->outer.state, sizeof(state));
+            sha512_transform_block(state, block);
+            sha512_batch_digest(state, 1, u);
+            for (i = 0; i < SHA512_DIGEST_LENGTH; i++) {
+                t[i] ^= u[i];
+            }
+        }
+        MEMCPY_BCOPY(key, t, len);
+        key += len;
+        keylen -= len;
+    }
+    dogecoin_mem_zero(&salted, sizeof(salted));
+    dogecoin_mem_zero(block, sizeof(block));
+    dogecoin_mem_zero(state, sizeof(state));
+    dogecoin_mem_zero(t, sizeof(t));
+}
+
+void pbkdf2_hmac_sha512(const uint8_t* pass, size_t passlen, const uint8_t* salt, size_t saltlen, uint32_t iterations, uint8_t* key, size_t keylen) {
+    hmac_sha512_ctx ctx;
+    hmac_sha512_prepare(&ctx, pass, passlen);
+    pbkdf2_hmac_sha512_ctx(&ctx, salt, saltlen, iterations, key, keylen);
+    hmac_sha512_ctx_cleanse(&ctx);
+}
+
+void pbkdf2_hmac_sha512_batch(const uint8_t* const passes[], const size_t passlens[], const uint8_t* const salts[], const size_t saltlens[], uint32_t iterations, uint8_t* const keys[], size_t n) {
+    hmac_sha512_ctx ctx[8];
+    sha2_word64 block[8][SHA512_BLOCK_LENGTH / 8], state[8 * 8];
+    const uint8_t* blocks[8];
+    uint8_t t[8][SHA512_DIGEST_LENGTH];
+    uint32_t it;
+    size_t i, j;
+
+    sha512_detect_once();
+    const sha512_transform_multi_fn transform = sha512_transform_multi;
+    const size_t width = sha512_batch_width;
+
+    if (transform && n >= width) {
+        for (j = 0; j < width; j++) {
+            pbkdf2_sha512_pad_block(block[j]);
+            blocks[j] = (const uint8_t*)block[j];
+        }
+        for (; n >= width; n -= width) {
+            for (j = 0; j < width; j++) {
+                sha512_context salted;
+                hmac_sha512_prepare(&ctx[j], passes[j], passlens[j]);
+                salted = ctx[j].inner;
+                sha512_write(&salted, salts[j], saltlens[j]);
+                pbkdf2_sha512_first(&ctx[j], &salted, 1, (uint8_t*)block[j]);
+                MEMCPY_BCOPY(t[j], block[j], SHA512_DIGEST_LENGTH);
+                dogecoin_mem_zero(&salted, sizeof(salted));
+            }
+            /* every lane runs the same number of iterations, so they stay in lock step */
+            for (it = 1; it < iterations; it++) {
+                for (j = 0; j < width; j++) {
+                    for (i = 0; i < 8; i++) {
+                        state[i * width + j] = ctx[j].inner.state[i];
+                    }
+                }
+                transform(state, blocks);
+                for (j = 0; j < width; j++) {
+                    sha512_batch_digest(state + j, width, (uint8_t*)block[j]);
+                    for (i = 0; i < 8; i++) {
+                        state[i * width + j] = ctx[j].outer.state[i];
+                    }
+                }
+                transform(state, blocks);
+                for (j = 0; j < width; j++) {
+                    sha512_batch_digest(state + j, width, (uint8_t*)block[j]);
+                    for (i = 0; i < SHA512_DIGEST_LENGTH; i++) {
+                        t[j][i] ^= ((const uint8_t*)block[j])[i];
+                    }
+                }
+            }
+            for (j = 0; j < width; j++) {
+                MEMCPY_BCOPY(keys[j], t[j], SHA512_DIGEST_LENGTH);
+                hmac_sha512_ctx_cleanse(&ctx[j]);
+            }
+            passes += width;
+            passlens += width;
+            salts += width;
+            saltlens += width;
+            keys += width;
+        }
+        dogecoin_mem_zero(block, sizeof(block));
+        dogecoin_mem_zero(state, sizeof(state));
+        dogecoin_mem_zero(t, sizeof(t));
+    }
+    for (j = 0; j < n; j++) {
+        pbkdf2_hmac_sha512(passes[j], passlens[j], salts[j], saltlens[j], iterations, keys[j], SHA512_DIGEST_LENGTH);
+    }
 }
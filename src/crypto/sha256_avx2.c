@@ -0,0 +1,211 @@
+/*
+
+ The MIT License (MIT)
+
+ Copyright (c) 2022 The Dogecoin Foundation
+
+ Permission is hereby granted, free of charge, to any person obtaining
+ a copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES
+ OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <immintrin.h>
+
+// sha256 compression with the message schedule of two blocks computed at once
+// (one block per 128 bit lane), built with -mavx2 -mbmi2 so the scalar rounds
+// use rorx, and only called after cpuid reported support
+
+static const uint32_t K256[64] __attribute__((aligned(16))) = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+#define ROTR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+#define VROTR(x, n) _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - (n)))
+#define VSIGMA0(x) _mm256_xor_si256(_mm256_xor_si256(VROTR(x, 7), VROTR(x, 18)), _mm256_srli_epi32(x, 3))
+#define VSIGMA1(x) _mm256_xor_si256(_mm256_xor_si256(VROTR(x, 17), VROTR(x, 19)), _mm256_srli_epi32(x, 10))
+
+#define ROUND(a, b, c, d, e, f, g, h, wk)                                                          \
+    do {                                                                                           \
+        const uint32_t t1 = (h) + (ROTR(e, 6) ^ ROTR(e, 11) ^ ROTR(e, 25)) + (((e) & (f)) ^ (~(e) & (g))) + (wk); \
+        const uint32_t t2 = (ROTR(a, 2) ^ ROTR(a, 13) ^ ROTR(a, 22)) + (((a) & (b)) ^ ((a) & (c)) ^ ((b) & (c))); \
+        (d) += t1;                                                                                 \
+        (h) = t1 + t2;                                                                             \
+    } while (0)
+
+// next four schedule words of both blocks from the previous sixteen (x0 oldest)
+static inline __m256i sha256_avx2_schedule(__m256i x0, __m256i x1, __m256i x2, __m256i x3) {
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i w = _mm256_add_epi32(x0, VSIGMA0(_mm256_alignr_epi8(x1, x0, 4)));
+    w = _mm256_add_epi32(w, _mm256_alignr_epi8(x3, x2, 4));
+    // sigma1 of w[t-2], w[t-1] completes the low two words, which then feed the high two
+    __m256i s1 = VSIGMA1(_mm256_shuffle_epi32(x3, _MM_SHUFFLE(3, 3, 3, 2)));
+    w = _mm256_add_epi32(w, _mm256_blend_epi32(s1, zero, 0xCC));
+    s1 = VSIGMA1(_mm256_shuffle_epi32(w, _MM_SHUFFLE(1, 0, 0, 0)));
+    return _mm256_add_epi32(w, _mm256_blend_epi32(zero, s1, 0xCC));
+}
+
+static inline __m256i sha256_avx2_load(const uint8_t* a, const uint8_t* b, __m256i bswap_mask) {
+    __m256i x = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)a)), _mm_loadu_si128((const __m128i*)b), 1);
+    return _mm256_shuffle_epi8(x, bswap_mask);
+}
+
+// wk[8 * q + 0..3] holds w + k of rounds 4q..4q+3 for block a, wk[8 * q + 4..7] for block b
+static void sha256_avx2_rounds(uint32_t* s, const uint32_t* wk) {
+    uint32_t a = s[0], b = s[1], c = s[2], d = s[3], e = s[4], f = s[5], g = s[6], h = s[7];
+    int i;
+    for (i = 0; i < 128; i += 16) {
+        ROUND(a, b, c, d, e, f, g, h, wk[i + 0]);
+        ROUND(h, a, b, c, d, e, f, g, wk[i + 1]);
+        ROUND(g, h, a, b, c, d, e, f, wk[i + 2]);
+        ROUND(f, g, h, a, b, c, d, e, wk[i + 3]);
+        ROUND(e, f, g, h, a, b, c, d, wk[i + 8]);
+        ROUND(d, e, f, g, h, a, b, c, wk[i + 9]);
+        ROUND(c, d, e, f, g, h, a, b, wk[i + 10]);
+        ROUND(b, c, d, e, f, g, h, a, wk[i + 11]);
+    }
+    s[0] += a;
+    s[1] += b;
+    s[2] += c;
+    s[3] += d;
+    s[4] += e;
+    s[5] += f;
+    s[6] += g;
+    s[7] += h;
+}
+
+void sha256_transform_avx2(uint32_t* s, const uint8_t* data, size_t blocks) {
+    const __m256i bswap_mask = _mm256_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL, 0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+    uint32_t wk[128] __attribute__((aligned(32)));
+    int i;
+
+    while (blocks) {
+        // a lone last block is scheduled in both lanes, only the first is used
+        const uint8_t* next = blocks > 1 ? data + 64 : data;
+        __m256i x0 = sha256_avx2_load(data + 0, next + 0, bswap_mask);
+        __m256i x1 = sha256_avx2_load(data + 16, next + 16, bswap_mask);
+        __m256i x2 = sha256_avx2_load(data + 32, next + 32, bswap_mask);
+        __m256i x3 = sha256_avx2_load(data + 48, next + 48, bswap_mask);
+
+        for (i = 0; i < 64; i += 16) {
+            _mm256_store_si256((__m256i*)&wk[2 * i + 0], _mm256_add_epi32(x0, _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)&K256[i + 0]))));
+            _mm256_store_si256((__m256i*)&wk[2 * i + 8], _mm256_add_epi32(x1, _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)&K256[i + 4]))));
+            _mm256_store_si256((__m256i*)&wk[2 * i + 16], _mm256_add_epi32(x2, _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)&K256[i + 8]))));
+            _mm256_store_si256((__m256i*)&wk[2 * i + 24], _mm256_add_epi32(x3, _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)&K256[i + 12]))));
+            if (i == 48)
+                break;
+            x0 = sha256_avx2_schedule(x0, x1, x2, x3);
+            x1 = sha256_avx2_schedule(x1, x2, x3, x0);
+            x2 = sha256_avx2_schedule(x2, x3, x0, x1);
+            x3 = sha256_avx2_schedule(x3, x0, x1, x2);
+        }
+
+        sha256_avx2_rounds(s, wk);
+        if (blocks == 1)
+            break;
+        sha256_avx2_rounds(s, wk + 4);
+        data += 128;
+        blocks -= 2;
+    }
+}
+
+// eight lane compression for sha256_raw_batch, one message per 32 bit lane
+
+#undef ROUND
+
+#define VEC __m256i
+#define ADD(a, b) _mm256_add_epi32(a, b)
+#define XOR(a, b) _mm256_xor_si256(a, b)
+#define SET1(k) _mm256_set1_epi32((int)(k))
+#define LOAD(p) _mm256_loadu_si256((const __m256i*)(p))
+#define STORE(p, v) _mm256_storeu_si256((__m256i*)(p), v)
+#define ROR(x, n) _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - (n)))
+#define CH(e, f, g) XOR(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g))
+#define MAJ(a, b, c) XOR(_mm256_and_si256(a, b), _mm256_and_si256(c, XOR(a, b)))
+#define SUM0(x) XOR(XOR(ROR(x, 2), ROR(x, 13)), ROR(x, 22))
+#define SUM1(x) XOR(XOR(ROR(x, 6), ROR(x, 11)), ROR(x, 25))
+#define SIG0(x) XOR(XOR(ROR(x, 7), ROR(x, 18)), _mm256_srli_epi32(x, 3))
+#define SIG1(x) XOR(XOR(ROR(x, 17), ROR(x, 19)), _mm256_srli_epi32(x, 10))
+#define READ(blocks, o) _mm256_set_epi32((int)sha256_avx2_read_be32(blocks[7] + (o)), (int)sha256_avx2_read_be32(blocks[6] + (o)), \
+                                         (int)sha256_avx2_read_be32(blocks[5] + (o)), (int)sha256_avx2_read_be32(blocks[4] + (o)), \
+                                         (int)sha256_avx2_read_be32(blocks[3] + (o)), (int)sha256_avx2_read_be32(blocks[2] + (o)), \
+                                         (int)sha256_avx2_read_be32(blocks[1] + (o)), (int)sha256_avx2_read_be32(blocks[0] + (o)))
+
+// one round on every lane, the caller rotates the working variables
+#define ROUND(a, b, c, d, e, f, g, h, k, w)                                            \
+    do {                                                                               \
+        const VEC t1 = ADD(ADD(h, SUM1(e)), ADD(ADD(CH(e, f, g), SET1(k)), w));        \
+        const VEC t2 = ADD(SUM0(a), MAJ(a, b, c));                                      \
+        d = ADD(d, t1);                                                                \
+        h = ADD(t1, t2);                                                               \
+    } while (0)
+
+#define SCHEDULE(i) (w[(i) & 15] = ADD(ADD(w[(i) & 15], SIG1(w[((i) + 14) & 15])), ADD(w[((i) + 9) & 15], SIG0(w[((i) + 1) & 15]))))
+
+static inline uint32_t sha256_avx2_read_be32(const uint8_t* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+// 8 independent sha256 compressions, state is word major (state[i * 8 + lane])
+void sha256_transform_8way(uint32_t* state, const uint8_t* const* blocks) {
+    VEC a = LOAD(state + 0 * 8), b = LOAD(state + 1 * 8), c = LOAD(state + 2 * 8), d = LOAD(state + 3 * 8);
+    VEC e = LOAD(state + 4 * 8), f = LOAD(state + 5 * 8), g = LOAD(state + 6 * 8), h = LOAD(state + 7 * 8);
+    VEC w[16];
+    int i;
+
+    for (i = 0; i < 16; i++) {
+        w[i] = READ(blocks, 4 * i);
+    }
+    for (i = 0; i < 16; i += 8) {
+        ROUND(a, b, c, d, e, f, g, h, K256[i + 0], w[i + 0]);
+        ROUND(h, a, b, c, d, e, f, g, K256[i + 1], w[i + 1]);
+        ROUND(g, h, a, b, c, d, e, f, K256[i + 2], w[i + 2]);
+        ROUND(f, g, h, a, b, c, d, e, K256[i + 3], w[i + 3]);
+        ROUND(e, f, g, h, a, b, c, d, K256[i + 4], w[i + 4]);
+        ROUND(d, e, f, g, h, a, b, c, K256[i + 5], w[i + 5]);
+        ROUND(c, d, e, f, g, h, a, b, K256[i + 6], w[i + 6]);
+        ROUND(b, c, d, e, f, g, h, a, K256[i + 7], w[i + 7]);
+    }
+    for (; i < 64; i += 8) {
+        ROUND(a, b, c, d, e, f, g, h, K256[i + 0], SCHEDULE(i + 0));
+        ROUND(h, a, b, c, d, e, f, g, K256[i + 1], SCHEDULE(i + 1));
+        ROUND(g, h, a, b, c, d, e, f, K256[i + 2], SCHEDULE(i + 2));
+        ROUND(f, g, h, a, b, c, d, e, K256[i + 3], SCHEDULE(i + 3));
+        ROUND(e, f, g, h, a, b, c, d, K256[i + 4], SCHEDULE(i + 4));
+        ROUND(d, e, f, g, h, a, b, c, K256[i + 5], SCHEDULE(i + 5));
+        ROUND(c, d, e, f, g, h, a, b, K256[i + 6], SCHEDULE(i + 6));
+        ROUND(b, c, d, e, f, g, h, a, K256[i + 7], SCHEDULE(i + 7));
+    }
+
+    STORE(state + 0 * 8, ADD(LOAD(state + 0 * 8), a));
+    STORE(state + 1 * 8, ADD(LOAD(state + 1 * 8), b));
+    STORE(state + 2 * 8, ADD(LOAD(state + 2 * 8), c));
+    STORE(state + 3 * 8, ADD(LOAD(state + 3 * 8), d));
+    STORE(state + 4 * 8, ADD(LOAD(state + 4 * 8), e));
+    STORE(state + 5 * 8, ADD(LOAD(state + 5 * 8), f));
+    STORE(state + 6 * 8, ADD(LOAD(state + 6 * 8), g));
+    STORE(state + 7 * 8, ADD(LOAD(state + 7 * 8), h));
+}
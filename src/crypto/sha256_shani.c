@@ -0,0 +1,132 @@
+/*
+
+ The MIT License (MIT)
+
+ Copyright (c) 2022 The Dogecoin Foundation
+
+ Permission is hereby granted, free of charge, to any person obtaining
+ a copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES
+ OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <immintrin.h>
+
+// sha256 compression using the x86 SHA extensions, built with -msse4.1 -msha
+// and only called after cpuid reported support
+
+static const uint32_t K256[64] __attribute__((aligned(16))) = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+// four rounds on the message words in w
+#define SHANI_QROUND(g, w)                                                        \
+    msg = _mm_add_epi32(w, _mm_load_si128((const __m128i*)&K256[4 * (g)]));       \
+    state1 = _mm_sha256rnds2_epu32(state1, state0, msg);                          \
+    msg = _mm_shuffle_epi32(msg, 0x0E);                                           \
+    state0 = _mm_sha256rnds2_epu32(state0, state1, msg)
+
+// message schedule: finish next from the two previous groups, start prev for the group after
+#define SHANI_SCHED2(next, cur, prev)                                             \
+    next = _mm_add_epi32(next, _mm_alignr_epi8(cur, prev, 4));                    \
+    next = _mm_sha256msg2_epu32(next, cur)
+#define SHANI_SCHED1(prev, cur) prev = _mm_sha256msg1_epu32(prev, cur)
+
+void sha256_transform_shani(uint32_t* s, const uint8_t* data, size_t blocks) {
+    const __m128i bswap_mask = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+    __m128i state0, state1, msg, tmp, m0, m1, m2, m3, abef_save, cdgh_save;
+
+    // state words are kept as ABEF / CDGH for the sha256rnds2 instruction
+    tmp = _mm_loadu_si128((const __m128i*)&s[0]);
+    state1 = _mm_loadu_si128((const __m128i*)&s[4]);
+    tmp = _mm_shuffle_epi32(tmp, 0xB1);
+    state1 = _mm_shuffle_epi32(state1, 0x1B);
+    state0 = _mm_alignr_epi8(tmp, state1, 8);
+    state1 = _mm_blend_epi16(state1, tmp, 0xF0);
+
+    while (blocks--) {
+        abef_save = state0;
+        cdgh_save = state1;
+
+        m0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 0)), bswap_mask);
+        m1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 16)), bswap_mask);
+        m2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 32)), bswap_mask);
+        m3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 48)), bswap_mask);
+
+        SHANI_QROUND(0, m0);
+        SHANI_QROUND(1, m1);
+        SHANI_SCHED1(m0, m1);
+        SHANI_QROUND(2, m2);
+        SHANI_SCHED1(m1, m2);
+        SHANI_QROUND(3, m3);
+        SHANI_SCHED2(m0, m3, m2);
+        SHANI_SCHED1(m2, m3);
+        SHANI_QROUND(4, m0);
+        SHANI_SCHED2(m1, m0, m3);
+        SHANI_SCHED1(m3, m0);
+        SHANI_QROUND(5, m1);
+        SHANI_SCHED2(m2, m1, m0);
+        SHANI_SCHED1(m0, m1);
+        SHANI_QROUND(6, m2);
+        SHANI_SCHED2(m3, m2, m1);
+        SHANI_SCHED1(m1, m2);
+        SHANI_QROUND(7, m3);
+        SHANI_SCHED2(m0, m3, m2);
+        SHANI_SCHED1(m2, m3);
+        SHANI_QROUND(8, m0);
+        SHANI_SCHED2(m1, m0, m3);
+        SHANI_SCHED1(m3, m0);
+        SHANI_QROUND(9, m1);
+        SHANI_SCHED2(m2, m1, m0);
+        SHANI_SCHED1(m0, m1);
+        SHANI_QROUND(10, m2);
+        SHANI_SCHED2(m3, m2, m1);
+        SHANI_SCHED1(m1, m2);
+        SHANI_QROUND(11, m3);
+        SHANI_SCHED2(m0, m3, m2);
+        SHANI_SCHED1(m2, m3);
+        SHANI_QROUND(12, m0);
+        SHANI_SCHED2(m1, m0, m3);
+        SHANI_SCHED1(m3, m0);
+        SHANI_QROUND(13, m1);
+        SHANI_SCHED2(m2, m1, m0);
+        SHANI_QROUND(14, m2);
+        SHANI_SCHED2(m3, m2, m1);
+        SHANI_QROUND(15, m3);
+
+        state0 = _mm_add_epi32(state0, abef_save);
+        state1 = _mm_add_epi32(state1, cdgh_save);
+        data += 64;
+    }
+
+    // back to ABCD / EFGH
+    tmp = _mm_shuffle_epi32(state0, 0x1B);
+    state1 = _mm_shuffle_epi32(state1, 0xB1);
+    state0 = _mm_blend_epi16(tmp, state1, 0xF0);
+    state1 = _mm_alignr_epi8(state1, tmp, 8);
+    _mm_storeu_si128((__m128i*)&s[0], state0);
+    _mm_storeu_si128((__m128i*)&s[4], state1);
+}
@@ -0,0 +1,115 @@
+/*
+
+ The MIT License (MIT)
+
+ Copyright (c) 2022 The Dogecoin Foundation
+
+ Permission is hereby granted, free of charge, to any person obtaining
+ a copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES
+ OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <emmintrin.h>
+
+// four lane sha256 compression for sha256_raw_batch, one message per 32 bit lane,
+// built with -msse2
+
+static const uint32_t K256[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+#define VEC __m128i
+#define ADD(a, b) _mm_add_epi32(a, b)
+#define XOR(a, b) _mm_xor_si128(a, b)
+#define SET1(k) _mm_set1_epi32((int)(k))
+#define LOAD(p) _mm_loadu_si128((const __m128i*)(p))
+#define STORE(p, v) _mm_storeu_si128((__m128i*)(p), v)
+#define ROR(x, n) _mm_or_si128(_mm_srli_epi32(x, n), _mm_slli_epi32(x, 32 - (n)))
+#define CH(e, f, g) XOR(_mm_and_si128(e, f), _mm_andnot_si128(e, g))
+#define MAJ(a, b, c) XOR(_mm_and_si128(a, b), _mm_and_si128(c, XOR(a, b)))
+#define SUM0(x) XOR(XOR(ROR(x, 2), ROR(x, 13)), ROR(x, 22))
+#define SUM1(x) XOR(XOR(ROR(x, 6), ROR(x, 11)), ROR(x, 25))
+#define SIG0(x) XOR(XOR(ROR(x, 7), ROR(x, 18)), _mm_srli_epi32(x, 3))
+#define SIG1(x) XOR(XOR(ROR(x, 17), ROR(x, 19)), _mm_srli_epi32(x, 10))
+#define READ(blocks, o) _mm_set_epi32((int)sha256_sse2_read_be32(blocks[3] + (o)), (int)sha256_sse2_read_be32(blocks[2] + (o)), \
+                                      (int)sha256_sse2_read_be32(blocks[1] + (o)), (int)sha256_sse2_read_be32(blocks[0] + (o)))
+
+// one round on every lane, the caller rotates the working variables
+#define ROUND(a, b, c, d, e, f, g, h, k, w)                                            \
+    do {                                                                               \
+        const VEC t1 = ADD(ADD(h, SUM1(e)), ADD(ADD(CH(e, f, g), SET1(k)), w));        \
+        const VEC t2 = ADD(SUM0(a), MAJ(a, b, c));                                      \
+        d = ADD(d, t1);                                                                \
+        h = ADD(t1, t2);                                                               \
+    } while (0)
+
+#define SCHEDULE(i) (w[(i) & 15] = ADD(ADD(w[(i) & 15], SIG1(w[((i) + 14) & 15])), ADD(w[((i) + 9) & 15], SIG0(w[((i) + 1) & 15]))))
+
+static inline uint32_t sha256_sse2_read_be32(const uint8_t* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+// 4 independent sha256 compressions, state is word major (state[i * 4 + lane])
+void sha256_transform_4way(uint32_t* state, const uint8_t* const* blocks) {
+    VEC a = LOAD(state + 0 * 4), b = LOAD(state + 1 * 4), c = LOAD(state + 2 * 4), d = LOAD(state + 3 * 4);
+    VEC e = LOAD(state + 4 * 4), f = LOAD(state + 5 * 4), g = LOAD(state + 6 * 4), h = LOAD(state + 7 * 4);
+    VEC w[16];
+    int i;
+
+    for (i = 0; i < 16; i++) {
+        w[i] = READ(blocks, 4 * i);
+    }
+    for (i = 0; i < 16; i += 8) {
+        ROUND(a, b, c, d, e, f, g, h, K256[i + 0], w[i + 0]);
+        ROUND(h, a, b, c, d, e, f, g, K256[i + 1], w[i + 1]);
+        ROUND(g, h, a, b, c, d, e, f, K256[i + 2], w[i + 2]);
+        ROUND(f, g, h, a, b, c, d, e, K256[i + 3], w[i + 3]);
+        ROUND(e, f, g, h, a, b, c, d, K256[i + 4], w[i + 4]);
+        ROUND(d, e, f, g, h, a, b, c, K256[i + 5], w[i + 5]);
+        ROUND(c, d, e, f, g, h, a, b, K256[i + 6], w[i + 6]);
+        ROUND(b, c, d, e, f, g, h, a, K256[i + 7], w[i + 7]);
+    }
+    for (; i < 64; i += 8) {
+        ROUND(a, b, c, d, e, f, g, h, K256[i + 0], SCHEDULE(i + 0));
+        ROUND(h, a, b, c, d, e, f, g, K256[i + 1], SCHEDULE(i + 1));
+        ROUND(g, h, a, b, c, d, e, f, K256[i + 2], SCHEDULE(i + 2));
+        ROUND(f, g, h, a, b, c, d, e, K256[i + 3], SCHEDULE(i + 3));
+        ROUND(e, f, g, h, a, b, c, d, K256[i + 4], SCHEDULE(i + 4));
+        ROUND(d, e, f, g, h, a, b, c, K256[i + 5], SCHEDULE(i + 5));
+        ROUND(c, d, e, f, g, h, a, b, K256[i + 6], SCHEDULE(i + 6));
+        ROUND(b, c, d, e, f, g, h, a, K256[i + 7], SCHEDULE(i + 7));
+    }
+
+    STORE(state + 0 * 4, ADD(LOAD(state + 0 * 4), a));
+    STORE(state + 1 * 4, ADD(LOAD(state + 1 * 4), b));
+    STORE(state + 2 * 4, ADD(LOAD(state + 2 * 4), c));
+    STORE(state + 3 * 4, ADD(LOAD(state + 3 * 4), d));
+    STORE(state + 4 * 4, ADD(LOAD(state + 4 * 4), e));
+    STORE(state + 5 * 4, ADD(LOAD(state + 5 * 4), f));
+    STORE(state + 6 * 4, ADD(LOAD(state + 6 * 4), g));
+    STORE(state + 7 * 4, ADD(LOAD(state + 7 * 4), h));
+}
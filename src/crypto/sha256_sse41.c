@@ -0,0 +1,115 @@
+/*
+
+ The MIT License (MIT)
+
+ Copyright (c) 2022 The Dogecoin Foundation
+
+ Permission is hereby granted, free of charge, to any person obtaining
+ a copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES
+ OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <immintrin.h>
+
+// sha256 compression with the message schedule computed four words at a time
+// in SSE registers, built with -msse4.1 and only called after cpuid reported support
+
+static const uint32_t K256[64] __attribute__((aligned(16))) = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+#define ROTR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+#define VROTR(x, n) _mm_or_si128(_mm_srli_epi32(x, n), _mm_slli_epi32(x, 32 - (n)))
+#define VSIGMA0(x) _mm_xor_si128(_mm_xor_si128(VROTR(x, 7), VROTR(x, 18)), _mm_srli_epi32(x, 3))
+#define VSIGMA1(x) _mm_xor_si128(_mm_xor_si128(VROTR(x, 17), VROTR(x, 19)), _mm_srli_epi32(x, 10))
+
+#define ROUND(a, b, c, d, e, f, g, h, wk)                                                          \
+    do {                                                                                           \
+        const uint32_t t1 = (h) + (ROTR(e, 6) ^ ROTR(e, 11) ^ ROTR(e, 25)) + (((e) & (f)) ^ (~(e) & (g))) + (wk); \
+        const uint32_t t2 = (ROTR(a, 2) ^ ROTR(a, 13) ^ ROTR(a, 22)) + (((a) & (b)) ^ ((a) & (c)) ^ ((b) & (c))); \
+        (d) += t1;                                                                                 \
+        (h) = t1 + t2;                                                                             \
+    } while (0)
+
+// next four schedule words from the previous sixteen (x0 oldest)
+static inline __m128i sha256_sse41_schedule(__m128i x0, __m128i x1, __m128i x2, __m128i x3) {
+    __m128i w = _mm_add_epi32(x0, VSIGMA0(_mm_alignr_epi8(x1, x0, 4)));
+    w = _mm_add_epi32(w, _mm_alignr_epi8(x3, x2, 4));
+    // sigma1 of w[t-2], w[t-1] completes the low two words, which then feed the high two
+    __m128i s1 = VSIGMA1(_mm_shuffle_epi32(x3, _MM_SHUFFLE(3, 3, 3, 2)));
+    w = _mm_add_epi32(w, _mm_move_epi64(s1));
+    s1 = VSIGMA1(_mm_shuffle_epi32(w, _MM_SHUFFLE(1, 0, 0, 0)));
+    return _mm_add_epi32(w, _mm_unpackhi_epi64(_mm_setzero_si128(), s1));
+}
+
+void sha256_transform_sse41(uint32_t* s, const uint8_t* data, size_t blocks) {
+    const __m128i bswap_mask = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+    uint32_t wk[64] __attribute__((aligned(16)));
+    int i;
+
+    while (blocks--) {
+        __m128i x0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 0)), bswap_mask);
+        __m128i x1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 16)), bswap_mask);
+        __m128i x2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 32)), bswap_mask);
+        __m128i x3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 48)), bswap_mask);
+
+        // w + k for all 64 rounds up front
+        for (i = 0; i < 64; i += 16) {
+            _mm_store_si128((__m128i*)&wk[i + 0], _mm_add_epi32(x0, _mm_load_si128((const __m128i*)&K256[i + 0])));
+            _mm_store_si128((__m128i*)&wk[i + 4], _mm_add_epi32(x1, _mm_load_si128((const __m128i*)&K256[i + 4])));
+            _mm_store_si128((__m128i*)&wk[i + 8], _mm_add_epi32(x2, _mm_load_si128((const __m128i*)&K256[i + 8])));
+            _mm_store_si128((__m128i*)&wk[i + 12], _mm_add_epi32(x3, _mm_load_si128((const __m128i*)&K256[i + 12])));
+            if (i == 48)
+                break;
+            x0 = sha256_sse41_schedule(x0, x1, x2, x3);
+            x1 = sha256_sse41_schedule(x1, x2, x3, x0);
+            x2 = sha256_sse41_schedule(x2, x3, x0, x1);
+            x3 = sha256_sse41_schedule(x3, x0, x1, x2);
+        }
+
+        uint32_t a = s[0], b = s[1], c = s[2], d = s[3], e = s[4], f = s[5], g = s[6], h = s[7];
+        for (i = 0; i < 64; i += 8) {
+            ROUND(a, b, c, d, e, f, g, h, wk[i + 0]);
+            ROUND(h, a, b, c, d, e, f, g, wk[i + 1]);
+            ROUND(g, h, a, b, c, d, e, f, wk[i + 2]);
+            ROUND(f, g, h, a, b, c, d, e, wk[i + 3]);
+            ROUND(e, f, g, h, a, b, c, d, wk[i + 4]);
+            ROUND(d, e, f, g, h, a, b, c, wk[i + 5]);
+            ROUND(c, d, e, f, g, h, a, b, wk[i + 6]);
+            ROUND(b, c, d, e, f, g, h, a, wk[i + 7]);
+        }
+        s[0] += a;
+        s[1] += b;
+        s[2] += c;
+        s[3] += d;
+        s[4] += e;
+        s[5] += f;
+        s[6] += g;
+        s[7] += h;
+        data += 64;
+    }
+}
@@ -0,0 +1,277 @@
+/*
+
+ The MIT License (MIT)
+
+ Copyright (c) 2022 The Dogecoin Foundation
+
+ Permission is hereby granted, free of charge, to any person obtaining
+ a copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES
+ OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <immintrin.h>
+
+// sha512 compression with the message schedule of two blocks computed at once
+// (one block per 128 bit lane, two words each), built with -mavx2 -mbmi2 so the
+// scalar rounds use rorx, and only called after cpuid reported support
+
+static const uint64_t K512[80] __attribute__((aligned(32))) = {
+    0x428a2f98d728ae22ULL, 0x7137449123ef65cdULL, 0xb5c0fbcfec4d3b2fULL, 0xe9b5dba58189dbbcULL,
+    0x3956c25bf348b538ULL, 0x59f111f1b605d019ULL, 0x923f82a4af194f9bULL, 0xab1c5ed5da6d8118ULL,
+    0xd807aa98a3030242ULL, 0x12835b0145706fbeULL, 0x243185be4ee4b28cULL, 0x550c7dc3d5ffb4e2ULL,
+    0x72be5d74f27b896fULL, 0x80deb1fe3b1696b1ULL, 0x9bdc06a725c71235ULL, 0xc19bf174cf692694ULL,
+    0xe49b69c19ef14ad2ULL, 0xefbe4786384f25e3ULL, 0x0fc19dc68b8cd5b5ULL, 0x240ca1cc77ac9c65ULL,
+    0x2de92c6f592b0275ULL, 0x4a7484aa6ea6e483ULL, 0x5cb0a9dcbd41fbd4ULL, 0x76f988da831153b5ULL,
+    0x983e5152ee66dfabULL, 0xa831c66d2db43210ULL, 0xb00327c898fb213fULL, 0xbf597fc7beef0ee4ULL,
+    0xc6e00bf33da88fc2ULL, 0xd5a79147930aa725ULL, 0x06ca6351e003826fULL, 0x142929670a0e6e70ULL,
+    0x27b70a8546d22ffcULL, 0x2e1b21385c26c926ULL, 0x4d2c6dfc5ac42aedULL, 0x53380d139d95b3dfULL,
+    0x650a73548baf63deULL, 0x766a0abb3c77b2a8ULL, 0x81c2c92e47edaee6ULL, 0x92722c851482353bULL,
+    0xa2bfe8a14cf10364ULL, 0xa81a664bbc423001ULL, 0xc24b8b70d0f89791ULL, 0xc76c51a30654be30ULL,
+    0xd192e819d6ef5218ULL, 0xd69906245565a910ULL, 0xf40e35855771202aULL, 0x106aa07032bbd1b8ULL,
+    0x19a4c116b8d2d0c8ULL, 0x1e376c085141ab53ULL, 0x2748774cdf8eeb99ULL, 0x34b0bcb5e19b48a8ULL,
+    0x391c0cb3c5c95a63ULL, 0x4ed8aa4ae3418acbULL, 0x5b9cca4f7763e373ULL, 0x682e6ff3d6b2b8a3ULL,
+    0x748f82ee5defb2fcULL, 0x78a5636f43172f60ULL, 0x84c87814a1f0ab72ULL, 0x8cc702081a6439ecULL,
+    0x90befffa23631e28ULL, 0xa4506cebde82bde9ULL, 0xbef9a3f7b2c67915ULL, 0xc67178f2e372532bULL,
+    0xca273eceea26619cULL, 0xd186b8c721c0c207ULL, 0xeada7dd6cde0eb1eULL, 0xf57d4f7fee6ed178ULL,
+    0x06f067aa72176fbaULL, 0x0a637dc5a2c898a6ULL, 0x113f9804bef90daeULL, 0x1b710b35131c471bULL,
+    0x28db77f523047d84ULL, 0x32caab7b40c72493ULL, 0x3c9ebe0a15c9bebcULL, 0x431d67c49c100d4cULL,
+    0x4cc5d4becb3e42b6ULL, 0x597f299cfc657e2aULL, 0x5fcb6fab3ad6faecULL, 0x6c44198c4a475817ULL};
+
+#define ROTR(x, n) (((x) >> (n)) | ((x) << (64 - (n))))
+#define VROTR(x, n) _mm256_or_si256(_mm256_srli_epi64(x, n), _mm256_slli_epi64(x, 64 - (n)))
+#define VSIGMA0(x) _mm256_xor_si256(_mm256_xor_si256(VROTR(x, 1), VROTR(x, 8)), _mm256_srli_epi64(x, 7))
+#define VSIGMA1(x) _mm256_xor_si256(_mm256_xor_si256(VROTR(x, 19), VROTR(x, 61)), _mm256_srli_epi64(x, 6))
+#define VROTR_1(x, n) _mm_or_si128(_mm_srli_epi64(x, n), _mm_slli_epi64(x, 64 - (n)))
+#define VSIGMA0_1(x) _mm_xor_si128(_mm_xor_si128(VROTR_1(x, 1), VROTR_1(x, 8)), _mm_srli_epi64(x, 7))
+#define VSIGMA1_1(x) _mm_xor_si128(_mm_xor_si128(VROTR_1(x, 19), VROTR_1(x, 61)), _mm_srli_epi64(x, 6))
+
+// w + k of rounds i, i + 1 of both blocks, or of a lone block
+#define WK(i, x) _mm256_store_si256((__m256i*)&wk[2 * (i)], _mm256_add_epi64(x, _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)&K512[i]))))
+#define WK1(i, x) _mm_store_si128((__m128i*)&wk[i], _mm_add_epi64(x, _mm_load_si128((const __m128i*)&K512[i])))
+
+#define ROUND(a, b, c, d, e, f, g, h, wk)                                                          \
+    do {                                                                                           \
+        const uint64_t t1 = (h) + (ROTR(e, 14) ^ ROTR(e, 18) ^ ROTR(e, 41)) + (((e) & (f)) ^ (~(e) & (g))) + (wk); \
+        const uint64_t t2 = (ROTR(a, 28) ^ ROTR(a, 34) ^ ROTR(a, 39)) + (((a) & (b)) ^ ((a) & (c)) ^ ((b) & (c))); \
+        (d) += t1;                                                                                 \
+        (h) = t1 + t2;                                                                             \
+    } while (0)
+
+// next two schedule words of both blocks from the previous sixteen, x0 holds the oldest two
+static inline __m256i sha512_avx2_schedule(__m256i x0, __m256i x1, __m256i x4, __m256i x5, __m256i x7) {
+    __m256i w = _mm256_add_epi64(x0, VSIGMA0(_mm256_alignr_epi8(x1, x0, 8)));
+    w = _mm256_add_epi64(w, _mm256_alignr_epi8(x5, x4, 8));
+    return _mm256_add_epi64(w, VSIGMA1(x7));
+}
+
+static inline __m256i sha512_avx2_load(const uint8_t* a, const uint8_t* b, __m256i bswap_mask) {
+    __m256i x = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)a)), _mm_loadu_si128((const __m128i*)b), 1);
+    return _mm256_shuffle_epi8(x, bswap_mask);
+}
+
+// next two schedule words of a lone block, same as above on one 128 bit lane
+static inline __m128i sha512_avx2_schedule1(__m128i x0, __m128i x1, __m128i x4, __m128i x5, __m128i x7) {
+    __m128i w = _mm_add_epi64(x0, VSIGMA0_1(_mm_alignr_epi8(x1, x0, 8)));
+    w = _mm_add_epi64(w, _mm_alignr_epi8(x5, x4, 8));
+    return _mm_add_epi64(w, VSIGMA1_1(x7));
+}
+
+// w + k of rounds 2q, 2q + 1 are at wk[stride * q + 0..1], stride is 4 when two blocks are interleaved
+static inline void sha512_avx2_rounds(uint64_t* s, const uint64_t* wk, const int stride) {
+    uint64_t a = s[0], b = s[1], c = s[2], d = s[3], e = s[4], f = s[5], g = s[6], h = s[7];
+    int i;
+    for (i = 0; i < 40 * stride; i += 4 * stride) {
+        ROUND(a, b, c, d, e, f, g, h, wk[i + 0]);
+        ROUND(h, a, b, c, d, e, f, g, wk[i + 1]);
+        ROUND(g, h, a, b, c, d, e, f, wk[i + stride]);
+        ROUND(f, g, h, a, b, c, d, e, wk[i + stride + 1]);
+        ROUND(e, f, g, h, a, b, c, d, wk[i + 2 * stride]);
+        ROUND(d, e, f, g, h, a, b, c, wk[i + 2 * stride + 1]);
+        ROUND(c, d, e, f, g, h, a, b, wk[i + 3 * stride]);
+        ROUND(b, c, d, e, f, g, h, a, wk[i + 3 * stride + 1]);
+    }
+    s[0] += a;
+    s[1] += b;
+    s[2] += c;
+    s[3] += d;
+    s[4] += e;
+    s[5] += f;
+    s[6] += g;
+    s[7] += h;
+}
+
+static void sha512_avx2_block1(uint64_t* s, const uint8_t* data) {
+    const __m128i bswap_mask = _mm_set_epi64x(0x08090a0b0c0d0e0fULL, 0x0001020304050607ULL);
+    uint64_t wk[80] __attribute__((aligned(16)));
+    __m128i x0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 0)), bswap_mask);
+    __m128i x1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 16)), bswap_mask);
+    __m128i x2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 32)), bswap_mask);
+    __m128i x3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 48)), bswap_mask);
+    __m128i x4 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 64)), bswap_mask);
+    __m128i x5 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 80)), bswap_mask);
+    __m128i x6 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 96)), bswap_mask);
+    __m128i x7 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 112)), bswap_mask);
+    int i;
+
+    for (i = 0; i < 80; i += 16) {
+        WK1(i + 0, x0);
+        WK1(i + 2, x1);
+        WK1(i + 4, x2);
+        WK1(i + 6, x3);
+        WK1(i + 8, x4);
+        WK1(i + 10, x5);
+        WK1(i + 12, x6);
+        WK1(i + 14, x7);
+        if (i == 64)
+            break;
+        x0 = sha512_avx2_schedule1(x0, x1, x4, x5, x7);
+        x1 = sha512_avx2_schedule1(x1, x2, x5, x6, x0);
+        x2 = sha512_avx2_schedule1(x2, x3, x6, x7, x1);
+        x3 = sha512_avx2_schedule1(x3, x4, x7, x0, x2);
+        x4 = sha512_avx2_schedule1(x4, x5, x0, x1, x3);
+        x5 = sha512_avx2_schedule1(x5, x6, x1, x2, x4);
+        x6 = sha512_avx2_schedule1(x6, x7, x2, x3, x5);
+        x7 = sha512_avx2_schedule1(x7, x0, x3, x4, x6);
+    }
+    sha512_avx2_rounds(s, wk, 2);
+}
+
+void sha512_transform_avx2(uint64_t* s, const uint8_t* data, size_t blocks) {
+    const __m256i bswap_mask = _mm256_set_epi64x(0x08090a0b0c0d0e0fULL, 0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL, 0x0001020304050607ULL);
+    uint64_t wk[160] __attribute__((aligned(32)));
+    int i;
+
+    for (; blocks >= 2; blocks -= 2, data += 256) {
+        __m256i x0 = sha512_avx2_load(data + 0, data + 128, bswap_mask);
+        __m256i x1 = sha512_avx2_load(data + 16, data + 144, bswap_mask);
+        __m256i x2 = sha512_avx2_load(data + 32, data + 160, bswap_mask);
+        __m256i x3 = sha512_avx2_load(data + 48, data + 176, bswap_mask);
+        __m256i x4 = sha512_avx2_load(data + 64, data + 192, bswap_mask);
+        __m256i x5 = sha512_avx2_load(data + 80, data + 208, bswap_mask);
+        __m256i x6 = sha512_avx2_load(data + 96, data + 224, bswap_mask);
+        __m256i x7 = sha512_avx2_load(data + 112, data + 240, bswap_mask);
+
+        for (i = 0; i < 80; i += 16) {
+            WK(i + 0, x0);
+            WK(i + 2, x1);
+            WK(i + 4, x2);
+            WK(i + 6, x3);
+            WK(i + 8, x4);
+            WK(i + 10, x5);
+            WK(i + 12, x6);
+            WK(i + 14, x7);
+            if (i == 64)
+                break;
+            x0 = sha512_avx2_schedule(x0, x1, x4, x5, x7);
+            x1 = sha512_avx2_schedule(x1, x2, x5, x6, x0);
+            x2 = sha512_avx2_schedule(x2, x3, x6, x7, x1);
+            x3 = sha512_avx2_schedule(x3, x4, x7, x0, x2);
+            x4 = sha512_avx2_schedule(x4, x5, x0, x1, x3);
+            x5 = sha512_avx2_schedule(x5, x6, x1, x2, x4);
+            x6 = sha512_avx2_schedule(x6, x7, x2, x3, x5);
+            x7 = sha512_avx2_schedule(x7, x0, x3, x4, x6);
+        }
+
+        sha512_avx2_rounds(s, wk, 4);
+        sha512_avx2_rounds(s, wk + 2, 4);
+    }
+    if (blocks)
+        sha512_avx2_block1(s, data);
+}
+
+// four lane compression for sha512_raw_batch, one message per 64 bit lane
+
+#undef ROUND
+#undef WK
+#undef WK1
+
+#define VEC __m256i
+#define ADD(a, b) _mm256_add_epi64(a, b)
+#define XOR(a, b) _mm256_xor_si256(a, b)
+#define SET1(k) _mm256_set1_epi64x((long long)(k))
+#define LOAD(p) _mm256_loadu_si256((const __m256i*)(p))
+#define STORE(p, v) _mm256_storeu_si256((__m256i*)(p), v)
+#define ROR(x, n) _mm256_or_si256(_mm256_srli_epi64(x, n), _mm256_slli_epi64(x, 64 - (n)))
+#define CH(e, f, g) XOR(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g))
+#define MAJ(a, b, c) XOR(_mm256_and_si256(a, b), _mm256_and_si256(c, XOR(a, b)))
+#define SUM0(x) XOR(XOR(ROR(x, 28), ROR(x, 34)), ROR(x, 39))
+#define SUM1(x) XOR(XOR(ROR(x, 14), ROR(x, 18)), ROR(x, 41))
+#define SIG0(x) XOR(XOR(ROR(x, 1), ROR(x, 8)), _mm256_srli_epi64(x, 7))
+#define SIG1(x) XOR(XOR(ROR(x, 19), ROR(x, 61)), _mm256_srli_epi64(x, 6))
+#define READ(blocks, o) _mm256_set_epi64x((long long)sha512_avx2_read_be64(blocks[3] + (o)), (long long)sha512_avx2_read_be64(blocks[2] + (o)), \
+                                          (long long)sha512_avx2_read_be64(blocks[1] + (o)), (long long)sha512_avx2_read_be64(blocks[0] + (o)))
+
+// one round on every lane, the caller rotates the working variables
+#define ROUND(a, b, c, d, e, f, g, h, k, w)                                            \
+    do {                                                                               \
+        const VEC t1 = ADD(ADD(h, SUM1(e)), ADD(ADD(CH(e, f, g), SET1(k)), w));        \
+        const VEC t2 = ADD(SUM0(a), MAJ(a, b, c));                                      \
+        d = ADD(d, t1);                                                                \
+        h = ADD(t1, t2);                                                               \
+    } while (0)
+
+#define SCHEDULE(i) (w[(i) & 15] = ADD(ADD(w[(i) & 15], SIG1(w[((i) + 14) & 15])), ADD(w[((i) + 9) & 15], SIG0(w[((i) + 1) & 15]))))
+
+static inline uint64_t sha512_avx2_read_be64(const uint8_t* p) {
+    return ((uint64_t)p[0] << 56) | ((uint64_t)p[1] << 48) | ((uint64_t)p[2] << 40) | ((uint64_t)p[3] << 32) |
+           ((uint64_t)p[4] << 24) | ((uint64_t)p[5] << 16) | ((uint64_t)p[6] << 8) | (uint64_t)p[7];
+}
+
+// 4 independent sha512 compressions, state is word major (state[i * 4 + lane])
+void sha512_transform_4way(uint64_t* state, const uint8_t* const* blocks) {
+    VEC a = LOAD(state + 0 * 4), b = LOAD(state + 1 * 4), c = LOAD(state + 2 * 4), d = LOAD(state + 3 * 4);
+    VEC e = LOAD(state + 4 * 4), f = LOAD(state + 5 * 4), g = LOAD(state + 6 * 4), h = LOAD(state + 7 * 4);
+    VEC w[16];
+    int i;
+
+    for (i = 0; i < 16; i++) {
+        w[i] = READ(blocks, 8 * i);
+    }
+    for (i = 0; i < 16; i += 8) {
+        ROUND(a, b, c, d, e, f, g, h, K512[i + 0], w[i + 0]);
+        ROUND(h, a, b, c, d, e, f, g, K512[i + 1], w[i + 1]);
+        ROUND(g, h, a, b, c, d, e, f, K512[i + 2], w[i + 2]);
+        ROUND(f, g, h, a, b, c, d, e, K512[i + 3], w[i + 3]);
+        ROUND(e, f, g, h, a, b, c, d, K512[i + 4], w[i + 4]);
+        ROUND(d, e, f, g, h, a, b, c, K512[i + 5], w[i + 5]);
+        ROUND(c, d, e, f, g, h, a, b, K512[i + 6], w[i + 6]);
+        ROUND(b, c, d, e, f, g, h, a, K512[i + 7], w[i + 7]);
+    }
+    for (; i < 80; i += 8) {
+        ROUND(a, b, c, d, e, f, g, h, K512[i + 0], SCHEDULE(i + 0));
+        ROUND(h, a, b, c, d, e, f, g, K512[i + 1], SCHEDULE(i + 1));
+        ROUND(g, h, a, b, c, d, e, f, K512[i + 2], SCHEDULE(i + 2));
+        ROUND(f, g, h, a, b, c, d, e, K512[i + 3], SCHEDULE(i + 3));
+        ROUND(e, f, g, h, a, b, c, d, K512[i + 4], SCHEDULE(i + 4));
+        ROUND(d, e, f, g, h, a, b, c, K512[i + 5], SCHEDULE(i + 5));
+        ROUND(c, d, e, f, g, h, a, b, K512[i + 6], SCHEDULE(i + 6));
+        ROUND(b, c, d, e, f, g, h, a, K512[i + 7], SCHEDULE(i + 7));
+    }
+
+    STORE(state + 0 * 4, ADD(LOAD(state + 0 * 4), a));
+    STORE(state + 1 * 4, ADD(LOAD(state + 1 * 4), b));
+    STORE(state + 2 * 4, ADD(LOAD(state + 2 * 4), c));
+    STORE(state + 3 * 4, ADD(LOAD(state + 3 * 4), d));
+    STORE(state + 4 * 4, ADD(LOAD(state + 4 * 4), e));
+    STORE(state + 5 * 4, ADD(LOAD(state + 5 * 4), f));
+    STORE(state + 6 * 4, ADD(LOAD(state + 6 * 4), g));
+    STORE(state + 7 * 4, ADD(LOAD(state + 7 * 4), h));
+}
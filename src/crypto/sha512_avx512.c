@@ -0,0 +1,129 @@
+/*
+
+ The MIT License (MIT)
+
+ Copyright (c) 2022 The Dogecoin Foundation
+
+ Permission is hereby granted, free of charge, to any person obtaining
+ a copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES
+ OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <immintrin.h>
+
+// eight lane sha512 compression for sha512_raw_batch, one message per 64 bit lane,
+// built with -mavx512f and only called after cpuid reported support
+
+static const uint64_t K512[80] = {
+    0x428a2f98d728ae22ULL, 0x7137449123ef65cdULL, 0xb5c0fbcfec4d3b2fULL, 0xe9b5dba58189dbbcULL,
+    0x3956c25bf348b538ULL, 0x59f111f1b605d019ULL, 0x923f82a4af194f9bULL, 0xab1c5ed5da6d8118ULL,
+    0xd807aa98a3030242ULL, 0x12835b0145706fbeULL, 0x243185be4ee4b28cULL, 0x550c7dc3d5ffb4e2ULL,
+    0x72be5d74f27b896fULL, 0x80deb1fe3b1696b1ULL, 0x9bdc06a725c71235ULL, 0xc19bf174cf692694ULL,
+    0xe49b69c19ef14ad2ULL, 0xefbe4786384f25e3ULL, 0x0fc19dc68b8cd5b5ULL, 0x240ca1cc77ac9c65ULL,
+    0x2de92c6f592b0275ULL, 0x4a7484aa6ea6e483ULL, 0x5cb0a9dcbd41fbd4ULL, 0x76f988da831153b5ULL,
+    0x983e5152ee66dfabULL, 0xa831c66d2db43210ULL, 0xb00327c898fb213fULL, 0xbf597fc7beef0ee4ULL,
+    0xc6e00bf33da88fc2ULL, 0xd5a79147930aa725ULL, 0x06ca6351e003826fULL, 0x142929670a0e6e70ULL,
+    0x27b70a8546d22ffcULL, 0x2e1b21385c26c926ULL, 0x4d2c6dfc5ac42aedULL, 0x53380d139d95b3dfULL,
+    0x650a73548baf63deULL, 0x766a0abb3c77b2a8ULL, 0x81c2c92e47edaee6ULL, 0x92722c851482353bULL,
+    0xa2bfe8a14cf10364ULL, 0xa81a664bbc423001ULL, 0xc24b8b70d0f89791ULL, 0xc76c51a30654be30ULL,
+    0xd192e819d6ef5218ULL, 0xd69906245565a910ULL, 0xf40e35855771202aULL, 0x106aa07032bbd1b8ULL,
+    0x19a4c116b8d2d0c8ULL, 0x1e376c085141ab53ULL, 0x2748774cdf8eeb99ULL, 0x34b0bcb5e19b48a8ULL,
+    0x391c0cb3c5c95a63ULL, 0x4ed8aa4ae3418acbULL, 0x5b9cca4f7763e373ULL, 0x682e6ff3d6b2b8a3ULL,
+    0x748f82ee5defb2fcULL, 0x78a5636f43172f60ULL, 0x84c87814a1f0ab72ULL, 0x8cc702081a6439ecULL,
+    0x90befffa23631e28ULL, 0xa4506cebde82bde9ULL, 0xbef9a3f7b2c67915ULL, 0xc67178f2e372532bULL,
+    0xca273eceea26619cULL, 0xd186b8c721c0c207ULL, 0xeada7dd6cde0eb1eULL, 0xf57d4f7fee6ed178ULL,
+    0x06f067aa72176fbaULL, 0x0a637dc5a2c898a6ULL, 0x113f9804bef90daeULL, 0x1b710b35131c471bULL,
+    0x28db77f523047d84ULL, 0x32caab7b40c72493ULL, 0x3c9ebe0a15c9bebcULL, 0x431d67c49c100d4cULL,
+    0x4cc5d4becb3e42b6ULL, 0x597f299cfc657e2aULL, 0x5fcb6fab3ad6faecULL, 0x6c44198c4a475817ULL};
+
+#define VEC __m512i
+#define ADD(a, b) _mm512_add_epi64(a, b)
+#define SET1(k) _mm512_set1_epi64((long long)(k))
+#define LOAD(p) _mm512_loadu_si512((const void*)(p))
+#define STORE(p, v) _mm512_storeu_si512((void*)(p), v)
+#define XOR3(a, b, c) _mm512_ternarylogic_epi64(a, b, c, 0x96)
+#define CH(e, f, g) _mm512_ternarylogic_epi64(e, f, g, 0xca)
+#define MAJ(a, b, c) _mm512_ternarylogic_epi64(a, b, c, 0xe8)
+#define SUM0(x) XOR3(_mm512_ror_epi64(x, 28), _mm512_ror_epi64(x, 34), _mm512_ror_epi64(x, 39))
+#define SUM1(x) XOR3(_mm512_ror_epi64(x, 14), _mm512_ror_epi64(x, 18), _mm512_ror_epi64(x, 41))
+#define SIG0(x) XOR3(_mm512_ror_epi64(x, 1), _mm512_ror_epi64(x, 8), _mm512_srli_epi64(x, 7))
+#define SIG1(x) XOR3(_mm512_ror_epi64(x, 19), _mm512_ror_epi64(x, 61), _mm512_srli_epi64(x, 6))
+#define READ(blocks, o) _mm512_set_epi64((long long)sha512_avx512_read_be64(blocks[7] + (o)), (long long)sha512_avx512_read_be64(blocks[6] + (o)), \
+                                         (long long)sha512_avx512_read_be64(blocks[5] + (o)), (long long)sha512_avx512_read_be64(blocks[4] + (o)), \
+                                         (long long)sha512_avx512_read_be64(blocks[3] + (o)), (long long)sha512_avx512_read_be64(blocks[2] + (o)), \
+                                         (long long)sha512_avx512_read_be64(blocks[1] + (o)), (long long)sha512_avx512_read_be64(blocks[0] + (o)))
+
+// one round on every lane, the caller rotates the working variables
+#define ROUND(a, b, c, d, e, f, g, h, k, w)                                            \
+    do {                                                                               \
+        const VEC t1 = ADD(ADD(h, SUM1(e)), ADD(ADD(CH(e, f, g), SET1(k)), w));        \
+        const VEC t2 = ADD(SUM0(a), MAJ(a, b, c));                                      \
+        d = ADD(d, t1);                                                                \
+        h = ADD(t1, t2);                                                               \
+    } while (0)
+
+#define SCHEDULE(i) (w[(i) & 15] = ADD(ADD(w[(i) & 15], SIG1(w[((i) + 14) & 15])), ADD(w[((i) + 9) & 15], SIG0(w[((i) + 1) & 15]))))
+
+static inline uint64_t sha512_avx512_read_be64(const uint8_t* p) {
+    return ((uint64_t)p[0] << 56) | ((uint64_t)p[1] << 48) | ((uint64_t)p[2] << 40) | ((uint64_t)p[3] << 32) |
+           ((uint64_t)p[4] << 24) | ((uint64_t)p[5] << 16) | ((uint64_t)p[6] << 8) | (uint64_t)p[7];
+}
+
+// 8 independent sha512 compressions, state is word major (state[i * 8 + lane])
+void sha512_transform_8way(uint64_t* state, const uint8_t* const* blocks) {
+    VEC a = LOAD(state + 0 * 8), b = LOAD(state + 1 * 8), c = LOAD(state + 2 * 8), d = LOAD(state + 3 * 8);
+    VEC e = LOAD(state + 4 * 8), f = LOAD(state + 5 * 8), g = LOAD(state + 6 * 8), h = LOAD(state + 7 * 8);
+    VEC w[16];
+    int i;
+
+    for (i = 0; i < 16; i++) {
+        w[i] = READ(blocks, 8 * i);
+    }
+    for (i = 0; i < 16; i += 8) {
+        ROUND(a, b, c, d, e, f, g, h, K512[i + 0], w[i + 0]);
+        ROUND(h, a, b, c, d, e, f, g, K512[i + 1], w[i + 1]);
+        ROUND(g, h, a, b, c, d, e, f, K512[i + 2], w[i + 2]);
+        ROUND(f, g, h, a, b, c, d, e, K512[i + 3], w[i + 3]);
+        ROUND(e, f, g, h, a, b, c, d, K512[i + 4], w[i + 4]);
+        ROUND(d, e, f, g, h, a, b, c, K512[i + 5], w[i + 5]);
+        ROUND(c, d, e, f, g, h, a, b, K512[i + 6], w[i + 6]);
+        ROUND(b, c, d, e, f, g, h, a, K512[i + 7], w[i + 7]);
+    }
+    for (; i < 80; i += 8) {
+        ROUND(a, b, c, d, e, f, g, h, K512[i + 0], SCHEDULE(i + 0));
+        ROUND(h, a, b, c, d, e, f, g, K512[i + 1], SCHEDULE(i + 1));
+        ROUND(g, h, a, b, c, d, e, f, K512[i + 2], SCHEDULE(i + 2));
+        ROUND(f, g, h, a, b, c, d, e, K512[i + 3], SCHEDULE(i + 3));
+        ROUND(e, f, g, h, a, b, c, d, K512[i + 4], SCHEDULE(i + 4));
+        ROUND(d, e, f, g, h, a, b, c, K512[i + 5], SCHEDULE(i + 5));
+        ROUND(c, d, e, f, g, h, a, b, K512[i + 6], SCHEDULE(i + 6));
+        ROUND(b, c, d, e, f, g, h, a, K512[i + 7], SCHEDULE(i + 7));
+    }
+
+    STORE(state + 0 * 8, ADD(LOAD(state + 0 * 8), a));
+    STORE(state + 1 * 8, ADD(LOAD(state + 1 * 8), b));
+    STORE(state + 2 * 8, ADD(LOAD(state + 2 * 8), c));
+    STORE(state + 3 * 8, ADD(LOAD(state + 3 * 8), d));
+    STORE(state + 4 * 8, ADD(LOAD(state + 4 * 8), e));
+    STORE(state + 5 * 8, ADD(LOAD(state + 5 * 8), f));
+    STORE(state + 6 * 8, ADD(LOAD(state + 6 * 8), g));
+    STORE(state + 7 * 8, ADD(LOAD(state + 7 * 8), h));
+}
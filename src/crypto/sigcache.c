@@ -0,0 +1,247 @@
+/*
+
+ The MIT License (MIT)
+
+ Copyright (c) 2022 The Dogecoin Foundation
+
+ Permission is hereby granted, free of charge, to any person obtaining
+ a copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES
+ OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+#ifdef HAVE_CONFIG_H
+#  include <src/libdogecoin-config.h>
+#endif
+
+#include <string.h>
+
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
+#include <dogecoin/crypto/ecc.h>
+#include <dogecoin/crypto/random.h>
+#include <dogecoin/crypto/sha2.h>
+#include <dogecoin/crypto/sigcache.h>
+#include <dogecoin/mem.h>
+
+#define SIGCACHE_WAYS 8
+
+// a slot holds the salted hash of a triple, all zero when empty; seq is odd while a writer
+// changes the slot so a reader can tell a torn copy from a stable one
+typedef struct sigcache_entry_ {
+    uint32_t seq;
+    uint64_t key[4];
+} sigcache_entry;
+
+struct dogecoin_sigcache_ {
+    sigcache_entry* entries;
+    size_t size;         // power of two
+    unsigned int depth;  // displacements tried before an insert gives up
+    sha256_context salted; // sha256 that already absorbed the salt block
+#ifdef HAVE_PTHREAD
+    pthread_mutex_t lock; // writers only
+#endif
+};
+
+static void sigcache_lock(dogecoin_sigcache* cache) {
+#ifdef HAVE_PTHREAD
+    pthread_mutex_lock(&cache->lock);
+#else
+    (void)cache;
+#endif
+}
+
+static void sigcache_unlock(dogecoin_sigcache* cache) {
+#ifdef HAVE_PTHREAD
+    pthread_mutex_unlock(&cache->lock);
+#else
+    (void)cache;
+#endif
+}
+
+dogecoin_sigcache* dogecoin_sigcache_new(size_t max_bytes) {
+    dogecoin_sigcache* cache = dogecoin_calloc(1, sizeof(*cache));
+    uint8_t salt[SHA256_BLOCK_LENGTH];
+    size_t size = 1;
+
+    while (size * 2 * sizeof(sigcache_entry) <= max_bytes) size *= 2;
+    cache->entries = dogecoin_calloc(size, sizeof(sigcache_entry));
+    cache->size = size;
+    // log2 of the size, like the cuckoo cache in bitcoin core
+    cache->depth = 1;
+    while (((size_t)1 << cache->depth) < size) cache->depth++;
+    // 32 random bytes and 32 zero bytes fill the first block, its midstate is reused for every key
+    memset(salt, 0, sizeof(salt));
+    dogecoin_random_bytes(salt, 32, 0);
+    sha256_init(&cache->salted);
+    sha256_write(&cache->salted, salt, sizeof(salt));
+    memset(salt, 0, sizeof(salt));
+#ifdef HAVE_PTHREAD
+    pthread_mutex_init(&cache->lock, NULL);
+#endif
+    return cache;
+}
+
+void dogecoin_sigcache_free(dogecoin_sigcache* cache) {
+    if (!cache)
+        return;
+#ifdef HAVE_PTHREAD
+    pthread_mutex_destroy(&cache->lock);
+#endif
+    dogecoin_free(cache->entries);
+    memset(cache, 0, sizeof(*cache));
+    dogecoin_free(cache);
+}
+
+size_t dogecoin_sigcache_size(const dogecoin_sigcache* cache) {
+    return cache->size;
+}
+
+static void sigcache_key(const dogecoin_sigcache* cache, const uint256 sighash, const uint8_t* pubkey, size_t pubkeylen, const unsigned char* sig, size_t siglen, uint64_t key[4]) {
+    sha256_context ctx = cache->salted;
+    uint8_t digest[SHA256_DIGEST_LENGTH];
+    sha256_write(&ctx, sighash, sizeof(uint256));
+    sha256_write(&ctx, pubkey, pubkeylen);
+    sha256_write(&ctx, sig, siglen);
+    sha256_finalize(digest, &ctx);
+    memcpy(key, digest, sizeof(digest));
+    // all zero marks an empty slot
+    if (!(key[0] | key[1] | key[2] | key[3]))
+        key[0] = 1;
+}
+
+// the eight 32 bit words of the key pick the eight slots
+static void sigcache_slots(const dogecoin_sigcache* cache, const uint64_t key[4], size_t slots[SIGCACHE_WAYS]) {
+    int i;
+    for (i = 0; i < 4; i++) {
+        slots[2 * i] = (size_t)(uint32_t)key[i] & (cache->size - 1);
+        slots[2 * i + 1] = (size_t)(key[i] >> 32) & (cache->size - 1);
+    }
+}
+
+// lock free read, retried until the copy was not torn by a writer
+static dogecoin_bool sigcache_slot_matches(const sigcache_entry* e, const uint64_t key[4]) {
+    uint64_t copy[4];
+    uint32_t before, after;
+    do {
+        before = __atomic_load_n(&e->seq, __ATOMIC_ACQUIRE);
+        copy[0] = __atomic_load_n(&e->key[0], __ATOMIC_RELAXED);
+        copy[1] = __atomic_load_n(&e->key[1], __ATOMIC_RELAXED);
+        copy[2] = __atomic_load_n(&e->key[2], __ATOMIC_RELAXED);
+        copy[3] = __atomic_load_n(&e->key[3], __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        after = __atomic_load_n(&e->seq, __ATOMIC_RELAXED);
+    } while ((before & 1) || before != after);
+    return copy[0] == key[0] && copy[1] == key[1] && copy[2] == key[2] && copy[3] == key[3];
+}
+
+// caller holds the writer lock
+static void sigcache_slot_write(sigcache_entry* e, const uint64_t key[4]) {
+    const uint32_t seq = e->seq;
+    __atomic_store_n(&e->seq, seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store_n(&e->key[0], key[0], __ATOMIC_RELAXED);
+    __atomic_store_n(&e->key[1], key[1], __ATOMIC_RELAXED);
+    __atomic_store_n(&e->key[2], key[2], __ATOMIC_RELAXED);
+    __atomic_store_n(&e->key[3], key[3], __ATOMIC_RELAXED);
+    __atomic_store_n(&e->seq, seq + 2, __ATOMIC_RELEASE);
+}
+
+static dogecoin_bool sigcache_slot_empty(const sigcache_entry* e) {
+    return !(e->key[0] | e->key[1] | e->key[2] | e->key[3]);
+}
+
+dogecoin_bool dogecoin_sigcache_contains(dogecoin_sigcache* cache, const uint256 sighash, const uint8_t* pubkey, size_t pubkeylen, const unsigned char* sig, size_t siglen, dogecoin_bool erase) {
+    static const uint64_t empty[4] = {0, 0, 0, 0};
+    uint64_t key[4];
+    size_t slots[SIGCACHE_WAYS];
+    int i;
+
+    sigcache_key(cache, sighash, pubkey, pubkeylen, sig, siglen, key);
+    sigcache_slots(cache, key, slots);
+    for (i = 0; i < SIGCACHE_WAYS; i++) {
+        if (!sigcache_slot_matches(&cache->entries[slots[i]], key))
+            continue;
+        if (erase) {
+            sigcache_lock(cache);
+            // it may have been moved or erased since the unlocked read, erase whatever still matches
+            for (i = 0; i < SIGCACHE_WAYS; i++) {
+                if (sigcache_slot_matches(&cache->entries[slots[i]], key))
+                    sigcache_slot_write(&cache->entries[slots[i]], empty);
+            }
+            sigcache_unlock(cache);
+        }
+        return true;
+    }
+    return false;
+}
+
+void dogecoin_sigcache_insert(dogecoin_sigcache* cache, const uint256 sighash, const uint8_t* pubkey, size_t pubkeylen, const unsigned char* sig, size_t siglen) {
+    uint64_t key[4], evicted[4];
+    size_t slots[SIGCACHE_WAYS];
+    size_t last;
+    unsigned int d;
+    int i, next;
+
+    sigcache_key(cache, sighash, pubkey, pubkeylen, sig, siglen, key);
+    sigcache_slots(cache, key, slots);
+    sigcache_lock(cache);
+    for (i = 0; i < SIGCACHE_WAYS; i++) {
+        if (sigcache_slot_matches(&cache->entries[slots[i]], key)) {
+            sigcache_unlock(cache);
+            return;
+        }
+    }
+    // cuckoo insert: take a free slot, else displace an entry into the next of its own slots
+    last = cache->size;
+    for (d = 0; d <= cache->depth; d++) {
+        for (i = 0; i < SIGCACHE_WAYS; i++) {
+            if (sigcache_slot_empty(&cache->entries[slots[i]])) {
+                sigcache_slot_write(&cache->entries[slots[i]], key);
+                sigcache_unlock(cache);
+                return;
+            }
+        }
+        next = (int)(key[3] >> 61);
+        for (i = 0; i < SIGCACHE_WAYS; i++) {
+            if (slots[i] == last) {
+                next = (i + 1) % SIGCACHE_WAYS;
+                break;
+            }
+        }
+        last = slots[next];
+        memcpy(evicted, cache->entries[last].key, sizeof(evicted));
+        sigcache_slot_write(&cache->entries[last], key);
+        memcpy(key, evicted, sizeof(key));
+        sigcache_slots(cache, key, slots);
+    }
+    // the entry displaced last has no room left and is dropped
+    sigcache_unlock(cache);
+}
+
+dogecoin_bool dogecoin_sigcache_verify_sig(dogecoin_sigcache* cache, const uint8_t* public_key, dogecoin_bool compressed, const uint256 hash, unsigned char* sigder, size_t siglen, dogecoin_bool store) {
+    const size_t pubkeylen = compressed ? DOGECOIN_ECKEY_COMPRESSED_LENGTH : DOGECOIN_ECKEY_UNCOMPRESSED_LENGTH;
+    if (dogecoin_sigcache_contains(cache, hash, public_key, pubkeylen, sigder, siglen, !store))
+        return true;
+    if (!dogecoin_ecc_verify_sig(public_key, compressed, hash, sigder, siglen))
+        return false;
+    if (store)
+        dogecoin_sigcache_insert(cache, hash, public_key, pubkeylen, sigder, siglen);
+    return true;
+}
@@ -63,6 +63,25 @@ void dogecoin_free(void* ptr) {
     current_mem_mapper.dogecoin_free(ptr);
 }
 
+void dogecoin_arena_init(dogecoin_arena* arena, void* buf, size_t size) {
+    arena->base = buf;
+    arena->size = size;
+    arena->used = 0;
+}
+
+void* dogecoin_arena_alloc(dogecoin_arena* arena, size_t size) {
+    const size_t align = sizeof(void*) * 2;
+    uintptr_t start = ((uintptr_t)(arena->base + arena->used) + (align - 1)) & ~(uintptr_t)(align - 1);
+    size_t offset = start - (uintptr_t)arena->base;
+    if (offset > arena->size || size > arena->size - offset) return NULL;
+    arena->used = offset + size;
+    return arena->base + offset;
+}
+
+void dogecoin_arena_reset(dogecoin_arena* arena) {
+    arena->used = 0;
+}
+
 void* dogecoin_malloc_internal(size_t size) {
     void* result;
     if ((result = malloc(size))) return (result); /* assignment intentional */
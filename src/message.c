@@ -0,0 +1,342 @@
+/*
+
+ The MIT License (MIT)
+
+ Copyright (c) 2022 The Dogecoin Foundation
+
+ Permission is hereby granted, free of charge, to any person obtaining
+ a copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES
+ OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+#ifdef HAVE_CONFIG_H
+#  include <src/libdogecoin-config.h>
+#endif
+
+#include <string.h>
+
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
+#include <dogecoin/cstr.h>
+#include <dogecoin/crypto/ecc.h>
+#include <dogecoin/crypto/hash.h>
+#include <dogecoin/crypto/random.h>
+#include <dogecoin/mem.h>
+#include <dogecoin/message.h>
+#include <dogecoin/serialize.h>
+#include <dogecoin/utils.h>
+
+// same layout as the parsed pubkey cache in ecc.c, set i uses lock i % MESSAGE_CACHE_LOCKS
+#define MESSAGE_CACHE_WAYS 4
+#define MESSAGE_CACHE_LOCKS 16
+
+typedef struct message_cache_entry_ {
+    uint256 hash;
+    uint8_t sig[DOGECOIN_MESSAGE_SIG_LENGTH];
+    uint8_t pubkey[DOGECOIN_ECKEY_UNCOMPRESSED_LENGTH];
+    uint8_t len;
+    uint32_t stamp;  // last use, 0 = empty
+} message_cache_entry;
+
+struct dogecoin_message_cache_ {
+    message_cache_entry* entries;
+    size_t sets;  // power of two
+    uint64_t salt;
+    uint32_t clock[MESSAGE_CACHE_LOCKS];
+    uint64_t hits[MESSAGE_CACHE_LOCKS];
+    uint64_t misses[MESSAGE_CACHE_LOCKS];
+#ifdef HAVE_PTHREAD
+    pthread_mutex_t locks[MESSAGE_CACHE_LOCKS];
+#endif
+};
+
+static void message_cache_lock(dogecoin_message_cache* cache, size_t stripe) {
+#ifdef HAVE_PTHREAD
+    pthread_mutex_lock(&cache->locks[stripe]);
+#else
+    (void)cache;
+    (void)stripe;
+#endif
+}
+
+static void message_cache_unlock(dogecoin_message_cache* cache, size_t stripe) {
+#ifdef HAVE_PTHREAD
+    pthread_mutex_unlock(&cache->locks[stripe]);
+#else
+    (void)cache;
+    (void)stripe;
+#endif
+}
+
+dogecoin_message_cache* dogecoin_message_cache_new(size_t max_entries) {
+    dogecoin_message_cache* cache = dogecoin_calloc(1, sizeof(*cache));
+    size_t i;
+    cache->sets = 1;
+    while (cache->sets * 2 * MESSAGE_CACHE_WAYS <= max_entries) cache->sets *= 2;
+    cache->entries = dogecoin_calloc(cache->sets * MESSAGE_CACHE_WAYS, sizeof(message_cache_entry));
+    dogecoin_random_bytes((uint8_t*)&cache->salt, sizeof(cache->salt), 0);
+#ifdef HAVE_PTHREAD
+    for (i = 0; i < MESSAGE_CACHE_LOCKS; i++) pthread_mutex_init(&cache->locks[i], NULL);
+#else
+    (void)i;
+#endif
+    return cache;
+}
+
+void dogecoin_message_cache_free(dogecoin_message_cache* cache) {
+#ifdef HAVE_PTHREAD
+    size_t i;
+#endif
+    if (!cache)
+        return;
+#ifdef HAVE_PTHREAD
+    for (i = 0; i < MESSAGE_CACHE_LOCKS; i++) pthread_mutex_destroy(&cache->locks[i]);
+#endif
+    dogecoin_free(cache->entries);
+    memset(cache, 0, sizeof(*cache));
+    dogecoin_free(cache);
+}
+
+void dogecoin_message_cache_stats(dogecoin_message_cache* cache, uint64_t* hits, uint64_t* misses) {
+    uint64_t h = 0, m = 0;
+    size_t i;
+    for (i = 0; i < MESSAGE_CACHE_LOCKS; i++) {
+        message_cache_lock(cache, i);
+        h += cache->hits[i];
+        m += cache->misses[i];
+        message_cache_unlock(cache, i);
+    }
+    if (hits) *hits = h;
+    if (misses) *misses = m;
+}
+
+// r of the signature and the message hash both vary, mixed with the per cache salt
+static size_t message_cache_set(const dogecoin_message_cache* cache, const uint256 hash, const uint8_t* sig) {
+    uint64_t a, b, h;
+    memcpy(&a, hash, sizeof(a));
+    memcpy(&b, sig + 1, sizeof(b));
+    h = (a ^ cache->salt) + b;
+    h *= 0x9e3779b97f4a7c15ULL;
+    h ^= h >> 29;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 32;
+    return (size_t)h & (cache->sets - 1);
+}
+
+static message_cache_entry* message_cache_find(message_cache_entry* set, const uint256 hash, const uint8_t* sig) {
+    size_t i;
+    for (i = 0; i < MESSAGE_CACHE_WAYS; i++) {
+        if (set[i].stamp && memcmp(set[i].sig, sig, DOGECOIN_MESSAGE_SIG_LENGTH) == 0 && memcmp(set[i].hash, hash, sizeof(uint256)) == 0)
+            return &set[i];
+    }
+    return NULL;
+}
+
+void dogecoin_message_hash(const char* message, size_t len, uint256 hash) {
+    cstring* s = cstr_new_sz(sizeof(DOGECOIN_MESSAGE_MAGIC) + len + 10);
+    ser_varlen(s, (uint32_t)(sizeof(DOGECOIN_MESSAGE_MAGIC) - 1));
+    cstr_append_buf(s, DOGECOIN_MESSAGE_MAGIC, sizeof(DOGECOIN_MESSAGE_MAGIC) - 1);
+    ser_varlen(s, (uint32_t)len);
+    cstr_append_buf(s, message, len);
+    dogecoin_hash((const unsigned char*)s->str, s->len, hash);
+    cstr_free(s, true);
+}
+
+dogecoin_bool dogecoin_message_sign(const dogecoin_key* key, dogecoin_bool compressed, const char* message, char* sig_base64) {
+    uint8_t sig[DOGECOIN_MESSAGE_SIG_LENGTH];
+    uint256 hash;
+    size_t outlen = DOGECOIN_MESSAGE_SIG_LENGTH - 1;
+    int recid;
+
+    if (!key || !message || !sig_base64)
+        return false;
+    dogecoin_message_hash(message, strlen(message), hash);
+    if (!dogecoin_ecc_sign_compact_recoverable(key->privkey, hash, sig + 1, &outlen, &recid))
+        return false;
+    sig[0] = (uint8_t)(27 + recid + (compressed ? 4 : 0));
+    utils_base64_encode(sig, sizeof(sig), sig_base64);
+    return true;
+}
+
+// recover the key in the form the header byte asks for
+static dogecoin_bool message_recover(dogecoin_message_cache* cache, const dogecoin_ecc_ctx* ctx, const char* sig_base64, const char* message, dogecoin_pubkey* pubkey) {
+    uint8_t sig[DOGECOIN_MESSAGE_SIG_LENGTH + 2];
+    message_cache_entry* set = NULL;
+    message_cache_entry* e;
+    size_t siglen = sizeof(sig), len, stripe = 0, i;
+    uint256 hash;
+
+    if (!sig_base64 || !message || !utils_base64_decode(sig_base64, strlen(sig_base64), sig, &siglen))
+        return false;
+    if (siglen != DOGECOIN_MESSAGE_SIG_LENGTH || sig[0] < 27 || sig[0] > 34)
+        return false;
+    dogecoin_message_hash(message, strlen(message), hash);
+    dogecoin_pubkey_init(pubkey);
+    pubkey->compressed = sig[0] >= 31;
+
+    if (cache) {
+        const size_t index = message_cache_set(cache, hash, sig);
+        stripe = index & (MESSAGE_CACHE_LOCKS - 1);
+        set = cache->entries + index * MESSAGE_CACHE_WAYS;
+        message_cache_lock(cache, stripe);
+        e = message_cache_find(set, hash, sig);
+        if (e) {
+            memcpy(pubkey->pubkey, e->pubkey, e->len);
+            e->stamp = ++cache->clock[stripe];
+            cache->hits[stripe]++;
+            message_cache_unlock(cache, stripe);
+            return true;
+        }
+        cache->misses[stripe]++;
+        message_cache_unlock(cache, stripe);
+    }
+
+    // the recovery runs outside of the lock, failures are not cached
+    len = sizeof(pubkey->pubkey);
+    if (!dogecoin_ecc_recover_pubkey_ctx(ctx, sig + 1, hash, (sig[0] - 27) & 3, pubkey->pubkey, &len, pubkey->compressed))
+        return false;
+
+    if (cache) {
+        message_cache_lock(cache, stripe);
+        if (!message_cache_find(set, hash, sig)) {
+            e = set;
+            for (i = 1; i < MESSAGE_CACHE_WAYS; i++) {
+                if (set[i].stamp < e->stamp)
+                    e = &set[i];
+            }
+            memcpy(e->hash, hash, sizeof(uint256));
+            memcpy(e->sig, sig, DOGECOIN_MESSAGE_SIG_LENGTH);
+            memcpy(e->pubkey, pubkey->pubkey, len);
+            e->len = (uint8_t)len;
+            e->stamp = ++cache->clock[stripe];
+        }
+        message_cache_unlock(cache, stripe);
+    }
+    return true;
+}
+
+static dogecoin_bool message_verify(dogecoin_message_cache* cache, const dogecoin_ecc_ctx* ctx, const char* address, const char* sig_base64, const char* message, const dogecoin_chainparams* chain) {
+    dogecoin_pubkey pubkey;
+    char recovered[100];
+    if (!address || !chain || !message_recover(cache, ctx, sig_base64, message, &pubkey))
+        return false;
+    dogecoin_pubkey_getaddr_p2pkh(&pubkey, chain, recovered);
+    return strcmp(recovered, address) == 0;
+}
+
+dogecoin_bool dogecoin_message_recover_pubkey(dogecoin_message_cache* cache, const char* sig_base64, const char* message, dogecoin_pubkey* pubkey) {
+    return pubkey && message_recover(cache, dogecoin_ecc_thread_ctx(), sig_base64, message, pubkey);
+}
+
+dogecoin_bool dogecoin_message_verify(dogecoin_message_cache* cache, const char* address, const char* sig_base64, const char* message, const dogecoin_chainparams* chain) {
+    return message_verify(cache, dogecoin_ecc_thread_ctx(), address, sig_base64, message, chain);
+}
+
+typedef struct message_verify_batch_ {
+    dogecoin_message_cache* cache;
+    dogecoin_message_check* checks;
+    size_t num_checks;
+    size_t next_check;
+    const dogecoin_chainparams* chain;
+#ifdef HAVE_PTHREAD
+    pthread_mutex_t lock;
+#endif
+} message_verify_batch;
+
+// checks are handed out in small runs so the lock is not taken once per signature
+#define MESSAGE_VERIFY_BATCH_RUN 16
+
+// a thread working on the batch and the context it recovers pubkeys with
+typedef struct message_verify_worker_ {
+    message_verify_batch* batch;
+    const dogecoin_ecc_ctx* ctx;
+} message_verify_worker;
+
+static void message_verify_batch_run(message_verify_batch* batch, const dogecoin_ecc_ctx* ctx, size_t begin, size_t end) {
+    size_t i;
+    for (i = begin; i < end && i < batch->num_checks; i++) {
+        dogecoin_message_check* check = &batch->checks[i];
+        check->valid = message_verify(batch->cache, ctx, check->address, check->signature, check->message, batch->chain);
+    }
+}
+
+#ifdef HAVE_PTHREAD
+static void* message_verify_batch_worker(void* arg) {
+    message_verify_worker* worker = arg;
+    message_verify_batch* batch = worker->batch;
+    for (;;) {
+        pthread_mutex_lock(&batch->lock);
+        size_t i = batch->next_check;
+        batch->next_check += MESSAGE_VERIFY_BATCH_RUN;
+        pthread_mutex_unlock(&batch->lock);
+        if (i >= batch->num_checks)
+            break;
+        message_verify_batch_run(batch, worker->ctx, i, i + MESSAGE_VERIFY_BATCH_RUN);
+    }
+    return NULL;
+}
+#endif
+
+size_t dogecoin_message_verify_batch(dogecoin_message_cache* cache, dogecoin_message_check* checks, size_t num_checks, const dogecoin_chainparams* chain, unsigned int num_threads) {
+    message_verify_batch batch;
+    size_t i, valid = 0;
+    batch.cache = cache;
+    batch.checks = checks;
+    batch.num_checks = num_checks;
+    batch.next_check = 0;
+    batch.chain = chain;
+
+    if (num_threads > (num_checks + MESSAGE_VERIFY_BATCH_RUN - 1) / MESSAGE_VERIFY_BATCH_RUN) {
+        num_threads = (unsigned int)((num_checks + MESSAGE_VERIFY_BATCH_RUN - 1) / MESSAGE_VERIFY_BATCH_RUN);
+    }
+#ifdef HAVE_PTHREAD
+    if (num_threads > 1) {
+        pthread_t* threads = dogecoin_calloc(num_threads, sizeof(pthread_t));
+        message_verify_worker* workers = dogecoin_calloc(num_threads, sizeof(message_verify_worker));
+        unsigned int started = 0;
+        pthread_mutex_init(&batch.lock, NULL);
+        // the calling thread works as well (on its own context), so spawn one thread less
+        workers[0].batch = &batch;
+        workers[0].ctx = dogecoin_ecc_thread_ctx();
+        for (started = 1; started < num_threads; started++) {
+            workers[started].batch = &batch;
+            workers[started].ctx = dogecoin_ecc_worker_ctx(started - 1);
+            if (pthread_create(&threads[started], NULL, message_verify_batch_worker, &workers[started]) != 0)
+                break;
+        }
+        message_verify_batch_worker(&workers[0]);
+        while (started > 1) {
+            pthread_join(threads[--started], NULL);
+        }
+        pthread_mutex_destroy(&batch.lock);
+        dogecoin_free(workers);
+        dogecoin_free(threads);
+    }
+#endif
+    // single threaded (or pthreads not available), run whatever is left
+    if (batch.next_check < num_checks)
+        message_verify_batch_run(&batch, dogecoin_ecc_thread_ctx(), batch.next_check, num_checks);
+
+    for (i = 0; i < num_checks; i++) {
+        if (checks[i].valid)
+            valid++;
+    }
+    return valid;
+}
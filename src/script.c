@@ -78,10 +78,10 @@ dogecoin_bool dogecoin_script_copy_without_op_codeseperator(const cstring* scrip
 
         if (data_len > 0) {
             assert(data_len < 16777215); //limit max push to 0xFFFFFF
-            unsigned char *bufpush = (unsigned char *)dogecoin_malloc(data_len);
-            deser_bytes(bufpush, &buf, data_len);
-            cstr_append_buf(script_out, bufpush, data_len);
-            dogecoin_free(bufpush);
+            if (data_len > buf.len)
+                goto err_out;
+            cstr_append_buf(script_out, buf.p, data_len);
+            deser_skip(&buf, data_len);
         } else
             cstr_append_buf(script_out, &opcode, 1);
     }
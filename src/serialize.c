@@ -70,6 +70,15 @@ void ser_varlen(cstring* s, uint32_t vlen)
     /* u64 case intentionally not implemented */
 }
 
+size_t ser_varlen_size(uint32_t vlen)
+{
+    if (vlen < 253)
+        return 1;
+    if (vlen < 0x10000)
+        return 3;
+    return 5;
+}
+
 void ser_str(cstring* s, const char* s_in, size_t maxlen)
 {
     size_t slen = strnlen(s_in, maxlen);
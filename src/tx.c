@@ -27,12 +27,20 @@
 
 */
 
+#ifdef HAVE_CONFIG_H
+#  include <src/libdogecoin-config.h>
+#endif
+
 #include <assert.h>
 #include <inttypes.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <string.h>
 
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
 #include <dogecoin/crypto/base58.h>
 #include <dogecoin/crypto/ecc.h>
 #include <dogecoin/mem.h>
@@ -165,6 +173,7 @@ int dogecoin_tx_deserialize(const unsigned char* tx_serialized, size_t inlen, do
         *consumed_length = 0;
 
     //tx needs to be initialized
+    dogecoin_tx_invalidate_hash(tx);
     deser_s32(&tx->version, &buf);
 
     uint32_t vlen;
@@ -215,7 +224,7 @@ int dogecoin_tx_deserialize(const unsigned char* tx_serialized, size_t inlen, do
             uint32_t vlen;
             if (!deser_varlen(&vlen, &buf)) return false;
             for (size_t j = 0; j < vlen; j++) {
-                cstring* witness_item = cstr_new_sz(1024);
+                cstring* witness_item = NULL;
                 if (!deser_varstr(&witness_item, &buf)) {
                     cstr_free(witness_item, true);
                     return false;
@@ -237,6 +246,305 @@ int dogecoin_tx_deserialize(const unsigned char* tx_serialized, size_t inlen, do
     return true;
 }
 
+static dogecoin_bool dogecoin_tx_view_read_varstr(const uint8_t** p, size_t* len, struct const_buffer* buf) {
+    uint32_t vlen;
+    if (!deser_varlen(&vlen, buf))
+        return false;
+    *p = buf->p;
+    *len = vlen;
+    return deser_skip(buf, vlen);
+}
+
+static dogecoin_bool dogecoin_tx_view_read_in(dogecoin_tx_view_in* in, struct const_buffer* buf) {
+    in->prevout_hash = buf->p;
+    if (!deser_skip(buf, DOGECOIN_HASH_LENGTH))
+        return false;
+    if (!deser_u32(&in->prevout_n, buf))
+        return false;
+    if (!dogecoin_tx_view_read_varstr(&in->script_sig, &in->script_sig_len, buf))
+        return false;
+    if (!deser_u32(&in->sequence, buf))
+        return false;
+    return true;
+}
+
+static dogecoin_bool dogecoin_tx_view_read_out(dogecoin_tx_view_out* out, struct const_buffer* buf) {
+    if (!deser_s64(&out->value, buf))
+        return false;
+    if (!dogecoin_tx_view_read_varstr(&out->script_pubkey, &out->script_pubkey_len, buf))
+        return false;
+    return true;
+}
+
+static dogecoin_bool dogecoin_tx_view_skip_witness_stack(struct const_buffer* buf) {
+    uint32_t vlen;
+    const uint8_t* item;
+    size_t item_len;
+    if (!deser_varlen(&vlen, buf))
+        return false;
+    for (size_t i = 0; i < vlen; i++) {
+        if (!dogecoin_tx_view_read_varstr(&item, &item_len, buf))
+            return false;
+    }
+    return true;
+}
+
+dogecoin_bool dogecoin_tx_view_parse(dogecoin_tx_view* view, const unsigned char* tx_serialized, size_t inlen, size_t* consumed_length, dogecoin_bool allow_witness) {
+    struct const_buffer buf = {tx_serialized, inlen};
+    memset(view, 0, sizeof(*view));
+    view->data = tx_serialized;
+    if (consumed_length)
+        *consumed_length = 0;
+
+    if (!deser_s32(&view->version, &buf))
+        return false;
+
+    uint32_t vlen;
+    if (!deser_varlen(&vlen, &buf))
+        return false;
+
+    // same witness marker handling as dogecoin_tx_deserialize
+    uint8_t flags = 0;
+    if (vlen == 0 && allow_witness) {
+        if (!deser_bytes(&flags, &buf, 1))
+            return false;
+        if (flags != 0) {
+            if (!deser_varlen(&vlen, &buf))
+                return false;
+        }
+    }
+
+    size_t i;
+    dogecoin_tx_view_in in;
+    view->vin_count = vlen;
+    view->vin_offset = inlen - buf.len;
+    for (i = 0; i < vlen; i++) {
+        if (!dogecoin_tx_view_read_in(&in, &buf))
+            return false;
+    }
+
+    dogecoin_tx_view_out out;
+    if (!deser_varlen(&vlen, &buf))
+        return false;
+    view->vout_count = vlen;
+    view->vout_offset = inlen - buf.len;
+    for (i = 0; i < vlen; i++) {
+        if (!dogecoin_tx_view_read_out(&out, &buf))
+            return false;
+    }
+
+    if ((flags & 1) && allow_witness) {
+        flags ^= 1;
+        view->has_witness = true;
+        view->witness_offset = inlen - buf.len;
+        for (i = 0; i < view->vin_count; i++) {
+            if (!dogecoin_tx_view_skip_witness_stack(&buf))
+                return false;
+        }
+    }
+    if (flags) {
+        /* Unknown flag in the serialization */
+        return false;
+    }
+
+    if (!deser_u32(&view->locktime, &buf))
+        return false;
+
+    view->len = inlen - buf.len;
+    if (consumed_length)
+        *consumed_length = view->len;
+    return true;
+}
+
+dogecoin_bool dogecoin_tx_view_get_in(const dogecoin_tx_view* view, size_t n, dogecoin_tx_view_in* in) {
+    if (n >= view->vin_count)
+        return false;
+    struct const_buffer buf = {view->data + view->vin_offset, view->len - view->vin_offset};
+    for (size_t i = 0; i <= n; i++) {
+        if (!dogecoin_tx_view_read_in(in, &buf))
+            return false;
+    }
+    in->index = n;
+    in->next_offset = view->len - buf.len;
+    return true;
+}
+
+dogecoin_bool dogecoin_tx_view_next_in(const dogecoin_tx_view* view, dogecoin_tx_view_in* in) {
+    if (in->index + 1 >= view->vin_count)
+        return false;
+    struct const_buffer buf = {view->data + in->next_offset, view->len - in->next_offset};
+    if (!dogecoin_tx_view_read_in(in, &buf))
+        return false;
+    in->index++;
+    in->next_offset = view->len - buf.len;
+    return true;
+}
+
+dogecoin_bool dogecoin_tx_view_get_out(const dogecoin_tx_view* view, size_t n, dogecoin_tx_view_out* out) {
+    if (n >= view->vout_count)
+        return false;
+    struct const_buffer buf = {view->data + view->vout_offset, view->len - view->vout_offset};
+    for (size_t i = 0; i <= n; i++) {
+        if (!dogecoin_tx_view_read_out(out, &buf))
+            return false;
+    }
+    out->index = n;
+    out->next_offset = view->len - buf.len;
+    return true;
+}
+
+dogecoin_bool dogecoin_tx_view_next_out(const dogecoin_tx_view* view, dogecoin_tx_view_out* out) {
+    if (out->index + 1 >= view->vout_count)
+        return false;
+    struct const_buffer buf = {view->data + out->next_offset, view->len - out->next_offset};
+    if (!dogecoin_tx_view_read_out(out, &buf))
+        return false;
+    out->index++;
+    out->next_offset = view->len - buf.len;
+    return true;
+}
+
+static dogecoin_bool dogecoin_tx_view_seek_witness(const dogecoin_tx_view* view, size_t n, struct const_buffer* buf, uint32_t* count) {
+    if (!view->has_witness || n >= view->vin_count)
+        return false;
+    buf->p = view->data + view->witness_offset;
+    buf->len = view->len - view->witness_offset;
+    for (size_t i = 0; i < n; i++) {
+        if (!dogecoin_tx_view_skip_witness_stack(buf))
+            return false;
+    }
+    return deser_varlen(count, buf);
+}
+
+size_t dogecoin_tx_view_witness_count(const dogecoin_tx_view* view, size_t n) {
+    struct const_buffer buf;
+    uint32_t count;
+    if (!dogecoin_tx_view_seek_witness(view, n, &buf, &count))
+        return 0;
+    return count;
+}
+
+dogecoin_bool dogecoin_tx_view_get_witness_item(const dogecoin_tx_view* view, size_t n, size_t item, const uint8_t** data_out, size_t* len_out) {
+    struct const_buffer buf;
+    uint32_t count;
+    if (!dogecoin_tx_view_seek_witness(view, n, &buf, &count) || item >= count)
+        return false;
+    for (size_t i = 0; i <= item; i++) {
+        if (!dogecoin_tx_view_read_varstr(data_out, len_out, &buf))
+            return false;
+    }
+    return true;
+}
+
+static cstring* dogecoin_tx_arena_cstr(dogecoin_arena* arena, const uint8_t* data, size_t len) {
+    cstring* s = dogecoin_arena_alloc(arena, sizeof(*s));
+    char* str = dogecoin_arena_alloc(arena, len + 1);
+    if (!s || !str)
+        return NULL;
+    memcpy(str, data, len);
+    str[len] = 0;
+    s->str = str;
+    s->len = len;
+    s->alloc = len + 1;
+    return s;
+}
+
+static vector* dogecoin_tx_arena_vector(dogecoin_arena* arena, size_t len) {
+    vector* vec = dogecoin_arena_alloc(arena, sizeof(*vec));
+    void** data = dogecoin_arena_alloc(arena, (len ? len : 1) * sizeof(void*));
+    if (!vec || !data)
+        return NULL;
+    vec->data = data;
+    vec->len = len;
+    vec->alloc = len;
+    vec->elem_free_f = NULL; // elements are owned by the arena
+    return vec;
+}
+
+static dogecoin_tx* dogecoin_tx_arena_fill(const dogecoin_tx_view* view, dogecoin_arena* arena) {
+    size_t i, j;
+    dogecoin_tx* tx = dogecoin_arena_alloc(arena, sizeof(*tx));
+    if (!tx)
+        return NULL;
+    memset(tx, 0, sizeof(*tx));
+    tx->version = view->version;
+    tx->locktime = view->locktime;
+    tx->vin = dogecoin_tx_arena_vector(arena, view->vin_count);
+    tx->vout = dogecoin_tx_arena_vector(arena, view->vout_count);
+    if (!tx->vin || !tx->vout)
+        return NULL;
+
+    dogecoin_tx_view_in in;
+    for (i = 0; i < view->vin_count; i++) {
+        if (!(i == 0 ? dogecoin_tx_view_get_in(view, 0, &in) : dogecoin_tx_view_next_in(view, &in)))
+            return NULL;
+        dogecoin_tx_in* tx_in = dogecoin_arena_alloc(arena, sizeof(*tx_in));
+        if (!tx_in)
+            return NULL;
+        memcpy(tx_in->prevout.hash, in.prevout_hash, DOGECOIN_HASH_LENGTH);
+        tx_in->prevout.n = in.prevout_n;
+        tx_in->sequence = in.sequence;
+        tx_in->script_sig = dogecoin_tx_arena_cstr(arena, in.script_sig, in.script_sig_len);
+        tx_in->witness_stack = view->has_witness ? NULL : dogecoin_tx_arena_vector(arena, 0);
+        if (!tx_in->script_sig || (!view->has_witness && !tx_in->witness_stack))
+            return NULL;
+        vector_idx(tx->vin, i) = tx_in;
+    }
+
+    if (view->has_witness) {
+        // walk the witness section once instead of seeking per input
+        struct const_buffer buf = {view->data + view->witness_offset, view->len - view->witness_offset};
+        for (i = 0; i < view->vin_count; i++) {
+            dogecoin_tx_in* tx_in = vector_idx(tx->vin, i);
+            uint32_t count;
+            if (!deser_varlen(&count, &buf))
+                return NULL;
+            tx_in->witness_stack = dogecoin_tx_arena_vector(arena, count);
+            if (!tx_in->witness_stack)
+                return NULL;
+            for (j = 0; j < count; j++) {
+                const uint8_t* item;
+                size_t item_len;
+                if (!dogecoin_tx_view_read_varstr(&item, &item_len, &buf))
+                    return NULL;
+                vector_idx(tx_in->witness_stack, j) = dogecoin_tx_arena_cstr(arena, item, item_len);
+                if (!vector_idx(tx_in->witness_stack, j))
+                    return NULL;
+            }
+        }
+    }
+
+    dogecoin_tx_view_out out;
+    for (i = 0; i < view->vout_count; i++) {
+        if (!(i == 0 ? dogecoin_tx_view_get_out(view, 0, &out) : dogecoin_tx_view_next_out(view, &out)))
+            return NULL;
+        dogecoin_tx_out* tx_out = dogecoin_arena_alloc(arena, sizeof(*tx_out));
+        if (!tx_out)
+            return NULL;
+        tx_out->value = out.value;
+        tx_out->script_pubkey = dogecoin_tx_arena_cstr(arena, out.script_pubkey, out.script_pubkey_len);
+        if (!tx_out->script_pubkey)
+            return NULL;
+        vector_idx(tx->vout, i) = tx_out;
+    }
+    return tx;
+}
+
+dogecoin_tx* dogecoin_tx_deserialize_arena(const unsigned char* tx_serialized, size_t inlen, dogecoin_arena* arena, size_t* consumed_length, dogecoin_bool allow_witness) {
+    dogecoin_tx_view view;
+    if (!dogecoin_tx_view_parse(&view, tx_serialized, inlen, consumed_length, allow_witness))
+        return NULL;
+
+    size_t mark = arena->used;
+    dogecoin_tx* tx = dogecoin_tx_arena_fill(&view, arena);
+    if (!tx) {
+        arena->used = mark;
+        if (consumed_length)
+            *consumed_length = 0;
+    }
+    return tx;
+}
+
 void dogecoin_tx_in_serialize(cstring* s, const dogecoin_tx_in* tx_in) {
     ser_u256(s, tx_in->prevout.hash);
     ser_u32(s, tx_in->prevout.n);
@@ -260,6 +568,9 @@ dogecoin_bool dogecoin_tx_has_witness(const dogecoin_tx *tx) {
 }
 
 void dogecoin_tx_serialize(cstring* s, const dogecoin_tx* tx, dogecoin_bool allow_witness) {
+    // grow the string once instead of doubling it while appending
+    cstr_alloc_minsize(s, s->len + dogecoin_tx_serialized_size(tx, allow_witness));
+
     ser_s32(s, tx->version);
     uint8_t flags = 0;
     // Consistency check
@@ -311,6 +622,8 @@ void dogecoin_tx_serialize(cstring* s, const dogecoin_tx* tx, dogecoin_bool allo
                         cstring *item = vector_idx(tx_in->witness_stack, j);
                         ser_varstr(s, item);
                     }
+                } else {
+                    ser_varlen(s, 0);
                 }
             }
         }
@@ -319,16 +632,124 @@ void dogecoin_tx_serialize(cstring* s, const dogecoin_tx* tx, dogecoin_bool allo
     ser_u32(s, tx->locktime);
 }
 
-void dogecoin_tx_hash(const dogecoin_tx* tx, uint256 hashout) {
-    cstring* txser = cstr_new_sz(1024);
-    dogecoin_tx_serialize(txser, tx, false);
+static size_t dogecoin_varstr_size(const cstring* s) {
+    size_t len = s ? s->len : 0;
+    return ser_varlen_size(len) + len;
+}
+
+size_t dogecoin_tx_serialized_size(const dogecoin_tx* tx, dogecoin_bool allow_witness) {
+    const dogecoin_bool witness = allow_witness && dogecoin_tx_has_witness(tx);
+    const size_t vin_len = tx->vin ? tx->vin->len : 0;
+    const size_t vout_len = tx->vout ? tx->vout->len : 0;
+    size_t i, j, size = 4 + 4; // version, locktime
+
+    if (witness)
+        size += 2; // marker, flags
+    size += ser_varlen_size(vin_len);
+    for (i = 0; i < vin_len; i++) {
+        const dogecoin_tx_in* tx_in = vector_idx(tx->vin, i);
+        size += DOGECOIN_HASH_LENGTH + 4 + dogecoin_varstr_size(tx_in->script_sig) + 4;
+        if (witness) {
+            const size_t items = tx_in->witness_stack ? tx_in->witness_stack->len : 0;
+            size += ser_varlen_size(items);
+            for (j = 0; j < items; j++) {
+                size += dogecoin_varstr_size(vector_idx(tx_in->witness_stack, j));
+            }
+        }
+    }
+    size += ser_varlen_size(vout_len);
+    for (i = 0; i < vout_len; i++) {
+        const dogecoin_tx_out* tx_out = vector_idx(tx->vout, i);
+        size += 8 + dogecoin_varstr_size(tx_out->script_pubkey);
+    }
+    return size;
+}
+
+static void dogecoin_buf_write(uint8_t** p, const void* data, size_t len) {
+    if (len)
+        memcpy(*p, data, len);
+    *p += len;
+}
+
+static void dogecoin_buf_write_u32(uint8_t** p, uint32_t v_) {
+    uint32_t v = htole32(v_);
+    dogecoin_buf_write(p, &v, sizeof(v));
+}
 
+static void dogecoin_buf_write_u64(uint8_t** p, uint64_t v_) {
+    uint64_t v = htole64(v_);
+    dogecoin_buf_write(p, &v, sizeof(v));
+}
 
-    sha256_raw((const uint8_t*)txser->str, txser->len, hashout);
-    sha256_raw(hashout, DOGECOIN_HASH_LENGTH, hashout);
-    cstr_free(txser, true);
+static void dogecoin_buf_write_varlen(uint8_t** p, uint32_t vlen) {
+    if (vlen < 253) {
+        *(*p)++ = (uint8_t)vlen;
+    } else if (vlen < 0x10000) {
+        uint16_t v16 = htole16((uint16_t)vlen);
+        *(*p)++ = 253;
+        dogecoin_buf_write(p, &v16, sizeof(v16));
+    } else {
+        *(*p)++ = 254;
+        dogecoin_buf_write_u32(p, vlen);
+    }
+}
+
+static void dogecoin_buf_write_varstr(uint8_t** p, const cstring* s) {
+    if (!s || !s->len) {
+        dogecoin_buf_write_varlen(p, 0);
+        return;
+    }
+    dogecoin_buf_write_varlen(p, s->len);
+    dogecoin_buf_write(p, s->str, s->len);
 }
 
+size_t dogecoin_tx_serialize_to(uint8_t* buf, size_t cap, const dogecoin_tx* tx, dogecoin_bool allow_witness) {
+    const size_t size = dogecoin_tx_serialized_size(tx, allow_witness);
+    const dogecoin_bool witness = allow_witness && dogecoin_tx_has_witness(tx);
+    const size_t vin_len = tx->vin ? tx->vin->len : 0;
+    const size_t vout_len = tx->vout ? tx->vout->len : 0;
+    uint8_t* p = buf;
+    size_t i, j;
+
+    if (!buf || size > cap)
+        return 0;
+
+    dogecoin_buf_write_u32(&p, (uint32_t)tx->version);
+    if (witness) {
+        *p++ = 0; // marker
+        *p++ = 1; // flags
+    }
+    dogecoin_buf_write_varlen(&p, vin_len);
+    for (i = 0; i < vin_len; i++) {
+        const dogecoin_tx_in* tx_in = vector_idx(tx->vin, i);
+        dogecoin_buf_write(&p, tx_in->prevout.hash, DOGECOIN_HASH_LENGTH);
+        dogecoin_buf_write_u32(&p, tx_in->prevout.n);
+        dogecoin_buf_write_varstr(&p, tx_in->script_sig);
+        dogecoin_buf_write_u32(&p, tx_in->sequence);
+    }
+    dogecoin_buf_write_varlen(&p, vout_len);
+    for (i = 0; i < vout_len; i++) {
+        const dogecoin_tx_out* tx_out = vector_idx(tx->vout, i);
+        dogecoin_buf_write_u64(&p, (uint64_t)tx_out->value);
+        dogecoin_buf_write_varstr(&p, tx_out->script_pubkey);
+    }
+    if (witness) {
+        for (i = 0; i < vin_len; i++) {
+            const dogecoin_tx_in* tx_in = vector_idx(tx->vin, i);
+            const size_t items = tx_in->witness_stack ? tx_in->witness_stack->len : 0;
+            dogecoin_buf_write_varlen(&p, items);
+            for (j = 0; j < items; j++) {
+                dogecoin_buf_write_varstr(&p, vector_idx(tx_in->witness_stack, j));
+            }
+        }
+    }
+    dogecoin_buf_write_u32(&p, tx->locktime);
+
+    assert((size_t)(p - buf) == size);
+    return size;
+}
+
+
 void dogecoin_tx_in_copy(dogecoin_tx_in* dest, const dogecoin_tx_in* src) {
     memcpy(&dest->prevout, &src->prevout, sizeof(dest->prevout));
     dest->sequence = src->sequence;
@@ -368,6 +789,7 @@ void dogecoin_tx_out_copy(dogecoin_tx_out* dest, const dogecoin_tx_out* src) {
 }
 
 void dogecoin_tx_copy(dogecoin_tx* dest, const dogecoin_tx* src) {
+    dogecoin_tx_invalidate_hash(dest);
     dest->version = src->version;
     dest->locktime = src->locktime;
 
@@ -413,199 +835,402 @@ void dogecoin_tx_copy(dogecoin_tx* dest, const dogecoin_tx* src) {
     }
 }
 
+// serialized size of an input with an empty script_sig (outpoint, varlen 0, sequence)
+#define DOGECOIN_SIGHASH_LEGACY_INPUT_SIZE (DOGECOIN_HASH_LENGTH + 4 + 1 + 4)
+
+static void dogecoin_sighash_write_u32(sha256_context* ctx, uint32_t v_) {
+    uint32_t v = htole32(v_);
+    sha256_write(ctx, (const uint8_t*)&v, sizeof(v));
+}
+
+static void dogecoin_sighash_write_u64(sha256_context* ctx, uint64_t v_) {
+    uint64_t v = htole64(v_);
+    sha256_write(ctx, (const uint8_t*)&v, sizeof(v));
+}
+
+static void dogecoin_sighash_write_varlen(sha256_context* ctx, uint32_t vlen) {
+    uint8_t buf[5];
+    size_t len = 1;
+    if (vlen < 253) {
+        buf[0] = (uint8_t)vlen;
+    } else if (vlen < 0x10000) {
+        uint16_t v16 = htole16((uint16_t)vlen);
+        buf[0] = 253;
+        memcpy(&buf[1], &v16, 2);
+        len = 3;
+    } else {
+        uint32_t v32 = htole32(vlen);
+        buf[0] = 254;
+        memcpy(&buf[1], &v32, 4);
+        len = 5;
+    }
+    sha256_write(ctx, buf, len);
+}
+
+static void dogecoin_sighash_write_varstr(sha256_context* ctx, const cstring* s) {
+    if (!s || !s->len) {
+        dogecoin_sighash_write_varlen(ctx, 0);
+        return;
+    }
+    dogecoin_sighash_write_varlen(ctx, s->len);
+    sha256_write(ctx, (const uint8_t*)s->str, s->len);
+}
+
+static void dogecoin_sighash_finalize(sha256_context* ctx, uint256 hash) {
+    sha256_finalize(hash, ctx);
+    sha256_raw_32(hash, hash);
+}
+
+// streams the p2p serialization into ctx, same layout as dogecoin_tx_serialize
+static void dogecoin_tx_hash_write(sha256_context* ctx, const dogecoin_tx* tx, dogecoin_bool witness) {
+    const size_t vin_len = tx->vin ? tx->vin->len : 0;
+    const size_t vout_len = tx->vout ? tx->vout->len : 0;
+    size_t i, j;
+
+    dogecoin_sighash_write_u32(ctx, (uint32_t)tx->version);
+    if (witness) {
+        static const uint8_t marker_flags[2] = {0, 1};
+        sha256_write(ctx, marker_flags, sizeof(marker_flags));
+    }
+    dogecoin_sighash_write_varlen(ctx, vin_len);
+    for (i = 0; i < vin_len; i++) {
+        const dogecoin_tx_in* tx_in = vector_idx(tx->vin, i);
+        sha256_write(ctx, tx_in->prevout.hash, DOGECOIN_HASH_LENGTH);
+        dogecoin_sighash_write_u32(ctx, tx_in->prevout.n);
+        dogecoin_sighash_write_varstr(ctx, tx_in->script_sig);
+        dogecoin_sighash_write_u32(ctx, tx_in->sequence);
+    }
+    dogecoin_sighash_write_varlen(ctx, vout_len);
+    for (i = 0; i < vout_len; i++) {
+        const dogecoin_tx_out* tx_out = vector_idx(tx->vout, i);
+        dogecoin_sighash_write_u64(ctx, (uint64_t)tx_out->value);
+        dogecoin_sighash_write_varstr(ctx, tx_out->script_pubkey);
+    }
+    if (witness) {
+        for (i = 0; i < vin_len; i++) {
+            const dogecoin_tx_in* tx_in = vector_idx(tx->vin, i);
+            const size_t items = tx_in->witness_stack ? tx_in->witness_stack->len : 0;
+            dogecoin_sighash_write_varlen(ctx, items);
+            for (j = 0; j < items; j++) {
+                dogecoin_sighash_write_varstr(ctx, vector_idx(tx_in->witness_stack, j));
+            }
+        }
+    }
+    dogecoin_sighash_write_u32(ctx, tx->locktime);
+}
+
+void dogecoin_tx_hash(const dogecoin_tx* tx, uint256 hashout) {
+    // the cache is not part of the logical state of the tx
+    dogecoin_tx* cache = (dogecoin_tx*)tx;
+    if (!tx->txid_valid) {
+        sha256_context ctx;
+        sha256_init(&ctx);
+        dogecoin_tx_hash_write(&ctx, tx, false);
+        dogecoin_sighash_finalize(&ctx, cache->txid);
+        cache->txid_valid = true;
+    }
+    memcpy(hashout, tx->txid, DOGECOIN_HASH_LENGTH);
+}
+
+void dogecoin_tx_wtxid(const dogecoin_tx* tx, uint256 hashout) {
+    dogecoin_tx* cache = (dogecoin_tx*)tx;
+    if (!tx->wtxid_valid) {
+        if (dogecoin_tx_has_witness(tx)) {
+            sha256_context ctx;
+            sha256_init(&ctx);
+            dogecoin_tx_hash_write(&ctx, tx, true);
+            dogecoin_sighash_finalize(&ctx, cache->wtxid);
+        } else {
+            dogecoin_tx_hash(tx, cache->wtxid);
+        }
+        cache->wtxid_valid = true;
+    }
+    memcpy(hashout, tx->wtxid, DOGECOIN_HASH_LENGTH);
+}
+
+void dogecoin_tx_invalidate_hash(dogecoin_tx* tx) {
+    tx->txid_valid = false;
+    tx->wtxid_valid = false;
+}
+
 void dogecoin_tx_prevout_hash(const dogecoin_tx* tx, uint256 hash) {
-    cstring* s = cstr_new_sz(512);
+    sha256_context ctx;
     unsigned int i;
     dogecoin_tx_in* tx_in;
+    sha256_init(&ctx);
     for (i = 0; i < tx->vin->len; i++) {
         tx_in = vector_idx(tx->vin, i);
-        ser_u256(s, tx_in->prevout.hash);
-        ser_u32(s, tx_in->prevout.n);
+        sha256_write(&ctx, tx_in->prevout.hash, DOGECOIN_HASH_LENGTH);
+        dogecoin_sighash_write_u32(&ctx, tx_in->prevout.n);
     }
-
-    dogecoin_hash((const uint8_t*)s->str, s->len, hash);
-    cstr_free(s, true);
+    dogecoin_sighash_finalize(&ctx, hash);
 }
 
 void dogecoin_tx_sequence_hash(const dogecoin_tx* tx, uint256 hash) {
-    cstring* s = cstr_new_sz(512);
+    sha256_context ctx;
     unsigned int i;
     dogecoin_tx_in* tx_in;
+    sha256_init(&ctx);
     for (i = 0; i < tx->vin->len; i++) {
         tx_in = vector_idx(tx->vin, i);
-        ser_u32(s, tx_in->sequence);
+        dogecoin_sighash_write_u32(&ctx, tx_in->sequence);
     }
-
-    dogecoin_hash((const uint8_t*)s->str, s->len, hash);
-    cstr_free(s, true);
+    dogecoin_sighash_finalize(&ctx, hash);
 }
 
 void dogecoin_tx_outputs_hash(const dogecoin_tx* tx, uint256 hash) {
-    cstring* s = cstr_new_sz(512);
+    sha256_context ctx;
     unsigned int i;
     dogecoin_tx_out* tx_out;
+    sha256_init(&ctx);
     for (i = 0; i < tx->vout->len; i++) {
         tx_out = vector_idx(tx->vout, i);
-        dogecoin_tx_out_serialize(s, tx_out);
+        dogecoin_sighash_write_u64(&ctx, (uint64_t)tx_out->value);
+        dogecoin_sighash_write_varstr(&ctx, tx_out->script_pubkey);
     }
-
-    dogecoin_hash((const uint8_t*)s->str, s->len, hash);
-    cstr_free(s, true);
+    dogecoin_sighash_finalize(&ctx, hash);
 }
 
-dogecoin_bool dogecoin_tx_sighash(const dogecoin_tx* tx_to, const cstring* fromPubKey, unsigned int in_num, int hashtype, const uint64_t amount, const enum dogecoin_sig_version sigversion, uint256 hash) {
-    if (in_num >= tx_to->vin->len)
-        return false;
-
-    dogecoin_bool ret = true;
+dogecoin_sighash_ctx* dogecoin_sighash_ctx_new(const dogecoin_tx* tx) {
+    dogecoin_sighash_ctx* ctx = dogecoin_calloc(1, sizeof(*ctx));
+    unsigned int i;
+    ctx->tx = tx;
 
-    dogecoin_tx* tx_tmp = dogecoin_tx_new();
-    dogecoin_tx_copy(tx_tmp, tx_to);
+    // BIP143 midstate pieces
+    dogecoin_tx_prevout_hash(tx, ctx->hash_prevouts);
+    dogecoin_tx_sequence_hash(tx, ctx->hash_sequence);
+    dogecoin_tx_outputs_hash(tx, ctx->hash_outputs);
 
-    cstring* s = NULL;
+    // legacy pieces, every input with an empty script_sig (41 bytes each)
+    // and the full output vector including its count
+    ctx->legacy_inputs = cstr_new_sz(tx->vin->len * DOGECOIN_SIGHASH_LEGACY_INPUT_SIZE);
+    for (i = 0; i < tx->vin->len; i++) {
+        dogecoin_tx_in* tx_in = vector_idx(tx->vin, i);
+        ser_u256(ctx->legacy_inputs, tx_in->prevout.hash);
+        ser_u32(ctx->legacy_inputs, tx_in->prevout.n);
+        ser_varlen(ctx->legacy_inputs, 0);
+        ser_u32(ctx->legacy_inputs, tx_in->sequence);
+    }
 
-    // segwit
-    if (sigversion == SIGVERSION_WITNESS_V0) {
-        uint256 hash_prevouts;
-        dogecoin_hash_clear(hash_prevouts);
-        uint256 hash_sequence;
-        dogecoin_hash_clear(hash_sequence);
-        uint256 hash_outputs;
-        dogecoin_hash_clear(hash_outputs);
+    ctx->legacy_outputs = cstr_new_sz(512);
+    ser_varlen(ctx->legacy_outputs, tx->vout->len);
+    for (i = 0; i < tx->vout->len; i++) {
+        dogecoin_tx_out_serialize(ctx->legacy_outputs, vector_idx(tx->vout, i));
+    }
+    return ctx;
+}
 
-        if (!(hashtype & SIGHASH_ANYONECANPAY)) {
-            dogecoin_tx_prevout_hash(tx_tmp, hash_prevouts);
-        }
-        if (!(hashtype & SIGHASH_ANYONECANPAY)) {
-            dogecoin_tx_outputs_hash(tx_tmp, hash_outputs);
-        }
-        if (!(hashtype & SIGHASH_ANYONECANPAY) && (hashtype & 0x1f) != SIGHASH_SINGLE && (hashtype & 0x1f) != SIGHASH_NONE) {
-            dogecoin_tx_sequence_hash(tx_tmp, hash_sequence);
-        }
+void dogecoin_sighash_ctx_free(dogecoin_sighash_ctx* ctx) {
+    if (!ctx)
+        return;
+    cstr_free(ctx->legacy_inputs, true);
+    cstr_free(ctx->legacy_outputs, true);
+    dogecoin_free(ctx);
+}
 
-        if ((hashtype & 0x1f) != SIGHASH_SINGLE && (hashtype & 0x1f) != SIGHASH_NONE) {
-            dogecoin_tx_outputs_hash(tx_tmp, hash_outputs);
-        } else if ((hashtype & 0x1f) == SIGHASH_SINGLE && in_num < tx_tmp->vout->len) {
-            cstring* s1 = cstr_new_sz(512);
-            dogecoin_tx_out* tx_out = vector_idx(tx_tmp->vout, in_num);
-            dogecoin_tx_out_serialize(s1, tx_out);
-            dogecoin_hash((const uint8_t*)s1->str, s1->len, hash);
-            cstr_free(s1, true);
+static void dogecoin_tx_sighash_bip143(const dogecoin_sighash_ctx* ctx, const cstring* fromPubKey, unsigned int in_num, int hashtype, const uint64_t amount, uint256 hash) {
+    const dogecoin_tx* tx = ctx->tx;
+    const int base_type = hashtype & 0x1f;
+    uint256 hash_single;
+    const uint8_t* hash_prevouts = ctx->hash_prevouts;
+    const uint8_t* hash_sequence = ctx->hash_sequence;
+    const uint8_t* hash_outputs = ctx->hash_outputs;
+    static const uint256 hash_zero = {0};
+    sha256_context shactx;
+
+    if (hashtype & SIGHASH_ANYONECANPAY) {
+        hash_prevouts = hash_zero;
+    }
+    if ((hashtype & SIGHASH_ANYONECANPAY) || base_type == SIGHASH_SINGLE || base_type == SIGHASH_NONE) {
+        hash_sequence = hash_zero;
+    }
+    if (base_type == SIGHASH_SINGLE || base_type == SIGHASH_NONE) {
+        hash_outputs = hash_zero;
+        if (base_type == SIGHASH_SINGLE && in_num < tx->vout->len) {
+            dogecoin_tx_out* tx_out = vector_idx(tx->vout, in_num);
+            sha256_init(&shactx);
+            dogecoin_sighash_write_u64(&shactx, (uint64_t)tx_out->value);
+            dogecoin_sighash_write_varstr(&shactx, tx_out->script_pubkey);
+            dogecoin_sighash_finalize(&shactx, hash_single);
+            hash_outputs = hash_single;
         }
-
-        s = cstr_new_sz(512);
-        ser_u32(s, tx_tmp->version); // Version
-
-        // Input prevouts/nSequence (none/all, depending on flags)
-        ser_u256(s, hash_prevouts);
-        ser_u256(s, hash_sequence);
-
-        // The input being signed (replacing the scriptSig with scriptCode + amount)
-        // The prevout may already be contained in hashPrevout, and the nSequence
-        // may already be contain in hashSequence.
-        dogecoin_tx_in* tx_in = vector_idx(tx_tmp->vin, in_num);
-        ser_u256(s, tx_in->prevout.hash);
-        ser_u32(s, tx_in->prevout.n);
-
-        ser_varstr(s, (cstring *)fromPubKey); // script code
-
-        ser_u64(s, amount);
-        ser_u32(s, tx_in->sequence);
-        ser_u256(s, hash_outputs); // Outputs (none/one/all, depending on flags)
-        ser_u32(s, tx_tmp->locktime); // Locktime
-        ser_s32(s, hashtype); // Sighash type
     }
-    else {
-        // standard (non witness) sighash (SIGVERSION_BASE)
-        cstring* new_script = cstr_new_sz(fromPubKey->len);
-        dogecoin_script_copy_without_op_codeseperator(fromPubKey, new_script);
 
-        unsigned int i;
-        dogecoin_tx_in* tx_in;
-        for (i = 0; i < tx_tmp->vin->len; i++) {
-            tx_in = vector_idx(tx_tmp->vin, i);
-            cstr_resize(tx_in->script_sig, 0);
+    dogecoin_tx_in* tx_in = vector_idx(tx->vin, in_num);
+    sha256_init(&shactx);
+    dogecoin_sighash_write_u32(&shactx, (uint32_t)tx->version);
+    sha256_write(&shactx, hash_prevouts, DOGECOIN_HASH_LENGTH);
+    sha256_write(&shactx, hash_sequence, DOGECOIN_HASH_LENGTH);
+    // the input being signed, scriptCode and amount in place of the scriptSig
+    sha256_write(&shactx, tx_in->prevout.hash, DOGECOIN_HASH_LENGTH);
+    dogecoin_sighash_write_u32(&shactx, tx_in->prevout.n);
+    dogecoin_sighash_write_varstr(&shactx, fromPubKey);
+    dogecoin_sighash_write_u64(&shactx, amount);
+    dogecoin_sighash_write_u32(&shactx, tx_in->sequence);
+    sha256_write(&shactx, hash_outputs, DOGECOIN_HASH_LENGTH);
+    dogecoin_sighash_write_u32(&shactx, tx->locktime);
+    dogecoin_sighash_write_u32(&shactx, (uint32_t)hashtype);
+    dogecoin_sighash_finalize(&shactx, hash);
+}
 
-            if (i == in_num)
-                cstr_append_buf(tx_in->script_sig,
-                                new_script->str,
-                                new_script->len);
-        }
-        cstr_free(new_script, true);
-        /* Blank out some of the outputs */
-        if ((hashtype & 0x1f) == SIGHASH_NONE) {
-            /* Wildcard payee */
-            if (tx_tmp->vout)
-                vector_free(tx_tmp->vout, true);
-
-            tx_tmp->vout = vector_new(1, dogecoin_tx_out_free_cb);
-
-            /* Let the others update at will */
-            for (i = 0; i < tx_tmp->vin->len; i++) {
-                tx_in = vector_idx(tx_tmp->vin, i);
-                if (i != in_num)
-                    tx_in->sequence = 0;
-            }
+// walks the script op by op and writes every run of bytes between OP_CODESEPARATORs to ctx (if not NULL)
+// an unparsable tail is kept verbatim, returns the length of the stripped script
+static size_t dogecoin_sighash_write_script_code(sha256_context* ctx, const cstring* script) {
+    const uint8_t* p = (const uint8_t*)script->str;
+    const size_t len = script->len;
+    size_t pos = 0, seg_start = 0, total = 0;
+
+    while (pos < len) {
+        const uint8_t opcode = p[pos];
+        const size_t op_start = pos++;
+        size_t push_len = 0;
+
+        if (opcode < OP_PUSHDATA1) {
+            push_len = opcode;
+        } else if (opcode == OP_PUSHDATA1) {
+            if (len - pos < 1)
+                break;
+            push_len = p[pos];
+            pos += 1;
+        } else if (opcode == OP_PUSHDATA2) {
+            if (len - pos < 2)
+                break;
+            push_len = (size_t)p[pos] | ((size_t)p[pos + 1] << 8);
+            pos += 2;
+        } else if (opcode == OP_PUSHDATA4) {
+            if (len - pos < 4)
+                break;
+            push_len = (size_t)p[pos] | ((size_t)p[pos + 1] << 8) | ((size_t)p[pos + 2] << 16) | ((size_t)p[pos + 3] << 24);
+            pos += 4;
         }
+        if (len - pos < push_len)
+            break;
+        pos += push_len;
+
+        if (opcode == OP_CODESEPARATOR) {
+            if (ctx)
+                sha256_write(ctx, p + seg_start, op_start - seg_start);
+            total += op_start - seg_start;
+            seg_start = pos;
+        }
+    }
+    if (ctx)
+        sha256_write(ctx, p + seg_start, len - seg_start);
+    return total + len - seg_start;
+}
 
-        else if ((hashtype & 0x1f) == SIGHASH_SINGLE) {
-            /* Only lock-in the txout payee at same index as txin */
-            unsigned int n_out = in_num;
-            if (n_out >= tx_tmp->vout->len) {
-                //TODO: set error code
-                ret = false;
-                goto out;
-            }
+static void dogecoin_sighash_write_legacy_input(sha256_context* ctx, const dogecoin_tx_in* tx_in, const cstring* script_code, uint32_t sequence) {
+    sha256_write(ctx, tx_in->prevout.hash, DOGECOIN_HASH_LENGTH);
+    dogecoin_sighash_write_u32(ctx, tx_in->prevout.n);
+    if (script_code) {
+        // script code with OP_CODESEPARATORs removed, the first pass only measures it
+        dogecoin_sighash_write_varlen(ctx, dogecoin_sighash_write_script_code(NULL, script_code));
+        dogecoin_sighash_write_script_code(ctx, script_code);
+    } else {
+        dogecoin_sighash_write_varlen(ctx, 0);
+    }
+    dogecoin_sighash_write_u32(ctx, sequence);
+}
 
-            vector_resize(tx_tmp->vout, n_out + 1);
+static void dogecoin_sighash_write_output(sha256_context* ctx, const dogecoin_tx_out* tx_out) {
+    dogecoin_sighash_write_u64(ctx, (uint64_t)tx_out->value);
+    dogecoin_sighash_write_varstr(ctx, tx_out->script_pubkey);
+}
 
-            for (i = 0; i < n_out; i++) {
-                dogecoin_tx_out* tx_out;
+// legacy (SIGVERSION_BASE) digest, streams the modified serialization without copying the tx
+// uses the cached input/output serialization of the context when available
+static dogecoin_bool dogecoin_tx_sighash_legacy(const dogecoin_sighash_ctx* ctx, const cstring* fromPubKey, unsigned int in_num, int hashtype, uint256 hash) {
+    const dogecoin_tx* tx = ctx->tx;
+    const int base_type = hashtype & 0x1f;
+    const dogecoin_bool anyonecanpay = (hashtype & SIGHASH_ANYONECANPAY) != 0;
+    // NONE and SINGLE let the others update at will
+    const dogecoin_bool blank_sequences = base_type == SIGHASH_NONE || base_type == SIGHASH_SINGLE;
+    const dogecoin_tx_in* tx_in = vector_idx(tx->vin, in_num);
+    sha256_context shactx;
+    unsigned int i;
 
-                tx_out = vector_idx(tx_tmp->vout, i);
-                tx_out->value = -1;
-                if (tx_out->script_pubkey) {
-                    cstr_free(tx_out->script_pubkey, true);
-                    tx_out->script_pubkey = NULL;
-                }
-            }
+    /* Only lock-in the txout payee at same index as txin */
+    if (base_type == SIGHASH_SINGLE && in_num >= tx->vout->len)
+        return false;
 
-            /* Let the others update at will */
-            for (i = 0; i < tx_tmp->vin->len; i++) {
-                tx_in = vector_idx(tx_tmp->vin, i);
-                if (i != in_num)
-                    tx_in->sequence = 0;
-            }
+    sha256_init(&shactx);
+    dogecoin_sighash_write_u32(&shactx, (uint32_t)tx->version);
+
+    /* Blank out other inputs completely;
+     not recommended for open transactions */
+    if (anyonecanpay) {
+        dogecoin_sighash_write_varlen(&shactx, 1);
+        dogecoin_sighash_write_legacy_input(&shactx, tx_in, fromPubKey, tx_in->sequence);
+    } else if (!blank_sequences && ctx->legacy_inputs) {
+        const uint8_t* inputs = (const uint8_t*)ctx->legacy_inputs->str;
+        const size_t in_size = DOGECOIN_SIGHASH_LEGACY_INPUT_SIZE;
+        dogecoin_sighash_write_varlen(&shactx, tx->vin->len);
+        sha256_write(&shactx, inputs, in_num * in_size);
+        dogecoin_sighash_write_legacy_input(&shactx, tx_in, fromPubKey, tx_in->sequence);
+        sha256_write(&shactx, inputs + (in_num + 1) * in_size, (tx->vin->len - in_num - 1) * in_size);
+    } else {
+        dogecoin_sighash_write_varlen(&shactx, tx->vin->len);
+        for (i = 0; i < tx->vin->len; i++) {
+            const dogecoin_tx_in* other = vector_idx(tx->vin, i);
+            if (i == in_num)
+                dogecoin_sighash_write_legacy_input(&shactx, other, fromPubKey, other->sequence);
+            else
+                dogecoin_sighash_write_legacy_input(&shactx, other, NULL, blank_sequences ? 0 : other->sequence);
         }
+    }
 
-        /* Blank out other inputs completely;
-         not recommended for open transactions */
-        if (hashtype & SIGHASH_ANYONECANPAY) {
-            if (in_num > 0)
-                vector_remove_range(tx_tmp->vin, 0, in_num);
-            vector_resize(tx_tmp->vin, 1);
+    if (base_type == SIGHASH_NONE) {
+        /* Wildcard payee */
+        dogecoin_sighash_write_varlen(&shactx, 0);
+    } else if (base_type == SIGHASH_SINGLE) {
+        // outputs before in_num are serialized as value -1 with an empty script
+        static const uint8_t blank_out[9] = {0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00};
+        dogecoin_sighash_write_varlen(&shactx, in_num + 1);
+        for (i = 0; i < in_num; i++) {
+            sha256_write(&shactx, blank_out, sizeof(blank_out));
+        }
+        dogecoin_sighash_write_output(&shactx, vector_idx(tx->vout, in_num));
+    } else if (ctx->legacy_outputs) {
+        sha256_write(&shactx, (const uint8_t*)ctx->legacy_outputs->str, ctx->legacy_outputs->len);
+    } else {
+        dogecoin_sighash_write_varlen(&shactx, tx->vout->len);
+        for (i = 0; i < tx->vout->len; i++) {
+            dogecoin_sighash_write_output(&shactx, vector_idx(tx->vout, i));
         }
-
-        s = cstr_new_sz(512);
-        dogecoin_tx_serialize(s, tx_tmp, false);
-        ser_s32(s, hashtype);
     }
 
-    //char str[10000];
-    //memset(str, strlen(str), 0);
-    //utils_bin_to_hex((unsigned char *)s->str, s->len, str);
-    //printf("\n");
-    //printf("%s\n", str);
+    dogecoin_sighash_write_u32(&shactx, tx->locktime);
+    dogecoin_sighash_write_u32(&shactx, (uint32_t)hashtype);
+    dogecoin_sighash_finalize(&shactx, hash);
+    return true;
+}
+
+dogecoin_bool dogecoin_tx_sighash_with_ctx(const dogecoin_sighash_ctx* ctx, const cstring* fromPubKey, unsigned int in_num, int hashtype, const uint64_t amount, const enum dogecoin_sig_version sigversion, uint256 hash) {
+    if (!ctx || !fromPubKey || in_num >= ctx->tx->vin->len)
+        return false;
 
-    sha256_raw((const uint8_t*)s->str, s->len, hash);
-    sha256_raw(hash, DOGECOIN_HASH_LENGTH, hash);
+    if (sigversion == SIGVERSION_WITNESS_V0) {
+        dogecoin_tx_sighash_bip143(ctx, fromPubKey, in_num, hashtype, amount, hash);
+        return true;
+    }
 
-    cstr_free(s, true);
+    return dogecoin_tx_sighash_legacy(ctx, fromPubKey, in_num, hashtype, hash);
+}
 
-out:
-    dogecoin_tx_free(tx_tmp);
+dogecoin_bool dogecoin_tx_sighash(const dogecoin_tx* tx_to, const cstring* fromPubKey, unsigned int in_num, int hashtype, const uint64_t amount, const enum dogecoin_sig_version sigversion, uint256 hash) {
+    if (in_num >= tx_to->vin->len)
+        return false;
 
-    return ret;
+    // one-shot context on the stack, the legacy digest is streamed straight from the tx
+    dogecoin_sighash_ctx ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.tx = tx_to;
+    if (sigversion == SIGVERSION_WITNESS_V0) {
+        dogecoin_tx_prevout_hash(tx_to, ctx.hash_prevouts);
+        dogecoin_tx_sequence_hash(tx_to, ctx.hash_sequence);
+        dogecoin_tx_outputs_hash(tx_to, ctx.hash_outputs);
+    }
+    return dogecoin_tx_sighash_with_ctx(&ctx, fromPubKey, in_num, hashtype, amount, sigversion, hash);
 }
 
 dogecoin_bool dogecoin_tx_add_data_out(dogecoin_tx* tx, const int64_t amount, const uint8_t *data, const size_t datalen) {
@@ -621,6 +1246,7 @@ dogecoin_bool dogecoin_tx_add_data_out(dogecoin_tx* tx, const int64_t amount, co
     tx_out->value = amount;
 
     vector_add(tx->vout, tx_out);
+    dogecoin_tx_invalidate_hash(tx);
 
     return true;
 }
@@ -638,6 +1264,7 @@ dogecoin_bool dogecoin_tx_add_puzzle_out(dogecoin_tx* tx, const int64_t amount,
     tx_out->value = amount;
 
     vector_add(tx->vout, tx_out);
+    dogecoin_tx_invalidate_hash(tx);
 
     return true;
 }
@@ -684,6 +1311,7 @@ dogecoin_bool dogecoin_tx_add_p2pkh_hash160_out(dogecoin_tx* tx, int64_t amount,
     tx_out->value = amount;
 
     vector_add(tx->vout, tx_out);
+    dogecoin_tx_invalidate_hash(tx);
 
     return true;
 }
@@ -697,6 +1325,7 @@ dogecoin_bool dogecoin_tx_add_p2sh_hash160_out(dogecoin_tx* tx, int64_t amount,
     tx_out->value = amount;
 
     vector_add(tx->vout, tx_out);
+    dogecoin_tx_invalidate_hash(tx);
 
     return true;
 }
@@ -747,139 +1376,295 @@ const char* dogecoin_tx_sign_result_to_str(const enum dogecoin_tx_sign_result re
     return "UNKOWN";
 }
 
-enum dogecoin_tx_sign_result dogecoin_tx_sign_input(dogecoin_tx *tx_in_out, const cstring *script, uint64_t amount, const dogecoin_key *privkey, int inputindex, int sighashtype, uint8_t *sigcompact_out, uint8_t *sigder_out, int *sigder_len_out) {
-    if (!tx_in_out || !script) {
+// per input signing state, filled by the prepare/sign steps and consumed by the apply step
+typedef struct dogecoin_tx_sign_state_ {
+    dogecoin_pubkey pubkey;
+    enum dogecoin_tx_out_type type;
+    enum dogecoin_sig_version sig_version;
+    cstring* script_sign;           // script used for the sighash
+    cstring* witness_set_scriptsig; // required in order to set the P2SH-P2WPKH scriptSig
+    uint256 sighash;
+    uint8_t sig[64];
+    uint8_t sigder_plus_hashtype[74 + 1];
+    size_t sigderlen;
+    enum dogecoin_tx_sign_result res;
+} dogecoin_tx_sign_state;
+
+static void dogecoin_tx_sign_state_free(dogecoin_tx_sign_state* state) {
+    cstr_free(state->script_sign, true);
+    cstr_free(state->witness_set_scriptsig, true);
+    state->script_sign = NULL;
+    state->witness_set_scriptsig = NULL;
+}
+
+// validates the input, derives the pubkey and classifies the script, only reads the tx
+static enum dogecoin_tx_sign_result dogecoin_tx_sign_prepare(const dogecoin_tx* tx, const cstring* script, const dogecoin_key* privkey, int inputindex, dogecoin_tx_sign_state* state) {
+    memset(state, 0, sizeof(*state));
+    if (!tx || !script) {
         return DOGECOIN_SIGN_INVALID_TX_OR_SCRIPT;
     }
-    if ((size_t)inputindex >= tx_in_out->vin->len) {
+    if (inputindex < 0 || (size_t)inputindex >= tx->vin->len) {
         return DOGECOIN_SIGN_INPUTINDEX_OUT_OF_RANGE;
     }
     if (!dogecoin_privkey_is_valid(privkey)) {
         return DOGECOIN_SIGN_INVALID_KEY;
     }
     // calculate pubkey
-    dogecoin_pubkey pubkey;
-    dogecoin_pubkey_init(&pubkey);
-    dogecoin_pubkey_from_key(privkey, &pubkey);
-    if (!dogecoin_pubkey_is_valid(&pubkey)) {
+    dogecoin_pubkey_init(&state->pubkey);
+    dogecoin_pubkey_from_key(privkey, &state->pubkey);
+    if (!dogecoin_pubkey_is_valid(&state->pubkey)) {
         return DOGECOIN_SIGN_INVALID_KEY;
     }
-    enum dogecoin_tx_sign_result res = DOGECOIN_SIGN_OK;
+    state->res = DOGECOIN_SIGN_OK;
+    state->sig_version = SIGVERSION_BASE;
 
-    cstring *script_sign = cstr_new_cstr(script); //copy the script because we may modify it
-    dogecoin_tx_in *tx_in = vector_idx(tx_in_out->vin, inputindex);
+    state->script_sign = cstr_new_cstr(script); //copy the script because we may modify it
     vector *script_pushes = vector_new(1, free);
 
-    cstring *witness_set_scriptsig = NULL; //required in order to set the P2SH-P2WPKH scriptSig
-    enum dogecoin_tx_out_type type = dogecoin_script_classify(script, script_pushes);
-    enum dogecoin_sig_version sig_version = SIGVERSION_BASE;
-    if (type == DOGECOIN_TX_SCRIPTHASH) {
+    state->type = dogecoin_script_classify(script, script_pushes);
+    if (state->type == DOGECOIN_TX_SCRIPTHASH) {
         // p2sh script, need the redeem script
         // for now, pretend to be a p2sh-p2wpkh
         vector_free(script_pushes, true);
         script_pushes = vector_new(1, free);
-        type = DOGECOIN_TX_WITNESS_V0_PUBKEYHASH;
+        state->type = DOGECOIN_TX_WITNESS_V0_PUBKEYHASH;
         uint8_t *hash160 = dogecoin_calloc(1, 20);
-        dogecoin_pubkey_get_hash160(&pubkey, hash160);
+        dogecoin_pubkey_get_hash160(&state->pubkey, hash160);
         vector_add(script_pushes, hash160);
 
         // set the script sig
-        witness_set_scriptsig = cstr_new_sz(22);
+        state->witness_set_scriptsig = cstr_new_sz(22);
         uint8_t version = 0;
-        ser_varlen(witness_set_scriptsig, 22);
-        ser_bytes(witness_set_scriptsig, &version, 1);
-        ser_varlen(witness_set_scriptsig, 20);
-        ser_bytes(witness_set_scriptsig, hash160, 20);
+        ser_varlen(state->witness_set_scriptsig, 22);
+        ser_bytes(state->witness_set_scriptsig, &version, 1);
+        ser_varlen(state->witness_set_scriptsig, 20);
+        ser_bytes(state->witness_set_scriptsig, hash160, 20);
     }
-    if (type == DOGECOIN_TX_PUBKEYHASH && script_pushes->len == 1) {
+    if (state->type == DOGECOIN_TX_PUBKEYHASH && script_pushes->len == 1) {
         // check if given private key matches the script
         uint160 hash160;
-        dogecoin_pubkey_get_hash160(&pubkey, hash160);
+        dogecoin_pubkey_get_hash160(&state->pubkey, hash160);
         uint160 *hash160_in_script = vector_idx(script_pushes, 0);
         if (memcmp(hash160_in_script, hash160, sizeof(hash160)) != 0) {
-            res = DOGECOIN_SIGN_NO_KEY_MATCH; //sign anyways
+            state->res = DOGECOIN_SIGN_NO_KEY_MATCH; //sign anyways
         }
     }
-    else if (type == DOGECOIN_TX_WITNESS_V0_PUBKEYHASH && script_pushes->len == 1) {
+    else if (state->type == DOGECOIN_TX_WITNESS_V0_PUBKEYHASH && script_pushes->len == 1) {
         uint160 *hash160_in_script = vector_idx(script_pushes, 0);
-        sig_version = SIGVERSION_WITNESS_V0;
+        state->sig_version = SIGVERSION_WITNESS_V0;
 
         // check if given private key matches the script
         uint160 hash160;
-        dogecoin_pubkey_get_hash160(&pubkey, hash160);
+        dogecoin_pubkey_get_hash160(&state->pubkey, hash160);
         if (memcmp(hash160_in_script, hash160, sizeof(hash160)) != 0) {
-            res = DOGECOIN_SIGN_NO_KEY_MATCH; //sign anyways
+            state->res = DOGECOIN_SIGN_NO_KEY_MATCH; //sign anyways
         }
 
-        cstr_resize(script_sign, 0);
-        dogecoin_script_build_p2pkh(script_sign, *hash160_in_script);
+        cstr_resize(state->script_sign, 0);
+        dogecoin_script_build_p2pkh(state->script_sign, *hash160_in_script);
     }
     else {
         // unknown script, however, still try to create a signature (don't apply though)
-        res = DOGECOIN_SIGN_UNKNOWN_SCRIPT_TYPE;
+        state->res = DOGECOIN_SIGN_UNKNOWN_SCRIPT_TYPE;
     }
     vector_free(script_pushes, true);
+    return DOGECOIN_SIGN_OK;
+}
 
-    uint256 sighash;
-    memset(sighash, 0, sizeof(sighash));
-    if(!dogecoin_tx_sighash(tx_in_out, script_sign, inputindex, sighashtype, amount, sig_version, sighash)) {
-        cstr_free(witness_set_scriptsig, true);
-        cstr_free(script_sign, true);
-        return DOGECOIN_SIGN_SIGHASH_FAILED;
-    }
-    cstr_free(script_sign, true);
-    // sign compact
-    uint8_t sig[64];
+// signs state->sighash, creates the compact and the normalized DER signature (+hashtype)
+static void dogecoin_tx_sign_hash(const dogecoin_key* privkey, int sighashtype, dogecoin_tx_sign_state* state) {
     size_t siglen = 0;
-    dogecoin_key_sign_hash_compact(privkey, sighash, sig, &siglen);
-    assert(siglen == sizeof(sig));
-    if (sigcompact_out) {
-        memcpy(sigcompact_out, sig, siglen);
-    }
+    dogecoin_key_sign_hash_compact(privkey, state->sighash, state->sig, &siglen);
+    assert(siglen == sizeof(state->sig));
 
     // form normalized DER signature & hashtype
-    unsigned char sigder_plus_hashtype[74+1];
-    size_t sigderlen = 75;
-    dogecoin_ecc_compact_to_der_normalized(sig, sigder_plus_hashtype, &sigderlen);
-    assert(sigderlen <= 74 && sigderlen >= 70);
-    sigder_plus_hashtype[sigderlen] = sighashtype;
-    sigderlen+=1; //+hashtype
-    if (sigcompact_out) {
-        memcpy(sigder_out, sigder_plus_hashtype, sigderlen);
-    }
-    if (sigder_len_out) {
-        *sigder_len_out = sigderlen;
-    }
+    state->sigderlen = 75;
+    dogecoin_ecc_compact_to_der_normalized(state->sig, state->sigder_plus_hashtype, &state->sigderlen);
+    assert(state->sigderlen <= 74 && state->sigderlen >= 70);
+    state->sigder_plus_hashtype[state->sigderlen] = sighashtype;
+    state->sigderlen += 1; //+hashtype
+}
 
-    // apply signature depending on script type
-    if (type == DOGECOIN_TX_PUBKEYHASH) {
+// applies the signature depending on script type
+static enum dogecoin_tx_sign_result dogecoin_tx_sign_apply(dogecoin_tx_in* tx_in, dogecoin_tx_sign_state* state) {
+    const size_t pubkeylen = state->pubkey.compressed ? DOGECOIN_ECKEY_COMPRESSED_LENGTH : DOGECOIN_ECKEY_UNCOMPRESSED_LENGTH;
+    if (state->type == DOGECOIN_TX_PUBKEYHASH) {
         // apply DER sig
-        ser_varlen(tx_in->script_sig, sigderlen);
-        ser_bytes(tx_in->script_sig, sigder_plus_hashtype, sigderlen);
+        ser_varlen(tx_in->script_sig, state->sigderlen);
+        ser_bytes(tx_in->script_sig, state->sigder_plus_hashtype, state->sigderlen);
 
         // apply pubkey
-        ser_varlen(tx_in->script_sig, pubkey.compressed ? DOGECOIN_ECKEY_COMPRESSED_LENGTH : DOGECOIN_ECKEY_UNCOMPRESSED_LENGTH);
-        ser_bytes(tx_in->script_sig, pubkey.pubkey, pubkey.compressed ? DOGECOIN_ECKEY_COMPRESSED_LENGTH : DOGECOIN_ECKEY_UNCOMPRESSED_LENGTH);
+        ser_varlen(tx_in->script_sig, pubkeylen);
+        ser_bytes(tx_in->script_sig, state->pubkey.pubkey, pubkeylen);
     }
-    else if (type == DOGECOIN_TX_WITNESS_V0_PUBKEYHASH) {
+    else if (state->type == DOGECOIN_TX_WITNESS_V0_PUBKEYHASH) {
         // signal witness by emtpying script sig (may be already empty)
         cstr_resize(tx_in->script_sig, 0);
-        if (witness_set_scriptsig) {
+        if (state->witness_set_scriptsig) {
             // apend the script sig in case of P2SH-P2WPKH
-            cstr_append_cstr(tx_in->script_sig, witness_set_scriptsig);
-            cstr_free(witness_set_scriptsig, true);
+            cstr_append_cstr(tx_in->script_sig, state->witness_set_scriptsig);
         }
 
         // fill witness stack (DER sig, pubkey)
-        cstring* witness_item = cstr_new_buf(sigder_plus_hashtype, sigderlen);
+        cstring* witness_item = cstr_new_buf(state->sigder_plus_hashtype, state->sigderlen);
         vector_add(tx_in->witness_stack, witness_item);
 
-        witness_item = cstr_new_buf(pubkey.pubkey, pubkey.compressed ? DOGECOIN_ECKEY_COMPRESSED_LENGTH : DOGECOIN_ECKEY_UNCOMPRESSED_LENGTH);
+        witness_item = cstr_new_buf(state->pubkey.pubkey, pubkeylen);
         vector_add(tx_in->witness_stack, witness_item);
     }
     else {
         // append nothing
-        res = DOGECOIN_SIGN_UNKNOWN_SCRIPT_TYPE;
+        return DOGECOIN_SIGN_UNKNOWN_SCRIPT_TYPE;
     }
+    return state->res;
+}
+
+enum dogecoin_tx_sign_result dogecoin_tx_sign_input(dogecoin_tx *tx_in_out, const cstring *script, uint64_t amount, const dogecoin_key *privkey, int inputindex, int sighashtype, uint8_t *sigcompact_out, uint8_t *sigder_out, int *sigder_len_out) {
+    dogecoin_tx_sign_state state;
+    enum dogecoin_tx_sign_result res = dogecoin_tx_sign_prepare(tx_in_out, script, privkey, inputindex, &state);
+    if (res != DOGECOIN_SIGN_OK) {
+        return res;
+    }
+
+    if (!dogecoin_tx_sighash(tx_in_out, state.script_sign, inputindex, sighashtype, amount, state.sig_version, state.sighash)) {
+        dogecoin_tx_sign_state_free(&state);
+        return DOGECOIN_SIGN_SIGHASH_FAILED;
+    }
+    dogecoin_tx_sign_hash(privkey, sighashtype, &state);
+    if (sigcompact_out) {
+        memcpy(sigcompact_out, state.sig, sizeof(state.sig));
+    }
+    if (sigder_out) {
+        memcpy(sigder_out, state.sigder_plus_hashtype, state.sigderlen);
+    }
+    if (sigder_len_out) {
+        *sigder_len_out = state.sigderlen;
+    }
+
+    res = dogecoin_tx_sign_apply(vector_idx(tx_in_out->vin, inputindex), &state);
+    dogecoin_tx_invalidate_hash(tx_in_out);
+    dogecoin_tx_sign_state_free(&state);
+    return res;
+}
+
+typedef struct dogecoin_tx_sign_batch_ {
+    const dogecoin_tx* tx;
+    const dogecoin_sighash_ctx* sighash_ctx;
+    dogecoin_tx_sign_job* jobs;
+    dogecoin_tx_sign_state* states;
+    size_t num_jobs;
+    size_t next_job;
+#ifdef HAVE_PTHREAD
+    pthread_mutex_t lock;
+#endif
+} dogecoin_tx_sign_batch;
+
+// prepare, sighash and sign one job, touches nothing but its own state so it can run on any thread
+static void dogecoin_tx_sign_batch_job(dogecoin_tx_sign_batch* batch, size_t i) {
+    dogecoin_tx_sign_job* job = &batch->jobs[i];
+    dogecoin_tx_sign_state* state = &batch->states[i];
+    job->result = dogecoin_tx_sign_prepare(batch->tx, job->script, job->privkey, job->inputindex, state);
+    if (job->result != DOGECOIN_SIGN_OK)
+        return;
+    if (!dogecoin_tx_sighash_with_ctx(batch->sighash_ctx, state->script_sign, job->inputindex, job->sighashtype, job->amount, state->sig_version, state->sighash)) {
+        job->result = DOGECOIN_SIGN_SIGHASH_FAILED;
+        return;
+    }
+    dogecoin_tx_sign_hash(job->privkey, job->sighashtype, state);
+}
+
+#ifdef HAVE_PTHREAD
+static void* dogecoin_tx_sign_batch_worker(void* arg) {
+    dogecoin_tx_sign_batch* batch = arg;
+    for (;;) {
+        pthread_mutex_lock(&batch->lock);
+        size_t i = batch->next_job++;
+        pthread_mutex_unlock(&batch->lock);
+        if (i >= batch->num_jobs)
+            break;
+        dogecoin_tx_sign_batch_job(batch, i);
+    }
+    return NULL;
+}
+
+// a spawned thread and the pooled context it signs with
+typedef struct dogecoin_tx_sign_worker_ {
+    dogecoin_tx_sign_batch* batch;
+    dogecoin_ecc_ctx* ctx;
+} dogecoin_tx_sign_worker;
+
+static void* dogecoin_tx_sign_batch_thread(void* arg) {
+    dogecoin_tx_sign_worker* worker = arg;
+    // key derivation and signing go through the thread's context, adopt the pooled one
+    dogecoin_ecc_thread_ctx_set(worker->ctx);
+    return dogecoin_tx_sign_batch_worker(worker->batch);
+}
+#endif
+
+enum dogecoin_tx_sign_result dogecoin_tx_sign_inputs_batch(dogecoin_tx* tx_in_out, dogecoin_tx_sign_job* jobs, size_t num_jobs, unsigned int num_threads) {
+    size_t i;
+    if (!tx_in_out || (!jobs && num_jobs > 0)) {
+        return DOGECOIN_SIGN_INVALID_TX_OR_SCRIPT;
+    }
+    if (num_jobs == 0) {
+        return DOGECOIN_SIGN_OK;
+    }
+
+    // all sighashes are computed against the unsigned tx, neither the legacy nor the
+    // witness v0 digest commits to the script_sig/witness of the other inputs
+    dogecoin_sighash_ctx* sighash_ctx = dogecoin_sighash_ctx_new(tx_in_out);
+    dogecoin_tx_sign_batch batch;
+    batch.tx = tx_in_out;
+    batch.sighash_ctx = sighash_ctx;
+    batch.jobs = jobs;
+    batch.states = dogecoin_calloc(num_jobs, sizeof(dogecoin_tx_sign_state));
+    batch.num_jobs = num_jobs;
+    batch.next_job = 0;
+
+    if (num_threads > num_jobs) {
+        num_threads = num_jobs;
+    }
+#ifdef HAVE_PTHREAD
+    if (num_threads > 1) {
+        pthread_t* threads = dogecoin_calloc(num_threads, sizeof(pthread_t));
+        dogecoin_tx_sign_worker* workers = dogecoin_calloc(num_threads, sizeof(dogecoin_tx_sign_worker));
+        unsigned int started = 0;
+        pthread_mutex_init(&batch.lock, NULL);
+        // the calling thread works as well (on its own context), so spawn one thread less
+        for (started = 0; started < num_threads - 1; started++) {
+            workers[started].batch = &batch;
+            workers[started].ctx = dogecoin_ecc_worker_ctx(started);
+            if (pthread_create(&threads[started], NULL, dogecoin_tx_sign_batch_thread, &workers[started]) != 0)
+                break;
+        }
+        dogecoin_tx_sign_batch_worker(&batch);
+        while (started > 0) {
+            pthread_join(threads[--started], NULL);
+        }
+        pthread_mutex_destroy(&batch.lock);
+        dogecoin_free(workers);
+        dogecoin_free(threads);
+    }
+#endif
+    // single threaded (or pthreads not available), run whatever is left
+    for (i = batch.next_job; i < num_jobs; i++) {
+        dogecoin_tx_sign_batch_job(&batch, i);
+    }
+
+    // apply in job order so the result does not depend on scheduling
+    enum dogecoin_tx_sign_result res = DOGECOIN_SIGN_OK;
+    for (i = 0; i < num_jobs; i++) {
+        if (jobs[i].result == DOGECOIN_SIGN_OK) {
+            jobs[i].result = dogecoin_tx_sign_apply(vector_idx(tx_in_out->vin, jobs[i].inputindex), &batch.states[i]);
+        }
+        dogecoin_tx_sign_state_free(&batch.states[i]);
+        if (res == DOGECOIN_SIGN_OK && jobs[i].result != DOGECOIN_SIGN_OK) {
+            res = jobs[i].result;
+        }
+    }
+
+    dogecoin_tx_invalidate_hash(tx_in_out);
+    dogecoin_free(batch.states);
+    dogecoin_sighash_ctx_free(sighash_ctx);
     return res;
 }
@@ -126,6 +126,55 @@ void utils_bin_to_hex(unsigned char* bin_in, size_t inlen, char* hex_out) {
 }
 
 
+size_t utils_base64_encode(const unsigned char* bin_in, size_t inlen, char* b64_out) {
+    static const char digits[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    size_t i, j = 0;
+    for (i = 0; i < inlen; i += 3) {
+        const uint32_t v = (uint32_t)bin_in[i] << 16 | (i + 1 < inlen ? (uint32_t)bin_in[i + 1] << 8 : 0) | (i + 2 < inlen ? bin_in[i + 2] : 0);
+        b64_out[j++] = digits[(v >> 18) & 0x3F];
+        b64_out[j++] = digits[(v >> 12) & 0x3F];
+        b64_out[j++] = i + 1 < inlen ? digits[(v >> 6) & 0x3F] : '=';
+        b64_out[j++] = i + 2 < inlen ? digits[v & 0x3F] : '=';
+    }
+    b64_out[j] = '\0';
+    return j;
+}
+
+static int utils_base64_digit(char c) {
+    if (c >= 'A' && c <= 'Z') return c - 'A';
+    if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+    if (c >= '0' && c <= '9') return c - '0' + 52;
+    if (c == '+') return 62;
+    if (c == '/') return 63;
+    return -1;
+}
+
+dogecoin_bool utils_base64_decode(const char* b64_in, size_t inlen, unsigned char* bin_out, size_t* outlen) {
+    size_t i, j = 0, pad = 0;
+    if (inlen % 4 != 0)
+        return false;
+    if (inlen > 0 && b64_in[inlen - 1] == '=') pad++;
+    if (inlen > 1 && b64_in[inlen - 2] == '=') pad++;
+    if (inlen / 4 * 3 - pad > *outlen)
+        return false;
+    for (i = 0; i < inlen; i += 4) {
+        int d[4], k;
+        uint32_t v = 0;
+        for (k = 0; k < 4; k++) {
+            // padding only at the very end
+            d[k] = i + k >= inlen - pad ? 0 : utils_base64_digit(b64_in[i + k]);
+            if (d[k] < 0)
+                return false;
+            v = v << 6 | (uint32_t)d[k];
+        }
+        bin_out[j++] = (unsigned char)(v >> 16);
+        if (j < inlen / 4 * 3 - pad) bin_out[j++] = (unsigned char)(v >> 8);
+        if (j < inlen / 4 * 3 - pad) bin_out[j++] = (unsigned char)v;
+    }
+    *outlen = j;
+    return true;
+}
+
 char* utils_uint8_to_hex(const uint8_t* bin, size_t l) {
     static char digits[] = "0123456789abcdef";
     size_t i;
@@ -0,0 +1,335 @@
+/*
+
+ The MIT License (MIT)
+
+ Copyright (c) 2022 The Dogecoin Foundation
+
+ Permission is hereby granted, free of charge, to any person obtaining
+ a copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES
+ OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+#ifdef HAVE_CONFIG_H
+#  include <src/libdogecoin-config.h>
+#endif
+
+#include <string.h>
+#include <time.h>
+#ifndef _MSC_VER
+#  include <sys/time.h>
+#endif
+
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
+#include <dogecoin/crypto/base58.h>
+#include <dogecoin/crypto/ecc.h>
+#include <dogecoin/crypto/hash.h>
+#include <dogecoin/mem.h>
+#include <dogecoin/vanity.h>
+
+// keys derived per point addition sequence, also the granularity of the key counter
+#define VANITY_BATCH 1024
+
+static const char vanity_b58digits[] = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
+
+/* 256 bit big endian helpers, enough room for the 200 bit address payload times 58 */
+
+// a = a * m + c, false on overflow
+static dogecoin_bool vanity_mul_add(uint8_t* a, unsigned int m, unsigned int c) {
+    int i;
+    for (i = 31; i >= 0; i--) {
+        c += a[i] * m;
+        a[i] = (uint8_t)c;
+        c >>= 8;
+    }
+    return c == 0;
+}
+
+static void vanity_sub1(uint8_t* a) {
+    int i;
+    for (i = 31; i >= 0 && a[i]-- == 0; i--) {
+    }
+}
+
+static double vanity_to_double(const uint8_t* a, size_t len) {
+    double d = 0;
+    size_t i;
+    for (i = 0; i < len; i++) {
+        d = d * 256.0 + a[i];
+    }
+    return d;
+}
+
+dogecoin_bool dogecoin_vanity_pattern_init(dogecoin_vanity_pattern* pattern, const char* prefix, const dogecoin_chainparams* chain) {
+    const size_t m = prefix ? strlen(prefix) : 0;
+    uint8_t p[32], lo[32], hi[32], vlo[32], vhi[32];
+    double total = 0;
+    size_t i, len;
+
+    if (!pattern || !chain || m == 0 || m > DOGECOIN_VANITY_MAX_PREFIX)
+        return false;
+    memset(pattern, 0, sizeof(*pattern));
+    memcpy(pattern->prefix, prefix, m);
+    pattern->version = chain->b58prefix_pubkey_address;
+
+    // a leading '1' stands for a zero version byte
+    if (prefix[0] == '1' || pattern->version == 0)
+        return false;
+    memset(p, 0, sizeof(p));
+    for (i = 0; i < m; i++) {
+        const char* digit = strchr(vanity_b58digits, prefix[i]);
+        if (!digit || !prefix[i])
+            return false;
+        vanity_mul_add(p, 58, (unsigned int)(digit - vanity_b58digits));
+    }
+
+    // payload version || hash160 || checksum, as a number the version fixes the top byte
+    memset(vlo, 0, sizeof(vlo));
+    vlo[7] = pattern->version;
+    memset(vhi, 0xff, sizeof(vhi));
+    memset(vhi, 0, 7);
+    vhi[7] = pattern->version;
+
+    // addresses of length len starting with the prefix are [p * 58^(len - m), (p + 1) * 58^(len - m))
+    memcpy(lo, p, sizeof(p));
+    memcpy(hi, p, sizeof(p));
+    vanity_mul_add(hi, 1, 1);
+    for (len = m; len <= DOGECOIN_VANITY_MAX_PREFIX + 1; len++) {
+        uint8_t a[32], b[32];
+        if (len > m && (!vanity_mul_add(lo, 58, 0) || !vanity_mul_add(hi, 58, 0)))
+            break;
+        if (memcmp(lo, vhi, 32) > 0)
+            break;
+        memcpy(a, memcmp(lo, vlo, 32) > 0 ? lo : vlo, 32);
+        memcpy(b, hi, 32);
+        vanity_sub1(b);
+        if (memcmp(b, vhi, 32) > 0)
+            memcpy(b, vhi, 32);
+        if (memcmp(a, b, 32) > 0 || pattern->num_ranges == DOGECOIN_VANITY_MAX_RANGES)
+            continue;
+        // the checksum makes the edges inexact, dogecoin_vanity_match encodes those
+        memcpy(pattern->lo[pattern->num_ranges], a + 8, sizeof(uint160));
+        memcpy(pattern->hi[pattern->num_ranges], b + 8, sizeof(uint160));
+        total += vanity_to_double(b + 8, sizeof(uint160)) - vanity_to_double(a + 8, sizeof(uint160)) + 1.0;
+        pattern->num_ranges++;
+    }
+    if (pattern->num_ranges == 0)
+        return false;
+    pattern->difficulty = vanity_to_double(vhi + 8, sizeof(uint160)) / total;
+    if (pattern->difficulty < 1.0)
+        pattern->difficulty = 1.0;
+    return true;
+}
+
+dogecoin_bool dogecoin_vanity_match(const dogecoin_vanity_pattern* pattern, const uint160 hash160) {
+    uint8_t payload[sizeof(uint160) + 1];
+    char address[64];
+    size_t i;
+
+    for (i = 0; i < pattern->num_ranges; i++) {
+        const int lo = memcmp(hash160, pattern->lo[i], sizeof(uint160));
+        const int hi = memcmp(hash160, pattern->hi[i], sizeof(uint160));
+        if (lo < 0 || hi > 0)
+            continue;
+        if (lo > 0 && hi < 0)
+            return true;
+        payload[0] = pattern->version;
+        memcpy(payload + 1, hash160, sizeof(uint160));
+        if (!dogecoin_base58_encode_check(payload, sizeof(payload), address, sizeof(address)))
+            return false;
+        return strncmp(address, pattern->prefix, strlen(pattern->prefix)) == 0;
+    }
+    return false;
+}
+
+static double vanity_now(void) {
+#ifdef _MSC_VER
+    return (double)time(NULL);
+#else
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (double)tv.tv_sec + (double)tv.tv_usec / 1e6;
+#endif
+}
+
+typedef struct vanity_search_ {
+    const dogecoin_vanity_pattern* pattern;
+    uint64_t max_keys;
+    dogecoin_vanity_progress_cb progress;
+    void* user_data;
+    double start;
+    double last_report;
+#ifdef HAVE_PTHREAD
+    pthread_mutex_t lock;
+#endif
+    uint64_t keys;
+    dogecoin_bool found;
+    uint8_t privkey[DOGECOIN_ECKEY_PKEY_LENGTH];
+} vanity_search;
+
+static void vanity_lock(vanity_search* search) {
+#ifdef HAVE_PTHREAD
+    pthread_mutex_lock(&search->lock);
+#else
+    (void)search;
+#endif
+}
+
+static void vanity_unlock(vanity_search* search) {
+#ifdef HAVE_PTHREAD
+    pthread_mutex_unlock(&search->lock);
+#else
+    (void)search;
+#endif
+}
+
+static void vanity_report(vanity_search* search, uint64_t keys, dogecoin_bool found) {
+    dogecoin_vanity_progress progress;
+    // half of the matches come within difficulty * ln(2) keys
+    const double median = search->pattern->difficulty * 0.6931471805599453;
+    progress.keys = keys;
+    progress.elapsed = vanity_now() - search->start;
+    progress.keys_per_sec = progress.elapsed > 0 ? (double)keys / progress.elapsed : 0;
+    progress.eta = progress.keys_per_sec > 0 && median > (double)keys ? (median - (double)keys) / progress.keys_per_sec : 0;
+    progress.found = found;
+    search->progress(&progress, search->user_data);
+}
+
+// a fresh random key with room for a whole batch after it
+static void vanity_random_base(uint8_t* privkey) {
+    dogecoin_key key;
+    uint8_t last[DOGECOIN_ECKEY_PKEY_LENGTH];
+    do {
+        dogecoin_privkey_gen(&key);
+        memcpy(last, key.privkey, sizeof(last));
+    } while (!dogecoin_ecc_private_key_add(last, VANITY_BATCH - 1));
+    memcpy(privkey, key.privkey, DOGECOIN_ECKEY_PKEY_LENGTH);
+    dogecoin_mem_zero(last, sizeof(last));
+    dogecoin_privkey_cleanse(&key);
+}
+
+typedef struct vanity_job_ {
+    vanity_search* search;
+    dogecoin_bool report; // the calling thread's job reports progress
+} vanity_job;
+
+static void* vanity_worker(void* arg) {
+    vanity_job* job = arg;
+    vanity_search* search = job->search;
+    uint8_t* pubkeys = dogecoin_malloc(VANITY_BATCH * DOGECOIN_ECKEY_COMPRESSED_LENGTH);
+    const unsigned char** data = dogecoin_malloc(VANITY_BATCH * sizeof(*data));
+    size_t* lens = dogecoin_malloc(VANITY_BATCH * sizeof(size_t));
+    uint160* hashes = dogecoin_malloc(VANITY_BATCH * sizeof(uint160));
+    uint8_t privkey[DOGECOIN_ECKEY_PKEY_LENGTH];
+    dogecoin_bool done = false;
+    uint64_t keys;
+    size_t i;
+
+    for (i = 0; i < VANITY_BATCH; i++) {
+        data[i] = pubkeys + i * DOGECOIN_ECKEY_COMPRESSED_LENGTH;
+        lens[i] = DOGECOIN_ECKEY_COMPRESSED_LENGTH;
+    }
+    vanity_random_base(privkey);
+    while (!done) {
+        // k, k + 1, ... by point addition, the prefix is checked on the hash160 without base58
+        if (!dogecoin_ecc_get_pubkey_sequence(privkey, VANITY_BATCH, pubkeys, true)) {
+            vanity_random_base(privkey);
+            continue;
+        }
+        dogecoin_hash160_batch(data, lens, VANITY_BATCH, hashes);
+        for (i = 0; i < VANITY_BATCH; i++) {
+            if (dogecoin_vanity_match(search->pattern, hashes[i]))
+                break;
+        }
+
+        vanity_lock(search);
+        if (i < VANITY_BATCH && !search->found) {
+            memcpy(search->privkey, privkey, sizeof(privkey));
+            dogecoin_ecc_private_key_add(search->privkey, i);
+            search->found = true;
+        }
+        search->keys += i < VANITY_BATCH ? i + 1 : VANITY_BATCH;
+        keys = search->keys;
+        done = search->found || (search->max_keys && keys >= search->max_keys);
+        vanity_unlock(search);
+
+        if (job->report && search->progress && !done && vanity_now() - search->last_report >= 1.0) {
+            search->last_report = vanity_now();
+            vanity_report(search, keys, false);
+        }
+        if (!dogecoin_ecc_private_key_add(privkey, VANITY_BATCH))
+            vanity_random_base(privkey);
+    }
+    dogecoin_mem_zero(privkey, sizeof(privkey));
+    dogecoin_free(hashes);
+    dogecoin_free(lens);
+    dogecoin_free(data);
+    dogecoin_free(pubkeys);
+    return NULL;
+}
+
+dogecoin_bool dogecoin_vanity_search(const dogecoin_vanity_pattern* pattern, unsigned int num_threads, uint64_t max_keys, dogecoin_vanity_progress_cb progress, void* user_data, dogecoin_key* key_out) {
+    vanity_search search;
+    vanity_job* jobs;
+    unsigned int i, started = 1;
+
+    if (!pattern || pattern->num_ranges == 0 || !key_out)
+        return false;
+    if (num_threads < 1)
+        num_threads = 1;
+    memset(&search, 0, sizeof(search));
+    search.pattern = pattern;
+    search.max_keys = max_keys;
+    search.progress = progress;
+    search.user_data = user_data;
+    search.start = search.last_report = vanity_now();
+    jobs = dogecoin_calloc(num_threads, sizeof(vanity_job));
+    for (i = 0; i < num_threads; i++) {
+        jobs[i].search = &search;
+        jobs[i].report = i == 0;
+    }
+#ifdef HAVE_PTHREAD
+    pthread_mutex_init(&search.lock, NULL);
+    pthread_t* threads = dogecoin_calloc(num_threads, sizeof(pthread_t));
+    for (started = 1; started < num_threads; started++) {
+        if (pthread_create(&threads[started], NULL, vanity_worker, &jobs[started]) != 0)
+            break;
+    }
+#endif
+    // the calling thread searches too, with fewer threads than asked for if some could not be started
+    vanity_worker(&jobs[0]);
+#ifdef HAVE_PTHREAD
+    for (i = 1; i < started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    dogecoin_free(threads);
+    pthread_mutex_destroy(&search.lock);
+#endif
+    dogecoin_free(jobs);
+
+    if (search.found) {
+        dogecoin_privkey_init(key_out);
+        memcpy(key_out->privkey, search.privkey, DOGECOIN_ECKEY_PKEY_LENGTH);
+    }
+    if (progress)
+        vanity_report(&search, search.keys, search.found);
+    dogecoin_mem_zero(search.privkey, sizeof(search.privkey));
+    return search.found;
+}
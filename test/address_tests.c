@@ -10,6 +10,9 @@
 #include <dogecoin/address.h>
 #include <dogecoin/crypto/base58.h>
 #include <dogecoin/chainparams.h>
+#include <dogecoin/crypto/ecc.h>
+#include <dogecoin/crypto/key.h>
+#include <dogecoin/mem.h>
 #include <dogecoin/utils.h>
 
 void test_address()
@@ -34,4 +37,80 @@ void test_address()
     char str[strsize];
     u_assert_int_eq(generateDerivedHDPubkey(masterkey, str), true)
 
+    // bulk keypairs are consecutive keys and match the single key path
+    const size_t n = 600;
+    char* wifs = dogecoin_malloc(n * KEYPAIR_WIF_LENGTH);
+    char* addrs = dogecoin_malloc(n * KEYPAIR_P2PKH_LENGTH);
+    unsigned int threads[2] = {1, 4};
+    size_t i, t;
+    for (t = 0; t < 2; t++) {
+        const dogecoin_chainparams* chain = t == 0 ? &dogecoin_chainparams_main : &dogecoin_chainparams_test;
+        uint8_t prev[DOGECOIN_ECKEY_PKEY_LENGTH];
+        u_assert_int_eq(generatePrivPubKeypairs(wifs, addrs, n, t == 1, threads[t]), true);
+        for (i = 0; i < n; i++) {
+            dogecoin_key key;
+            dogecoin_pubkey pubkey;
+            char addr[KEYPAIR_P2PKH_LENGTH];
+            u_assert_int_eq(strlen(wifs + i * KEYPAIR_WIF_LENGTH), KEYPAIR_WIF_LENGTH - 1);
+            u_assert_int_eq(dogecoin_privkey_decode_wif(wifs + i * KEYPAIR_WIF_LENGTH, chain, &key), true);
+            if (i > 0) {
+                u_assert_int_eq(dogecoin_ecc_private_key_add(prev, 1), true);
+                u_assert_mem_eq(key.privkey, prev, sizeof(prev));
+            }
+            memcpy(prev, key.privkey, sizeof(prev));
+            if (i < 3 || i % 97 == 0 || i == n - 1) {
+                dogecoin_pubkey_init(&pubkey);
+                dogecoin_pubkey_from_key(&key, &pubkey);
+                dogecoin_pubkey_getaddr_p2pkh(&pubkey, chain, addr);
+                u_assert_str_eq(addrs + i * KEYPAIR_P2PKH_LENGTH, addr);
+            }
+        }
+    }
+    // tweaked keys are not a sequence but still match their addresses
+    u_assert_int_eq(generatePrivPubKeypairsTweaked(wifs, addrs, n, false, 4), true);
+    for (i = 0; i < n; i++) {
+        dogecoin_key key, next;
+        dogecoin_pubkey pubkey;
+        char addr[KEYPAIR_P2PKH_LENGTH];
+        u_assert_int_eq(dogecoin_privkey_decode_wif(wifs + i * KEYPAIR_WIF_LENGTH, &dogecoin_chainparams_main, &key), true);
+        if (i + 1 < n) {
+            u_assert_int_eq(dogecoin_privkey_decode_wif(wifs + (i + 1) * KEYPAIR_WIF_LENGTH, &dogecoin_chainparams_main, &next), true);
+            u_assert_int_eq(dogecoin_ecc_private_key_add(key.privkey, 1), true);
+            u_assert_int_eq(memcmp(key.privkey, next.privkey, DOGECOIN_ECKEY_PKEY_LENGTH) != 0, true);
+            u_assert_int_eq(dogecoin_privkey_decode_wif(wifs + i * KEYPAIR_WIF_LENGTH, &dogecoin_chainparams_main, &key), true);
+        }
+        if (i < 3 || i % 97 == 0 || i == n - 1) {
+            dogecoin_pubkey_init(&pubkey);
+            dogecoin_pubkey_from_key(&key, &pubkey);
+            dogecoin_pubkey_getaddr_p2pkh(&pubkey, &dogecoin_chainparams_main, addr);
+            u_assert_str_eq(addrs + i * KEYPAIR_P2PKH_LENGTH, addr);
+        }
+    }
+    u_assert_int_eq(generatePrivPubKeypairs(wifs, NULL, n, false, 2), true);
+    u_assert_int_eq(generatePrivPubKeypairs(NULL, addrs, n, false, 2), true);
+    u_assert_int_eq(generatePrivPubKeypairs(NULL, NULL, 0, false, 2), true);
+    dogecoin_free(addrs);
+    dogecoin_free(wifs);
+
+    FILE* file = tmpfile();
+    u_assert_not_null(file);
+    u_assert_int_eq(generatePrivPubKeypairsToFile(file, 5, false, 1), true);
+    rewind(file);
+    char line[128];
+    for (i = 0; fgets(line, sizeof(line), file); i++) {
+        u_assert_int_eq(strlen(line), KEYPAIR_WIF_LENGTH + KEYPAIR_P2PKH_LENGTH);
+        u_assert_int_eq(line[KEYPAIR_WIF_LENGTH - 1], ' ');
+    }
+    u_assert_int_eq(i, 5);
+    fclose(file);
+    file = tmpfile();
+    u_assert_not_null(file);
+    u_assert_int_eq(generatePrivPubKeypairsTweakedToFile(file, 5, true, 1), true);
+    rewind(file);
+    for (i = 0; fgets(line, sizeof(line), file); i++) {
+        u_assert_int_eq(strlen(line), KEYPAIR_WIF_LENGTH + KEYPAIR_P2PKH_LENGTH);
+    }
+    u_assert_int_eq(i, 5);
+    fclose(file);
+    u_assert_int_eq(generatePrivPubKeypairsToFile(NULL, 5, false, 1), false);
 }
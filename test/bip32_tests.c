@@ -236,6 +236,36 @@ void test_bip32() {
     dogecoin_hdnode_serialize_public(&node4, &dogecoin_chainparams_test, str, sizeof(str));
     u_assert_str_eq(str, "tpubD8MQJFN9LVzG9L2CzDwdBRfnyvoJWr8zGR8UrAsMjq89BqGwLQihzyrMJVaMm1WE91LavvHKqfWtk6Ce5Rr8mdPEacB1R2Ln6mc92FNPihs");
 
+    // a range of children from one prepared parent chain code matches one-at-a-time derivation
+    dogecoin_hdnode children[20], child;
+    uint160 hash160s[20], hash160;
+    hmac_sha512_ctx chain_code_ctx;
+    uint32_t c;
+    hmac_sha512_prepare(&chain_code_ctx, node4.chain_code, DOGECOIN_BIP32_CHAINCODE_SIZE);
+    for (c = 0; c < 20; c++) {
+        memcpy(&children[c], &node4, sizeof(dogecoin_hdnode));
+        u_assert_int_eq(dogecoin_hdnode_public_ckd_ctx(&children[c], c, &chain_code_ctx), true);
+        memcpy(&child, &node4, sizeof(dogecoin_hdnode));
+        u_assert_int_eq(dogecoin_hdnode_public_ckd(&child, c), true);
+        u_assert_mem_eq(&children[c], &child, sizeof(dogecoin_hdnode));
+    }
+    hmac_sha512_ctx_cleanse(&chain_code_ctx);
+    dogecoin_hdnode_get_hash160_batch(children, 20, hash160s);
+    for (c = 0; c < 20; c++) {
+        dogecoin_hdnode_get_hash160(&children[c], hash160);
+        u_assert_mem_eq(hash160s[c], hash160, sizeof(hash160));
+    }
+
+    hmac_sha512_prepare(&chain_code_ctx, node.chain_code, DOGECOIN_BIP32_CHAINCODE_SIZE);
+    for (c = 0; c < 4; c++) {
+        memcpy(&children[c], &node, sizeof(dogecoin_hdnode));
+        u_assert_int_eq(dogecoin_hdnode_private_ckd_ctx(&children[c], c | (c & 1 ? 0x80000000 : 0), &chain_code_ctx), true);
+        memcpy(&child, &node, sizeof(dogecoin_hdnode));
+        u_assert_int_eq(dogecoin_hdnode_private_ckd(&child, c | (c & 1 ? 0x80000000 : 0)), true);
+        u_assert_mem_eq(&children[c], &child, sizeof(dogecoin_hdnode));
+    }
+    hmac_sha512_ctx_cleanse(&chain_code_ctx);
+
     dogecoin_hdnode *nodeheap;
     nodeheap = dogecoin_hdnode_new();
     dogecoin_hdnode *nodeheap_copy = dogecoin_hdnode_copy(nodeheap);
@@ -0,0 +1,122 @@
+/**********************************************************************
+ * Copyright (c) 2022 The Dogecoin Foundation                         *
+ * Distributed under the MIT software license, see the accompanying   *
+ * file COPYING or http://www.opensource.org/licenses/mit-license.php.*
+ **********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include <dogecoin/bip39.h>
+#include <dogecoin/crypto/sha2.h>
+#include <dogecoin/utils.h>
+
+struct bip39_test_v {
+    const char* entropy_hex;
+    const char* mnemonic;
+    const char* seed_hex; /* passphrase "TREZOR" */
+};
+
+static const struct bip39_test_v bip39_test_vectors[] = {
+    {"00000000000000000000000000000000",
+     "abandon abandon abandon abandon abandon abandon abandon abandon abandon abandon abandon about",
+     "c55257c360c07c72029aebc1b53c05ed0362ada38ead3e3e9efa3708e53495531f09a6987599d18264c1e1c92f2cf141630c7a3c4ab7c81b2f001698e7463b04"},
+    {"7f7f7f7f7f7f7f7f7f7f7f7f7f7f7f7f",
+     "legal winner thank year wave sausage worth useful legal winner thank yellow",
+     "2e8905819b8723fe2c1d161860e5ee1830318dbf49a83bd451cfb8440c28bd6fa457fe1296106559a3c80937a1c1069be3a3a5bd381ee6260e8d9739fce1f607"},
+    {"80808080808080808080808080808080",
+     "letter advice cage absurd amount doctor acoustic avoid letter advice cage above",
+     "d71de856f81a8acc65e6fc851a38d4d7ec216fd0796d0a6827a3ad6ed5511a30fa280f12eb2e47ed2ac03b5c462a0358d18d69fe4f985ec81778c1b370b652a8"},
+    {"ffffffffffffffffffffffffffffffff",
+     "zoo zoo zoo zoo zoo zoo zoo zoo zoo zoo zoo wrong",
+     "ac27495480225222079d7be181583751e86f571027b0497b5b5d11218e0a8a13332572917f0f8e5a589620c6f15b11c61dee327651a14c34e18231052e48c069"},
+    {"000000000000000000000000000000000000000000000000",
+     "abandon abandon abandon abandon abandon abandon abandon abandon abandon abandon abandon abandon abandon abandon abandon abandon abandon agent",
+     "035895f2f481b1b0f01fcf8c289c794660b289981a78f8106447707fdd9666ca06da5a9a565181599b79f53b844d8a71dd9f439c52a3d7b3e8a79c906ac845fa"},
+    {"8080808080808080808080808080808080808080",
+     "letter advice cage absurd amount doctor acoustic avoid letter advice cage absurd amount doctor accident",
+     "bc40a19ec918698b32e3e13ed906006d9e3b9987ba7dee6fc53a824774cc5be68f89b865bbfbac21b2fb99c016e214f54f239f77dd99881c1b81de275c60be3d"},
+    {"ffffffffffffffffffffffffffffffffffffffffffffffffffffffff",
+     "zoo zoo zoo zoo zoo zoo zoo zoo zoo zoo zoo zoo zoo zoo zoo zoo zoo zoo zoo zoo veteran",
+     "4aa0af4ca02ef1d9fa675cd02aa06d318425564e7fadd3d51b6165cc56d77398f28d8522073cd036c2a4a24a83e919211c84500d96cb120084e613ff5fcd96c1"},
+    {"0000000000000000000000000000000000000000000000000000000000000000",
+     "abandon abandon abandon abandon abandon abandon abandon abandon abandon abandon abandon abandon abandon abandon abandon abandon abandon abandon abandon abandon abandon abandon abandon art",
+     "bda85446c68413707090a52022edd26a1c9462295029f2e60cd7c4f2bbd3097170af7a4d73245cafa9c3cca8d561a7c3de6f5d4a10be8ed2a5e608d68f92fcc8"},
+    {"9e885d952ad362caeb4efe34a8e91bd2",
+     "ozone drill grab fiber curtain grace pudding thank cruise elder eight picnic",
+     "274ddc525802f7c828d8ef7ddbcdc5304e87ac3535913611fbbfa986d0c9e5476c91689f9c8a54fd55bd38606aa6a8595ad213d4c9c9f9aca3fb217069a41028"},
+    {"68a79eaca2324873eacc50cb9c6eca8cc68ea5d936f98787c60c7ebc74e6ce7c",
+     "hamster diagram private dutch cause delay private meat slide toddler razor book happy fancy gospel tennis maple dilemma loan word shrug inflict delay length",
+     "64c87cde7e12ecf6704ab95bb1408bef047c22db4cc7491c4271d170a1b213d20b385bc1588d9c7b38f1b39d415665b8a9030c9ec653d75e65f847d8fc1fc440"},
+};
+
+#define BIP39_TESTS (sizeof(bip39_test_vectors) / sizeof(bip39_test_vectors[0]))
+
+void test_bip39()
+{
+    char mnemonic[BIP39_MAX_MNEMONIC_LENGTH];
+    uint8_t entropy[32];
+    uint8_t seed[BIP39_SEED_LENGTH];
+    uint8_t seeds[BIP39_TESTS * BIP39_SEED_LENGTH];
+    const char* mnemonics[BIP39_TESTS];
+    const char* passphrases[BIP39_TESTS];
+    const unsigned int lanes[] = {1, 4, 8};
+    size_t entropy_len, i;
+    int outlen;
+
+    // the perfect hash finds every word and nothing else
+    for (i = 0; i < BIP39_WORDLIST_SIZE; i++) {
+        const char* word = dogecoin_bip39_wordlist_english[i];
+        assert(dogecoin_bip39_word_index(word, strlen(word)) == (int)i);
+    }
+    assert(dogecoin_bip39_word_index("abando", 6) == -1);
+    assert(dogecoin_bip39_word_index("abandons", 8) == -1);
+    assert(dogecoin_bip39_word_index("zooo", 4) == -1);
+    assert(dogecoin_bip39_word_index("xyz", 3) == -1);
+    assert(dogecoin_bip39_word_index("ab", 2) == -1);
+    assert(dogecoin_bip39_word_index("zoo zoo", 3) == 2047);
+
+    for (i = 0; i < BIP39_TESTS; i++) {
+        const struct bip39_test_v* v = &bip39_test_vectors[i];
+        uint8_t expected[32];
+        utils_hex_to_bin(v->entropy_hex, expected, strlen(v->entropy_hex), &outlen);
+        assert(dogecoin_bip39_mnemonic_from_entropy(expected, outlen, mnemonic, sizeof(mnemonic)));
+        assert(strcmp(mnemonic, v->mnemonic) == 0);
+        assert(dogecoin_bip39_mnemonic_to_entropy(v->mnemonic, entropy, &entropy_len));
+        assert(entropy_len == (size_t)outlen);
+        assert(memcmp(entropy, expected, entropy_len) == 0);
+        assert(dogecoin_bip39_mnemonic_check(v->mnemonic));
+        dogecoin_bip39_seed_from_mnemonic(v->mnemonic, "TREZOR", seed);
+        assert(memcmp(seed, utils_hex_to_uint8(v->seed_hex), BIP39_SEED_LENGTH) == 0);
+        mnemonics[i] = v->mnemonic;
+        passphrases[i] = "TREZOR";
+    }
+
+    // bulk restore on every lane width, the vectors do not fill the last group
+    for (i = 0; i < sizeof(lanes) / sizeof(lanes[0]); i++) {
+        size_t j;
+        if (!sha512_set_batch_lanes(lanes[i]))
+            continue;
+        memset(seeds, 0, sizeof(seeds));
+        dogecoin_bip39_seeds_from_mnemonics(mnemonics, passphrases, BIP39_TESTS, seeds);
+        for (j = 0; j < BIP39_TESTS; j++) {
+            assert(memcmp(seeds + j * BIP39_SEED_LENGTH, utils_hex_to_uint8(bip39_test_vectors[j].seed_hex), BIP39_SEED_LENGTH) == 0);
+        }
+    }
+    sha512_autodetect();
+    dogecoin_bip39_seeds_from_mnemonics(mnemonics, NULL, 1, seeds);
+    dogecoin_bip39_seed_from_mnemonic(mnemonics[0], "", seed);
+    assert(memcmp(seeds, seed, BIP39_SEED_LENGTH) == 0);
+
+    // checksum, word count, spacing and unknown words
+    assert(!dogecoin_bip39_mnemonic_check("abandon abandon abandon abandon abandon abandon abandon abandon abandon abandon abandon abandon"));
+    assert(!dogecoin_bip39_mnemonic_check("abandon abandon abandon abandon abandon abandon abandon abandon abandon abandon about"));
+    assert(!dogecoin_bip39_mnemonic_check("abandon abandon abandon abandon abandon abandon abandon abandon abandon abandon abandon  about"));
+    assert(!dogecoin_bip39_mnemonic_check("abandon abandon abandon abandon abandon abandon abandon abandon abandon abandon abandon about "));
+    assert(!dogecoin_bip39_mnemonic_check("abandon abandon abandon abandon abandon abandon abandon abandon abandon abandon abandon abouts"));
+    assert(!dogecoin_bip39_mnemonic_check(""));
+    assert(!dogecoin_bip39_mnemonic_from_entropy(entropy, 15, mnemonic, sizeof(mnemonic)));
+    assert(!dogecoin_bip39_mnemonic_from_entropy(entropy, 16, mnemonic, 20));
+}
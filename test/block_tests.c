@@ -0,0 +1,207 @@
+/**********************************************************************
+ * Copyright (c) 2022 The Dogecoin Foundation                         *
+ * Distributed under the MIT software license, see the accompanying   *
+ * file COPYING or http://www.opensource.org/licenses/mit-license.php.*
+ **********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include <test/utest.h>
+
+#include <dogecoin/block.h>
+#include <dogecoin/cstr.h>
+#include <dogecoin/serialize.h>
+#include <dogecoin/tx.h>
+#include <dogecoin/utils.h>
+
+static const char* genesis_block_hex = "010000000000000000000000000000000000000000000000000000000000000000000000696ad20e2dd4365c7459b4a4a5af743d5e92c6da3229e6532cd605f6533f2a5b24a6a152f0ff0f1e678601000101000000010000000000000000000000000000000000000000000000000000000000000000ffffffff1004ffff001d0104084e696e746f6e646fffffffff010058850c020000004341040184710fa689ad5023690c80f3a49c8f13f8d45b8c857fbcbc8bc4a8e4d3eb4b10f4d4604fa08dce601aaf0f470216fe1b51850b4acf21b179c45070ac7b03a9ac00000000";
+
+static const char* block_txs_hex[] = {
+    "01000000010001000000000000000000000000000000000000000000000000000000000000000000006a473044022067288ea50aa799543a536ff9306f8e1cba05b9c6b10951175b924f96732555ed022026d7b5265f38d21541519e4a1e55044d5b9e17e15cdbaf29ae3792e99e883e7a012103ba8c8b86dea131c22ab967e6dd99bdae8eff7a1f75a2c35f1f944109e3fe5e22ffffffff010000000000000000015100000000",
+    "02000000027409797c31feecc4e69b51c58b477b72c53355743a6f6124f9d78221672df3700100000000ffffffff6e1709c1e2bdd85aed24dccfd48293993617f249d4d4381296a9c914be3e85e60100000000ffffffff01c07fdc0b0000000017a914ba277fd56b69177464fcb6a27a530f03740345ed8700000000",
+    "01000000023d6cf972d4dff9c519eff407ea800361dd0a121de1da8b6f4138a2f25de864b40000000000ffffffff21ebc9ba20594737864352e95b727f1a565756f9d365083eb1a8596ec98c97b7010000001976a914bef80ecf3a44500fda1bc92176e442891662aed288acffffffff01f0da5200000000001976a914857ccd42dded6df32949d4646dfa10a92458cfaa88ac00000000",
+    "01000000010001000000000000000000000000000000000000000000000000000000000000000000001a76a9145b6462475454710f3c22f5fdf0b40704c92f25c388ad51ffffffff010000000000000000015100000000",
+};
+
+static void hex_to_cstr(cstring* s, const char* hex) {
+    uint8_t buf[strlen(hex) / 2];
+    int outlen;
+    utils_hex_to_bin(hex, buf, strlen(hex), &outlen);
+    cstr_append_buf(s, buf, outlen);
+}
+
+// reference merkle root, straight from the definition, hashes needs room for n + 1 entries
+static void merkle_root_reference(uint256* hashes, size_t n, uint256 root) {
+    while (n > 1) {
+        size_t i;
+        if (n & 1) {
+            memcpy(hashes[n], hashes[n - 1], sizeof(uint256));
+            n++;
+        }
+        for (i = 0; i < n / 2; i++) {
+            uint8_t pair[64];
+            memcpy(pair, hashes[2 * i], 32);
+            memcpy(pair + 32, hashes[2 * i + 1], 32);
+            dogecoin_hash(pair, sizeof(pair), hashes[i]);
+        }
+        n /= 2;
+    }
+    memcpy(root, hashes[0], sizeof(uint256));
+}
+
+void test_block_genesis() {
+    uint8_t data[strlen(genesis_block_hex) / 2];
+    int outlen;
+    utils_hex_to_bin(genesis_block_hex, data, strlen(genesis_block_hex), &outlen);
+
+    dogecoin_block* block = dogecoin_block_new();
+    size_t consumed = 0;
+    u_assert_int_eq(dogecoin_block_deserialize(data, outlen, block, &consumed, 0), true);
+    u_assert_int_eq(consumed, (size_t)outlen);
+    u_assert_int_eq(block->txs->len, 1);
+    u_assert_is_null(block->auxpow);
+    u_assert_int_eq(block->header.timestamp, 1386325540);
+    u_assert_int_eq(block->header.bits, 0x1e0ffff0);
+    u_assert_int_eq(block->header.nonce, 99943);
+    u_assert_int_eq(dogecoin_block_check_merkle_root(block), true);
+
+    uint256 hash;
+    char hexbuf[sizeof(hash) * 2 + 1];
+    dogecoin_block_header_hash(&block->header, hash);
+    utils_bin_to_hex(hash, sizeof(hash), hexbuf);
+    utils_reverse_hex(hexbuf, sizeof(hash) * 2);
+    u_assert_str_eq(hexbuf, "1a91e3dace36e2be3bf030a65679fe821aa1d6ef92e7c9902eb318182c355691");
+    utils_bin_to_hex(block->txids[0], sizeof(hash), hexbuf);
+    utils_reverse_hex(hexbuf, sizeof(hash) * 2);
+    u_assert_str_eq(hexbuf, "5b2a3f53f605d62c53e62932dac6925e3d74afa5a4b459745c36d42d0ed26a69");
+
+    // scrypt proof of work of the genesis header meets its own target, a tighter one fails
+    dogecoin_block_header_pow_hash(&block->header, hash);
+    utils_bin_to_hex(hash, sizeof(hash), hexbuf);
+    utils_reverse_hex(hexbuf, sizeof(hash) * 2);
+    u_assert_str_eq(hexbuf, "0000026f3f7874ca0c251314eaed2d2fcf83d7da3acfaacf59417d485310b448");
+    u_assert_int_eq(dogecoin_block_header_check_pow(&block->header, hash), true);
+    dogecoin_block_header tight = block->header;
+    tight.bits = 0x1e00ffff;
+    u_assert_int_eq(dogecoin_block_header_check_pow(&tight, hash), false);
+    tight.bits = 0x1e8ffff0;
+    u_assert_int_eq(dogecoin_block_header_check_pow(&tight, hash), false);
+    dogecoin_block_header headers[2] = {block->header, block->header};
+    uint256 hashes[2];
+    dogecoin_block_header_pow_hash_batch(headers, 2, hashes);
+    u_assert_mem_eq(hashes[1], hash, sizeof(hash));
+
+    cstring* s = cstr_new_sz(DOGECOIN_BLOCK_HEADER_SIZE);
+    dogecoin_block_header_serialize(s, &block->header);
+    u_assert_int_eq(s->len, DOGECOIN_BLOCK_HEADER_SIZE);
+    u_assert_mem_eq(s->str, data, DOGECOIN_BLOCK_HEADER_SIZE);
+    cstr_free(s, true);
+    dogecoin_block_free(block);
+
+    // truncated blocks are rejected
+    block = dogecoin_block_new();
+    u_assert_int_eq(dogecoin_block_deserialize(data, outlen - 1, block, NULL, 0), false);
+    dogecoin_block_free(block);
+}
+
+void test_block_parse() {
+    const size_t num_txs = sizeof(block_txs_hex) / sizeof(block_txs_hex[0]);
+    uint256 txids[sizeof(block_txs_hex) / sizeof(block_txs_hex[0])];
+    uint256 root;
+    unsigned int threads[3] = {1, 2, 16};
+    size_t i, t;
+
+    // expected txids from the single tx code path
+    cstring* txs = cstr_new_sz(1024);
+    for (i = 0; i < num_txs; i++) {
+        uint8_t tx_data[strlen(block_txs_hex[i]) / 2];
+        int outlen;
+        utils_hex_to_bin(block_txs_hex[i], tx_data, strlen(block_txs_hex[i]), &outlen);
+        dogecoin_tx* tx = dogecoin_tx_new();
+        dogecoin_tx_deserialize(tx_data, outlen, tx, NULL, true);
+        dogecoin_tx_hash(tx, txids[i]);
+        dogecoin_tx_free(tx);
+        hex_to_cstr(txs, block_txs_hex[i]);
+    }
+    uint256 scratch[sizeof(block_txs_hex) / sizeof(block_txs_hex[0]) + 1];
+    memcpy(scratch, txids, num_txs * sizeof(uint256));
+    merkle_root_reference(scratch, num_txs, root);
+
+    dogecoin_block_header header;
+    memset(&header, 0, sizeof(header));
+    header.version = 4 | DOGECOIN_BLOCK_VERSION_AUXPOW;
+    memcpy(header.merkle_root, root, sizeof(root));
+
+    // synthetic auxpow: parent coinbase, block hash, one branch hash, index, empty chain branch, index, parent header
+    cstring* auxpow = cstr_new_sz(256);
+    uint8_t zero[DOGECOIN_BLOCK_HEADER_SIZE];
+    memset(zero, 0, sizeof(zero));
+    hex_to_cstr(auxpow, block_txs_hex[0]);
+    ser_u256(auxpow, zero);
+    ser_varlen(auxpow, 1);
+    ser_u256(auxpow, zero);
+    ser_u32(auxpow, 0);
+    ser_varlen(auxpow, 0);
+    ser_u32(auxpow, 0);
+    ser_bytes(auxpow, zero, DOGECOIN_BLOCK_HEADER_SIZE);
+
+    cstring* raw = cstr_new_sz(2048);
+    dogecoin_block_header_serialize(raw, &header);
+    cstr_append_cstr(raw, auxpow);
+    ser_varlen(raw, num_txs);
+    cstr_append_cstr(raw, txs);
+
+    for (t = 0; t < sizeof(threads) / sizeof(threads[0]); t++) {
+        dogecoin_block* block = dogecoin_block_new();
+        size_t consumed = 0;
+        u_assert_int_eq(dogecoin_block_deserialize((const unsigned char*)raw->str, raw->len, block, &consumed, threads[t]), true);
+        u_assert_int_eq(consumed, raw->len);
+        u_assert_int_eq(block->txs->len, num_txs);
+        u_assert_int_eq(block->auxpow->len, auxpow->len);
+        for (i = 0; i < num_txs; i++) {
+            u_assert_mem_eq(block->txids[i], txids[i], sizeof(uint256));
+        }
+        u_assert_mem_eq(block->merkle_root, root, sizeof(root));
+        u_assert_int_eq(dogecoin_block_check_merkle_root(block), true);
+        dogecoin_block_free(block);
+    }
+
+    // a header committing to a different root is reported
+    raw->str[36] ^= 1;
+    dogecoin_block* block = dogecoin_block_new();
+    u_assert_int_eq(dogecoin_block_deserialize((const unsigned char*)raw->str, raw->len, block, NULL, 2), true);
+    u_assert_int_eq(dogecoin_block_check_merkle_root(block), false);
+
+    // deserializing again into the same block replaces its content instead of appending
+    raw->str[36] ^= 1;
+    u_assert_int_eq(dogecoin_block_deserialize((const unsigned char*)raw->str, raw->len, block, NULL, 2), true);
+    u_assert_int_eq(block->txs->len, num_txs);
+    u_assert_int_eq(block->auxpow->len, auxpow->len);
+    u_assert_int_eq(dogecoin_block_check_merkle_root(block), true);
+    uint8_t genesis[strlen(genesis_block_hex) / 2];
+    int genesis_len;
+    utils_hex_to_bin(genesis_block_hex, genesis, strlen(genesis_block_hex), &genesis_len);
+    u_assert_int_eq(dogecoin_block_deserialize(genesis, genesis_len, block, NULL, 0), true);
+    u_assert_int_eq(block->txs->len, 1);
+    u_assert_is_null(block->auxpow);
+    u_assert_int_eq(dogecoin_block_check_merkle_root(block), true);
+    dogecoin_block_free(block);
+
+    // duplicating the last tx of an odd list keeps the root but marks the tree as mutated
+    dogecoin_bool mutated = false;
+    uint256 root_mutated;
+    dogecoin_block_merkle_root((const uint256*)txids, num_txs - 1, root_mutated, &mutated);
+    u_assert_int_eq(mutated, false);
+    dogecoin_block_merkle_root((const uint256*)txids, num_txs - 1, root, NULL);
+    memcpy(txids[num_txs - 1], txids[num_txs - 2], sizeof(uint256));
+    dogecoin_block_merkle_root((const uint256*)txids, num_txs, root_mutated, &mutated);
+    u_assert_int_eq(mutated, true);
+    u_assert_mem_eq(root_mutated, root, sizeof(root));
+
+    cstr_free(auxpow, true);
+    cstr_free(raw, true);
+    cstr_free(txs, true);
+}
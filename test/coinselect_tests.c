@@ -0,0 +1,129 @@
+/**********************************************************************
+ * Copyright (c) 2022 The Dogecoin Foundation                         *
+ * Distributed under the MIT software license, see the accompanying   *
+ * file COPYING or http://www.opensource.org/licenses/mit-license.php.*
+ **********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include <test/utest.h>
+
+#include <dogecoin/coinselect.h>
+#include <dogecoin/cstr.h>
+#include <dogecoin/mem.h>
+#include <dogecoin/utils.h>
+
+#define COIN 100000000LL
+
+static cstring* script_from_hex(const char* hex) {
+    uint8_t buf[strlen(hex) / 2];
+    int outlen;
+    utils_hex_to_bin(hex, buf, strlen(hex), &outlen);
+    return cstr_new_buf(buf, outlen);
+}
+
+// selected value must pay for target, fee and change, indices ascending
+static void check_result(const dogecoin_coinselect_result* result, const dogecoin_utxo* utxos, int64_t target) {
+    int64_t value = 0;
+    size_t i;
+    for (i = 0; i < result->count; i++) {
+        if (i > 0)
+            u_assert_int_eq(result->selected[i - 1] < result->selected[i], true);
+        value += utxos[result->selected[i]].value;
+    }
+    u_assert_int_eq(value, result->value);
+    u_assert_int_eq(result->value, target + result->fee + result->change);
+    u_assert_int_eq(result->fee >= 0, true);
+    u_assert_int_eq(result->change == 0 || result->change >= DOGECOIN_COINSELECT_MIN_CHANGE, true);
+}
+
+void test_coinselect() {
+    enum dogecoin_tx_out_type type;
+
+    u_assert_int_eq(dogecoin_coinselect_input_size(DOGECOIN_TX_PUBKEYHASH), 148);
+    u_assert_int_eq(dogecoin_coinselect_input_size(DOGECOIN_TX_PUBKEY), 114);
+    u_assert_int_eq(dogecoin_coinselect_input_size(DOGECOIN_TX_SCRIPTHASH), 91);
+    u_assert_int_eq(dogecoin_coinselect_input_size(DOGECOIN_TX_WITNESS_V0_PUBKEYHASH), 68);
+
+    cstring* p2pkh = script_from_hex("76a914bef80ecf3a44500fda1bc92176e442891662aed288ac");
+    u_assert_int_eq(dogecoin_coinselect_script_input_size(p2pkh, &type), 148);
+    u_assert_int_eq(type, DOGECOIN_TX_PUBKEYHASH);
+    cstr_free(p2pkh, true);
+
+    // 2 of 3 bare multisig: OP_0 and two signatures
+    cstring* multisig = script_from_hex("522103ba8c8b86dea131c22ab967e6dd99bdae8eff7a1f75a2c35f1f944109e3fe5e222103ba8c8b86dea131c22ab967e6dd99bdae8eff7a1f75a2c35f1f944109e3fe5e222103ba8c8b86dea131c22ab967e6dd99bdae8eff7a1f75a2c35f1f944109e3fe5e2253ae");
+    u_assert_int_eq(dogecoin_coinselect_script_input_size(multisig, &type), 40 + 1 + 1 + 2 * 73);
+    u_assert_int_eq(type, DOGECOIN_TX_MULTISIG);
+    cstr_free(multisig, true);
+
+    dogecoin_utxo utxos[6];
+    const int64_t values[6] = {1 * COIN, 2 * COIN, 3 * COIN, 5 * COIN, 7 * COIN, 20 * COIN};
+    size_t i;
+    memset(utxos, 0, sizeof(utxos));
+    for (i = 0; i < 6; i++) {
+        utxos[i].outpoint.n = (uint32_t)i;
+        utxos[i].value = values[i];
+        utxos[i].script_type = DOGECOIN_TX_PUBKEYHASH;
+    }
+
+    // without fees there is an exact match, no change output
+    dogecoin_coinselect_result* result = dogecoin_coinselect(utxos, 6, 10 * COIN, 0);
+    u_assert_not_null(result);
+    u_assert_int_eq(result->algo, DOGECOIN_COINSELECT_BNB);
+    u_assert_int_eq(result->value, 10 * COIN);
+    u_assert_int_eq(result->change, 0);
+    u_assert_int_eq(result->fee, 0);
+    check_result(result, utxos, 10 * COIN);
+    dogecoin_coinselect_result_free(result);
+
+    // with 1 DOGE/kb only value - 0.148 DOGE per input counts, no exact match left
+    result = dogecoin_coinselect(utxos, 6, 4 * COIN, COIN);
+    u_assert_not_null(result);
+    u_assert_int_eq(result->algo != DOGECOIN_COINSELECT_BNB, true);
+    u_assert_int_eq(result->change > 0, true);
+    check_result(result, utxos, 4 * COIN);
+    dogecoin_coinselect_result_free(result);
+
+    // a match within the cost of change drops the excess to the fee
+    result = dogecoin_coinselect(utxos, 6, 5 * COIN - 14800000 - 1000000, COIN);
+    u_assert_not_null(result);
+    u_assert_int_eq(result->algo, DOGECOIN_COINSELECT_BNB);
+    u_assert_int_eq(result->count, 1);
+    u_assert_int_eq(result->selected[0], 3);
+    u_assert_int_eq(result->change, 0);
+    check_result(result, utxos, 5 * COIN - 14800000 - 1000000);
+    dogecoin_coinselect_result_free(result);
+
+    // insufficient funds, and utxos worth less than their input fee are ignored
+    u_assert_is_null(dogecoin_coinselect(utxos, 6, 39 * COIN, 0));
+    u_assert_is_null(dogecoin_coinselect(utxos, 6, 38 * COIN, COIN));
+    u_assert_is_null(dogecoin_coinselect(utxos, 1, COIN / 2, 10 * COIN));
+}
+
+void test_coinselect_large() {
+    const size_t num_utxos = 100000;
+    dogecoin_utxo* utxos = dogecoin_calloc(num_utxos, sizeof(dogecoin_utxo));
+    uint64_t seed = 42;
+    size_t i;
+    for (i = 0; i < num_utxos; i++) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        utxos[i].outpoint.n = (uint32_t)i;
+        utxos[i].value = (int64_t)((seed >> 11) % (1000 * COIN)) + COIN / 100;
+        utxos[i].script_type = (i & 1) ? DOGECOIN_TX_PUBKEYHASH : DOGECOIN_TX_WITNESS_V0_PUBKEYHASH;
+    }
+
+    const int64_t targets[3] = {COIN / 2, 12345 * COIN + 6789, 4000000 * COIN};
+    for (i = 0; i < 3; i++) {
+        dogecoin_coinselect_result* result = dogecoin_coinselect(utxos, num_utxos, targets[i], COIN / 100);
+        u_assert_not_null(result);
+        check_result(result, utxos, targets[i]);
+        dogecoin_coinselect_result_free(result);
+    }
+
+    // the whole set can not pay for an absurd target
+    u_assert_is_null(dogecoin_coinselect(utxos, num_utxos, 1000000000 * COIN, COIN / 100));
+    dogecoin_free(utxos);
+}
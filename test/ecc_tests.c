@@ -6,11 +6,19 @@
  * file COPYING or http://www.opensource.org/licenses/mit-license.php.*
  **********************************************************************/
 
+#ifdef HAVE_CONFIG_H
+#  include <src/libdogecoin-config.h>
+#endif
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
 
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
 #include <test/utest.h>
 
 #include <dogecoin/crypto/ecc.h>
@@ -18,6 +26,32 @@
 #include <dogecoin/crypto/random.h>
 #include <dogecoin/utils.h>
 
+// sign and verify on the thread's own context, and on an explicit one if given
+static void* ecc_test_sign_worker(void* arg) {
+    dogecoin_ecc_ctx* ctx = arg;
+    uint8_t privkey[32], pubkey[33], hash[32];
+    unsigned char sig[74];
+    size_t siglen, publen;
+    int i;
+    for (i = 0; i < 16; i++) {
+        memset(privkey, i + 1, sizeof(privkey));
+        memset(hash, i, sizeof(hash));
+        publen = sizeof(pubkey);
+        dogecoin_ecc_get_pubkey(privkey, pubkey, &publen, true);
+        siglen = sizeof(sig);
+        if (ctx) {
+            assert(dogecoin_ecc_sign_ctx(ctx, privkey, hash, sig, &siglen));
+            assert(dogecoin_ecc_verify_sig_ctx(ctx, pubkey, true, hash, sig, siglen));
+        } else {
+            assert(dogecoin_ecc_sign(privkey, hash, sig, &siglen));
+        }
+        assert(dogecoin_ecc_verify_sig(pubkey, true, hash, sig, siglen));
+        hash[0] ^= 1;
+        assert(!dogecoin_ecc_verify_sig(pubkey, true, hash, sig, siglen));
+    }
+    return NULL;
+}
+
 void test_ecc() {
     unsigned char r_buf[32];
     memset(r_buf, 0, 32);
@@ -49,4 +83,196 @@ void test_ecc() {
     u_assert_int_eq(dogecoin_ecc_compact_to_der_normalized(sigcomp, sigder, &sigderlen),  true);
     u_assert_int_eq(outlen, sigderlen);
     u_assert_int_eq(memcmp(sig,sigder,sigderlen), 0);
+
+    // parsed pubkey cache: a repeated key hits, an invalid one is never cached and
+    // a cached key does not verify someone else's signature
+    uint64_t hits, misses;
+    dogecoin_pubkey pubkeys[12];
+    unsigned char sigs[12][74];
+    size_t siglens[12];
+    size_t i;
+    u_assert_int_eq(dogecoin_ecc_pubkey_cache_resize(8), true);
+    u_assert_int_eq(dogecoin_ecc_pubkey_cache_size(), 8);
+    for (i = 0; i < 12; i++) {
+        dogecoin_privkey_gen(&key);
+        dogecoin_pubkey_init(&pubkeys[i]);
+        dogecoin_pubkey_from_key(&key, &pubkeys[i]);
+        siglens[i] = 74;
+        dogecoin_key_sign_hash(&key, hash, sigs[i], &siglens[i]);
+    }
+    u_assert_int_eq(dogecoin_pubkey_verify_sig(&pubkeys[0], hash, sigs[0], siglens[0]), true);
+    u_assert_int_eq(dogecoin_pubkey_verify_sig(&pubkeys[0], hash, sigs[0], siglens[0]), true);
+    u_assert_int_eq(dogecoin_pubkey_verify_sig(&pubkeys[0], hash, sigs[1], siglens[1]), false);
+    dogecoin_ecc_pubkey_cache_stats(&hits, &misses);
+    u_assert_int_eq(hits, 2);
+    u_assert_int_eq(misses, 1);
+    u_assert_int_eq(dogecoin_ecc_verify_sig(pub_key33_invalid, true, hash, sigs[0], siglens[0]), false);
+    u_assert_int_eq(dogecoin_ecc_verify_sig(pub_key33_invalid, true, hash, sigs[0], siglens[0]), false);
+    dogecoin_ecc_pubkey_cache_stats(&hits, &misses);
+    u_assert_int_eq(hits, 2);
+    u_assert_int_eq(misses, 3);
+    // more keys than entries, evicted keys are parsed again
+    for (i = 0; i < 3 * 12; i++) {
+        u_assert_int_eq(dogecoin_pubkey_verify_sig(&pubkeys[i % 12], hash, sigs[i % 12], siglens[i % 12]), true);
+        u_assert_int_eq(dogecoin_pubkey_verify_sig(&pubkeys[i % 12], hash, sigs[(i + 1) % 12], siglens[(i + 1) % 12]), false);
+    }
+    dogecoin_ecc_pubkey_cache_stats(&hits, &misses);
+    u_assert_int_eq(hits + misses, 5 + 2 * 3 * 12);
+    // disabled, nothing is counted
+    u_assert_int_eq(dogecoin_ecc_pubkey_cache_resize(0), true);
+    u_assert_int_eq(dogecoin_pubkey_verify_sig(&pubkeys[0], hash, sigs[0], siglens[0]), true);
+    dogecoin_ecc_pubkey_cache_stats(&hits, &misses);
+    u_assert_int_eq(hits + misses, 0);
+    u_assert_int_eq(dogecoin_ecc_pubkey_cache_resize(DOGECOIN_ECC_PUBKEY_CACHE_DEFAULT_ENTRIES), true);
+    dogecoin_privkey_cleanse(&key);
+
+    // explicit contexts give the same rfc6979 signatures as the thread's context
+    dogecoin_ecc_ctx* ctx = dogecoin_ecc_ctx_new();
+    u_assert_not_null(ctx);
+    u_assert_int_eq(dogecoin_ecc_thread_ctx() == dogecoin_ecc_thread_ctx(), true);
+    u_assert_int_eq(dogecoin_ecc_thread_ctx() != ctx, true);
+    uint8_t sigcomp_ctx[64], sigrec[64], sigrec_ctx[64];
+    size_t complen = sizeof(sigcomp_ctx), reclen = sizeof(sigrec);
+    int recid_ctx, recid;
+    memset(r_buf, 0x11, 32);
+    sigderlen = sizeof(sigder);
+    u_assert_int_eq(dogecoin_ecc_sign_ctx(ctx, r_buf, hash, sigder, &sigderlen), true);
+    outlen = sizeof(sig);
+    u_assert_int_eq(dogecoin_ecc_sign(r_buf, hash, sig, &outlen), true);
+    u_assert_int_eq(outlen, sigderlen);
+    u_assert_mem_eq(sig, sigder, outlen);
+    u_assert_int_eq(dogecoin_ecc_sign_compact_ctx(ctx, r_buf, hash, sigcomp_ctx, &complen), true);
+    u_assert_int_eq(dogecoin_ecc_sign_compact(r_buf, hash, sigcomp, &complen), true);
+    u_assert_mem_eq(sigcomp, sigcomp_ctx, 64);
+    u_assert_int_eq(dogecoin_ecc_sign_compact_recoverable_ctx(ctx, r_buf, hash, sigrec_ctx, &reclen, &recid_ctx), true);
+    u_assert_int_eq(dogecoin_ecc_sign_compact_recoverable(r_buf, hash, sigrec, &reclen, &recid), true);
+    u_assert_int_eq(recid, recid_ctx);
+    u_assert_mem_eq(sigrec, sigrec_ctx, 64);
+
+#ifdef HAVE_PTHREAD
+    // workers without a context of their own get one on first use, the others share nothing
+    pthread_t workers[4];
+    dogecoin_ecc_ctx* worker_ctx[4] = {NULL, ctx, NULL, NULL};
+    unsigned int started;
+    worker_ctx[3] = dogecoin_ecc_ctx_new();
+    for (started = 0; started < 4; started++) {
+        if (pthread_create(&workers[started], NULL, ecc_test_sign_worker, worker_ctx[started]) != 0)
+            break;
+    }
+    while (started > 0) {
+        pthread_join(workers[--started], NULL);
+    }
+    dogecoin_ecc_ctx_free(worker_ctx[3]);
+#endif
+    ecc_test_sign_worker(NULL);
+    dogecoin_ecc_ctx_free(ctx);
+
+    // private seqkey increments stop below the group order
+    uint8_t seqkey[32];
+    int hexlen;
+    utils_hex_to_bin("fffffffffffffffffffffffffffffffebaaedce6af48a03bbfd25e8cd0364140", seqkey, 64, &hexlen);
+    u_assert_int_eq(dogecoin_ecc_private_key_add(seqkey, 1), false);
+    u_assert_int_eq(seqkey[31], 0x40);
+    u_assert_int_eq(dogecoin_ecc_private_key_add(seqkey, 0), true);
+    memset(seqkey, 0, sizeof(seqkey));
+    seqkey[31] = 0xff;
+    u_assert_int_eq(dogecoin_ecc_private_key_add(seqkey, 0x1234), true);
+    u_assert_int_eq(seqkey[30], 0x13);
+    u_assert_int_eq(seqkey[31], 0x33);
+    u_assert_int_eq(dogecoin_ecc_get_pubkey_sequence(seqkey, 0, NULL, true), true);
+
+    // pubkeys of k, k + 1, ... by point addition match the scalar multiplication of each seqkey,
+    // 1100 keys cross one batch boundary
+    uint8_t* seq = malloc(1100 * 65);
+    uint8_t expected[65];
+    size_t c, seqlen;
+    dogecoin_random_bytes(seqkey, sizeof(seqkey), 0);
+    seqkey[0] &= 0x7f;
+    for (c = 0; c < 2; c++) {
+        const dogecoin_bool compressed = c == 0;
+        const size_t step = compressed ? 33 : 65;
+        size_t j;
+        uint8_t k[32];
+        memcpy(k, seqkey, sizeof(k));
+        u_assert_int_eq(dogecoin_ecc_get_pubkey_sequence(seqkey, 1100, seq, compressed), true);
+        for (j = 0; j < 1100; j += (j < 4 || j > 1020 ? 1 : 97)) {
+            memcpy(k, seqkey, sizeof(k));
+            u_assert_int_eq(dogecoin_ecc_private_key_add(k, j), true);
+            seqlen = step;
+            dogecoin_ecc_get_pubkey(k, expected, &seqlen, compressed);
+            u_assert_mem_eq(seq + j * step, expected, step);
+        }
+    }
+    utils_hex_to_bin("fffffffffffffffffffffffffffffffebaaedce6af48a03bbfd25e8cd0364139", seqkey, 64, &hexlen);
+    u_assert_int_eq(dogecoin_ecc_get_pubkey_sequence(seqkey, 8, seq, true), true);
+    u_assert_int_eq(dogecoin_ecc_get_pubkey_sequence(seqkey, 9, seq, true), false);
+    free(seq);
+}
+
+void test_ecc_schnorr() {
+    // bip340 test vectors 0 and 1
+    uint8_t privkey[32], xonly[32], aux[32], hash[32];
+    unsigned char sig[64];
+    memset(privkey, 0, sizeof(privkey));
+    privkey[31] = 3;
+    memset(aux, 0, sizeof(aux));
+    memset(hash, 0, sizeof(hash));
+    u_assert_int_eq(dogecoin_ecc_get_xonly_pubkey(privkey, xonly), true);
+    u_assert_mem_eq(xonly, utils_hex_to_uint8("f9308a019258c31049344f85f89d5229b531c845836f99b08601f113bce036f9"), 32);
+    u_assert_int_eq(dogecoin_ecc_schnorr_sign(privkey, hash, sig, aux), true);
+    u_assert_mem_eq(sig, utils_hex_to_uint8("e907831f80848d1069a5371b402410364bdf1c5f8307b0084c55f1ce2dca821525f66a4a85ea8b71e482a74f382d2ce5ebeee8fdb2172f477df4900d310536c0"), 64);
+    u_assert_int_eq(dogecoin_ecc_schnorr_verify(xonly, hash, sig), true);
+
+    memcpy(privkey, utils_hex_to_uint8("b7e151628aed2a6abf7158809cf4f3c762e7160f38b4da56a784d9045190cfef"), 32);
+    memcpy(hash, utils_hex_to_uint8("243f6a8885a308d313198a2e03707344a4093822299f31d0082efa98ec4e6c89"), 32);
+    aux[31] = 1;
+    u_assert_int_eq(dogecoin_ecc_get_xonly_pubkey(privkey, xonly), true);
+    u_assert_mem_eq(xonly, utils_hex_to_uint8("dff1d77f2a671c5f36183726db2341be58feae1da2deced843240f7b502ba659"), 32);
+    u_assert_int_eq(dogecoin_ecc_schnorr_sign(privkey, hash, sig, aux), true);
+    u_assert_mem_eq(sig, utils_hex_to_uint8("6896bd60eeae296db48a229ff71dfe071bde413e6d43f917dc8dcf8c78de33418906d11ac976abccb20b091292bff4ea897efcb639ea871cfa95f6de339e4b0a"), 64);
+    u_assert_int_eq(dogecoin_ecc_schnorr_verify(xonly, hash, sig), true);
+    hash[0] ^= 1;
+    u_assert_int_eq(dogecoin_ecc_schnorr_verify(xonly, hash, sig), false);
+    hash[0] ^= 1;
+    // fresh aux randomness still verifies, an x coordinate off the curve does not parse
+    u_assert_int_eq(dogecoin_ecc_schnorr_sign(privkey, hash, sig, NULL), true);
+    u_assert_int_eq(dogecoin_ecc_schnorr_verify(xonly, hash, sig), true);
+    memset(xonly, 0xff, sizeof(xonly));
+    u_assert_int_eq(dogecoin_ecc_schnorr_verify(xonly, hash, sig), false);
+
+    // bulk verification on 1 and 4 threads, one bad signature is reported in its own slot
+    const size_t num_checks = 50;
+    uint8_t keys[50][32], hashes[50][32];
+    unsigned char sigs[50][64];
+    dogecoin_schnorr_check checks[50];
+    unsigned int threads[2] = {1, 4};
+    size_t i, t;
+    for (i = 0; i < num_checks; i++) {
+        memset(privkey, (int)i + 1, sizeof(privkey));
+        memset(hashes[i], (int)i, sizeof(hashes[i]));
+        dogecoin_ecc_get_xonly_pubkey(privkey, keys[i]);
+        dogecoin_ecc_schnorr_sign(privkey, hashes[i], sigs[i], NULL);
+        checks[i].hash = hashes[i];
+        checks[i].xonly_pubkey = keys[i];
+        checks[i].sig = sigs[i];
+    }
+    for (t = 0; t < 2; t++) {
+        for (i = 0; i < num_checks; i++) checks[i].valid = false;
+        u_assert_int_eq(dogecoin_ecc_schnorr_verify_batch(checks, num_checks, threads[t]), true);
+        sigs[37][5] ^= 1;
+        u_assert_int_eq(dogecoin_ecc_schnorr_verify_batch(checks, num_checks, threads[t]), false);
+        for (i = 0; i < num_checks; i++) {
+            u_assert_int_eq(checks[i].valid, i != 37);
+        }
+        sigs[37][5] ^= 1;
+    }
+    u_assert_int_eq(dogecoin_ecc_schnorr_verify_batch(checks, 0, 4), true);
+
+    // worker contexts survive across batches and are not freed by their threads
+    dogecoin_ecc_ctx* worker_ctx = dogecoin_ecc_worker_ctx(2);
+    u_assert_not_null(worker_ctx);
+    u_assert_int_eq(dogecoin_ecc_worker_ctx(2) == worker_ctx, true);
+    u_assert_int_eq(dogecoin_ecc_worker_ctx(2 + DOGECOIN_ECC_WORKER_CTXS) == worker_ctx, true);
+    dogecoin_ecc_ctx_free(worker_ctx);
+    u_assert_int_eq(dogecoin_ecc_schnorr_verify_ctx(worker_ctx, keys[0], hashes[0], sigs[0]), true);
 }
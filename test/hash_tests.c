@@ -24,3 +24,49 @@ void test_hash() {
     dogecoin_hash((const unsigned char *)data, strlen(data), hashout);
     assert(memcmp(hashout, digest_expected, sizeof(hashout)) == 0);
 }
+
+void test_hash_fixed() {
+    const unsigned int lanes[4] = {1, 4, 8, 16};
+    uint8_t data[37 * 64];
+    uint256 expected[37];
+    uint256 out[37];
+    uint8_t inplace[37 * 64];
+    unsigned int i, l;
+
+    for (i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t)(i * 61 + 17);
+    }
+
+    for (l = 0; l < sizeof(lanes) / sizeof(lanes[0]); l++) {
+        if (!sha256_set_batch_lanes(lanes[l]))
+            continue;
+
+        for (i = 0; i < 37; i++) {
+            dogecoin_hash(data + i * 64, 64, expected[i]);
+            dogecoin_hash_64(data + i * 64, out[i]);
+            assert(memcmp(out[i], expected[i], sizeof(uint256)) == 0);
+        }
+        dogecoin_hash_64_batch(data, 37, out);
+        assert(memcmp(out, expected, sizeof(out)) == 0);
+        /* a merkle level hashed into the front of its own buffer */
+        memcpy(inplace, data, sizeof(inplace));
+        dogecoin_hash_64_batch(inplace, 37, (uint256*)inplace);
+        assert(memcmp(inplace, expected, sizeof(expected)) == 0);
+
+        for (i = 0; i < 37; i++) {
+            dogecoin_hash(data + i * 32, 32, expected[i]);
+            dogecoin_hash_32(data + i * 32, out[i]);
+            assert(memcmp(out[i], expected[i], sizeof(uint256)) == 0);
+            sha256_raw(data + i * 32, 32, expected[i]);
+            sha256_raw_32(data + i * 32, out[i]);
+            assert(memcmp(out[i], expected[i], sizeof(uint256)) == 0);
+            dogecoin_hash(data + i * 32, 32, expected[i]);
+        }
+        dogecoin_hash_32_batch(data, 37, out);
+        assert(memcmp(out, expected, sizeof(out)) == 0);
+        memcpy(inplace, data, sizeof(inplace));
+        dogecoin_hash_32_batch(inplace, 37, (uint256*)inplace);
+        assert(memcmp(inplace, expected, sizeof(expected)) == 0);
+    }
+    sha256_autodetect();
+}
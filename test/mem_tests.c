@@ -49,3 +49,21 @@ void test_memory() {
     // switch back to the default memory callback mapper
     dogecoin_mem_set_mapper_default();
 }
+
+void test_memory_arena() {
+    uint8_t buf[256];
+    dogecoin_arena arena;
+    dogecoin_arena_init(&arena, buf, sizeof(buf));
+    uint8_t *a = dogecoin_arena_alloc(&arena, 3);
+    uint8_t *b = dogecoin_arena_alloc(&arena, 16);
+    u_assert_int_eq((a != NULL && b != NULL), 1);
+    u_assert_int_eq(((uintptr_t)b % (sizeof(void*) * 2)), 0);
+    u_assert_int_eq((b >= a + 3), 1);
+    // exhausting the arena must not move the bump pointer
+    size_t used = arena.used;
+    u_assert_int_eq((dogecoin_arena_alloc(&arena, sizeof(buf)) == NULL), 1);
+    u_assert_int_eq(arena.used, used);
+    dogecoin_arena_reset(&arena);
+    u_assert_int_eq(arena.used, 0);
+    u_assert_int_eq((dogecoin_arena_alloc(&arena, 3) == a), 1);
+}
@@ -0,0 +1,117 @@
+/**********************************************************************
+ * Copyright (c) 2022 The Dogecoin Foundation                         *
+ * Distributed under the MIT software license, see the accompanying   *
+ * file COPYING or http://www.opensource.org/licenses/mit-license.php.*
+ **********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <test/utest.h>
+
+#include <dogecoin/chainparams.h>
+#include <dogecoin/crypto/key.h>
+#include <dogecoin/mem.h>
+#include <dogecoin/message.h>
+#include <dogecoin/utils.h>
+
+void test_message() {
+    const char* message = "Such signed, very message";
+    const char* expected_sig = "IDe1eQ7us3ZiYHXIiOzN+S4n5l/PdtpdV4nrOD0e3LjuYLfFXiQozGgHD7md8hv2iN+5DqjUrs2nxZnxlTG+tmQ=";
+    const char* expected_address = "DMnz8PjLcQxdE5eeeJBdKT6LWFnbsSU75r";
+    dogecoin_key key;
+    dogecoin_pubkey pubkey, recovered;
+    char sig[DOGECOIN_MESSAGE_SIG_BASE64_LENGTH];
+    char sig_uncompressed[DOGECOIN_MESSAGE_SIG_BASE64_LENGTH];
+    char address[64], address_uncompressed[64];
+    int outlen;
+
+    dogecoin_privkey_init(&key);
+    utils_hex_to_bin("b0d7a6bba5f8a4dca1e7ce2c6a3e42eb3d8d1f4f0a1b6c5d9e2f3a4b5c6d7e8f", key.privkey, 64, &outlen);
+    dogecoin_pubkey_init(&pubkey);
+    dogecoin_pubkey_from_key(&key, &pubkey);
+    dogecoin_pubkey_getaddr_p2pkh(&pubkey, &dogecoin_chainparams_main, address);
+    u_assert_str_eq(address, expected_address);
+
+    // rfc6979 nonces make the signature deterministic
+    u_assert_int_eq(dogecoin_message_sign(&key, true, message, sig), true);
+    u_assert_int_eq(strlen(sig), DOGECOIN_MESSAGE_SIG_BASE64_LENGTH - 1);
+    u_assert_str_eq(sig, expected_sig);
+    u_assert_int_eq(dogecoin_message_verify(NULL, address, sig, message, &dogecoin_chainparams_main), true);
+    u_assert_int_eq(dogecoin_message_recover_pubkey(NULL, sig, message, &recovered), true);
+    u_assert_int_eq(recovered.compressed, true);
+    u_assert_mem_eq(recovered.pubkey, pubkey.pubkey, DOGECOIN_ECKEY_COMPRESSED_LENGTH);
+
+    // the header byte commits to the key form, and so to the address
+    u_assert_int_eq(dogecoin_message_sign(&key, false, message, sig_uncompressed), true);
+    u_assert_int_eq(dogecoin_message_recover_pubkey(NULL, sig_uncompressed, message, &recovered), true);
+    u_assert_int_eq(recovered.compressed, false);
+    dogecoin_pubkey_getaddr_p2pkh(&recovered, &dogecoin_chainparams_main, address_uncompressed);
+    u_assert_int_eq(strcmp(address, address_uncompressed) != 0, true);
+    u_assert_int_eq(dogecoin_message_verify(NULL, address_uncompressed, sig_uncompressed, message, &dogecoin_chainparams_main), true);
+    u_assert_int_eq(dogecoin_message_verify(NULL, address, sig_uncompressed, message, &dogecoin_chainparams_main), false);
+    u_assert_int_eq(dogecoin_message_verify(NULL, address_uncompressed, sig, message, &dogecoin_chainparams_main), false);
+
+    // other message, other chain, malformed signatures
+    u_assert_int_eq(dogecoin_message_verify(NULL, address, sig, "Such signed, very massage", &dogecoin_chainparams_main), false);
+    u_assert_int_eq(dogecoin_message_verify(NULL, address, sig, message, &dogecoin_chainparams_test), false);
+    u_assert_int_eq(dogecoin_message_verify(NULL, address, "", message, &dogecoin_chainparams_main), false);
+    u_assert_int_eq(dogecoin_message_verify(NULL, address, "Zm9vYmFy", message, &dogecoin_chainparams_main), false);
+    u_assert_int_eq(dogecoin_message_verify(NULL, address, NULL, message, &dogecoin_chainparams_main), false);
+    char bad[DOGECOIN_MESSAGE_SIG_BASE64_LENGTH];
+    memcpy(bad, sig, sizeof(bad));
+    bad[0] = 'A'; // header byte below 27
+    u_assert_int_eq(dogecoin_message_verify(NULL, address, bad, message, &dogecoin_chainparams_main), false);
+    memcpy(bad, sig, sizeof(bad));
+    bad[87] = '!';
+    u_assert_int_eq(dogecoin_message_verify(NULL, address, bad, message, &dogecoin_chainparams_main), false);
+
+    // batch with every other check broken, on one and several threads, with and without the cache
+    const size_t n = 64;
+    dogecoin_message_check* checks = dogecoin_calloc(n, sizeof(dogecoin_message_check));
+    char (*sigs)[DOGECOIN_MESSAGE_SIG_BASE64_LENGTH] = dogecoin_calloc(n, DOGECOIN_MESSAGE_SIG_BASE64_LENGTH);
+    char (*messages)[32] = dogecoin_calloc(n, 32);
+    char (*addresses)[64] = dogecoin_calloc(n, 64);
+    unsigned int threads[3] = {1, 3, 8};
+    size_t i, t;
+    for (i = 0; i < n; i++) {
+        dogecoin_key k;
+        dogecoin_pubkey p;
+        dogecoin_privkey_gen(&k);
+        dogecoin_pubkey_init(&p);
+        dogecoin_pubkey_from_key(&k, &p);
+        dogecoin_pubkey_getaddr_p2pkh(&p, &dogecoin_chainparams_main, addresses[i]);
+        snprintf(messages[i], 32, "login %u", (unsigned int)i);
+        u_assert_int_eq(dogecoin_message_sign(&k, true, messages[i], sigs[i]), true);
+        checks[i].address = addresses[i];
+        checks[i].signature = sigs[i];
+        checks[i].message = i & 1 ? messages[i ^ 1] : messages[i];
+        dogecoin_privkey_cleanse(&k);
+    }
+    dogecoin_message_cache* cache = dogecoin_message_cache_new(1024);
+    uint64_t hits, misses;
+    for (t = 0; t < 6; t++) {
+        for (i = 0; i < n; i++) {
+            checks[i].valid = i & 1 ? true : false;
+        }
+        u_assert_int_eq(dogecoin_message_verify_batch(t < 3 ? NULL : cache, checks, n, &dogecoin_chainparams_main, threads[t % 3]), n / 2);
+        for (i = 0; i < n; i++) {
+            u_assert_int_eq(checks[i].valid, (i & 1) ? false : true);
+        }
+    }
+    // the first cached round recovered every key, the other two found them
+    dogecoin_message_cache_stats(cache, &hits, &misses);
+    u_assert_int_eq(misses, n);
+    u_assert_int_eq(hits, 2 * n);
+    u_assert_int_eq(dogecoin_message_recover_pubkey(cache, sigs[0], messages[0], &recovered), true);
+    dogecoin_message_cache_stats(cache, &hits, &misses);
+    u_assert_int_eq(hits, 2 * n + 1);
+    dogecoin_message_cache_free(cache);
+
+    dogecoin_free(addresses);
+    dogecoin_free(messages);
+    dogecoin_free(sigs);
+    dogecoin_free(checks);
+    dogecoin_privkey_cleanse(&key);
+}
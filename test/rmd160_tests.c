@@ -10,6 +10,7 @@
 #include <string.h>
 #include <assert.h>
 
+#include <dogecoin/crypto/hash.h>
 #include <dogecoin/crypto/rmd160.h>
 
 #define TESTS 8
@@ -60,4 +61,59 @@ void test_rmd160()
         rmd160(ripemd160_test_str[i], ripemd160_test_strlen[i], (uint8_t*)output);
         assert(memcmp(output, ripemd160_test_md[i], 20) == 0);
     }
+
+    // streaming in uneven pieces gives the one-shot digest
+    for (i = 0; i < TESTS; i++) {
+        size_t step, pos;
+        for (step = 1; step < 12; step += 5) {
+            rmd160_context ctx;
+            rmd160_init(&ctx);
+            for (pos = 0; pos < ripemd160_test_strlen[i]; pos += step) {
+                size_t len = ripemd160_test_strlen[i] - pos < step ? ripemd160_test_strlen[i] - pos : step;
+                rmd160_write(&ctx, ripemd160_test_str[i] + pos, len);
+            }
+            rmd160_finalize((uint8_t*)output, &ctx);
+            assert(memcmp(output, ripemd160_test_md[i], 20) == 0);
+        }
+    }
+}
+
+void test_rmd160_batch()
+{
+    const unsigned int lanes[4] = {1, 4, 8, 16};
+    uint8_t data[37 * 32];
+    uint8_t expected[37 * 20], out[37 * 20];
+    unsigned int i, l;
+
+    for (i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t)(i * 7 + 3);
+    }
+    for (i = 0; i < 37; i++) {
+        rmd160(data + i * 32, 32, expected + i * 20);
+        rmd160_32(data + i * 32, out + i * 20);
+        assert(memcmp(out + i * 20, expected + i * 20, 20) == 0);
+    }
+    // hash160 of mixed length messages (compressed and uncompressed pubkey sizes, empty, multi block)
+    const unsigned char* msgs[100];
+    size_t lens[100];
+    uint160 hashes[100], single;
+    for (i = 0; i < 100; i++) {
+        msgs[i] = data + i;
+        lens[i] = i % 3 == 0 ? 33 : i % 3 == 1 ? 65 : (i * 11) % 140;
+    }
+
+    // the last supported lane count tried is the widest, which is also the autodetected one
+    for (l = 0; l < 4; l++) {
+        if (!rmd160_set_batch_lanes(lanes[l]))
+            continue;
+        memset(out, 0, sizeof(out));
+        rmd160_32_batch(out, data, 37);
+        assert(memcmp(out, expected, sizeof(out)) == 0);
+        dogecoin_hash160_batch(msgs, lens, 100, hashes);
+        for (i = 0; i < 100; i++) {
+            dogecoin_hash160(msgs[i], lens[i], single);
+            assert(memcmp(hashes[i], single, sizeof(single)) == 0);
+        }
+    }
+    assert(!rmd160_set_batch_lanes(3));
 }
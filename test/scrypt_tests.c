@@ -0,0 +1,66 @@
+/**********************************************************************
+ * Copyright (c) 2022 The Dogecoin Foundation                         *
+ * Distributed under the MIT software license, see the accompanying   *
+ * file COPYING or http://www.opensource.org/licenses/mit-license.php.*
+ **********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include <dogecoin/crypto/scrypt.h>
+#include <dogecoin/utils.h>
+
+#define BATCH_HEADERS 37
+
+struct scrypt_test_v {
+    const char* header_hex;
+    const char* hash_hex;
+};
+
+static const struct scrypt_test_v scrypt_test_vectors[] = {
+    /* dogecoin mainnet genesis header */
+    {"010000000000000000000000000000000000000000000000000000000000000000000000696ad20e2dd4365c7459b4a4a5af743d5e92c6da3229e6532cd605f6533f2a5b24a6a152f0ff0f1e67860100",
+     "48b41053487d4159cfaacf3adad783cf2f2dedea1413250cca74783f6f020000"},
+    {"0000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000",
+     "161d0876f3b93b1048cda1bdeaa7332ee210f7131b42013cb43913a6553a4b69"},
+    {"000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f202122232425262728292a2b2c2d2e2f303132333435363738393a3b3c3d3e3f404142434445464748494a4b4c4d4e4f",
+     "bc540a1a801df96e493005c71e010e2d387607fbf0fec416fd3c2645aa1ba9d2"},
+};
+
+void test_scrypt()
+{
+    const enum scrypt_implementation impls[] = {SCRYPT_IMPL_STANDARD, SCRYPT_IMPL_SSE2};
+    const unsigned int lanes[] = {1, 4, 8, 16};
+    uint8_t headers[BATCH_HEADERS * SCRYPT_POW_INPUT_LENGTH];
+    uint8_t expected[BATCH_HEADERS * SCRYPT_POW_OUTPUT_LENGTH];
+    uint8_t hashes[BATCH_HEADERS * SCRYPT_POW_OUTPUT_LENGTH];
+    uint8_t hash[SCRYPT_POW_OUTPUT_LENGTH];
+    size_t i, j;
+
+    for (i = 0; i < sizeof(impls) / sizeof(impls[0]); i++) {
+        if (!scrypt_set_implementation(impls[i]))
+            continue;
+        for (j = 0; j < sizeof(scrypt_test_vectors) / sizeof(scrypt_test_vectors[0]); j++) {
+            scrypt_1024_1_1_256(utils_hex_to_uint8(scrypt_test_vectors[j].header_hex), hash);
+            assert(memcmp(hash, utils_hex_to_uint8(scrypt_test_vectors[j].hash_hex), sizeof(hash)) == 0);
+        }
+    }
+
+    // every lane width against the single stream path, with a partial group at the end
+    for (i = 0; i < sizeof(headers); i++) {
+        headers[i] = (uint8_t)(i * 7 + (i >> 5));
+    }
+    for (i = 0; i < BATCH_HEADERS; i++) {
+        scrypt_1024_1_1_256(headers + i * SCRYPT_POW_INPUT_LENGTH, expected + i * SCRYPT_POW_OUTPUT_LENGTH);
+    }
+    for (i = 0; i < sizeof(lanes) / sizeof(lanes[0]); i++) {
+        if (!scrypt_set_batch_lanes(lanes[i]))
+            continue;
+        memset(hashes, 0, sizeof(hashes));
+        scrypt_1024_1_1_256_batch(hashes, headers, BATCH_HEADERS);
+        assert(memcmp(hashes, expected, sizeof(hashes)) == 0);
+    }
+    assert(scrypt_autodetect() != NULL);
+}
@@ -412,7 +412,7 @@ static const struct sha_hmac_test_v sha_hmac_test_vectors[] =
         {373, 142, 64, "8a0349d4d1ed8c4af533e9e83468b5859bb68237798038171346684499c9dc2b5970730533eb2ca04d1680630820f58d32ecf0bd7db7cab72ffc27651c94831cd1220e2113aeba6c889092abb3904d8a264b2332f2d9df0f63ac36d7eabb57c85be0c331587f5f330d69c7c91f00e606de9bc49ec22c9ea815203ca2ed867fb65d743a3beca6427f4669c9c432b7", "035f55033df01f670015a828eff154a245e8ca7474b0b3330cabbe5fdd74e89560b8fa075347532aa46ae7ae907888b30ca4653a6419d0d9224944b43181a6a842c1cbc96fcc3b0f1e7b344c2956f2613c652eb27e44e5d773765a9521fb5e0c7125cf31d9a75f7f38ef96ea01b61b159cd52fc4095a7a94c7db0aeaf40a9929", "3780ef695742f09a160c8dd7d35e2758b08284e8150934d222db31df2767d40d7c815c526ecee5f787030c8dc5f050c419ec6ea7563650dcce1480892d3088e6"},
         {374, 142, 64, "f78343071f61ee7d9f791bd53132e6d557928bcfe4b214bebf6f3592e46374c7ab148c3c4d6a1443a4675cf4321298c865b440631947b6b05f2c2a337d1cbb9b3661de974b4604eb41cc77c3659e85470e47e16f22a34619db935d59cbf5e1101ed401c020db069eff1035e9d1bff77bd8b3379e05ac0c20bc0e98aad7d7304dedd3bc5ed4136184649b5e0f7e5b", "d63b50b54e1536e35d5f3c6e29f1e49a78ca43fa22b31232c71f0300bd56517e4cd29ba11ee9f206f1ad31ee8f118c87004d6c6dfe837b70a9a2fa987c8b5b6680720c5dbf8791c1fcd6d59fa16cc20df9bc0fb39f41598a376476e45b9f06add8e34af01b373a9ce6a3d189484cacb6cbe0d3d5ef34d709d72c1dee43dc79da", "086f674d778db491e73b6fbc5126233c6b6e1f066963356d49ea386d9c0868ad25bf6edad0371cde87cea94a18c6dba47535dfce2e40d2246ab17980495d656c"}};
 
-void test_sha_256()
+static void sha256_check_vectors()
 {
     sha256_context context;
     uint8_t buf[SHA256_DIGEST_LENGTH];
@@ -446,7 +446,79 @@ void test_sha_256()
     }
 }
 
-void test_sha_512()
+void test_sha_256()
+{
+    uint8_t msg[1024];
+    uint8_t expected[64][SHA256_DIGEST_LENGTH];
+    uint8_t buf[SHA256_DIGEST_LENGTH];
+    unsigned int i, impl;
+
+    for (i = 0; i < sizeof(msg); i++) {
+        msg[i] = (uint8_t)(i * 131 + 7);
+    }
+    assert(sha256_set_implementation(SHA256_IMPL_STANDARD));
+    for (i = 0; i < 64; i++) {
+        sha256_raw(msg, i * 16 + i % 3, expected[i]);
+    }
+
+    /* every transform this cpu supports must agree with the portable one */
+    for (impl = SHA256_IMPL_STANDARD; impl <= SHA256_IMPL_SHANI; impl++) {
+        if (!sha256_set_implementation((enum sha256_implementation)impl))
+            continue;
+        sha256_check_vectors();
+        for (i = 0; i < 64; i++) {
+            sha256_raw(msg, i * 16 + i % 3, buf);
+            assert(memcmp(buf, expected[i], SHA256_DIGEST_LENGTH) == 0);
+        }
+    }
+    assert(sha256_autodetect() != NULL);
+}
+
+void test_sha_256_batch()
+{
+    const unsigned int lanes[4] = {1, 4, 8, 16};
+    uint8_t msg[512];
+    const uint8_t* inputs[37];
+    size_t lens[37];
+    uint8_t digests[37][SHA256_DIGEST_LENGTH];
+    uint8_t* outs[37];
+    uint8_t expected[SHA256_DIGEST_LENGTH];
+    unsigned int i, l;
+
+    for (i = 0; i < sizeof(msg); i++) {
+        msg[i] = (uint8_t)(i * 89 + 3);
+    }
+    /* lengths around the padding boundaries and some multi block messages */
+    for (i = 0; i < 37; i++) {
+        inputs[i] = msg + i;
+        lens[i] = (i * 55) % 300;
+        outs[i] = digests[i];
+    }
+    lens[1] = 55;
+    lens[2] = 56;
+    lens[3] = 64;
+    lens[4] = 0;
+
+    for (l = 0; l < sizeof(lanes) / sizeof(lanes[0]); l++) {
+        if (!sha256_set_batch_lanes(lanes[l]))
+            continue;
+        memset(digests, 0, sizeof(digests));
+        sha256_raw_batch(inputs, lens, outs, 37);
+        for (i = 0; i < 37; i++) {
+            sha256_raw(inputs[i], lens[i], expected);
+            assert(memcmp(digests[i], expected, SHA256_DIGEST_LENGTH) == 0);
+        }
+        /* fewer messages than lanes */
+        sha256_raw_batch(inputs, lens, outs, 3);
+        for (i = 0; i < 3; i++) {
+            sha256_raw(inputs[i], lens[i], expected);
+            assert(memcmp(digests[i], expected, SHA256_DIGEST_LENGTH) == 0);
+        }
+    }
+    sha256_autodetect();
+}
+
+static void sha512_check_vectors()
 {
     sha512_context context;
     uint8_t buf[SHA512_DIGEST_LENGTH];
@@ -482,6 +554,55 @@ void test_sha_512()
     }
 }
 
+void test_sha_512()
+{
+    const unsigned int lanes[3] = {1, 4, 8};
+    uint8_t msg[1024];
+    const uint8_t* inputs[37];
+    size_t lens[37];
+    uint8_t digests[37][SHA512_DIGEST_LENGTH];
+    uint8_t* outs[37];
+    uint8_t expected[37][SHA512_DIGEST_LENGTH];
+    unsigned int i, impl, l;
+
+    for (i = 0; i < sizeof(msg); i++) {
+        msg[i] = (uint8_t)(i * 131 + 7);
+    }
+    /* lengths around the padding boundaries and some multi block messages */
+    for (i = 0; i < 37; i++) {
+        inputs[i] = msg + i;
+        lens[i] = (i * 111) % 700;
+        outs[i] = digests[i];
+    }
+    lens[1] = 111;
+    lens[2] = 112;
+    lens[3] = 128;
+    lens[4] = 0;
+    assert(sha512_set_implementation(SHA512_IMPL_STANDARD));
+    for (i = 0; i < 37; i++) {
+        sha512_raw(inputs[i], lens[i], expected[i]);
+    }
+
+    /* every transform this cpu supports must agree with the portable one */
+    for (impl = SHA512_IMPL_STANDARD; impl <= SHA512_IMPL_AVX2; impl++) {
+        if (!sha512_set_implementation((enum sha512_implementation)impl))
+            continue;
+        sha512_check_vectors();
+        for (i = 0; i < 37; i++) {
+            sha512_raw(inputs[i], lens[i], digests[i]);
+            assert(memcmp(digests[i], expected[i], SHA512_DIGEST_LENGTH) == 0);
+        }
+    }
+    for (l = 0; l < sizeof(lanes) / sizeof(lanes[0]); l++) {
+        if (!sha512_set_batch_lanes(lanes[l]))
+            continue;
+        memset(digests, 0, sizeof(digests));
+        sha512_raw_batch(inputs, lens, outs, 37);
+        assert(memcmp(digests, expected, sizeof(digests)) == 0);
+    }
+    assert(sha512_autodetect() != NULL);
+}
+
 void test_sha_hmac()
 {
     uint8_t buf[SHA512_DIGEST_LENGTH];
@@ -504,5 +625,67 @@ void test_sha_hmac()
 
         digest_out = utils_hex_to_uint8((const char*)sha_hmac_test_vectors[i].digest_hex);
         assert(memcmp(buf, digest_out, sha_hmac_test_vectors[i].tlen) == 0);
+
+        // a prepared key context gives the same mac, and stays valid for the next message
+        int round;
+        for (round = 0; round < 2; round++) {
+            memset(buf, 0, sizeof(buf));
+            if (sha_hmac_test_vectors[i].tlen == 32) {
+                hmac_sha256_ctx ctx;
+                hmac_sha256_prepare(&ctx, key_buf, sha_hmac_test_vectors[i].klen);
+                hmac_sha256_compute(&ctx, msg_buf, oLenMsg, buf);
+                hmac_sha256_compute(&ctx, msg_buf, oLenMsg, buf);
+                hmac_sha256_ctx_cleanse(&ctx);
+            } else {
+                hmac_sha512_ctx ctx;
+                hmac_sha512_prepare(&ctx, key_buf, sha_hmac_test_vectors[i].klen);
+                hmac_sha512_compute(&ctx, msg_buf, oLenMsg, buf);
+                hmac_sha512_compute(&ctx, msg_buf, oLenMsg, buf);
+                hmac_sha512_ctx_cleanse(&ctx);
+            }
+            assert(memcmp(buf, digest_out, sha_hmac_test_vectors[i].tlen) == 0);
+        }
+    }
+
+    // pbkdf2-hmac-sha256, rfc 7914 section 11 and rfc 6070 style
+    uint8_t key[64];
+    pbkdf2_hmac_sha256((const uint8_t*)"passwd", 6, (const uint8_t*)"salt", 4, 1, key, 64);
+    assert(memcmp(key, utils_hex_to_uint8("55ac046e56e3089fec1691c22544b605f94185216dde0465e68b9d57c20dacbc49ca9cccf179b645991664b39d77ef317c71b845b1e30bd509112041d3a19783"), 64) == 0);
+    pbkdf2_hmac_sha256((const uint8_t*)"Password", 8, (const uint8_t*)"NaCl", 4, 80000, key, 64);
+    assert(memcmp(key, utils_hex_to_uint8("4ddcd8f60b98be21830cee5ef22701f9641a4418d04c0414aeff08876b34ab56a1d425a1225833549adb841b51c9b3176a272bdebba1d078478f62b397f33c8d"), 64) == 0);
+    memset(key, 0, sizeof(key));
+    pbkdf2_hmac_sha256((const uint8_t*)"password", 8, (const uint8_t*)"salt", 4, 4096, key, 20);
+    assert(memcmp(key, utils_hex_to_uint8("c5e478d59288c841aa530db6845c4c8d962893a0"), 20) == 0);
+    assert(key[20] == 0);
+
+    // pbkdf2-hmac-sha512, a multi block key and the batch lanes against the single key path
+    uint8_t key512[100];
+    pbkdf2_hmac_sha512((const uint8_t*)"password", 8, (const uint8_t*)"salt", 4, 1, key512, 64);
+    assert(memcmp(key512, utils_hex_to_uint8("867f70cf1ade02cff3752599a3a53dc4af34c7a669815ae5d513554e1c8cf252c02d470a285a0501bad999bfe943c08f050235d7d68b1da55e63f73b60a57fce"), 64) == 0);
+    pbkdf2_hmac_sha512((const uint8_t*)"password", 8, (const uint8_t*)"salt", 4, 4096, key512, 100);
+    assert(memcmp(key512, utils_hex_to_uint8("d197b1b33db0143e018b12f3d1d1479e6cdebdcc97c5c0f87f6902e072f457b5143f30602641b3d55cd335988cb36b84376060ecd532e039b742a239434af2d5d6883f0be4c24d363b638f4c2f8d917533cd4158937d0b490697a64adadb07f180c32308"), 100) == 0);
+
+    const unsigned int lanes[] = {1, 4, 8};
+    const uint8_t* passes[11];
+    const uint8_t* salts[11];
+    size_t passlens[11], saltlens[11];
+    uint8_t batch_keys[11][64], expected_keys[11][64];
+    uint8_t* keys[11];
+    for (i = 0; i < 11; i++) {
+        // the last password is longer than a sha512 block and is hashed down first
+        passes[i] = (const uint8_t*)"a password long enough to be hashed down before the pads are applied, 129 bytes total for the last lane of this batch of keys ok.";
+        passlens[i] = 9 + i * 12;
+        salts[i] = (const uint8_t*)"saltSALTsaltSALT";
+        saltlens[i] = i + 1;
+        keys[i] = batch_keys[i];
+        pbkdf2_hmac_sha512(passes[i], passlens[i], salts[i], saltlens[i], 50, expected_keys[i], 64);
+    }
+    for (i = 0; i < sizeof(lanes) / sizeof(lanes[0]); i++) {
+        if (!sha512_set_batch_lanes(lanes[i]))
+            continue;
+        memset(batch_keys, 0, sizeof(batch_keys));
+        pbkdf2_hmac_sha512_batch(passes, passlens, salts, saltlens, 50, keys, 11);
+        assert(memcmp(batch_keys, expected_keys, sizeof(batch_keys)) == 0);
     }
+    sha512_autodetect();
 }
@@ -0,0 +1,138 @@
+/**********************************************************************
+ * Copyright (c) 2022 The Dogecoin Foundation                         *
+ * Distributed under the MIT software license, see the accompanying   *
+ * file COPYING or http://www.opensource.org/licenses/mit-license.php.*
+ **********************************************************************/
+
+#ifdef HAVE_CONFIG_H
+#  include <src/libdogecoin-config.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
+#include <test/utest.h>
+
+#include <dogecoin/crypto/key.h>
+#include <dogecoin/crypto/sigcache.h>
+
+#define SIGCACHE_TEST_TRIPLES 512
+
+// fake triples, the cache never looks inside them
+static void sigcache_test_triple(unsigned int n, uint256 hash, uint8_t pubkey[33], uint8_t sig[72]) {
+    memset(hash, 0, sizeof(uint256));
+    memset(pubkey, 2, 33);
+    memset(sig, 0x30, 72);
+    memcpy(hash, &n, sizeof(n));
+    memcpy(pubkey + 1, &n, sizeof(n));
+}
+
+#ifdef HAVE_PTHREAD
+static dogecoin_sigcache* sigcache_test_shared;
+
+// the first half is cached before the readers start, the second half never is
+static void* sigcache_test_reader(void* arg) {
+    uint256 hash;
+    uint8_t pubkey[33], sig[72];
+    unsigned int round, n;
+    (void)arg;
+    for (round = 0; round < 20; round++) {
+        for (n = 0; n < SIGCACHE_TEST_TRIPLES; n++) {
+            sigcache_test_triple(n, hash, pubkey, sig);
+            assert(dogecoin_sigcache_contains(sigcache_test_shared, hash, pubkey, 33, sig, 72, false) == (n < SIGCACHE_TEST_TRIPLES / 2));
+        }
+    }
+    return NULL;
+}
+#endif
+
+void test_sigcache() {
+    dogecoin_sigcache* cache = dogecoin_sigcache_new(4096);
+    uint256 hash;
+    uint8_t pubkey[33], sig[72];
+    unsigned int n, found;
+
+    // 4096 bytes hold 64 slots of 40 bytes
+    u_assert_int_eq(dogecoin_sigcache_size(cache), 64);
+    sigcache_test_triple(1, hash, pubkey, sig);
+    u_assert_int_eq(dogecoin_sigcache_contains(cache, hash, pubkey, 33, sig, 72, false), false);
+    dogecoin_sigcache_insert(cache, hash, pubkey, 33, sig, 72);
+    dogecoin_sigcache_insert(cache, hash, pubkey, 33, sig, 72);
+    u_assert_int_eq(dogecoin_sigcache_contains(cache, hash, pubkey, 33, sig, 72, false), true);
+    // any part of the triple changes the key
+    hash[31] ^= 1;
+    u_assert_int_eq(dogecoin_sigcache_contains(cache, hash, pubkey, 33, sig, 72, false), false);
+    hash[31] ^= 1;
+    pubkey[32] ^= 1;
+    u_assert_int_eq(dogecoin_sigcache_contains(cache, hash, pubkey, 33, sig, 72, false), false);
+    pubkey[32] ^= 1;
+    u_assert_int_eq(dogecoin_sigcache_contains(cache, hash, pubkey, 33, sig, 71, false), false);
+    // erased on the first hit
+    u_assert_int_eq(dogecoin_sigcache_contains(cache, hash, pubkey, 33, sig, 72, true), true);
+    u_assert_int_eq(dogecoin_sigcache_contains(cache, hash, pubkey, 33, sig, 72, false), false);
+
+    // overfilled, it stays bounded and keeps most of what fits
+    for (n = 0; n < 256; n++) {
+        sigcache_test_triple(n, hash, pubkey, sig);
+        dogecoin_sigcache_insert(cache, hash, pubkey, 33, sig, 72);
+    }
+    for (n = 0, found = 0; n < 256; n++) {
+        sigcache_test_triple(n, hash, pubkey, sig);
+        found += dogecoin_sigcache_contains(cache, hash, pubkey, 33, sig, 72, false);
+    }
+    u_assert_int_eq(found <= 64, true);
+    u_assert_int_eq(found >= 48, true);
+    dogecoin_sigcache_free(cache);
+
+    // real signatures, the mempool pass stores them and the block pass uses them up
+    dogecoin_key key;
+    dogecoin_pubkey pub;
+    unsigned char der[74];
+    size_t derlen = sizeof(der);
+    dogecoin_privkey_init(&key);
+    dogecoin_privkey_gen(&key);
+    dogecoin_pubkey_init(&pub);
+    dogecoin_pubkey_from_key(&key, &pub);
+    memset(hash, 0x42, sizeof(hash));
+    dogecoin_key_sign_hash(&key, hash, der, &derlen);
+    cache = dogecoin_sigcache_new(DOGECOIN_SIGCACHE_DEFAULT_BYTES / 32);
+    u_assert_int_eq(dogecoin_sigcache_verify_sig(cache, pub.pubkey, pub.compressed, hash, der, derlen, true), true);
+    u_assert_int_eq(dogecoin_sigcache_contains(cache, hash, pub.pubkey, 33, der, derlen, false), true);
+    u_assert_int_eq(dogecoin_sigcache_verify_sig(cache, pub.pubkey, pub.compressed, hash, der, derlen, false), true);
+    u_assert_int_eq(dogecoin_sigcache_contains(cache, hash, pub.pubkey, 33, der, derlen, false), false);
+    hash[0] ^= 1;
+    u_assert_int_eq(dogecoin_sigcache_verify_sig(cache, pub.pubkey, pub.compressed, hash, der, derlen, true), false);
+    u_assert_int_eq(dogecoin_sigcache_contains(cache, hash, pub.pubkey, 33, der, derlen, false), false);
+    dogecoin_privkey_cleanse(&key);
+
+#ifdef HAVE_PTHREAD
+    // readers run without a lock next to a writer
+    pthread_t readers[4];
+    unsigned int started;
+    sigcache_test_shared = cache;
+    for (n = 0; n < SIGCACHE_TEST_TRIPLES / 2; n++) {
+        sigcache_test_triple(n, hash, pubkey, sig);
+        dogecoin_sigcache_insert(cache, hash, pubkey, 33, sig, 72);
+    }
+    for (started = 0; started < 4; started++) {
+        if (pthread_create(&readers[started], NULL, sigcache_test_reader, NULL) != 0)
+            break;
+    }
+    // the table stays sparse, so no cached entry is ever displaced while the readers look for it
+    for (n = 0; n < 1024; n++) {
+        sigcache_test_triple(n + SIGCACHE_TEST_TRIPLES, hash, pubkey, sig);
+        dogecoin_sigcache_insert(cache, hash, pubkey, 33, sig, 72);
+        dogecoin_sigcache_contains(cache, hash, pubkey, 33, sig, 72, n & 1);
+    }
+    while (started > 0) {
+        pthread_join(readers[--started], NULL);
+    }
+#endif
+    dogecoin_sigcache_free(cache);
+}
@@ -917,6 +917,159 @@ void test_tx_sighash_ext()
     }
 }
 
+// BIP143 examples: the P2SH-P2WSH 6-of-6 multisig with every hashtype, and the native P2WSH
+// OP_CODESEPARATOR input signed with SINGLE before and after the separator
+struct bip143test {
+    char txhex[512];
+    char script[512]; // witness script code without its length prefix
+    unsigned int inputindex;
+    uint64_t amount;
+    int hashtype;
+    char hashhex[32 * 2 + 1];
+};
+
+static const struct bip143test bip143_tests[] = {
+    {"010000000136641869ca081e70f394c6948e8af409e18b619df2ed74aa106c1ca29787b96e0100000000ffffffff0200e9a435000000001976a914389ffce9cd9ae88dcc0631e88a821ffdbe9bfe2688acc0832f05000000001976a9147480a33f950689af511e6e84c138dbbd3c3ee41588ac00000000",
+     "56210307b8ae49ac90a048e9b53357a2354b3334e9c8bee813ecb98e99a7e07e8c3ba32103b28f0c28bfab54554ae8c658ac5c3e0ce6e79ad336331f78c428dd43eea8449b21034b8113d703413d57761b8b9781957b8c0ac1dfe69f492580ca4195f50376ba4a21033400f6afecb833092a9a21cfdf1ed1376e58c5d1f47de74683123987e967a8f42103a6d48b1131e94ba04d9737d61acdaa1322008af9602b3b14862c07a1789aac162102d8b661b0b3302ee2f162b09e07a55ad5dfbe673a9f01d9f0c19617681024306b56ae",
+     0, 987654321, SIGHASH_ALL, "7cee48b240dc974544893a10d0fb2b27b6c17379040ab54b5bce3d26e50b5c18"},
+    {"010000000136641869ca081e70f394c6948e8af409e18b619df2ed74aa106c1ca29787b96e0100000000ffffffff0200e9a435000000001976a914389ffce9cd9ae88dcc0631e88a821ffdbe9bfe2688acc0832f05000000001976a9147480a33f950689af511e6e84c138dbbd3c3ee41588ac00000000",
+     "56210307b8ae49ac90a048e9b53357a2354b3334e9c8bee813ecb98e99a7e07e8c3ba32103b28f0c28bfab54554ae8c658ac5c3e0ce6e79ad336331f78c428dd43eea8449b21034b8113d703413d57761b8b9781957b8c0ac1dfe69f492580ca4195f50376ba4a21033400f6afecb833092a9a21cfdf1ed1376e58c5d1f47de74683123987e967a8f42103a6d48b1131e94ba04d9737d61acdaa1322008af9602b3b14862c07a1789aac162102d8b661b0b3302ee2f162b09e07a55ad5dfbe673a9f01d9f0c19617681024306b56ae",
+     0, 987654321, SIGHASH_NONE, "362f5daecb86f613c214aa805e929af22f5a97bb667052c6953ca10ec63b73e9"},
+    {"010000000136641869ca081e70f394c6948e8af409e18b619df2ed74aa106c1ca29787b96e0100000000ffffffff0200e9a435000000001976a914389ffce9cd9ae88dcc0631e88a821ffdbe9bfe2688acc0832f05000000001976a9147480a33f950689af511e6e84c138dbbd3c3ee41588ac00000000",
+     "56210307b8ae49ac90a048e9b53357a2354b3334e9c8bee813ecb98e99a7e07e8c3ba32103b28f0c28bfab54554ae8c658ac5c3e0ce6e79ad336331f78c428dd43eea8449b21034b8113d703413d57761b8b9781957b8c0ac1dfe69f492580ca4195f50376ba4a21033400f6afecb833092a9a21cfdf1ed1376e58c5d1f47de74683123987e967a8f42103a6d48b1131e94ba04d9737d61acdaa1322008af9602b3b14862c07a1789aac162102d8b661b0b3302ee2f162b09e07a55ad5dfbe673a9f01d9f0c19617681024306b56ae",
+     0, 987654321, SIGHASH_SINGLE, "ea0a53788f1e7d158cf78b14f9cfe4fa33e983e572cb4a66bd25c03d301c1f1e"},
+    {"010000000136641869ca081e70f394c6948e8af409e18b619df2ed74aa106c1ca29787b96e0100000000ffffffff0200e9a435000000001976a914389ffce9cd9ae88dcc0631e88a821ffdbe9bfe2688acc0832f05000000001976a9147480a33f950689af511e6e84c138dbbd3c3ee41588ac00000000",
+     "56210307b8ae49ac90a048e9b53357a2354b3334e9c8bee813ecb98e99a7e07e8c3ba32103b28f0c28bfab54554ae8c658ac5c3e0ce6e79ad336331f78c428dd43eea8449b21034b8113d703413d57761b8b9781957b8c0ac1dfe69f492580ca4195f50376ba4a21033400f6afecb833092a9a21cfdf1ed1376e58c5d1f47de74683123987e967a8f42103a6d48b1131e94ba04d9737d61acdaa1322008af9602b3b14862c07a1789aac162102d8b661b0b3302ee2f162b09e07a55ad5dfbe673a9f01d9f0c19617681024306b56ae",
+     0, 987654321, SIGHASH_ALL | SIGHASH_ANYONECANPAY, "6e5c95a9e5f68a52ee88feaaefd4e83b59da820bb478581222a4a6633ef0672a"},
+    {"010000000136641869ca081e70f394c6948e8af409e18b619df2ed74aa106c1ca29787b96e0100000000ffffffff0200e9a435000000001976a914389ffce9cd9ae88dcc0631e88a821ffdbe9bfe2688acc0832f05000000001976a9147480a33f950689af511e6e84c138dbbd3c3ee41588ac00000000",
+     "56210307b8ae49ac90a048e9b53357a2354b3334e9c8bee813ecb98e99a7e07e8c3ba32103b28f0c28bfab54554ae8c658ac5c3e0ce6e79ad336331f78c428dd43eea8449b21034b8113d703413d57761b8b9781957b8c0ac1dfe69f492580ca4195f50376ba4a21033400f6afecb833092a9a21cfdf1ed1376e58c5d1f47de74683123987e967a8f42103a6d48b1131e94ba04d9737d61acdaa1322008af9602b3b14862c07a1789aac162102d8b661b0b3302ee2f162b09e07a55ad5dfbe673a9f01d9f0c19617681024306b56ae",
+     0, 987654321, SIGHASH_NONE | SIGHASH_ANYONECANPAY, "0a892c4e935461c98e48516f2ae45e3a731687c1b5ece82c54d579375fa11b78"},
+    {"010000000136641869ca081e70f394c6948e8af409e18b619df2ed74aa106c1ca29787b96e0100000000ffffffff0200e9a435000000001976a914389ffce9cd9ae88dcc0631e88a821ffdbe9bfe2688acc0832f05000000001976a9147480a33f950689af511e6e84c138dbbd3c3ee41588ac00000000",
+     "56210307b8ae49ac90a048e9b53357a2354b3334e9c8bee813ecb98e99a7e07e8c3ba32103b28f0c28bfab54554ae8c658ac5c3e0ce6e79ad336331f78c428dd43eea8449b21034b8113d703413d57761b8b9781957b8c0ac1dfe69f492580ca4195f50376ba4a21033400f6afecb833092a9a21cfdf1ed1376e58c5d1f47de74683123987e967a8f42103a6d48b1131e94ba04d9737d61acdaa1322008af9602b3b14862c07a1789aac162102d8b661b0b3302ee2f162b09e07a55ad5dfbe673a9f01d9f0c19617681024306b56ae",
+     0, 987654321, SIGHASH_SINGLE | SIGHASH_ANYONECANPAY, "9ba9e6c205af6bdc76e06226f66382120255397049651bfc214157ed528e1e51"},
+    {"0100000002fe3dc9208094f3ffd12645477b3dc56f60ec4fa8e6f5d67c565d1c6b9216b36e0000000000ffffffff0815cf020f013ed6cf91d29f4202e8a58726b1ac6c79da47c23d1bee0a6925f80000000000ffffffff0100f2052a010000001976a914a30741f8145e5acadf23f751864167f32e0963f788ac00000000",
+     "21026dccc749adc2a9d0d89497ac511f760f45c47dc5ed9cf352a58ac706453880aeadab210255a9626aebf5e29c0e6538428ba0d1dcf6ca98ffdf086aa8ced5e0d0215ea465ac",
+     1, 4900000000, SIGHASH_SINGLE, "914319e437664a19582fd5e964d0481f695d11d203adb7c2024de9f1e4e6dd82"},
+    {"0100000002fe3dc9208094f3ffd12645477b3dc56f60ec4fa8e6f5d67c565d1c6b9216b36e0000000000ffffffff0815cf020f013ed6cf91d29f4202e8a58726b1ac6c79da47c23d1bee0a6925f80000000000ffffffff0100f2052a010000001976a914a30741f8145e5acadf23f751864167f32e0963f788ac00000000",
+     "210255a9626aebf5e29c0e6538428ba0d1dcf6ca98ffdf086aa8ced5e0d0215ea465ac",
+     1, 4900000000, SIGHASH_SINGLE, "47fc34212dbebc68627363ea9ce535d9f01adf96d72b055c0c71ce9c74bdf7fe"},
+};
+
+void test_tx_sighash_ctx()
+{
+    unsigned int i, j;
+    for (i = 0; i < (sizeof(sighash_tests) / sizeof(sighash_tests[0])); i++) {
+        const struct sighashtest* test = &sighash_tests[i];
+        uint8_t tx_data[sizeof(test->txhex) / 2];
+        int outlen;
+        utils_hex_to_bin(test->txhex, tx_data, strlen(test->txhex), &outlen);
+
+        dogecoin_tx* tx = dogecoin_tx_new();
+        dogecoin_tx_deserialize(tx_data, outlen, tx, NULL, true);
+
+        uint8_t script_data[strlen(test->script) / 2 + 1];
+        utils_hex_to_bin(test->script, script_data, strlen(test->script), &outlen);
+        cstring* script = cstr_new_buf(script_data, outlen);
+
+        dogecoin_sighash_ctx* ctx = dogecoin_sighash_ctx_new(tx);
+        uint256 sighash;
+        memset(sighash, 0, sizeof(sighash));
+        dogecoin_bool ret = dogecoin_tx_sighash_with_ctx(ctx, script, test->inputindex, test->hashtype, 0, SIGVERSION_BASE, sighash);
+        u_assert_int_eq(ret, true);
+
+        char hexbuf[sizeof(sighash) * 2 + 1];
+        utils_bin_to_hex(sighash, sizeof(sighash), hexbuf);
+        utils_reverse_hex(hexbuf, sizeof(sighash) * 2);
+        u_assert_str_eq(hexbuf, test->hashhex);
+
+        // the shared context must give the same result as the one-shot call for every input and both digest versions
+        for (j = 0; j < tx->vin->len; j++) {
+            uint256 expected;
+            dogecoin_bool ret_expected = dogecoin_tx_sighash(tx, script, j, test->hashtype, 1000, SIGVERSION_BASE, expected);
+            ret = dogecoin_tx_sighash_with_ctx(ctx, script, j, test->hashtype, 1000, SIGVERSION_BASE, sighash);
+            u_assert_int_eq(ret, ret_expected);
+            if (ret)
+                u_assert_mem_eq(sighash, expected, sizeof(sighash));
+            dogecoin_tx_sighash(tx, script, j, test->hashtype, 1000, SIGVERSION_WITNESS_V0, expected);
+            dogecoin_tx_sighash_with_ctx(ctx, script, j, test->hashtype, 1000, SIGVERSION_WITNESS_V0, sighash);
+            u_assert_mem_eq(sighash, expected, sizeof(sighash));
+        }
+        u_assert_int_eq(dogecoin_tx_sighash_with_ctx(ctx, script, tx->vin->len, test->hashtype, 0, SIGVERSION_BASE, sighash), false);
+
+        dogecoin_sighash_ctx_free(ctx);
+        cstr_free(script, true);
+        dogecoin_tx_free(tx);
+    }
+
+    for (i = 0; i < (sizeof(bip143_tests) / sizeof(bip143_tests[0])); i++) {
+        const struct bip143test* test = &bip143_tests[i];
+        uint8_t tx_data[sizeof(test->txhex) / 2];
+        int outlen;
+        utils_hex_to_bin(test->txhex, tx_data, strlen(test->txhex), &outlen);
+        dogecoin_tx* tx = dogecoin_tx_new();
+        u_assert_int_eq(dogecoin_tx_deserialize(tx_data, outlen, tx, NULL, true), true);
+        uint8_t script_data[sizeof(test->script) / 2];
+        utils_hex_to_bin(test->script, script_data, strlen(test->script), &outlen);
+        cstring* script = cstr_new_buf(script_data, outlen);
+
+        uint256 sighash;
+        char hexbuf[sizeof(sighash) * 2 + 1];
+        dogecoin_sighash_ctx* ctx = dogecoin_sighash_ctx_new(tx);
+        u_assert_int_eq(dogecoin_tx_sighash_with_ctx(ctx, script, test->inputindex, test->hashtype, test->amount, SIGVERSION_WITNESS_V0, sighash), true);
+        utils_bin_to_hex(sighash, sizeof(sighash), hexbuf);
+        utils_reverse_hex(hexbuf, sizeof(sighash) * 2);
+        u_assert_str_eq(hexbuf, test->hashhex);
+        u_assert_int_eq(dogecoin_tx_sighash(tx, script, test->inputindex, test->hashtype, test->amount, SIGVERSION_WITNESS_V0, sighash), true);
+        utils_bin_to_hex(sighash, sizeof(sighash), hexbuf);
+        utils_reverse_hex(hexbuf, sizeof(sighash) * 2);
+        u_assert_str_eq(hexbuf, test->hashhex);
+
+        dogecoin_sighash_ctx_free(ctx);
+        cstr_free(script, true);
+        dogecoin_tx_free(tx);
+    }
+
+    // BIP143 NONE and SINGLE must only commit to no output / the output at the input index
+    const struct txtest_sighash* test = &txvalid_sighash[0];
+    for (i = 0; i < (sizeof(txvalid_sighash) / sizeof(txvalid_sighash[0])); i++) {
+        if (txvalid_sighash[i].witness) {
+            test = &txvalid_sighash[i];
+            break;
+        }
+    }
+    int outlen = 0;
+    uint8_t tx_data[sizeof(test->sertx) / 2];
+    utils_hex_to_bin(test->sertx, tx_data, strlen(test->sertx), &outlen);
+    dogecoin_tx* tx = dogecoin_tx_new();
+    dogecoin_tx_deserialize(tx_data, outlen, tx, NULL, true);
+    uint8_t script_data[sizeof(test->script) / 2];
+    utils_hex_to_bin(test->script, script_data, strlen(test->script), &outlen);
+    cstring* script = cstr_new_buf(script_data, outlen);
+
+    u_assert_int_eq((size_t)test->i < tx->vout->len, 1);
+    uint256 none_before, single_before, all_before, hash;
+    dogecoin_sighash_ctx* ctx = dogecoin_sighash_ctx_new(tx);
+    dogecoin_tx_sighash_with_ctx(ctx, script, test->i, SIGHASH_NONE, test->amount, SIGVERSION_WITNESS_V0, none_before);
+    dogecoin_tx_sighash_with_ctx(ctx, script, test->i, SIGHASH_SINGLE, test->amount, SIGVERSION_WITNESS_V0, single_before);
+    dogecoin_tx_sighash_with_ctx(ctx, script, test->i, SIGHASH_ALL, test->amount, SIGVERSION_WITNESS_V0, all_before);
+    dogecoin_sighash_ctx_free(ctx);
+
+    // adding an output after the signed one keeps NONE/SINGLE but changes ALL
+    dogecoin_tx_add_data_out(tx, 0, (const uint8_t*)"doge", 4);
+    ctx = dogecoin_sighash_ctx_new(tx);
+    dogecoin_tx_sighash_with_ctx(ctx, script, test->i, SIGHASH_NONE, test->amount, SIGVERSION_WITNESS_V0, hash);
+    u_assert_mem_eq(hash, none_before, sizeof(hash));
+    dogecoin_tx_sighash_with_ctx(ctx, script, test->i, SIGHASH_SINGLE, test->amount, SIGVERSION_WITNESS_V0, hash);
+    u_assert_mem_eq(hash, single_before, sizeof(hash));
+    dogecoin_tx_sighash_with_ctx(ctx, script, test->i, SIGHASH_ALL, test->amount, SIGVERSION_WITNESS_V0, hash);
+    u_assert_int_eq(memcmp(hash, all_before, sizeof(hash)) != 0, 1);
+    u_assert_int_eq(memcmp(none_before, single_before, sizeof(hash)) != 0, 1);
+    dogecoin_sighash_ctx_free(ctx);
+
+    cstr_free(script, true);
+    dogecoin_tx_free(tx);
+}
+
 void test_tx_sighash()
 {
     unsigned int i;
@@ -978,6 +1131,240 @@ void test_tx_negative_version()
 }
 
 
+static void check_tx_view_matches(const dogecoin_tx_view* view, const dogecoin_tx* tx)
+{
+    assert(view->version == tx->version);
+    assert(view->locktime == tx->locktime);
+    assert(view->vin_count == tx->vin->len);
+    assert(view->vout_count == tx->vout->len);
+
+    size_t i, j;
+    dogecoin_tx_view_in in;
+    for (i = 0; i < tx->vin->len; i++) {
+        dogecoin_tx_in* tx_in = vector_idx(tx->vin, i);
+        if (i == 0)
+            assert(dogecoin_tx_view_get_in(view, 0, &in));
+        else
+            assert(dogecoin_tx_view_next_in(view, &in));
+        assert(in.index == i);
+        assert(memcmp(in.prevout_hash, tx_in->prevout.hash, 32) == 0);
+        assert(in.prevout_n == tx_in->prevout.n);
+        assert(in.sequence == tx_in->sequence);
+        assert(in.script_sig_len == tx_in->script_sig->len);
+        assert(memcmp(in.script_sig, tx_in->script_sig->str, in.script_sig_len) == 0);
+
+        assert(dogecoin_tx_view_witness_count(view, i) == tx_in->witness_stack->len);
+        for (j = 0; j < tx_in->witness_stack->len; j++) {
+            cstring* item = vector_idx(tx_in->witness_stack, j);
+            const uint8_t* item_data;
+            size_t item_len;
+            assert(dogecoin_tx_view_get_witness_item(view, i, j, &item_data, &item_len));
+            assert(item_len == item->len);
+            assert(memcmp(item_data, item->str, item_len) == 0);
+        }
+    }
+    if (tx->vin->len > 0)
+        assert(!dogecoin_tx_view_next_in(view, &in));
+    assert(!dogecoin_tx_view_get_in(view, tx->vin->len, &in));
+
+    dogecoin_tx_view_out out;
+    for (i = 0; i < tx->vout->len; i++) {
+        dogecoin_tx_out* tx_out = vector_idx(tx->vout, i);
+        assert(dogecoin_tx_view_get_out(view, i, &out));
+        assert(out.value == tx_out->value);
+        assert(out.script_pubkey_len == tx_out->script_pubkey->len);
+        assert(memcmp(out.script_pubkey, tx_out->script_pubkey->str, out.script_pubkey_len) == 0);
+    }
+    assert(!dogecoin_tx_view_get_out(view, tx->vout->len, &out));
+}
+
+void test_tx_view()
+{
+    unsigned int i;
+    for (i = 0; i < (sizeof(txvalid) / sizeof(txvalid[0])); i++) {
+        const struct txtest* one_test = &txvalid[i];
+        uint8_t tx_data[sizeof(one_test->hextx) / 2];
+        int outlen;
+        utils_hex_to_bin(one_test->hextx, tx_data, strlen(one_test->hextx), &outlen);
+
+        dogecoin_tx* tx = dogecoin_tx_new();
+        size_t consumed_tx = 0;
+        u_assert_int_eq(dogecoin_tx_deserialize(tx_data, outlen, tx, &consumed_tx, true), true);
+
+        dogecoin_tx_view view;
+        size_t consumed_view = 0;
+        u_assert_int_eq(dogecoin_tx_view_parse(&view, tx_data, outlen, &consumed_view, true), true);
+        u_assert_int_eq(consumed_view, consumed_tx);
+        u_assert_int_eq(view.has_witness, false);
+        check_tx_view_matches(&view, tx);
+
+        // every truncation must be rejected
+        u_assert_int_eq(dogecoin_tx_view_parse(&view, tx_data, outlen - 1, NULL, true), false);
+        dogecoin_tx_free(tx);
+    }
+
+    const char* witness_tx_hex = "02000000000101bb3ee7f13f00b58a65f3789ff9917ae2eb2f360957ca86d4ec8068deae16f94c0000000017160014d7d7d2e56512a14b41f2b412eb33f9a2c464e407ffffffff01c0878b3b0000000017a914b1c1b08a898e07095e72a50cdf889bcdb1530a3587024730440220685849941f583fe4a54b77fbe7963a2f7fdb9fefc661f9e43d9c6c213f6a4c9c02207da98e43af69d2c616c489eb22657e62a1360eeb5a86d8a31bd8a33dd9de21f10121022d0e577424abfbbb5e321d3e2c700122a0c004305f57725810988cee6c4c278d00000000";
+    uint8_t witness_tx_data[strlen(witness_tx_hex) / 2];
+    int outlen;
+    utils_hex_to_bin(witness_tx_hex, witness_tx_data, strlen(witness_tx_hex), &outlen);
+
+    dogecoin_tx* tx = dogecoin_tx_new();
+    u_assert_int_eq(dogecoin_tx_deserialize(witness_tx_data, outlen, tx, NULL, true), true);
+    dogecoin_tx_view view;
+    u_assert_int_eq(dogecoin_tx_view_parse(&view, witness_tx_data, outlen, NULL, true), true);
+    u_assert_int_eq(view.has_witness, true);
+    u_assert_int_eq(dogecoin_tx_view_witness_count(&view, 0), 2);
+    check_tx_view_matches(&view, tx);
+    u_assert_int_eq(dogecoin_tx_view_parse(&view, witness_tx_data, outlen - 4, NULL, true), false);
+    dogecoin_tx_free(tx);
+}
+
+void test_tx_serialize_to()
+{
+    const char* witness_tx_hex = "02000000000101bb3ee7f13f00b58a65f3789ff9917ae2eb2f360957ca86d4ec8068deae16f94c0000000017160014d7d7d2e56512a14b41f2b412eb33f9a2c464e407ffffffff01c0878b3b0000000017a914b1c1b08a898e07095e72a50cdf889bcdb1530a3587024730440220685849941f583fe4a54b77fbe7963a2f7fdb9fefc661f9e43d9c6c213f6a4c9c02207da98e43af69d2c616c489eb22657e62a1360eeb5a86d8a31bd8a33dd9de21f10121022d0e577424abfbbb5e321d3e2c700122a0c004305f57725810988cee6c4c278d00000000";
+    unsigned int i;
+    for (i = 0; i <= (sizeof(txvalid) / sizeof(txvalid[0])); i++) {
+        const char* hextx = i < (sizeof(txvalid) / sizeof(txvalid[0])) ? txvalid[i].hextx : witness_tx_hex;
+        uint8_t tx_data[strlen(hextx) / 2];
+        int outlen;
+        utils_hex_to_bin(hextx, tx_data, strlen(hextx), &outlen);
+
+        dogecoin_tx* tx = dogecoin_tx_new();
+        u_assert_int_eq(dogecoin_tx_deserialize(tx_data, outlen, tx, NULL, true), true);
+
+        dogecoin_bool allow_witness;
+        for (allow_witness = 0; allow_witness <= 1; allow_witness++) {
+            cstring* str = cstr_new_sz(16);
+            dogecoin_tx_serialize(str, tx, allow_witness);
+            size_t size = dogecoin_tx_serialized_size(tx, allow_witness);
+            u_assert_int_eq(size, str->len);
+
+            uint8_t buf[size + 1];
+            memset(buf, 0xaa, sizeof(buf));
+            u_assert_int_eq(dogecoin_tx_serialize_to(buf, size - 1, tx, allow_witness), 0);
+            u_assert_int_eq(buf[0], 0xaa);
+            u_assert_int_eq(dogecoin_tx_serialize_to(buf, sizeof(buf), tx, allow_witness), size);
+            u_assert_mem_eq(buf, str->str, size);
+            u_assert_int_eq(buf[size], 0xaa);
+            cstr_free(str, true);
+        }
+        u_assert_int_eq(dogecoin_tx_serialized_size(tx, true), (size_t)outlen);
+        dogecoin_tx_free(tx);
+    }
+}
+
+void test_tx_hash_cache()
+{
+    const char* witness_tx_hex = "02000000000101bb3ee7f13f00b58a65f3789ff9917ae2eb2f360957ca86d4ec8068deae16f94c0000000017160014d7d7d2e56512a14b41f2b412eb33f9a2c464e407ffffffff01c0878b3b0000000017a914b1c1b08a898e07095e72a50cdf889bcdb1530a3587024730440220685849941f583fe4a54b77fbe7963a2f7fdb9fefc661f9e43d9c6c213f6a4c9c02207da98e43af69d2c616c489eb22657e62a1360eeb5a86d8a31bd8a33dd9de21f10121022d0e577424abfbbb5e321d3e2c700122a0c004305f57725810988cee6c4c278d00000000";
+    uint8_t tx_data[strlen(witness_tx_hex) / 2];
+    int outlen;
+    utils_hex_to_bin(witness_tx_hex, tx_data, strlen(witness_tx_hex), &outlen);
+    dogecoin_tx* tx = dogecoin_tx_new();
+    dogecoin_tx_deserialize(tx_data, outlen, tx, NULL, true);
+
+    uint256 txid, wtxid, expected;
+    cstring* str = cstr_new_sz(outlen);
+    dogecoin_tx_serialize(str, tx, false);
+    dogecoin_hash((const uint8_t*)str->str, str->len, expected);
+    cstr_free(str, true);
+    dogecoin_tx_hash(tx, txid);
+    u_assert_mem_eq(txid, expected, sizeof(txid));
+    u_assert_int_eq(tx->txid_valid, true);
+
+    dogecoin_hash(tx_data, outlen, expected);
+    dogecoin_tx_wtxid(tx, wtxid);
+    u_assert_mem_eq(wtxid, expected, sizeof(wtxid));
+    u_assert_int_eq(memcmp(txid, wtxid, sizeof(txid)) != 0, 1);
+
+    // direct changes need an explicit invalidation, the helpers do it on their own
+    tx->locktime++;
+    dogecoin_tx_hash(tx, expected);
+    u_assert_mem_eq(expected, txid, sizeof(txid));
+    dogecoin_tx_invalidate_hash(tx);
+    dogecoin_tx_hash(tx, expected);
+    u_assert_int_eq(memcmp(expected, txid, sizeof(txid)) != 0, 1);
+    memcpy(txid, expected, sizeof(txid));
+    dogecoin_tx_add_data_out(tx, 0, (const uint8_t*)"doge", 4);
+    u_assert_int_eq(tx->txid_valid || tx->wtxid_valid, false);
+    dogecoin_tx_hash(tx, expected);
+    u_assert_int_eq(memcmp(expected, txid, sizeof(txid)) != 0, 1);
+
+    // without witness data both ids are the same
+    dogecoin_tx* tx_copy = dogecoin_tx_new();
+    dogecoin_tx_copy(tx_copy, tx);
+    dogecoin_tx_in* tx_in = vector_idx(tx_copy->vin, 0);
+    vector_resize(tx_in->witness_stack, 0);
+    dogecoin_tx_hash(tx_copy, txid);
+    dogecoin_tx_wtxid(tx_copy, wtxid);
+    u_assert_mem_eq(txid, wtxid, sizeof(txid));
+    u_assert_mem_eq(txid, expected, sizeof(txid));
+
+    dogecoin_tx_free(tx_copy);
+    dogecoin_tx_free(tx);
+}
+
+void test_tx_deserialize_arena()
+{
+    static uint8_t arena_buf[64 * 1024];
+    dogecoin_arena arena;
+    dogecoin_arena_init(&arena, arena_buf, sizeof(arena_buf));
+
+    unsigned int i;
+    for (i = 0; i < (sizeof(txvalid) / sizeof(txvalid[0])); i++) {
+        const struct txtest* one_test = &txvalid[i];
+        uint8_t tx_data[sizeof(one_test->hextx) / 2];
+        int outlen;
+        utils_hex_to_bin(one_test->hextx, tx_data, strlen(one_test->hextx), &outlen);
+
+        size_t consumed = 0;
+        dogecoin_tx* tx = dogecoin_tx_deserialize_arena(tx_data, outlen, &arena, &consumed, true);
+        u_assert_int_eq((tx != NULL), 1);
+        u_assert_int_eq(consumed, (size_t)outlen);
+        u_assert_int_eq(tx->vin->len, (size_t)one_test->num_ins);
+
+        cstring* str = cstr_new_sz(outlen);
+        dogecoin_tx_serialize(str, tx, true);
+        u_assert_int_eq(str->len, (size_t)outlen);
+        u_assert_int_eq(memcmp(str->str, tx_data, outlen), 0);
+        cstr_free(str, true);
+
+        // a heap copy is fully independent from the arena
+        dogecoin_tx* tx_copy = dogecoin_tx_new();
+        dogecoin_tx_copy(tx_copy, tx);
+        dogecoin_arena_reset(&arena);
+        str = cstr_new_sz(outlen);
+        dogecoin_tx_serialize(str, tx_copy, true);
+        u_assert_int_eq(memcmp(str->str, tx_data, outlen), 0);
+        cstr_free(str, true);
+        dogecoin_tx_free(tx_copy);
+
+        // invalid data and exhausted arenas are rejected without consuming arena space
+        u_assert_is_null(dogecoin_tx_deserialize_arena(tx_data, outlen - 1, &arena, NULL, true));
+        dogecoin_arena small_arena;
+        dogecoin_arena_init(&small_arena, arena_buf, 64);
+        u_assert_is_null(dogecoin_tx_deserialize_arena(tx_data, outlen, &small_arena, &consumed, true));
+        u_assert_int_eq(small_arena.used, 0);
+        u_assert_int_eq(consumed, 0);
+        u_assert_int_eq(arena.used, 0);
+    }
+
+    const char* witness_tx_hex = "02000000000101bb3ee7f13f00b58a65f3789ff9917ae2eb2f360957ca86d4ec8068deae16f94c0000000017160014d7d7d2e56512a14b41f2b412eb33f9a2c464e407ffffffff01c0878b3b0000000017a914b1c1b08a898e07095e72a50cdf889bcdb1530a3587024730440220685849941f583fe4a54b77fbe7963a2f7fdb9fefc661f9e43d9c6c213f6a4c9c02207da98e43af69d2c616c489eb22657e62a1360eeb5a86d8a31bd8a33dd9de21f10121022d0e577424abfbbb5e321d3e2c700122a0c004305f57725810988cee6c4c278d00000000";
+    uint8_t witness_tx_data[strlen(witness_tx_hex) / 2];
+    int outlen;
+    utils_hex_to_bin(witness_tx_hex, witness_tx_data, strlen(witness_tx_hex), &outlen);
+    dogecoin_tx* tx = dogecoin_tx_deserialize_arena(witness_tx_data, outlen, &arena, NULL, true);
+    u_assert_int_eq((tx != NULL), 1);
+    u_assert_int_eq(dogecoin_tx_has_witness(tx), true);
+    dogecoin_tx_in* tx_in = vector_idx(tx->vin, 0);
+    u_assert_int_eq(tx_in->witness_stack->len, 2);
+    cstring* str = cstr_new_sz(outlen);
+    dogecoin_tx_serialize(str, tx, true);
+    u_assert_int_eq(str->len, (size_t)outlen);
+    u_assert_int_eq(memcmp(str->str, witness_tx_data, outlen), 0);
+    cstr_free(str, true);
+    dogecoin_arena_reset(&arena);
+}
+
 struct script_test {
     char script[32];
 };
@@ -1079,9 +1466,9 @@ void test_script_parse()
 
     uint256 txhash;
     dogecoin_tx_hash(tx, txhash);
-    char txhashhex[sizeof(txhash)*2];
+    char txhashhex[sizeof(txhash)*2 + 1];
     utils_bin_to_hex((unsigned char*)txhash, sizeof(txhash), txhashhex);
-    utils_reverse_hex(txhashhex, sizeof(txhashhex));
+    utils_reverse_hex(txhashhex, sizeof(txhash) * 2);
 
     u_assert_str_eq(txhashhex, "41a86af25423391b1d9d78df1143e3a237f20db27511d8b72e25f2dec7a81d80");
 
@@ -1365,6 +1752,64 @@ void test_tx_sign() {
     dogecoin_tx_free(tx);
 }
 
+void test_tx_sign_inputs_batch() {
+    const char *tx_hex = "02000000027409797c31feecc4e69b51c58b477b72c53355743a6f6124f9d78221672df3700100000000ffffffff6e1709c1e2bdd85aed24dccfd48293993617f249d4d4381296a9c914be3e85e60100000000ffffffff01c07fdc0b0000000017a914ba277fd56b69177464fcb6a27a530f03740345ed8700000000";
+    const char *script_hex[2] = {"76a9149b47fd7adc7a671ed059c9dcbf2eee2e882ea56b88ac", "76a91481edb497b5ba6eb9e67b7ed50fb220395f76f95088ac"};
+    const char *pkey_wif[2] = {"cRpSdivawavdAPgEYGXusWt64cJG9zLcgDPsEvnhHWtizVtmGk5b", "cS8Xxe3MNoeWp5SckUfVw3WuaCNZ9eeQ4awjwkkARQ4xmXS5B1VW"};
+    const char *expected_tx_signed = "02000000027409797c31feecc4e69b51c58b477b72c53355743a6f6124f9d78221672df370010000006a47304402205d44c682a69da1ca10e1149548bf7e7b53f0ce8f2d2bd2ea74026cba57cd4fe702200e0f9d87aafa1c88697238aaf1059b7718a97ff681efe474097221d456eb7ea2012102c5b9d2d528f13b7b745736f6fd198614a09200c3c5cb0554327e110b4a8efcf1ffffffff6e1709c1e2bdd85aed24dccfd48293993617f249d4d4381296a9c914be3e85e6010000006b48304502210084181199e59f30ab947fa751662b20899a3c89a45f13b5aff8096eae56a68aa502204ea5d1b96c15099315be0a3583628a09d18530a9f937a88e74fa8c24a49449a401210228f47e13841624ec8669f71176558927105207c138a65772331b7fc19c117b64ffffffff01c07fdc0b0000000017a914ba277fd56b69177464fcb6a27a530f03740345ed8700000000";
+    unsigned int threads[3] = {0, 2, 8};
+    unsigned int t;
+    int i, outlen;
+
+    uint8_t tx_data[strlen(tx_hex) / 2];
+    utils_hex_to_bin(tx_hex, tx_data, strlen(tx_hex), &outlen);
+
+    cstring *script[2];
+    dogecoin_key pkey[2];
+    for (i = 0; i < 2; i++) {
+        uint8_t script_data[strlen(script_hex[i]) / 2];
+        int script_len;
+        utils_hex_to_bin(script_hex[i], script_data, strlen(script_hex[i]), &script_len);
+        script[i] = cstr_new_buf(script_data, script_len);
+        dogecoin_privkey_init(&pkey[i]);
+        dogecoin_privkey_decode_wif(pkey_wif[i], &dogecoin_chainparams_regtest, &pkey[i]);
+    }
+
+    for (t = 0; t < sizeof(threads) / sizeof(threads[0]); t++) {
+        dogecoin_tx* tx = dogecoin_tx_new();
+        dogecoin_tx_deserialize(tx_data, outlen, tx, NULL, true);
+
+        // jobs in reverse input order, the result must not depend on it
+        dogecoin_tx_sign_job jobs[2];
+        for (i = 0; i < 2; i++) {
+            jobs[i].inputindex = 1 - i;
+            jobs[i].script = script[1 - i];
+            jobs[i].amount = 100000000;
+            jobs[i].privkey = &pkey[1 - i];
+            jobs[i].sighashtype = SIGHASH_ALL;
+        }
+        u_assert_int_eq(dogecoin_tx_sign_inputs_batch(tx, jobs, 2, threads[t]), DOGECOIN_SIGN_OK);
+        u_assert_int_eq(jobs[0].result, DOGECOIN_SIGN_OK);
+        u_assert_int_eq(jobs[1].result, DOGECOIN_SIGN_OK);
+
+        cstring* tx_ser = cstr_new_sz(1024);
+        dogecoin_tx_serialize(tx_ser, tx, true);
+        char hexbuf[tx_ser->len * 2 + 1];
+        utils_bin_to_hex((unsigned char*)tx_ser->str, tx_ser->len, hexbuf);
+        u_assert_str_eq(hexbuf, expected_tx_signed);
+        cstr_free(tx_ser, true);
+
+        // out of range input is reported per job
+        jobs[0].inputindex = 2;
+        u_assert_int_eq(dogecoin_tx_sign_inputs_batch(tx, jobs, 1, threads[t]), DOGECOIN_SIGN_INPUTINDEX_OUT_OF_RANGE);
+        u_assert_int_eq(jobs[0].result, DOGECOIN_SIGN_INPUTINDEX_OUT_OF_RANGE);
+        dogecoin_tx_free(tx);
+    }
+
+    cstr_free(script[0], true);
+    cstr_free(script[1], true);
+}
+
 void test_scripts() {
     const char *script_p2pk = "41042f462d3245d2f3a015f7f9505f763ee1080cab36191d07ae9e6509f71bb68818719e6fb41c019bf48ae11c45b024d476e19b6963103ce8647fc15fee513b15c7ac";
     const char *script_p2pkh = "76a91481edb497b5ba6eb9e67b7ed50fb220395f76f95088ac";
@@ -14,6 +14,8 @@
 #include <string.h>
 #include <assert.h>
 
+#include <dogecoin/crypto/ecc.h>
+
 #include <test/utest.h>
 
 #ifdef HAVE_BUILTIN_EXPECT
@@ -35,69 +37,108 @@
         }                                                  \
     } while (0)
 
+extern void test_address();
 extern void test_aes();
 extern void test_base58();
 extern void test_bip32();
+extern void test_bip39();
+extern void test_block_genesis();
+extern void test_block_parse();
 extern void test_buffer();
+extern void test_coinselect();
+extern void test_coinselect_large();
 extern void test_cstr();
 extern void test_ecc();
+extern void test_ecc_schnorr();
 extern void test_hash();
+extern void test_hash_fixed();
 extern void test_key();
 extern void test_memory();
+extern void test_memory_arena();
 extern void test_random();
 extern void test_rmd160();
+extern void test_rmd160_batch();
+extern void test_scrypt();
 extern void test_serialize();
 extern void test_sha_256();
+extern void test_sha_256_batch();
 extern void test_sha_512();
 extern void test_sha_hmac();
+extern void test_sigcache();
 extern void test_tool();
 extern void test_tx_serialization();
 extern void test_tx_sighash();
 extern void test_tx_sighash_ext();
+extern void test_tx_sighash_ctx();
 extern void test_tx_negative_version();
+extern void test_tx_view();
+extern void test_tx_deserialize_arena();
+extern void test_tx_serialize_to();
+extern void test_tx_hash_cache();
 extern void test_script_parse();
 extern void test_script_op_codeseperator();
 extern void test_invalid_tx_deser();
 extern void test_tx_sign();
+extern void test_tx_sign_inputs_batch();
 extern void test_scripts();
+extern void test_message();
 extern void test_utils();
+extern void test_vanity();
 extern void test_vector();
 
-extern void dogecoin_ecc_start();
-extern void dogecoin_ecc_stop();
-
 int U_TESTS_RUN = 0;
 int U_TESTS_FAIL = 0;
 
 int main() {
     dogecoin_ecc_start();
 
+    u_run_test(test_address);
     u_run_test(test_aes);
     u_run_test(test_base58);
     u_run_test(test_bip32);
+    u_run_test(test_bip39);
+    u_run_test(test_block_genesis);
+    u_run_test(test_block_parse);
     u_run_test(test_buffer);
+    u_run_test(test_coinselect);
+    u_run_test(test_coinselect_large);
     u_run_test(test_cstr);
     u_run_test(test_ecc);
+    u_run_test(test_ecc_schnorr);
     u_run_test(test_hash);
+    u_run_test(test_hash_fixed);
     u_run_test(test_key);
     u_run_test(test_memory);
+    u_run_test(test_memory_arena);
     u_run_test(test_random);
     u_run_test(test_rmd160);
+    u_run_test(test_rmd160_batch);
+    u_run_test(test_scrypt);
     u_run_test(test_serialize);
     u_run_test(test_sha_256);
+    u_run_test(test_sha_256_batch);
     u_run_test(test_sha_512);
     u_run_test(test_sha_hmac);
+    u_run_test(test_sigcache);
     u_run_test(test_tool);
     u_run_test(test_tx_serialization);
     u_run_test(test_invalid_tx_deser);
     u_run_test(test_tx_sign);
+    u_run_test(test_tx_sign_inputs_batch);
     u_run_test(test_tx_sighash);
     u_run_test(test_tx_sighash_ext);
+    u_run_test(test_tx_sighash_ctx);
     u_run_test(test_tx_negative_version);
+    u_run_test(test_tx_view);
+    u_run_test(test_tx_deserialize_arena);
+    u_run_test(test_tx_serialize_to);
+    u_run_test(test_tx_hash_cache);
     u_run_test(test_scripts);
     u_run_test(test_script_parse);
     u_run_test(test_script_op_codeseperator);
+    u_run_test(test_message);
     u_run_test(test_utils);
+    u_run_test(test_vanity);
     u_run_test(test_vector);
 
     dogecoin_ecc_stop();
@@ -45,4 +45,25 @@ void test_utils()
     utils_hex_to_bin(hex2, data3, strlen(hex2), &outlen);
     hash_bin = utils_hex_to_uint8(hex2);
     utils_clear_buffers();
+
+    /* rfc 4648 base64 vectors */
+    const char* b64_plain[] = {"", "f", "fo", "foo", "foob", "fooba", "foobar"};
+    const char* b64_enc[] = {"", "Zg==", "Zm8=", "Zm9v", "Zm9vYg==", "Zm9vYmE=", "Zm9vYmFy"};
+    char b64[16];
+    unsigned char b64_bin[8];
+    size_t b64_len, i;
+    for (i = 0; i < 7; i++) {
+        assert(utils_base64_encode((const unsigned char*)b64_plain[i], strlen(b64_plain[i]), b64) == strlen(b64_enc[i]));
+        assert(strcmp(b64, b64_enc[i]) == 0);
+        b64_len = sizeof(b64_bin);
+        assert(utils_base64_decode(b64_enc[i], strlen(b64_enc[i]), b64_bin, &b64_len));
+        assert(b64_len == strlen(b64_plain[i]));
+        assert(memcmp(b64_bin, b64_plain[i], b64_len) == 0);
+    }
+    b64_len = sizeof(b64_bin);
+    assert(!utils_base64_decode("Zm9", 3, b64_bin, &b64_len));
+    assert(!utils_base64_decode("Zm=v", 4, b64_bin, &b64_len));
+    assert(!utils_base64_decode("Zm9v!A==", 8, b64_bin, &b64_len));
+    b64_len = 2;
+    assert(!utils_base64_decode("Zm9v", 4, b64_bin, &b64_len));
 }
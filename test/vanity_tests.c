@@ -0,0 +1,111 @@
+/**********************************************************************
+ * Copyright (c) 2022 The Dogecoin Foundation                         *
+ * Distributed under the MIT software license, see the accompanying   *
+ * file COPYING or http://www.opensource.org/licenses/mit-license.php.*
+ **********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <test/utest.h>
+
+#include <dogecoin/chainparams.h>
+#include <dogecoin/crypto/base58.h>
+#include <dogecoin/crypto/key.h>
+#include <dogecoin/crypto/random.h>
+#include <dogecoin/vanity.h>
+
+// the slow way, encode and compare
+static dogecoin_bool vanity_reference(const dogecoin_vanity_pattern* pattern, const uint160 hash160) {
+    uint8_t payload[sizeof(uint160) + 1];
+    char address[64];
+    payload[0] = pattern->version;
+    memcpy(payload + 1, hash160, sizeof(uint160));
+    dogecoin_base58_encode_check(payload, sizeof(payload), address, sizeof(address));
+    return strncmp(address, pattern->prefix, strlen(pattern->prefix)) == 0;
+}
+
+static void vanity_progress(const dogecoin_vanity_progress* progress, void* user_data) {
+    dogecoin_vanity_progress* last = user_data;
+    *last = *progress;
+}
+
+void test_vanity() {
+    dogecoin_vanity_pattern pattern;
+    const char* invalid[] = {"", "DO", "D0", "Dl", "1D", "Da", "D4", "DUV", "D596YFweJQuHY1BbjazZYmAbt8jJL2VzVMz"};
+    size_t i, r;
+
+    for (i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+        u_assert_int_eq(dogecoin_vanity_pattern_init(&pattern, invalid[i], &dogecoin_chainparams_main), false);
+    }
+    u_assert_int_eq(dogecoin_vanity_pattern_init(&pattern, NULL, &dogecoin_chainparams_main), false);
+
+    // every mainnet p2pkh address starts with D
+    u_assert_int_eq(dogecoin_vanity_pattern_init(&pattern, "D", &dogecoin_chainparams_main), true);
+    u_assert_int_eq(pattern.num_ranges, 1);
+    u_assert_int_eq(pattern.difficulty < 1.0001, true);
+    u_assert_int_eq(dogecoin_vanity_pattern_init(&pattern, "D", &dogecoin_chainparams_test), false);
+    u_assert_int_eq(dogecoin_vanity_pattern_init(&pattern, "n", &dogecoin_chainparams_test), true);
+
+    // a whole address is a single hash160
+    u_assert_int_eq(dogecoin_vanity_pattern_init(&pattern, "D596YFweJQuHY1BbjazZYmAbt8jJL2VzVM", &dogecoin_chainparams_main), true);
+    u_assert_int_eq(pattern.num_ranges, 1);
+    u_assert_int_eq(pattern.difficulty > 1e47, true);
+
+    // range check against encoding, on random hashes and around the bounds
+    const char* prefixes[] = {"DSh", "DA", "D5", "DU", "DUUh", "D9x", "nX", "nsX"};
+    for (i = 0; i < sizeof(prefixes) / sizeof(prefixes[0]); i++) {
+        const dogecoin_chainparams* chain = prefixes[i][0] == 'n' ? &dogecoin_chainparams_test : &dogecoin_chainparams_main;
+        u_assert_int_eq(dogecoin_vanity_pattern_init(&pattern, prefixes[i], chain), true);
+        for (r = 0; r < 256; r++) {
+            uint160 hash;
+            dogecoin_random_bytes(hash, sizeof(hash), 0);
+            if (r & 1) // stay within the first bytes of the range
+                memcpy(hash, pattern.lo[0], 2 + r % 3);
+            u_assert_int_eq(dogecoin_vanity_match(&pattern, hash), vanity_reference(&pattern, hash));
+        }
+        for (r = 0; r < pattern.num_ranges; r++) {
+            uint160 hash;
+            int k;
+            memcpy(hash, pattern.lo[r], sizeof(hash));
+            u_assert_int_eq(dogecoin_vanity_match(&pattern, hash), vanity_reference(&pattern, hash));
+            for (k = sizeof(hash) - 1; k >= 0 && hash[k]-- == 0; k--) {
+            }
+            u_assert_int_eq(dogecoin_vanity_match(&pattern, hash), vanity_reference(&pattern, hash));
+            memcpy(hash, pattern.hi[r], sizeof(hash));
+            u_assert_int_eq(dogecoin_vanity_match(&pattern, hash), vanity_reference(&pattern, hash));
+            for (k = sizeof(hash) - 1; k >= 0 && ++hash[k] == 0; k--) {
+            }
+            u_assert_int_eq(dogecoin_vanity_match(&pattern, hash), vanity_reference(&pattern, hash));
+        }
+    }
+
+    // a short search finds a key whose address has the prefix
+    unsigned int threads[2] = {1, 3};
+    for (i = 0; i < 2; i++) {
+        dogecoin_vanity_progress progress;
+        dogecoin_key key;
+        dogecoin_pubkey pubkey;
+        char address[64];
+        memset(&progress, 0, sizeof(progress));
+        u_assert_int_eq(dogecoin_vanity_pattern_init(&pattern, "DSh", &dogecoin_chainparams_main), true);
+        u_assert_int_eq(dogecoin_vanity_search(&pattern, threads[i], 0, vanity_progress, &progress, &key), true);
+        u_assert_int_eq(progress.found, true);
+        u_assert_int_eq(progress.keys > 0, true);
+        dogecoin_pubkey_init(&pubkey);
+        dogecoin_pubkey_from_key(&key, &pubkey);
+        dogecoin_pubkey_getaddr_p2pkh(&pubkey, &dogecoin_chainparams_main, address);
+        u_assert_int_eq(strncmp(address, "DSh", 3), 0);
+        dogecoin_privkey_cleanse(&key);
+    }
+
+    // gives up after max_keys
+    dogecoin_vanity_progress progress;
+    dogecoin_key key;
+    u_assert_int_eq(dogecoin_vanity_pattern_init(&pattern, "DShopDShop", &dogecoin_chainparams_main), true);
+    u_assert_int_eq(dogecoin_vanity_search(&pattern, 2, 4096, vanity_progress, &progress, &key), false);
+    u_assert_int_eq(progress.found, false);
+    u_assert_int_eq(progress.keys >= 4096, true);
+    u_assert_int_eq(progress.eta > 0, true);
+}